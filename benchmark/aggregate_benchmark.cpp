@@ -0,0 +1,21 @@
+#include "benchmark_data.hpp"
+#include "flockmtl/functions/aggregate/aggregate.hpp"
+
+namespace flockmtl {
+
+static void BM_AggregateStateCombine(benchmark::State& state) {
+    AggregateFunctionState source;
+    for (auto& tuple : MakeTuples(kChunkRows, state.range(0), 8)) {
+        source.Update(tuple);
+    }
+    for (auto _ : state) {
+        AggregateFunctionState target;
+        target.Initialize();
+        target.Combine(source);
+        benchmark::DoNotOptimize(target.value.data());
+    }
+    SetRowsProcessed(state, kChunkRows);
+}
+BENCHMARK(BM_AggregateStateCombine)->Arg(1)->Arg(8);
+
+} // namespace flockmtl
@@ -0,0 +1,97 @@
+#include "benchmark_data.hpp"
+#include "flockmtl/functions/batch_response_builder.hpp"
+#include "flockmtl/functions/scalar/scalar.hpp"
+
+namespace flockmtl {
+
+// Answers every batch immediately with one value per XML tuple, so only FlockMTL's own work is measured.
+class StubProvider : public IProvider {
+public:
+    explicit StubProvider(const ModelDetails& model_details) : IProvider(model_details) {}
+
+    nlohmann::json CallComplete(const std::string& prompt, bool json_response) override {
+        // The first <tuple> is the header that names the columns.
+        size_t tuples = 0;
+        for (auto pos = prompt.find("<tuple>"); pos != std::string::npos; pos = prompt.find("<tuple>", pos + 1)) {
+            tuples++;
+        }
+        return {{"tuples", std::vector<bool>(tuples > 0 ? tuples - 1 : 0, true)}};
+    }
+
+    nlohmann::json CallEmbedding(const std::vector<std::string>& inputs) override {
+        return std::vector<std::vector<double>>(inputs.size(), std::vector<double>(8, 0.5));
+    }
+};
+
+static ModelDetails GetStubModelDetails() {
+    ModelDetails model_details;
+    model_details.provider_name = "stub";
+    model_details.model_name = "stub";
+    model_details.model = "stub";
+    model_details.context_window = 16000;
+    model_details.max_output_tokens = 4000;
+    model_details.temperature = 0;
+    model_details.tuple_format = "XML";
+    model_details.batch_size = 0;
+    model_details.encoding_format = "float";
+    model_details.dimensions = 0;
+    model_details.requests_per_minute = 0;
+    model_details.tokens_per_minute = 0;
+    model_details.max_retries = 0;
+    model_details.connect_timeout = std::chrono::milliseconds(0);
+    model_details.request_timeout = std::chrono::milliseconds(0);
+    model_details.hedged_requests = false;
+    model_details.input_price = 0;
+    model_details.output_price = 0;
+    return model_details;
+}
+
+static void BM_BatchAndComplete(benchmark::State& state) {
+    const auto tuples = MakeTuples(kChunkRows, state.range(0), 12);
+    Model model(std::make_shared<StubProvider>(GetStubModelDetails()));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            ScalarFunctionBase::BatchAndComplete(tuples, "Is this review positive?", ScalarFunctionType::FILTER, model));
+    }
+    SetRowsProcessed(state, kChunkRows);
+}
+BENCHMARK(BM_BatchAndComplete)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+
+// A STRUCT vector of `columns` VARCHAR children filled from the generated tuples.
+static duckdb::Vector MakeStructVector(const std::vector<nlohmann::json>& tuples, const size_t columns) {
+    duckdb::child_list_t<duckdb::LogicalType> children;
+    for (size_t column = 0; column < columns; column++) {
+        children.emplace_back("column_" + std::to_string(column), duckdb::LogicalType::VARCHAR);
+    }
+    duckdb::Vector vector(duckdb::LogicalType::STRUCT(children), tuples.size());
+    auto& entries = duckdb::StructVector::GetEntries(vector);
+    for (size_t column = 0; column < columns; column++) {
+        auto data = duckdb::FlatVector::GetData<duckdb::string_t>(*entries[column]);
+        const auto key = "column_" + std::to_string(column);
+        for (size_t row = 0; row < tuples.size(); row++) {
+            data[row] = duckdb::StringVector::AddString(*entries[column], tuples[row][key].get<std::string>());
+        }
+    }
+    return vector;
+}
+
+static void BM_CastVectorOfStructsToJson(benchmark::State& state) {
+    const size_t columns = state.range(0);
+    const auto tuples = MakeTuples(kChunkRows, columns, 8);
+    const auto vector = MakeStructVector(tuples, columns);
+    int64_t bytes = 0;
+    for (const auto& tuple : tuples) {
+        for (const auto& [key, value] : tuple.items()) {
+            bytes += static_cast<int64_t>(value.get<std::string>().size());
+        }
+    }
+    state.SetLabel(columns > 4 ? "wide" : "narrow");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CastVectorOfStructsToJson(vector, kChunkRows));
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    SetRowsProcessed(state, kChunkRows);
+}
+BENCHMARK(BM_CastVectorOfStructsToJson)->Arg(2)->Arg(32);
+
+} // namespace flockmtl
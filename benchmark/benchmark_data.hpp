@@ -0,0 +1,48 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace flockmtl {
+
+// Every benchmark draws its inputs from this seed so runs are comparable.
+constexpr uint64_t kBenchmarkSeed = 42;
+
+// Rows of one DuckDB vector.
+constexpr int kChunkRows = 2048;
+
+inline std::string RandomText(std::mt19937_64& generator, const size_t words) {
+    static const std::vector<std::string> vocabulary = {
+        "the",     "duck",    "database", "quacks",  "query",   "semantic", "pond",    "vector",  "model", "table",
+        "reviews", "product", "great",    "terrible", "shipping", "arrived", "broken", "feather", "join",  "index"};
+    std::uniform_int_distribution<size_t> pick(0, vocabulary.size() - 1);
+    std::string text;
+    for (size_t i = 0; i < words; i++) {
+        text += (i == 0 ? "" : " ") + vocabulary[pick(generator)];
+    }
+    return text;
+}
+
+// `rows` tuples with `columns` text columns of about `words` words each.
+inline std::vector<nlohmann::json> MakeTuples(const size_t rows, const size_t columns, const size_t words) {
+    std::mt19937_64 generator(kBenchmarkSeed);
+    std::vector<nlohmann::json> tuples(rows);
+    for (auto& tuple : tuples) {
+        for (size_t column = 0; column < columns; column++) {
+            tuple["column_" + std::to_string(column)] = RandomText(generator, words);
+        }
+    }
+    return tuples;
+}
+
+inline void SetRowsProcessed(benchmark::State& state, const int64_t rows_per_iteration) {
+    state.counters["rows/s"] =
+        benchmark::Counter(static_cast<double>(state.iterations() * rows_per_iteration), benchmark::Counter::kIsRate);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,53 @@
+#include "benchmark_data.hpp"
+#include "flockmtl/functions/scalar/fusion_combanz.hpp"
+#include "flockmtl/functions/scalar/fusion_combmed.hpp"
+#include "flockmtl/functions/scalar/fusion_combmnz.hpp"
+#include "flockmtl/functions/scalar/fusion_combsum.hpp"
+#include "flockmtl/functions/scalar/fusion_rrf.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace flockmtl {
+
+// A chunk of `columns` score columns: normalized DOUBLE scores, or BIGINT ranks for rank-based fusion.
+static void MakeScoreChunk(duckdb::DataChunk& chunk, const size_t columns, const bool ranks) {
+    std::mt19937_64 generator(kBenchmarkSeed);
+    const auto type = ranks ? duckdb::LogicalType::BIGINT : duckdb::LogicalType::DOUBLE;
+    chunk.Initialize(duckdb::Allocator::DefaultAllocator(), duckdb::vector<duckdb::LogicalType>(columns, type),
+                     kChunkRows);
+    chunk.SetCardinality(kChunkRows);
+    for (size_t column = 0; column < columns; column++) {
+        if (ranks) {
+            auto data = duckdb::FlatVector::GetData<int64_t>(chunk.data[column]);
+            std::iota(data, data + kChunkRows, 1);
+            std::shuffle(data, data + kChunkRows, generator);
+            continue;
+        }
+        std::uniform_real_distribution<double> score(0, 1);
+        auto data = duckdb::FlatVector::GetData<double>(chunk.data[column]);
+        for (auto row = 0; row < kChunkRows; row++) {
+            data[row] = score(generator);
+        }
+    }
+}
+
+template <void (*FUSE)(duckdb::DataChunk&, double*), bool RANKS>
+static void BM_Fusion(benchmark::State& state) {
+    duckdb::DataChunk chunk;
+    MakeScoreChunk(chunk, state.range(0), RANKS);
+    std::vector<double> scores(kChunkRows);
+    for (auto _ : state) {
+        FUSE(chunk, scores.data());
+        benchmark::DoNotOptimize(scores.data());
+    }
+    state.SetBytesProcessed(state.iterations() * kChunkRows * state.range(0) * static_cast<int64_t>(sizeof(double)));
+    SetRowsProcessed(state, kChunkRows);
+}
+BENCHMARK_TEMPLATE(BM_Fusion, FusionRRF::Fuse, true)->Name("BM_FusionRRF")->Arg(2)->Arg(8);
+BENCHMARK_TEMPLATE(BM_Fusion, FusionCombANZ::Fuse, false)->Name("BM_FusionCombANZ")->Arg(2)->Arg(8);
+BENCHMARK_TEMPLATE(BM_Fusion, FusionCombMED::Fuse, false)->Name("BM_FusionCombMED")->Arg(2)->Arg(8);
+BENCHMARK_TEMPLATE(BM_Fusion, FusionCombMNZ::Fuse, false)->Name("BM_FusionCombMNZ")->Arg(2)->Arg(8);
+BENCHMARK_TEMPLATE(BM_Fusion, FusionCombSUM::Fuse, false)->Name("BM_FusionCombSUM")->Arg(2)->Arg(8);
+
+} // namespace flockmtl
@@ -0,0 +1,39 @@
+#include "benchmark_data.hpp"
+#include "flockmtl/prompt_manager/prompt_manager.hpp"
+
+namespace flockmtl {
+
+static const char* kTupleFormats[] = {"XML", "JSON", "MARKDOWN"};
+
+static void BM_ConstructInputTuples(benchmark::State& state) {
+    const auto tuple_format = kTupleFormats[state.range(0)];
+    const nlohmann::json tuples = MakeTuples(state.range(1), 3, 12);
+    state.SetLabel(tuple_format);
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        const auto rendered = PromptManager::ConstructInputTuples(tuples, tuple_format);
+        bytes += static_cast<int64_t>(rendered.size());
+        benchmark::DoNotOptimize(rendered.data());
+    }
+    state.SetBytesProcessed(bytes);
+    SetRowsProcessed(state, state.range(1));
+}
+BENCHMARK(BM_ConstructInputTuples)->ArgsProduct({{0, 1, 2}, {16, 256}});
+
+static void BM_PromptRender(benchmark::State& state) {
+    const auto tuple_format = kTupleFormats[state.range(0)];
+    const nlohmann::json tuples = MakeTuples(state.range(1), 3, 12);
+    state.SetLabel(tuple_format);
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        const auto prompt = PromptManager::Render("Is this review positive?", tuples, ScalarFunctionType::FILTER,
+                                                  tuple_format);
+        bytes += static_cast<int64_t>(prompt.size());
+        benchmark::DoNotOptimize(prompt.data());
+    }
+    state.SetBytesProcessed(bytes);
+    SetRowsProcessed(state, state.range(1));
+}
+BENCHMARK(BM_PromptRender)->ArgsProduct({{0, 1, 2}, {16, 256}});
+
+} // namespace flockmtl
@@ -0,0 +1,16 @@
+#include "benchmark_data.hpp"
+#include "flockmtl/model_manager/tiktoken.hpp"
+
+namespace flockmtl {
+
+static void BM_TiktokenGetNumTokens(benchmark::State& state) {
+    std::mt19937_64 generator(kBenchmarkSeed);
+    const auto text = RandomText(generator, state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Tiktoken::GetNumTokens(text));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_TiktokenGetNumTokens)->Arg(16)->Arg(256)->Arg(4096);
+
+} // namespace flockmtl
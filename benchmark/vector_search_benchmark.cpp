@@ -0,0 +1,108 @@
+#include "benchmark_data.hpp"
+
+#include <set>
+#include <thread>
+#include "flockmtl/vector_search/distance.hpp"
+#include "flockmtl/vector_search/hnsw.hpp"
+#include "flockmtl/vector_search/top_k.hpp"
+
+namespace flockmtl {
+
+// `rows` random vectors of `dimensions` floats, stored contiguously.
+static std::vector<float> MakeVectors(const size_t rows, const size_t dimensions) {
+    std::mt19937_64 generator(kBenchmarkSeed);
+    std::uniform_real_distribution<float> value(-1, 1);
+    std::vector<float> vectors(rows * dimensions);
+    for (auto& element : vectors) {
+        element = value(generator);
+    }
+    return vectors;
+}
+
+// Distances from one query to a chunk of vectors, keeping the 10 closest.
+static void BM_KnnScan(benchmark::State& state) {
+    const auto metric = static_cast<DistanceMetric>(state.range(0));
+    const size_t dimensions = state.range(1);
+    const auto vectors = MakeVectors(kChunkRows + 1, dimensions);
+    const auto query = vectors.data() + kChunkRows * dimensions;
+    const auto query_norm = Distance::Norm(query, dimensions);
+    state.SetLabel(metric == DistanceMetric::COSINE ? "cosine" : metric == DistanceMetric::L2 ? "l2" : "dot");
+    for (auto _ : state) {
+        TopK<size_t> neighbours(10);
+        for (size_t row = 0; row < kChunkRows; row++) {
+            neighbours.Push(Distance::Compute(metric, query, query_norm, vectors.data() + row * dimensions, dimensions),
+                            row);
+        }
+        benchmark::DoNotOptimize(neighbours.TakeSorted());
+    }
+    state.SetBytesProcessed(state.iterations() * kChunkRows * dimensions * static_cast<int64_t>(sizeof(float)));
+    SetRowsProcessed(state, kChunkRows);
+}
+BENCHMARK(BM_KnnScan)->ArgsProduct({{0, 1, 2}, {384, 1536}});
+
+constexpr size_t kIndexRows = 20000;
+constexpr size_t kIndexDimensions = 128;
+
+static std::vector<int64_t> MakeIds(const size_t rows) {
+    std::vector<int64_t> ids(rows);
+    for (size_t row = 0; row < rows; row++) {
+        ids[row] = static_cast<int64_t>(row);
+    }
+    return ids;
+}
+
+// Multi-threaded HNSW insertion of 20k 128-dimension vectors, with m = 16 and ef_construction = 200.
+static void BM_HnswBuild(benchmark::State& state) {
+    const size_t threads = state.range(0);
+    const auto vectors = MakeVectors(kIndexRows, kIndexDimensions);
+    for (auto _ : state) {
+        HnswIndex index(kIndexDimensions, {});
+        index.Build(vectors, MakeIds(kIndexRows), threads);
+        benchmark::DoNotOptimize(index.Size());
+    }
+    SetRowsProcessed(state, kIndexRows);
+}
+BENCHMARK(BM_HnswBuild)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Top-10 HNSW searches by ef_search. The recall@10 counter is the share of the exact 10 nearest neighbours found.
+static void BM_HnswSearch(benchmark::State& state) {
+    const size_t ef_search = state.range(0);
+    constexpr size_t k = 10;
+    constexpr size_t num_queries = 100;
+    static const auto vectors = MakeVectors(kIndexRows + num_queries, kIndexDimensions);
+    static const auto index = [] {
+        auto built = std::make_unique<HnswIndex>(kIndexDimensions, HnswIndex::Options());
+        built->Build(std::vector<float>(vectors.begin(), vectors.begin() + kIndexRows * kIndexDimensions),
+                     MakeIds(kIndexRows), std::thread::hardware_concurrency());
+        return built;
+    }();
+    const auto query = [&](const size_t i) { return vectors.data() + (kIndexRows + i) * kIndexDimensions; };
+
+    size_t found = 0;
+    for (size_t i = 0; i < num_queries; i++) {
+        const auto query_norm = Distance::Norm(query(i), kIndexDimensions);
+        TopK<int64_t> exact(k);
+        for (size_t row = 0; row < kIndexRows; row++) {
+            exact.Push(Distance::Compute(DistanceMetric::COSINE, query(i), query_norm,
+                                         vectors.data() + row * kIndexDimensions, kIndexDimensions),
+                       static_cast<int64_t>(row));
+        }
+        std::set<int64_t> exact_ids;
+        for (const auto& entry : exact.TakeSorted()) {
+            exact_ids.insert(entry.item);
+        }
+        for (const auto& entry : index->Search(query(i), k, ef_search)) {
+            found += exact_ids.count(entry.item);
+        }
+    }
+    state.counters["recall@10"] = static_cast<double>(found) / (num_queries * k);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index->Search(query(i++ % num_queries), k, ef_search));
+    }
+    SetRowsProcessed(state, 1);
+}
+BENCHMARK(BM_HnswSearch)->Arg(16)->Arg(64)->Arg(256);
+
+} // namespace flockmtl
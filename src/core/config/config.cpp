@@ -1,6 +1,8 @@
 #include "flockmtl/core/config.hpp"
 #include "filesystem.hpp"
+#include "flockmtl/model_manager/model.hpp"
 #include "flockmtl/secret_manager/secret_manager.hpp"
+#include "duckdb/storage/object_cache.hpp"
 #include <fmt/format.h>
 
 namespace flockmtl {
@@ -75,11 +77,106 @@ void Config::ConfigureTables(duckdb::Connection& con, const ConfigType type) {
     ConfigSchema(con, schema);
     ConfigModelTable(con, schema, type);
     ConfigPromptTable(con, schema, type);
+    ConfigVectorIndexTable(con, schema, type);
     con.Commit();
 }
 
+void Config::ConfigureSettings(duckdb::DatabaseInstance& db) {
+    auto& config = duckdb::DBConfig::GetConfig(db);
+    config.AddExtensionOption("flockmtl_max_tokens",
+                              "Maximum prompt and completion tokens a query may spend on LLM calls (0 for no limit)",
+                              duckdb::LogicalType::BIGINT, duckdb::Value::BIGINT(0));
+    config.AddExtensionOption("flockmtl_max_cost",
+                              "Maximum estimated cost of the LLM calls of a query, priced with the models' "
+                              "input_price and output_price (0 for no limit)",
+                              duckdb::LogicalType::DOUBLE, duckdb::Value::DOUBLE(0));
+    config.AddExtensionOption("flockmtl_semantic_cache_model",
+                              "Embedding model of the semantic cache of prompt-only llm_complete and llm_complete_json "
+                              "calls (empty to disable the cache)",
+                              duckdb::LogicalType::VARCHAR, duckdb::Value(""));
+    config.AddExtensionOption("flockmtl_semantic_cache_threshold",
+                              "Minimum cosine similarity of two prompts for the semantic cache to reuse a response",
+                              duckdb::LogicalType::DOUBLE, duckdb::Value::DOUBLE(0.95));
+}
+
+QueryBudget::Limits Config::GetQueryLimits(duckdb::ClientContext& context) {
+    QueryBudget::Limits limits;
+    duckdb::Value value;
+    if (context.TryGetCurrentSetting("flockmtl_max_tokens", value) && !value.IsNull()) {
+        limits.max_tokens = value.GetValue<int64_t>();
+    }
+    if (context.TryGetCurrentSetting("flockmtl_max_cost", value) && !value.IsNull()) {
+        limits.max_cost = value.GetValue<double>();
+    }
+    return limits;
+}
+
+std::shared_ptr<QueryBudgets> Config::GetQueryBudgets(duckdb::ClientContext& context) {
+    return context.registered_state->GetOrCreate<QueryBudgetState>("flockmtl_query_budget");
+}
+
+SemanticCache::Options Config::GetSemanticCacheOptions(duckdb::ClientContext& context) {
+    return GetQueryModels(context)->GetSemanticCacheOptions(context);
+}
+
+SemanticCache::Options QueryModelsState::GetSemanticCacheOptions(duckdb::ClientContext& context) {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (semantic_cache_options_) {
+            return *semantic_cache_options_;
+        }
+    }
+    SemanticCache::Options options;
+    duckdb::Value value;
+    if (context.TryGetCurrentSetting("flockmtl_semantic_cache_model", value) && !value.IsNull()) {
+        options.model_name = value.ToString();
+    }
+    if (context.TryGetCurrentSetting("flockmtl_semantic_cache_threshold", value) && !value.IsNull()) {
+        options.threshold = value.GetValue<double>();
+    }
+    if (!options.model_name.empty()) {
+        options.cache = Config::GetSemanticCache(context);
+        options.embedding_model = GetModel({{"model_name", options.model_name}});
+    }
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!semantic_cache_options_) {
+        semantic_cache_options_ = std::move(options);
+    }
+    return *semantic_cache_options_;
+}
+
+// Lives in the database's object cache, so it goes away with the database.
+class SemanticCacheEntry : public duckdb::ObjectCacheEntry {
+public:
+    static std::string ObjectType() { return "flockmtl_semantic_cache"; }
+    std::string GetObjectType() override { return ObjectType(); }
+
+    std::shared_ptr<SemanticCache> cache = std::make_shared<SemanticCache>();
+};
+
+std::shared_ptr<SemanticCache> Config::GetSemanticCache(duckdb::ClientContext& context) {
+    return duckdb::ObjectCache::GetObjectCache(context)
+            .GetOrCreate<SemanticCacheEntry>(SemanticCacheEntry::ObjectType())
+            ->cache;
+}
+
+std::shared_ptr<QueryModelsState> Config::GetQueryModels(duckdb::ClientContext& context) {
+    return context.registered_state->GetOrCreate<QueryModelsState>("flockmtl_query_models");
+}
+
+std::shared_ptr<Model> QueryModelsState::GetModel(const nlohmann::json& model_json) {
+    const auto key = model_json.dump();
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto& model = models_[key];
+    if (!model) {
+        model = std::make_shared<Model>(model_json);
+    }
+    return model;
+}
+
 void Config::Configure(duckdb::DatabaseInstance& db) {
     Registry::Register(db);
+    ConfigureSettings(db);
     SecretManager::Register(db);
     if (const auto db_path = db.config.options.database_path; db_path != get_global_storage_path().string()) {
         SetupGlobalStorageLocation();
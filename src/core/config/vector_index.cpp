@@ -0,0 +1,54 @@
+#include "flockmtl/core/config.hpp"
+
+namespace flockmtl {
+
+std::string Config::get_vector_indexes_table_name() { return "FLOCKMTL_VECTOR_INDEX_INTERNAL_TABLE"; }
+
+std::string Config::get_vector_index_pages_table_name() { return "FLOCKMTL_VECTOR_INDEX_PAGE_INTERNAL_TABLE"; }
+
+void Config::ConfigVectorIndexTable(duckdb::Connection& con, std::string& schema_name, const ConfigType type) {
+    // Indexes point at the rows of the database they were built in, so only local storage has them
+    if (type != ConfigType::LOCAL) {
+        return;
+    }
+    const std::string table_name = get_vector_indexes_table_name();
+
+    auto result = con.Query(duckdb_fmt::format(" SELECT table_name "
+                                               "   FROM information_schema.tables "
+                                               "  WHERE table_schema = '{}' "
+                                               "    AND table_name = '{}'; ",
+                                               schema_name, table_name));
+    if (result->RowCount() == 0) {
+        con.Query(duckdb_fmt::format(" CREATE TABLE {}.{} ( "
+                                     " index_name VARCHAR NOT NULL PRIMARY KEY, "
+                                     " table_name VARCHAR NOT NULL, "
+                                     " column_name VARCHAR NOT NULL, "
+                                     " metric VARCHAR NOT NULL, "
+                                     " m INT NOT NULL, "
+                                     " ef_construction INT NOT NULL, "
+                                     " dimensions INT NOT NULL, "
+                                     " vectors BIGINT NOT NULL, "
+                                     " created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP "
+                                     " ); ",
+                                     schema_name, table_name));
+    }
+
+    // The serialized graph of each index, split into pages
+    const std::string pages_table_name = get_vector_index_pages_table_name();
+    result = con.Query(duckdb_fmt::format(" SELECT table_name "
+                                          "   FROM information_schema.tables "
+                                          "  WHERE table_schema = '{}' "
+                                          "    AND table_name = '{}'; ",
+                                          schema_name, pages_table_name));
+    if (result->RowCount() == 0) {
+        con.Query(duckdb_fmt::format(" CREATE TABLE {}.{} ( "
+                                     " index_name VARCHAR NOT NULL, "
+                                     " page INT NOT NULL, "
+                                     " data BLOB NOT NULL, "
+                                     " PRIMARY KEY (index_name, page) "
+                                     " ); ",
+                                     schema_name, pages_table_name));
+    }
+}
+
+} // namespace flockmtl
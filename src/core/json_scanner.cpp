@@ -0,0 +1,257 @@
+#include "flockmtl/core/json_scanner.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace flockmtl {
+
+size_t JsonScanner::SkipWhitespace(std::string_view json, size_t pos) {
+    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\n' || json[pos] == '\r' || json[pos] == '\t')) {
+        pos++;
+    }
+    return pos;
+}
+
+size_t JsonScanner::Expect(std::string_view json, size_t pos, const char expected) {
+    if (pos >= json.size() || json[pos] != expected) {
+        throw std::runtime_error(std::string("Malformed JSON: expected '") + expected + "' at offset " +
+                                 std::to_string(pos));
+    }
+    return pos + 1;
+}
+
+size_t JsonScanner::SkipString(std::string_view json, size_t pos) {
+    pos = Expect(json, pos, '"');
+    while (true) {
+        // Jump straight to the next quote or escape; everything in between is opaque payload.
+        pos = json.find_first_of("\"\\", pos);
+        if (pos == std::string_view::npos) {
+            throw std::runtime_error("Malformed JSON: unterminated string");
+        }
+        if (json[pos] == '"') {
+            return pos + 1;
+        }
+        pos += 2;
+    }
+}
+
+size_t JsonScanner::SkipValue(std::string_view json, size_t pos) {
+    pos = SkipWhitespace(json, pos);
+    if (pos >= json.size()) {
+        throw std::runtime_error("Malformed JSON: unexpected end of input");
+    }
+    switch (json[pos]) {
+        case '"':
+            return SkipString(json, pos);
+        case '{':
+        case '[': {
+            auto depth = 0;
+            while (pos < json.size()) {
+                const auto c = json[pos];
+                if (c == '"') {
+                    pos = SkipString(json, pos);
+                    continue;
+                }
+                if (c == '{' || c == '[') {
+                    depth++;
+                } else if (c == '}' || c == ']') {
+                    if (--depth == 0) {
+                        return pos + 1;
+                    }
+                }
+                pos++;
+            }
+            throw std::runtime_error("Malformed JSON: unterminated container");
+        }
+        default: {
+            // number, true, false or null
+            while (pos < json.size() && json[pos] != ',' && json[pos] != '}' && json[pos] != ']' && json[pos] != ' ' &&
+                   json[pos] != '\n' && json[pos] != '\r' && json[pos] != '\t') {
+                pos++;
+            }
+            return pos;
+        }
+    }
+}
+
+std::optional<std::string_view> JsonScanner::GetMember(std::string_view object, std::string_view key) {
+    auto pos = Expect(object, SkipWhitespace(object, 0), '{');
+    pos = SkipWhitespace(object, pos);
+    if (pos < object.size() && object[pos] == '}') {
+        return std::nullopt;
+    }
+    while (true) {
+        pos = SkipWhitespace(object, pos);
+        const auto key_end = SkipString(object, pos);
+        const auto raw_key = object.substr(pos + 1, key_end - pos - 2);
+        auto matches = raw_key == key;
+        if (!matches && raw_key.find('\\') != std::string_view::npos) {
+            matches = GetString(object.substr(pos, key_end - pos)) == key;
+        }
+        pos = Expect(object, SkipWhitespace(object, key_end), ':');
+        pos = SkipWhitespace(object, pos);
+        const auto value_end = SkipValue(object, pos);
+        if (matches) {
+            return object.substr(pos, value_end - pos);
+        }
+        pos = SkipWhitespace(object, value_end);
+        if (pos < object.size() && object[pos] == ',') {
+            pos++;
+            continue;
+        }
+        Expect(object, pos, '}');
+        return std::nullopt;
+    }
+}
+
+std::optional<std::string_view> JsonScanner::GetElement(std::string_view array, const size_t index) {
+    std::optional<std::string_view> element;
+    size_t current = 0;
+    ForEachElement(array, [&](std::string_view value) {
+        if (current++ == index) {
+            element = value;
+        }
+    });
+    return element;
+}
+
+std::string_view JsonScanner::Trim(std::string_view value) {
+    const auto start = SkipWhitespace(value, 0);
+    auto end = value.size();
+    while (end > start && (value[end - 1] == ' ' || value[end - 1] == '\n' || value[end - 1] == '\r' ||
+                           value[end - 1] == '\t')) {
+        end--;
+    }
+    return value.substr(start, end - start);
+}
+
+bool JsonScanner::IsNull(std::string_view value) { return Trim(value) == "null"; }
+
+bool JsonScanner::IsString(std::string_view value) {
+    const auto trimmed = Trim(value);
+    return !trimmed.empty() && trimmed[0] == '"';
+}
+
+void JsonScanner::AppendUtf8(std::string& out, const uint32_t code_point) {
+    if (code_point < 0x80) {
+        out += static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+        out += static_cast<char>(0xC0 | (code_point >> 6));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else if (code_point < 0x10000) {
+        out += static_cast<char>(0xE0 | (code_point >> 12));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code_point >> 18));
+        out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+}
+
+std::string JsonScanner::GetString(std::string_view value) {
+    const auto trimmed = Trim(value);
+    if (trimmed.size() < 2 || trimmed.front() != '"' || trimmed.back() != '"') {
+        throw std::runtime_error("Expected a JSON string");
+    }
+    const auto body = trimmed.substr(1, trimmed.size() - 2);
+
+    std::string result;
+    result.reserve(body.size());
+    size_t pos = 0;
+    while (pos < body.size()) {
+        const auto escape = body.find('\\', pos);
+        if (escape == std::string_view::npos) {
+            result.append(body.data() + pos, body.size() - pos);
+            break;
+        }
+        result.append(body.data() + pos, escape - pos);
+        if (escape + 1 >= body.size()) {
+            throw std::runtime_error("Malformed JSON: dangling escape");
+        }
+        const auto c = body[escape + 1];
+        pos = escape + 2;
+        switch (c) {
+            case '"':
+                result += '"';
+                break;
+            case '\\':
+                result += '\\';
+                break;
+            case '/':
+                result += '/';
+                break;
+            case 'b':
+                result += '\b';
+                break;
+            case 'f':
+                result += '\f';
+                break;
+            case 'n':
+                result += '\n';
+                break;
+            case 'r':
+                result += '\r';
+                break;
+            case 't':
+                result += '\t';
+                break;
+            case 'u': {
+                auto read_hex = [&](size_t at) {
+                    if (at + 4 > body.size()) {
+                        throw std::runtime_error("Malformed JSON: truncated unicode escape");
+                    }
+                    return static_cast<uint32_t>(std::stoul(std::string(body.substr(at, 4)), nullptr, 16));
+                };
+                auto code_point = read_hex(pos);
+                pos += 4;
+                // Combine UTF-16 surrogate pairs into a single code point.
+                if (code_point >= 0xD800 && code_point <= 0xDBFF && pos + 6 <= body.size() && body[pos] == '\\' &&
+                    body[pos + 1] == 'u') {
+                    const auto low = read_hex(pos + 2);
+                    if (low >= 0xDC00 && low <= 0xDFFF) {
+                        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                        pos += 6;
+                    }
+                }
+                AppendUtf8(result, code_point);
+                break;
+            }
+            default:
+                throw std::runtime_error(std::string("Malformed JSON: invalid escape '\\") + c + "'");
+        }
+    }
+    return result;
+}
+
+double JsonScanner::GetDouble(std::string_view value) {
+    const auto trimmed = Trim(value);
+    char buffer[64];
+    if (trimmed.empty() || trimmed.size() >= sizeof(buffer)) {
+        throw std::runtime_error("Expected a JSON number");
+    }
+    std::memcpy(buffer, trimmed.data(), trimmed.size());
+    buffer[trimmed.size()] = '\0';
+    char* end = nullptr;
+    const auto result = std::strtod(buffer, &end);
+    if (end != buffer + trimmed.size()) {
+        throw std::runtime_error("Expected a JSON number");
+    }
+    return result;
+}
+
+int64_t JsonScanner::GetInteger(std::string_view value) { return static_cast<int64_t>(GetDouble(value)); }
+
+bool JsonScanner::GetBool(std::string_view value) {
+    const auto trimmed = Trim(value);
+    if (trimmed == "true") {
+        return true;
+    }
+    if (trimmed == "false") {
+        return false;
+    }
+    throw std::runtime_error("Expected a JSON boolean");
+}
+
+} // namespace flockmtl
@@ -29,6 +29,72 @@ void ModelParser::Parse(const std::string& query, std::unique_ptr<QueryStatement
     }
 }
 
+void ModelParser::ValidateModelArgs(const nlohmann::json& model_args) {
+    const std::set<std::string> required_keys = {"context_window", "max_output_tokens"};
+    const std::set<std::string> optional_keys = {"requests_per_minute", "tokens_per_minute", "connect_timeout",
+                                                 "request_timeout", "hedged_requests", "backends", "replay_file",
+                                                 "replay_mode", "backend", "latency_ms", "jitter_ms",
+                                                 "input_price", "output_price", "dimensions"};
+    std::set<std::string> json_keys;
+    for (auto it = model_args.begin(); it != model_args.end(); ++it) {
+        if (required_keys.count(it.key()) == 0 && optional_keys.count(it.key()) == 0) {
+            std::ostringstream message;
+            message << "Unexpected key in model_args: " << it.key() << ". Optional keys are: ";
+            for (auto key = optional_keys.begin(); key != optional_keys.end(); ++key) {
+                message << (key == optional_keys.begin() ? "" : ", ") << *key;
+            }
+            throw std::runtime_error(message.str() + ".");
+        }
+        json_keys.insert(it.key());
+    }
+    if (model_args.contains("backends")) {
+        const auto& backends = model_args["backends"];
+        if (!backends.is_array() || backends.empty()) {
+            throw std::runtime_error("`backends` must be a non-empty array of backend models.");
+        }
+        for (const auto& backend : backends) {
+            if (!backend.is_object() || !backend.contains("model_name") || !backend["model_name"].is_string()) {
+                throw std::runtime_error("Every entry in `backends` needs a `model_name`.");
+            }
+            if (backend.contains("weight") && (!backend["weight"].is_number() || backend["weight"].get<double>() <= 0)) {
+                throw std::runtime_error("The `weight` of a backend must be a positive number.");
+            }
+        }
+    }
+    if (model_args.contains("replay_file") && !model_args["replay_file"].is_string()) {
+        throw std::runtime_error("`replay_file` must be a file path.");
+    }
+    if (model_args.contains("replay_mode") && model_args["replay_mode"] != "record" &&
+        model_args["replay_mode"] != "replay") {
+        throw std::runtime_error("`replay_mode` must be either 'record' or 'replay'.");
+    }
+    if (model_args.contains("backend") &&
+        (!model_args["backend"].is_object() || !model_args["backend"].contains("model_name") ||
+         !model_args["backend"]["model_name"].is_string())) {
+        throw std::runtime_error("`backend` must be a model with a `model_name`.");
+    }
+    for (const auto* key : {"latency_ms", "jitter_ms"}) {
+        if (model_args.contains(key) &&
+            (!model_args[key].is_number_integer() || model_args[key].get<int64_t>() < 0)) {
+            throw std::runtime_error(std::string("`") + key + "` must be a non-negative integer.");
+        }
+    }
+    for (const auto* key : {"input_price", "output_price"}) {
+        if (model_args.contains(key) && (!model_args[key].is_number() || model_args[key].get<double>() < 0)) {
+            throw std::runtime_error(std::string("`") + key + "` must be a non-negative price per million tokens.");
+        }
+    }
+    if (model_args.contains("dimensions") &&
+        (!model_args["dimensions"].is_number_integer() || model_args["dimensions"].get<int64_t>() <= 0)) {
+        throw std::runtime_error("`dimensions` must be a positive integer.");
+    }
+    for (const auto& key : required_keys) {
+        if (json_keys.count(key) == 0) {
+            throw std::runtime_error("Expected keys: context_window, max_output_tokens in model_args.");
+        }
+    }
+}
+
 void ModelParser::ParseCreateModel(Tokenizer& tokenizer, std::unique_ptr<QueryStatement>& statement) {
     auto token = tokenizer.NextToken();
     auto value = duckdb::StringUtil::Upper(token.value);
@@ -89,14 +155,7 @@ void ModelParser::ParseCreateModel(Tokenizer& tokenizer, std::unique_ptr<QuerySt
         throw std::runtime_error("Expected json value for the model_args.");
     }
     auto model_args = nlohmann::json::parse(token.value);
-    const std::set<std::string> expected_keys = {"context_window", "max_output_tokens"};
-    std::set<std::string> json_keys;
-    for (auto it = model_args.begin(); it != model_args.end(); ++it) {
-        json_keys.insert(it.key());
-    }
-    if (json_keys != expected_keys) {
-        throw std::runtime_error("Expected keys: context_window, max_output_tokens in model_args.");
-    }
+    ValidateModelArgs(model_args);
 
     token = tokenizer.NextToken();
     if (token.type != TokenType::PARENTHESIS || token.value != ")") {
@@ -216,14 +275,7 @@ void ModelParser::ParseUpdateModel(Tokenizer& tokenizer, std::unique_ptr<QuerySt
             throw std::runtime_error("Expected json value for the model_args.");
         }
         auto new_model_args = nlohmann::json::parse(token.value);
-        const std::set<std::string> expected_keys = {"context_window", "max_output_tokens"};
-        std::set<std::string> json_keys;
-        for (auto it = new_model_args.begin(); it != new_model_args.end(); ++it) {
-            json_keys.insert(it.key());
-        }
-        if (json_keys != expected_keys) {
-            throw std::runtime_error("Expected keys: context_window, max_output_tokens in model_args.");
-        }
+        ValidateModelArgs(new_model_args);
 
         token = tokenizer.NextToken();
         if (token.type != TokenType::PARENTHESIS || token.value != ")") {
@@ -7,6 +7,7 @@
 #include "flockmtl/core/common.hpp"
 #include "flockmtl/core/config.hpp"
 #include "flockmtl/custom_parser/query_parser.hpp"
+#include "flockmtl/optimizer/llm_predicate_ordering.hpp"
 
 #include <flockmtl/model_manager/model.hpp>
 
@@ -20,6 +21,7 @@ static void LoadInternal(DatabaseInstance& instance) {
     DuckParserExtension duck_parser;
     config.parser_extensions.push_back(duck_parser);
     config.operator_extensions.push_back(make_uniq<DuckOperatorExtension>());
+    config.optimizer_extensions.push_back(flockmtl::LlmPredicateOrdering::GetExtension());
 }
 
 ParserExtensionParseResult duck_parse(ParserExtensionInfo*, const std::string& query) {
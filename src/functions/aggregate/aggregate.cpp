@@ -18,6 +18,23 @@ void AggregateFunctionBase::ValidateArguments(duckdb::Vector inputs[], idx_t inp
     }
 }
 
+duckdb::unique_ptr<duckdb::FunctionData>
+AggregateFunctionBase::Bind(duckdb::ClientContext& context, duckdb::AggregateFunction& function,
+                            duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments) {
+    return duckdb::make_uniq<AggregateBindData>(Config::GetQueryBudgets(context), &context,
+                                                context.transaction.GetActiveQuery(), function.name,
+                                                Config::GetQueryLimits(context));
+}
+
+FunctionScope AggregateFunctionBase::ScopeToQuery(const duckdb::AggregateInputData& aggr_input_data) {
+    if (!aggr_input_data.bind_data) {
+        return FunctionScope(nullptr, nullptr, 0, "");
+    }
+    const auto& bind_data = aggr_input_data.bind_data->Cast<AggregateBindData>();
+    return FunctionScope(bind_data.budgets.get(), bind_data.client, bind_data.query_id, bind_data.function_name,
+                         bind_data.limits);
+}
+
 std::tuple<nlohmann::json, nlohmann::json, std::vector<nlohmann::json>>
 AggregateFunctionBase::CastInputsToJson(duckdb::Vector inputs[], idx_t count) {
     auto model_details_json = CastVectorOfStructsToJson(inputs[0], 1)[0];
@@ -0,0 +1,220 @@
+#include "flockmtl/functions/aggregate/flockmtl_knn_agg.hpp"
+
+#include "duckdb/execution/expression_executor.hpp"
+
+namespace flockmtl {
+
+duckdb::Value FlockmtlKnnAgg::EvaluateConstant(duckdb::ClientContext& context, duckdb::Expression& argument,
+                                               const std::string& name) {
+    if (!argument.IsFoldable()) {
+        throw std::runtime_error("`" + name + "` must be a constant.");
+    }
+    return duckdb::ExpressionExecutor::EvaluateScalar(context, argument);
+}
+
+std::vector<float> FlockmtlKnnAgg::GetQueryVector(const duckdb::Value& query) {
+    if (query.IsNull()) {
+        throw std::runtime_error("The query vector must not be NULL.");
+    }
+    std::vector<float> vector;
+    for (const auto& element :
+         duckdb::ListValue::GetChildren(query.DefaultCastAs(duckdb::LogicalType::LIST(duckdb::LogicalType::FLOAT)))) {
+        if (element.IsNull()) {
+            throw std::runtime_error("The query vector must not contain NULL values.");
+        }
+        vector.push_back(element.GetValue<float>());
+    }
+    if (vector.empty()) {
+        throw std::runtime_error("The query vector must not be empty.");
+    }
+    return vector;
+}
+
+duckdb::unique_ptr<duckdb::FunctionData>
+FlockmtlKnnAgg::Bind(duckdb::ClientContext& context, duckdb::AggregateFunction& function,
+                     duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments) {
+    const auto& embedding_type = arguments[1]->return_type;
+    const auto quantized = embedding_type.id() == duckdb::LogicalTypeId::BLOB;
+    const auto is_list = embedding_type.id() == duckdb::LogicalTypeId::LIST &&
+                         duckdb::ListType::GetChildType(embedding_type).IsNumeric();
+    const auto is_array = embedding_type.id() == duckdb::LogicalTypeId::ARRAY &&
+                          duckdb::ArrayType::GetChildType(embedding_type).IsNumeric();
+    if (!is_list && !is_array && !quantized) {
+        throw std::runtime_error("The embedding must be a list or array of numbers, or a quantized embedding.");
+    }
+    // The embeddings are read as lists of floats, so each row's vector is contiguous
+    function.arguments[0] = arguments[0]->return_type;
+    function.arguments[1] =
+        quantized ? duckdb::LogicalType::BLOB : duckdb::LogicalType::LIST(duckdb::LogicalType::FLOAT);
+
+    auto query = GetQueryVector(EvaluateConstant(context, *arguments[2], "query"));
+    const auto k = EvaluateConstant(context, *arguments[3], "k");
+    if (k.IsNull() || k.GetValue<int64_t>() <= 0) {
+        throw std::runtime_error("`k` must be a positive integer.");
+    }
+    auto metric = DistanceMetric::COSINE;
+    if (arguments.size() > 4) {
+        metric = Distance::ParseMetric(EvaluateConstant(context, *arguments[4], "metric").ToString());
+    }
+    while (arguments.size() > 2) {
+        duckdb::Function::EraseArgument(function, arguments, arguments.size() - 1);
+    }
+
+    function.return_type = duckdb::LogicalType::LIST(duckdb::LogicalType::STRUCT(
+        {{"id", arguments[0]->return_type}, {"distance", duckdb::LogicalType::DOUBLE}}));
+    return duckdb::make_uniq<BindData>(std::move(query), static_cast<size_t>(k.GetValue<int64_t>()), metric,
+                                      quantized);
+}
+
+void FlockmtlKnnAgg::Initialize(const duckdb::AggregateFunction&, duckdb::data_ptr_t state_p) {
+    // The heap is allocated on the first row, once k is known from the bind data
+    reinterpret_cast<State*>(state_p)->neighbours = nullptr;
+}
+
+void FlockmtlKnnAgg::ComputeDistances(const BindData& bind_data, duckdb::Vector& embeddings, const idx_t count,
+                                      float* distances, bool* valid) {
+    duckdb::UnifiedVectorFormat embedding_format;
+    embeddings.ToUnifiedFormat(count, embedding_format);
+    const auto list_entries = duckdb::UnifiedVectorFormat::GetData<duckdb::list_entry_t>(embedding_format);
+    auto& child = duckdb::ListVector::GetEntry(embeddings);
+    child.Flatten(duckdb::ListVector::GetListSize(embeddings));
+    const auto child_data = duckdb::FlatVector::GetData<float>(child);
+    const auto& child_validity = duckdb::FlatVector::Validity(child);
+
+    const auto dimensions = bind_data.query.size();
+    for (idx_t row = 0; row < count; row++) {
+        const auto index = embedding_format.sel->get_index(row);
+        valid[row] = embedding_format.validity.RowIsValid(index);
+        if (!valid[row]) {
+            continue;
+        }
+        const auto& entry = list_entries[index];
+        if (entry.length != dimensions) {
+            throw std::runtime_error("An embedding has " + std::to_string(entry.length) +
+                                     " dimensions but the query vector has " + std::to_string(dimensions) + ".");
+        }
+        if (!child_validity.CheckAllValid(entry.offset + entry.length, entry.offset)) {
+            throw std::runtime_error("Embeddings must not contain NULL values.");
+        }
+        distances[row] = Distance::Compute(bind_data.metric, bind_data.query.data(), bind_data.query_norm,
+                                           child_data + entry.offset, dimensions);
+    }
+}
+
+void FlockmtlKnnAgg::ComputeQuantizedDistances(const BindData& bind_data, duckdb::Vector& embeddings,
+                                               const idx_t count, float* distances, bool* valid) {
+    duckdb::UnifiedVectorFormat embedding_format;
+    embeddings.ToUnifiedFormat(count, embedding_format);
+    const auto blobs = duckdb::UnifiedVectorFormat::GetData<duckdb::string_t>(embedding_format);
+
+    for (idx_t row = 0; row < count; row++) {
+        const auto index = embedding_format.sel->get_index(row);
+        valid[row] = embedding_format.validity.RowIsValid(index);
+        if (!valid[row]) {
+            continue;
+        }
+        const auto& blob = blobs[index];
+        if (Quantization::GetEncoding(blob.GetData(), blob.GetSize()) == Quantization::Encoding::INT8) {
+            distances[row] = Quantization::Compute(bind_data.metric, bind_data.query_int8,
+                                                   bind_data.query_int8_squared_norm, blob.GetData(), blob.GetSize());
+        } else {
+            distances[row] =
+                Quantization::Compute(bind_data.metric, bind_data.query_binary, 0, blob.GetData(), blob.GetSize());
+        }
+    }
+}
+
+template <class GET_STATE>
+void FlockmtlKnnAgg::Accumulate(const BindData& bind_data, duckdb::Vector& ids, duckdb::Vector& embeddings,
+                                const idx_t count, GET_STATE&& get_state) {
+    float distances[STANDARD_VECTOR_SIZE];
+    bool valid[STANDARD_VECTOR_SIZE];
+    if (bind_data.quantized) {
+        ComputeQuantizedDistances(bind_data, embeddings, count, distances, valid);
+    } else {
+        ComputeDistances(bind_data, embeddings, count, distances, valid);
+    }
+
+    for (idx_t row = 0; row < count; row++) {
+        if (!valid[row]) {
+            continue;
+        }
+        auto& state = get_state(row);
+        if (state.neighbours == nullptr) {
+            state.neighbours = new TopK<duckdb::Value>(bind_data.k);
+        }
+        if (state.neighbours->Accepts(distances[row])) {
+            state.neighbours->Push(distances[row], ids.GetValue(row));
+        }
+    }
+}
+
+void FlockmtlKnnAgg::Update(duckdb::Vector inputs[], duckdb::AggregateInputData& aggr_input_data, idx_t input_count,
+                            duckdb::Vector& states, const idx_t count) {
+    const auto& bind_data = aggr_input_data.bind_data->Cast<BindData>();
+    const auto states_vector = duckdb::FlatVector::GetData<State*>(states);
+    Accumulate(bind_data, inputs[0], inputs[1], count, [&](const idx_t row) -> State& { return *states_vector[row]; });
+}
+
+void FlockmtlKnnAgg::SimpleUpdate(duckdb::Vector inputs[], duckdb::AggregateInputData& aggr_input_data,
+                                  idx_t input_count, duckdb::data_ptr_t state_p, const idx_t count) {
+    const auto& bind_data = aggr_input_data.bind_data->Cast<BindData>();
+    auto& state = *reinterpret_cast<State*>(state_p);
+    Accumulate(bind_data, inputs[0], inputs[1], count, [&](const idx_t) -> State& { return state; });
+}
+
+void FlockmtlKnnAgg::Combine(duckdb::Vector& source, duckdb::Vector& target,
+                             duckdb::AggregateInputData& aggr_input_data, const idx_t count) {
+    const auto source_vector = duckdb::FlatVector::GetData<State*>(source);
+    const auto target_vector = duckdb::FlatVector::GetData<State*>(target);
+    for (idx_t i = 0; i < count; i++) {
+        const auto& source_state = *source_vector[i];
+        auto& target_state = *target_vector[i];
+        if (source_state.neighbours == nullptr) {
+            continue;
+        }
+        // The source may be combined again, e.g. in window segment trees, so it is copied rather than drained
+        auto neighbours = *source_state.neighbours;
+        if (target_state.neighbours == nullptr) {
+            target_state.neighbours = new TopK<duckdb::Value>(std::move(neighbours));
+        } else {
+            target_state.neighbours->Merge(neighbours);
+        }
+    }
+}
+
+void FlockmtlKnnAgg::Finalize(duckdb::Vector& states, duckdb::AggregateInputData& aggr_input_data,
+                              duckdb::Vector& result, const idx_t count, const idx_t offset) {
+    const auto states_vector = duckdb::FlatVector::GetData<State*>(states);
+    auto list_entries = duckdb::FlatVector::GetData<duckdb::list_entry_t>(result);
+    auto list_size = duckdb::ListVector::GetListSize(result);
+
+    for (idx_t i = 0; i < count; i++) {
+        const auto& state = *states_vector[i];
+        std::vector<TopK<duckdb::Value>::Entry> neighbours;
+        if (state.neighbours != nullptr) {
+            neighbours = TopK<duckdb::Value>(*state.neighbours).TakeSorted();
+        }
+
+        list_entries[i + offset] = {list_size, neighbours.size()};
+        duckdb::ListVector::Reserve(result, list_size + neighbours.size());
+        auto& fields = duckdb::StructVector::GetEntries(duckdb::ListVector::GetEntry(result));
+        const auto distances = duckdb::FlatVector::GetData<double>(*fields[1]);
+        for (const auto& neighbour : neighbours) {
+            fields[0]->SetValue(list_size, neighbour.item);
+            distances[list_size] = neighbour.distance;
+            list_size++;
+        }
+        duckdb::ListVector::SetListSize(result, list_size);
+    }
+}
+
+void FlockmtlKnnAgg::Destroy(duckdb::Vector& states, duckdb::AggregateInputData& aggr_input_data, const idx_t count) {
+    const auto states_vector = duckdb::FlatVector::GetData<State*>(states);
+    for (idx_t i = 0; i < count; i++) {
+        delete states_vector[i]->neighbours;
+        states_vector[i]->neighbours = nullptr;
+    }
+}
+
+} // namespace flockmtl
@@ -0,0 +1,26 @@
+#include "flockmtl/functions/aggregate/flockmtl_knn_agg.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void AggregateRegistry::RegisterFlockmtlKnnAgg(duckdb::DatabaseInstance& db) {
+    const auto get_function = [](const duckdb::vector<duckdb::LogicalType>& arguments) {
+        return duckdb::AggregateFunction(
+            "flockmtl_knn_agg", arguments, duckdb::LogicalType::ANY,
+            duckdb::AggregateFunction::StateSize<FlockmtlKnnAgg::State>, FlockmtlKnnAgg::Initialize,
+            FlockmtlKnnAgg::Update, FlockmtlKnnAgg::Combine, FlockmtlKnnAgg::Finalize, FlockmtlKnnAgg::SimpleUpdate,
+            FlockmtlKnnAgg::Bind, FlockmtlKnnAgg::Destroy);
+    };
+
+    // id, embedding, query, k and optionally the metric, which defaults to cosine
+    duckdb::vector<duckdb::LogicalType> arguments = {duckdb::LogicalType::ANY, duckdb::LogicalType::ANY,
+                                                     duckdb::LogicalType::ANY, duckdb::LogicalType::BIGINT};
+    duckdb::AggregateFunctionSet knn_agg("flockmtl_knn_agg");
+    knn_agg.AddFunction(get_function(arguments));
+    arguments.push_back(duckdb::LogicalType::VARCHAR);
+    knn_agg.AddFunction(get_function(arguments));
+
+    duckdb::ExtensionUtil::RegisterFunction(db, knn_agg);
+}
+
+} // namespace flockmtl
@@ -19,6 +19,7 @@ int LlmFirstOrLast::GetAvailableTokens() {
 int LlmFirstOrLast::GetFirstOrLastTupleId(const nlohmann::json& tuples) {
     nlohmann::json data;
     const auto prompt = PromptManager::Render(user_query, tuples, function_type, model.GetModelDetails().tuple_format);
+    Profiler::RecordBatch(tuples.size());
     auto response = model.CallComplete(prompt);
     return response["selected"].get<int>();
 }
@@ -58,6 +59,7 @@ nlohmann::json LlmFirstOrLast::Evaluate(nlohmann::json& tuples) {
 void LlmFirstOrLast::FinalizeResults(duckdb::Vector& states, duckdb::AggregateInputData& aggr_input_data,
                                      duckdb::Vector& result, idx_t count, idx_t offset,
                                      AggregateFunctionType function_type) {
+    const auto query_scope = ScopeToQuery(aggr_input_data);
     auto states_vector = duckdb::FlatVector::GetData<AggregateFunctionState*>(states);
     auto function_instance = AggregateFunctionBase::GetInstance<LlmFirstOrLast>();
     function_instance->function_type = function_type;
@@ -9,6 +9,7 @@ void AggregateRegistry::RegisterLlmFirst(duckdb::DatabaseInstance& db) {
         duckdb::LogicalType::VARCHAR, duckdb::AggregateFunction::StateSize<AggregateFunctionState>,
         LlmFirstOrLast::Initialize, LlmFirstOrLast::Operation, LlmFirstOrLast::Combine,
         LlmFirstOrLast::Finalize<AggregateFunctionType::FIRST>, LlmFirstOrLast::SimpleUpdate);
+    string_concat.bind = AggregateFunctionBase::Bind;
 
     duckdb::ExtensionUtil::RegisterFunction(db, string_concat);
 }
@@ -19,6 +20,7 @@ void AggregateRegistry::RegisterLlmLast(duckdb::DatabaseInstance& db) {
         duckdb::LogicalType::VARCHAR, duckdb::AggregateFunction::StateSize<AggregateFunctionState>,
         LlmFirstOrLast::Initialize, LlmFirstOrLast::Operation, LlmFirstOrLast::Combine,
         LlmFirstOrLast::Finalize<AggregateFunctionType::LAST>, LlmFirstOrLast::SimpleUpdate);
+    string_concat.bind = AggregateFunctionBase::Bind;
 
     duckdb::ExtensionUtil::RegisterFunction(db, string_concat);
 }
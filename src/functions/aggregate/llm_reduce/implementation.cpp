@@ -19,6 +19,7 @@ int LlmReduce::GetAvailableTokens(const AggregateFunctionType& function_type) {
 nlohmann::json LlmReduce::ReduceBatch(const nlohmann::json& tuples, const AggregateFunctionType& function_type) {
     nlohmann::json data;
     const auto prompt = PromptManager::Render(user_query, tuples, function_type, model.GetModelDetails().tuple_format);
+    Profiler::RecordBatch(tuples.size());
     auto response = model.CallComplete(prompt);
     return response["output"];
 };
@@ -59,6 +60,7 @@ nlohmann::json LlmReduce::ReduceLoop(const std::vector<nlohmann::json>& tuples,
 void LlmReduce::FinalizeResults(duckdb::Vector& states, duckdb::AggregateInputData& aggr_input_data,
                                 duckdb::Vector& result, idx_t count, idx_t offset,
                                 const AggregateFunctionType function_type) {
+    const auto query_scope = ScopeToQuery(aggr_input_data);
     auto states_vector = duckdb::FlatVector::GetData<AggregateFunctionState*>(states);
 
     auto function_instance = AggregateFunctionBase::GetInstance<LlmReduce>();
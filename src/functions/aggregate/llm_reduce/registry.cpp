@@ -9,6 +9,7 @@ void AggregateRegistry::RegisterLlmReduce(duckdb::DatabaseInstance& db) {
         duckdb::LogicalType::VARCHAR, duckdb::AggregateFunction::StateSize<AggregateFunctionState>,
         LlmReduce::Initialize, LlmReduce::Operation, LlmReduce::Combine,
         LlmReduce::Finalize<AggregateFunctionType::REDUCE>, LlmReduce::SimpleUpdate);
+    string_concat.bind = AggregateFunctionBase::Bind;
 
     duckdb::ExtensionUtil::RegisterFunction(db, string_concat);
 }
@@ -19,6 +20,7 @@ void AggregateRegistry::RegisterLlmReduceJson(duckdb::DatabaseInstance& db) {
         duckdb::LogicalType::VARCHAR, duckdb::AggregateFunction::StateSize<AggregateFunctionState>,
         LlmReduce::Initialize, LlmReduce::Operation, LlmReduce::Combine,
         LlmReduce::Finalize<AggregateFunctionType::REDUCE_JSON>, LlmReduce::SimpleUpdate);
+    string_concat.bind = AggregateFunctionBase::Bind;
 
     duckdb::ExtensionUtil::RegisterFunction(db, string_concat);
 }
@@ -21,6 +21,7 @@ std::vector<int> LlmRerank::RerankBatch(const nlohmann::json& tuples) {
     nlohmann::json data;
     auto prompt =
         PromptManager::Render(user_query, tuples, AggregateFunctionType::RERANK, model.GetModelDetails().tuple_format);
+    Profiler::RecordBatch(tuples.size());
     auto response = model.CallComplete(prompt);
     return response["ranking"].get<std::vector<int>>();
 };
@@ -77,6 +78,7 @@ nlohmann::json LlmRerank::SlidingWindow(nlohmann::json& tuples) {
 
 void LlmRerank::Finalize(duckdb::Vector& states, duckdb::AggregateInputData& aggr_input_data, duckdb::Vector& result,
                          idx_t count, idx_t offset) {
+    const auto query_scope = ScopeToQuery(aggr_input_data);
     auto states_vector = duckdb::FlatVector::GetData<AggregateFunctionState*>(states);
     auto function_instance = AggregateFunctionBase::GetInstance<LlmRerank>();
     for (idx_t i = 0; i < count; i++) {
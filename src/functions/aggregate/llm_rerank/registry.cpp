@@ -8,6 +8,7 @@ void AggregateRegistry::RegisterLlmRerank(duckdb::DatabaseInstance& db) {
         "llm_rerank", {duckdb::LogicalType::ANY, duckdb::LogicalType::ANY, duckdb::LogicalType::ANY},
         duckdb::LogicalType::VARCHAR, duckdb::AggregateFunction::StateSize<AggregateFunctionState>,
         LlmRerank::Initialize, LlmRerank::Operation, LlmRerank::Combine, LlmRerank::Finalize, LlmRerank::SimpleUpdate);
+    string_concat.bind = AggregateFunctionBase::Bind;
 
     duckdb::ExtensionUtil::RegisterFunction(db, string_concat);
 }
@@ -2,18 +2,96 @@
 
 namespace flockmtl {
 
-std::vector<nlohmann::json> CastVectorOfStructsToJson(const duckdb::Vector& struct_vector, const int size) {
-    std::vector<nlohmann::json> vector_json;
+namespace {
+
+// Casts the whole column to VARCHAR at once instead of materializing a Value per cell, and stores it under `key`.
+// A STRUCT column becomes an object per row with its children cast the same way, e.g. the settings of a cascade model.
+void AddColumnToJson(duckdb::Vector& column, const std::string& key, const int size,
+                     std::vector<nlohmann::json>& vector_json) {
+    if (column.GetType().id() == duckdb::LogicalTypeId::STRUCT) {
+        column.Flatten(size);
+        const auto& struct_type = column.GetType();
+        auto& children = duckdb::StructVector::GetEntries(column);
+        std::vector<nlohmann::json> nested(size, nlohmann::json::object());
+        for (duckdb::idx_t j = 0; j < children.size(); j++) {
+            AddColumnToJson(*children[j], duckdb::StructType::GetChildName(struct_type, j), size, nested);
+        }
+        const auto& validity = duckdb::FlatVector::Validity(column);
+        for (auto i = 0; i < size; i++) {
+            vector_json[i][key] = validity.RowIsValid(i) ? std::move(nested[i]) : nlohmann::json("NULL");
+        }
+        return;
+    }
+
+    duckdb::Vector varchar_column(duckdb::LogicalType::VARCHAR, size);
+    if (column.GetType().id() == duckdb::LogicalTypeId::VARCHAR) {
+        varchar_column.Reference(column);
+    } else {
+        duckdb::VectorOperations::DefaultCast(column, varchar_column, size);
+    }
+    varchar_column.Flatten(size);
+
+    const auto strings = duckdb::FlatVector::GetData<duckdb::string_t>(varchar_column);
+    const auto& validity = duckdb::FlatVector::Validity(varchar_column);
     for (auto i = 0; i < size; i++) {
-        nlohmann::json json;
-        for (auto j = 0; j < static_cast<int>(duckdb::StructType::GetChildCount(struct_vector.GetType())); j++) {
-            const auto key = duckdb::StructType::GetChildName(struct_vector.GetType(), j);
-            auto value = duckdb::StructValue::GetChildren(struct_vector.GetValue(i))[j].ToString();
-            json[key] = value;
+        if (!validity.RowIsValid(i)) {
+            vector_json[i][key] = "NULL";
+            continue;
         }
-        vector_json.push_back(json);
+        vector_json[i][key] = std::string(strings[i].GetData(), strings[i].GetSize());
+    }
+}
+
+// The children of a STRUCT value as an object of strings, nested STRUCTs included.
+nlohmann::json StructValueToJson(const duckdb::Value& value) {
+    auto json = nlohmann::json::object();
+    const auto& children = duckdb::StructValue::GetChildren(value);
+    for (duckdb::idx_t i = 0; i < children.size(); i++) {
+        const auto& child = children[i];
+        const auto is_struct = child.type().id() == duckdb::LogicalTypeId::STRUCT && !child.IsNull();
+        json[duckdb::StructType::GetChildName(value.type(), i)] =
+                is_struct ? StructValueToJson(child) : nlohmann::json(child.ToString());
+    }
+    return json;
+}
+
+} // namespace
+
+std::vector<nlohmann::json> CastVectorOfStructsToJson(const duckdb::Vector& struct_vector, const int size) {
+    const auto& struct_type = struct_vector.GetType();
+    const auto num_children = duckdb::StructType::GetChildCount(struct_type);
+
+    // Work on a flat view of the struct so every child column can be read directly by row index.
+    duckdb::Vector flat_struct(struct_type);
+    flat_struct.Reference(struct_vector);
+    flat_struct.Flatten(size);
+    auto& children = duckdb::StructVector::GetEntries(flat_struct);
+
+    std::vector<nlohmann::json> vector_json(size, nlohmann::json::object());
+    for (duckdb::idx_t j = 0; j < num_children; j++) {
+        AddColumnToJson(*children[j], duckdb::StructType::GetChildName(struct_type, j), size, vector_json);
     }
     return vector_json;
 }
 
+std::vector<nlohmann::json> CastChunkToJson(duckdb::DataChunk& chunk, const std::vector<std::string>& names) {
+    const auto size = static_cast<int>(chunk.size());
+    std::vector<nlohmann::json> vector_json(size, nlohmann::json::object());
+    for (duckdb::idx_t j = 0; j < chunk.ColumnCount(); j++) {
+        AddColumnToJson(chunk.data[j], names[j], size, vector_json);
+    }
+    return vector_json;
+}
+
+std::vector<nlohmann::json> CastStructValuesToJson(const duckdb::vector<duckdb::Value>& values) {
+    std::vector<nlohmann::json> structs;
+    for (const auto& value : values) {
+        if (value.type().id() != duckdb::LogicalTypeId::STRUCT) {
+            continue;
+        }
+        structs.push_back(StructValueToJson(value));
+    }
+    return structs;
+}
+
 } // namespace flockmtl
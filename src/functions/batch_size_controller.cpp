@@ -0,0 +1,103 @@
+#include "flockmtl/functions/batch_size_controller.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace flockmtl {
+
+std::mutex BatchSizeController::mutex_;
+std::unordered_map<std::string, BatchSizeController::Statistics> BatchSizeController::statistics_;
+uint64_t BatchSizeController::clock_ = 0;
+
+BatchSizeController::Statistics& BatchSizeController::GetStatistics(const std::string& key) {
+    auto it = statistics_.find(key);
+    if (it == statistics_.end()) {
+        if (statistics_.size() >= kMaxEntries) {
+            const auto oldest = std::min_element(statistics_.begin(), statistics_.end(), [](const auto& a, const auto& b) {
+                return a.second.last_used < b.second.last_used;
+            });
+            statistics_.erase(oldest);
+        }
+        it = statistics_.emplace(key, Statistics()).first;
+    }
+    it->second.last_used = ++clock_;
+    return it->second;
+}
+
+int BatchSizeController::GetBatchSize(const std::string& key, const int max_output_tokens, const int upper_bound) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& statistics = GetStatistics(key);
+    if (statistics.output_tokens_per_tuple <= 0) {
+        return std::max(1, upper_bound);
+    }
+    if (statistics.overflowed) {
+        // Keep halving until a batch goes through; the averages only hold a lower bound at this point.
+        return std::max(1, std::min(statistics.batch_size, upper_bound));
+    }
+
+    // Hard limit: the batch size at which the expected output fills max_output_tokens completely.
+    const auto hard_limit = std::max(1.0, max_output_tokens / statistics.output_tokens_per_tuple);
+    auto target = hard_limit * kOutputHeadroom;
+    if (statistics.latency_ms_per_tuple > 0) {
+        target = std::min(target, kTargetLatencyMs / statistics.latency_ms_per_tuple);
+    }
+
+    // Move towards the target gradually: grow by at most kMaxGrowth and shrink by at most half per call, unless
+    // staying that large would overflow on expectation.
+    if (statistics.batch_size > 0) {
+        target = std::min(target, std::ceil(statistics.batch_size * kMaxGrowth));
+        target = std::max(target, std::floor(statistics.batch_size / 2.0));
+    }
+    target = std::min(target, hard_limit);
+
+    statistics.batch_size = std::max(1, static_cast<int>(target));
+    return std::max(1, std::min(statistics.batch_size, upper_bound));
+}
+
+void BatchSizeController::RecordSuccess(const std::string& key, const int num_tuples, const int64_t output_tokens,
+                                        const std::chrono::milliseconds latency) {
+    if (num_tuples <= 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& statistics = GetStatistics(key);
+
+    const auto tokens_sample = static_cast<double>(output_tokens) / num_tuples;
+    const auto latency_sample = static_cast<double>(latency.count()) / num_tuples;
+    // Output size rises to a larger sample immediately and decays slowly, since overshooting costs a whole call.
+    if (statistics.output_tokens_per_tuple <= 0 || tokens_sample > statistics.output_tokens_per_tuple) {
+        statistics.output_tokens_per_tuple = tokens_sample;
+    } else {
+        statistics.output_tokens_per_tuple =
+            kSmoothing * tokens_sample + (1 - kSmoothing) * statistics.output_tokens_per_tuple;
+    }
+    if (statistics.latency_ms_per_tuple <= 0) {
+        statistics.latency_ms_per_tuple = latency_sample;
+    } else {
+        statistics.latency_ms_per_tuple =
+            kSmoothing * latency_sample + (1 - kSmoothing) * statistics.latency_ms_per_tuple;
+    }
+    if (statistics.batch_size == 0 || statistics.overflowed) {
+        statistics.batch_size = num_tuples;
+    }
+    statistics.overflowed = false;
+}
+
+void BatchSizeController::RecordOverflow(const std::string& key, const int num_tuples, const int max_output_tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& statistics = GetStatistics(key);
+
+    // Overflowing proves the tuples needed at least this many output tokens each.
+    const auto lower_bound = static_cast<double>(max_output_tokens) / std::max(1, num_tuples);
+    statistics.output_tokens_per_tuple = std::max(statistics.output_tokens_per_tuple, lower_bound);
+    statistics.batch_size = std::max(1, num_tuples / 2);
+    statistics.overflowed = true;
+}
+
+void BatchSizeController::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_.clear();
+    clock_ = 0;
+}
+
+} // namespace flockmtl
@@ -0,0 +1,25 @@
+#include "flockmtl/functions/scalar/flockmtl_hamming_distance.hpp"
+#include "flockmtl/vector_search/quantization.hpp"
+
+namespace flockmtl {
+
+void FlockmtlHammingDistance::Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                      duckdb::Vector& result) {
+    duckdb::BinaryExecutor::Execute<duckdb::string_t, duckdb::string_t, int64_t>(
+        args.data[0], args.data[1], result, args.size(), [](const duckdb::string_t& a, const duckdb::string_t& b) {
+            if (Quantization::GetEncoding(a.GetData(), a.GetSize()) != Quantization::Encoding::BINARY ||
+                Quantization::GetEncoding(b.GetData(), b.GetSize()) != Quantization::Encoding::BINARY) {
+                throw std::runtime_error("flockmtl_hamming_distance expects embeddings made by "
+                                         "flockmtl_quantize_binary.");
+            }
+            if (a.GetSize() != b.GetSize()) {
+                throw std::runtime_error("Cannot compare embeddings with different dimensions.");
+            }
+            // skip the encoding byte
+            return static_cast<int64_t>(Quantization::Hamming(reinterpret_cast<const uint8_t*>(a.GetData()) + 1,
+                                                              reinterpret_cast<const uint8_t*>(b.GetData()) + 1,
+                                                              a.GetSize() - 1));
+        });
+}
+
+} // namespace flockmtl
@@ -0,0 +1,12 @@
+#include "flockmtl/functions/scalar/flockmtl_hamming_distance.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void ScalarRegistry::RegisterFlockmtlHammingDistance(duckdb::DatabaseInstance& db) {
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("flockmtl_hamming_distance", {duckdb::LogicalType::BLOB, duckdb::LogicalType::BLOB},
+                                   duckdb::LogicalType::BIGINT, FlockmtlHammingDistance::Execute));
+}
+
+} // namespace flockmtl
@@ -0,0 +1,35 @@
+#include "flockmtl/functions/scalar/flockmtl_quantize.hpp"
+#include "flockmtl/vector_search/quantization.hpp"
+
+namespace flockmtl {
+
+template <std::string (*QUANTIZE)(const float*, size_t)>
+void FlockmtlQuantize::Quantize(duckdb::DataChunk& args, duckdb::Vector& result) {
+    auto& embeddings = args.data[0];
+    auto& child = duckdb::ListVector::GetEntry(embeddings);
+    child.Flatten(duckdb::ListVector::GetListSize(embeddings));
+    const auto child_data = duckdb::FlatVector::GetData<float>(child);
+    const auto& child_validity = duckdb::FlatVector::Validity(child);
+
+    duckdb::UnaryExecutor::Execute<duckdb::list_entry_t, duckdb::string_t>(
+        embeddings, result, args.size(), [&](const duckdb::list_entry_t& entry) {
+            if (entry.length == 0) {
+                throw std::runtime_error("Cannot quantize an empty embedding.");
+            }
+            if (!child_validity.CheckAllValid(entry.offset + entry.length, entry.offset)) {
+                throw std::runtime_error("Embeddings must not contain NULL values.");
+            }
+            return duckdb::StringVector::AddStringOrBlob(result, QUANTIZE(child_data + entry.offset, entry.length));
+        });
+}
+
+void FlockmtlQuantize::ExecuteInt8(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
+    Quantize<Quantization::QuantizeInt8>(args, result);
+}
+
+void FlockmtlQuantize::ExecuteBinary(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                     duckdb::Vector& result) {
+    Quantize<Quantization::QuantizeBinary>(args, result);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,17 @@
+#include "flockmtl/functions/scalar/flockmtl_quantize.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void ScalarRegistry::RegisterFlockmtlQuantize(duckdb::DatabaseInstance& db) {
+    // lists of any numbers and fixed-size arrays are cast to lists of floats
+    const auto embedding = duckdb::LogicalType::LIST(duckdb::LogicalType::FLOAT);
+    duckdb::ExtensionUtil::RegisterFunction(db, duckdb::ScalarFunction("flockmtl_quantize_int8", {embedding},
+                                                                       duckdb::LogicalType::BLOB,
+                                                                       FlockmtlQuantize::ExecuteInt8));
+    duckdb::ExtensionUtil::RegisterFunction(db, duckdb::ScalarFunction("flockmtl_quantize_binary", {embedding},
+                                                                       duckdb::LogicalType::BLOB,
+                                                                       FlockmtlQuantize::ExecuteBinary));
+}
+
+} // namespace flockmtl
@@ -5,9 +5,9 @@ namespace flockmtl {
 
 void ScalarRegistry::RegisterFusionCombANZ(duckdb::DatabaseInstance& db) {
     duckdb::ExtensionUtil::RegisterFunction(
-        db, duckdb::ScalarFunction("fusion_combanz", {}, duckdb::LogicalType::VARCHAR, FusionCombANZ::Execute, nullptr,
+        db, duckdb::ScalarFunction("fusion_combanz", {}, duckdb::LogicalType::DOUBLE, FusionCombANZ::Execute, nullptr,
                                    nullptr, nullptr, nullptr, duckdb::LogicalType::ANY,
-                                   duckdb::FunctionStability::VOLATILE, duckdb::FunctionNullHandling::SPECIAL_HANDLING));
+                                   duckdb::FunctionStability::CONSISTENT, duckdb::FunctionNullHandling::SPECIAL_HANDLING));
 }
 
 } // namespace flockmtl
@@ -3,73 +3,77 @@
 namespace flockmtl {
 
 // performs CombMED to merge lists based on a calculated score.
-std::vector<double> FusionCombMED::Operation(duckdb::DataChunk& args) {
-    int num_different_scores = static_cast<int>(args.ColumnCount());
-    int num_entries = static_cast<int>(args.size());
-
-    // we want to keep track of all scores for each entry (in a vector)
-    std::vector<std::vector<double>> cumulative_scores(num_entries);
+void FusionCombMED::Fuse(duckdb::DataChunk& args, double* scores) {
+    const auto num_different_scores = args.ColumnCount();
+    const auto num_entries = args.size();
+    if (num_different_scores == 0) {
+        std::fill(scores, scores + num_entries, 0.0);
+        return;
+    }
 
-    // for each column (scoring system), we want a vector of individual input scores so we can normalize them
-    for (int i = 0; i < num_different_scores; i++) {
-        // extract a single column's score values.
-        std::vector<double> extracted_scores(num_entries);
-        for (int j = 0; j < num_entries; j++) {
-            auto valueWrapper = args.data[i].GetValue(j);
-            // if there is a value, it is extracted. if there is no value (NULL/NaN), it stays at 0
-            if (!valueWrapper.IsNull()) {
-                if (const double value = valueWrapper.GetValue<double>(); !std::isnan(value)) {
-                    extracted_scores[j] = value;
-                }
-            }
-        }
+    // all scores of the chunk in one row-major matrix, so each entry's scores are contiguous and can be selected from
+    // in place without allocating per entry
+    std::vector<double> matrix(num_entries * num_different_scores);
 
+    for (duckdb::idx_t i = 0; i < num_different_scores; i++) {
+        const FusionInput<double> column(args.data[i], num_entries, duckdb::LogicalType::DOUBLE);
+        // if there is a value, it is extracted. if there is no value (NULL/NaN), it counts as 0.
         // We make sure not to skip columns where all entries are the same.
         // If a retrieval system has all 0, it means the document wasn't found, which we want to keep in mind.
-
-        // add this column's scores to the scores for this entry
-        for (size_t k = 0; k < num_entries; k++) {
-            cumulative_scores[k].push_back(extracted_scores[k]);
+        for (duckdb::idx_t k = 0; k < num_entries; k++) {
+            const auto value = column.Get(k, 0.0);
+            matrix[k * num_different_scores + i] = std::isnan(value) ? 0.0 : value;
         }
     }
 
-    // Now that all scores are normalized and extracted, we can calculate the median score for each entry
-    std::vector<double> median_scores(num_entries);
-    for (int i = 0; i < num_entries; i++) {
-        median_scores[i] = FusionCombMED::calculateMedian(cumulative_scores[i]);
+    // Now that all scores are extracted, we can calculate the median score for each entry
+    for (duckdb::idx_t k = 0; k < num_entries; k++) {
+        scores[k] = FusionCombMED::calculateMedian(&matrix[k * num_different_scores], num_different_scores);
     }
+}
 
-    return median_scores;
+std::vector<double> FusionCombMED::Operation(duckdb::DataChunk& args) {
+    std::vector<double> scores(args.size());
+    Fuse(args, scores.data());
+    return scores;
 }
 
 void FusionCombMED::Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
-    auto results = FusionCombMED::Operation(args);
-
-    auto index = 0;
-    for (const auto& res : results) {
-        result.SetValue(index++, duckdb::Value(res));
-    }
+    ExecuteFusion<Fuse>(args, result);
 }
 
-double FusionCombMED::calculateMedian(const std::vector<double>& scores) {
-    if (scores.empty()) {
+double FusionCombMED::calculateMedian(double* scores, const size_t size) {
+    if (size == 0) {
         return 0.0;
     }
-
-    // Create a copy to avoid modifying the original vector
-    std::vector<double> sorted_scores = scores;
-    const size_t size = sorted_scores.size();
     const size_t mid = size / 2;
 
-    // Sort the copy
-    std::sort(sorted_scores.begin(), sorted_scores.end());
+    if (size <= kInsertionSortThreshold) {
+        // a handful of retrievers is the common case, where insertion sort beats nth_element's partitioning
+        for (size_t i = 1; i < size; i++) {
+            const auto score = scores[i];
+            auto j = i;
+            for (; j > 0 && scores[j - 1] > score; j--) {
+                scores[j] = scores[j - 1];
+            }
+            scores[j] = score;
+        }
+    } else {
+        // only the middle element has to be in place; everything before it is no greater
+        std::nth_element(scores, scores + mid, scores + size);
+        if (size % 2 == 0) {
+            // the other middle element is the largest of the lower half
+            return (*std::max_element(scores, scores + mid) + scores[mid]) / 2.0;
+        }
+        return scores[mid];
+    }
 
     if (size % 2 == 0) {
-        // For even-sized vectors, average the two middle elements
-        return (sorted_scores[mid - 1] + sorted_scores[mid]) / 2.0;
+        // For even-sized inputs, average the two middle elements
+        return (scores[mid - 1] + scores[mid]) / 2.0;
     } else {
-        // For odd-sized vectors, return the middle element
-        return sorted_scores[mid];
+        // For odd-sized inputs, return the middle element
+        return scores[mid];
     }
 }
 
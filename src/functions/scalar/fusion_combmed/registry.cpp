@@ -5,9 +5,9 @@ namespace flockmtl {
 
 void ScalarRegistry::RegisterFusionCombMED(duckdb::DatabaseInstance& db) {
     duckdb::ExtensionUtil::RegisterFunction(
-        db, duckdb::ScalarFunction("fusion_combmed", {}, duckdb::LogicalType::VARCHAR, FusionCombMED::Execute, nullptr,
+        db, duckdb::ScalarFunction("fusion_combmed", {}, duckdb::LogicalType::DOUBLE, FusionCombMED::Execute, nullptr,
                                    nullptr, nullptr, nullptr, duckdb::LogicalType::ANY,
-                                   duckdb::FunctionStability::VOLATILE, duckdb::FunctionNullHandling::SPECIAL_HANDLING));
+                                   duckdb::FunctionStability::CONSISTENT, duckdb::FunctionNullHandling::SPECIAL_HANDLING));
 }
 
 } // namespace flockmtl
@@ -7,7 +7,7 @@ void ScalarRegistry::RegisterFusionCombMNZ(duckdb::DatabaseInstance& db) {
     duckdb::ExtensionUtil::RegisterFunction(
         db, duckdb::ScalarFunction("fusion_combmnz", {}, duckdb::LogicalType::DOUBLE, FusionCombMNZ::Execute, nullptr,
                                    nullptr, nullptr, nullptr, duckdb::LogicalType::ANY,
-                                   duckdb::FunctionStability::VOLATILE, duckdb::FunctionNullHandling::SPECIAL_HANDLING));
+                                   duckdb::FunctionStability::CONSISTENT, duckdb::FunctionNullHandling::SPECIAL_HANDLING));
 }
 
 } // namespace flockmtl
@@ -7,7 +7,7 @@ void ScalarRegistry::RegisterFusionCombSUM(duckdb::DatabaseInstance& db) {
     duckdb::ExtensionUtil::RegisterFunction(
         db, duckdb::ScalarFunction("fusion_combsum", {}, duckdb::LogicalType::DOUBLE, FusionCombSUM::Execute, nullptr,
                                    nullptr, nullptr, nullptr, duckdb::LogicalType::ANY,
-                                   duckdb::FunctionStability::VOLATILE, duckdb::FunctionNullHandling::SPECIAL_HANDLING));
+                                   duckdb::FunctionStability::CONSISTENT, duckdb::FunctionNullHandling::SPECIAL_HANDLING));
 }
 
 } // namespace flockmtl
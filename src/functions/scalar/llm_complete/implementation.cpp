@@ -21,7 +21,7 @@ void LlmComplete::ValidateArguments(duckdb::DataChunk& args) {
     }
 }
 
-std::vector<std::string> LlmComplete::Operation(duckdb::DataChunk& args) {
+std::vector<std::string> LlmComplete::Operation(duckdb::DataChunk& args, const SemanticCache::Options& cache_options) {
     LlmComplete::ValidateArguments(args);
 
     auto model_details_json = CastVectorOfStructsToJson(args.data[0], 1)[0];
@@ -32,7 +32,7 @@ std::vector<std::string> LlmComplete::Operation(duckdb::DataChunk& args) {
     std::vector<std::string> results;
     if (args.ColumnCount() == 2) {
         auto template_str = prompt_details.prompt;
-        auto response = model.CallComplete(template_str, false);
+        auto response = CompletePrompt(template_str, false, model, cache_options);
         results.push_back(response.get<std::string>());
     } else {
         auto tuples = CastVectorOfStructsToJson(args.data[2], args.size());
@@ -48,8 +48,10 @@ std::vector<std::string> LlmComplete::Operation(duckdb::DataChunk& args) {
 }
 
 void LlmComplete::Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
+    const auto query_scope = ScopeToQuery(state);
 
-    if (const auto results = LlmComplete::Operation(args); static_cast<int>(results.size()) == 1) {
+    const auto cache_options = Config::GetSemanticCacheOptions(state.GetContext());
+    if (const auto results = LlmComplete::Operation(args, cache_options); static_cast<int>(results.size()) == 1) {
         auto empty_vec = duckdb::Vector(std::string());
         duckdb::UnaryExecutor::Execute<duckdb::string_t, duckdb::string_t>(
             empty_vec, result, args.size(),
@@ -4,9 +4,10 @@
 namespace flockmtl {
 
 void ScalarRegistry::RegisterLlmComplete(duckdb::DatabaseInstance& db) {
-    duckdb::ExtensionUtil::RegisterFunction(db, duckdb::ScalarFunction("llm_complete", {}, duckdb::LogicalType::VARCHAR,
-                                                                       LlmComplete::Execute, nullptr, nullptr, nullptr,
-                                                                       nullptr, duckdb::LogicalType::ANY));
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("llm_complete", {}, duckdb::LogicalType::VARCHAR, LlmComplete::Execute, nullptr,
+                                   nullptr, nullptr, nullptr, duckdb::LogicalType::ANY,
+                                   duckdb::FunctionStability::VOLATILE));
 }
 
 } // namespace flockmtl
@@ -21,7 +21,8 @@ void LlmCompleteJson::ValidateArguments(duckdb::DataChunk& args) {
     }
 }
 
-std::vector<std::string> LlmCompleteJson::Operation(duckdb::DataChunk& args) {
+std::vector<std::string> LlmCompleteJson::Operation(duckdb::DataChunk& args,
+                                                   const SemanticCache::Options& cache_options) {
     LlmCompleteJson::ValidateArguments(args);
 
     auto model_details_json = CastVectorOfStructsToJson(args.data[0], 1)[0];
@@ -33,7 +34,7 @@ std::vector<std::string> LlmCompleteJson::Operation(duckdb::DataChunk& args) {
     if (args.ColumnCount() == 2) {
         auto template_str = prompt_details.prompt;
         template_str += "\nThe Ouput should be in JSON format.";
-        auto response = model.CallComplete(template_str);
+        auto response = CompletePrompt(template_str, true, model, cache_options);
 
         results.push_back(response.dump());
     } else {
@@ -50,8 +51,10 @@ std::vector<std::string> LlmCompleteJson::Operation(duckdb::DataChunk& args) {
 }
 
 void LlmCompleteJson::Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
+    const auto query_scope = ScopeToQuery(state);
 
-    if (const auto results = LlmCompleteJson::Operation(args); static_cast<int>(results.size()) == 1) {
+    const auto cache_options = Config::GetSemanticCacheOptions(state.GetContext());
+    if (const auto results = LlmCompleteJson::Operation(args, cache_options); static_cast<int>(results.size()) == 1) {
         auto empty_vec = duckdb::Vector(std::string());
         duckdb::UnaryExecutor::Execute<duckdb::string_t, duckdb::string_t>(
             empty_vec, result, args.size(),
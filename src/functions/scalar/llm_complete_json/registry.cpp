@@ -6,7 +6,8 @@ namespace flockmtl {
 void ScalarRegistry::RegisterLlmCompleteJson(duckdb::DatabaseInstance& db) {
     duckdb::ExtensionUtil::RegisterFunction(
         db, duckdb::ScalarFunction("llm_complete_json", {}, duckdb::LogicalType::JSON(), LlmCompleteJson::Execute,
-                                   nullptr, nullptr, nullptr, nullptr, duckdb::LogicalType::ANY));
+                                   nullptr, nullptr, nullptr, nullptr, duckdb::LogicalType::ANY,
+                                   duckdb::FunctionStability::VOLATILE));
 }
 
 } // namespace flockmtl
@@ -1,5 +1,7 @@
 #include "flockmtl/functions/scalar/llm_embedding.hpp"
 
+#include <cstring>
+
 namespace flockmtl {
 
 void LlmEmbedding::ValidateArguments(duckdb::DataChunk& args) {
@@ -14,7 +16,38 @@ void LlmEmbedding::ValidateArguments(duckdb::DataChunk& args) {
     }
 }
 
-std::vector<duckdb::vector<duckdb::Value>> LlmEmbedding::Operation(duckdb::DataChunk& args) {
+namespace {
+
+// Appends each decoded embedding to the child vector of the LIST(DOUBLE) result and points the row's list entry at it.
+class ListVectorEmbeddingSink : public EmbeddingSink {
+public:
+    ListVectorEmbeddingSink(duckdb::Vector& result, const size_t rows) : result_(result), written_(rows) {}
+
+    void SetBatchOffset(const size_t batch_offset) { batch_offset_ = batch_offset; }
+
+    void Write(size_t row, const double* values, size_t count) override {
+        const auto list_size = duckdb::ListVector::GetListSize(result_);
+        duckdb::ListVector::Reserve(result_, list_size + count);
+        auto child_data = duckdb::FlatVector::GetData<double>(duckdb::ListVector::GetEntry(result_));
+        std::memcpy(child_data + list_size, values, count * sizeof(double));
+        duckdb::ListVector::SetListSize(result_, list_size + count);
+
+        auto entries = duckdb::FlatVector::GetData<duckdb::list_entry_t>(result_);
+        entries[batch_offset_ + row] = duckdb::list_entry_t(list_size, count);
+        written_[batch_offset_ + row] = true;
+    }
+
+    bool IsWritten(const size_t row) const { return written_[row]; }
+
+private:
+    duckdb::Vector& result_;
+    size_t batch_offset_ = 0;
+    std::vector<bool> written_;
+};
+
+} // namespace
+
+void LlmEmbedding::Operation(duckdb::DataChunk& args, duckdb::Vector& result) {
     LlmEmbedding::ValidateArguments(args);
 
     auto inputs = CastVectorOfStructsToJson(args.data[1], args.size());
@@ -36,31 +69,28 @@ std::vector<duckdb::vector<duckdb::Value>> LlmEmbedding::Operation(duckdb::DataC
         batch_size = static_cast<int>(prepared_inputs.size());
     }
 
-    std::vector<duckdb::vector<duckdb::Value>> results;
+    result.SetVectorType(duckdb::VectorType::FLAT_VECTOR);
+    ListVectorEmbeddingSink sink(result, prepared_inputs.size());
     for (size_t i = 0; i < prepared_inputs.size(); i += batch_size) {
         std::vector<std::string> batch_inputs;
         for (size_t j = i; j < i + batch_size && j < prepared_inputs.size(); j++) {
             batch_inputs.push_back(prepared_inputs[j]);
         }
-        auto embeddings = model.CallEmbedding(batch_inputs);
-        for (size_t index = 0; index < embeddings.size(); index++) {
-            duckdb::vector<duckdb::Value> embedding;
-            for (auto& value : embeddings[index]) {
-                embedding.push_back(duckdb::Value(static_cast<double>(value)));
-            }
-            results.push_back(embedding);
+        sink.SetBatchOffset(i);
+        model.CallEmbeddingInto(batch_inputs, sink);
+    }
+
+    for (size_t row = 0; row < prepared_inputs.size(); row++) {
+        if (!sink.IsWritten(row)) {
+            throw std::runtime_error(
+                duckdb_fmt::format("The provider returned no embedding for input {} of the chunk", row));
         }
     }
-    return results;
 }
 
 void LlmEmbedding::Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
-    auto results = LlmEmbedding::Operation(args);
-
-    auto index = 0;
-    for (const auto& res : results) {
-        result.SetValue(index++, duckdb::Value::LIST(res));
-    }
+    const auto query_scope = ScopeToQuery(state);
+    LlmEmbedding::Operation(args, result);
 }
 
 } // namespace flockmtl
@@ -19,17 +19,113 @@ void LlmFilter::ValidateArguments(duckdb::DataChunk& args) {
     }
 }
 
-std::vector<std::string> LlmFilter::Operation(duckdb::DataChunk& args) {
+static double GetCascadeThreshold(const nlohmann::json& value) {
+    auto threshold = std::numeric_limits<double>::quiet_NaN();
+    if (value.is_number()) {
+        threshold = value.get<double>();
+    } else if (value.is_string()) {
+        const auto& text = value.get_ref<const std::string&>();
+        size_t parsed = 0;
+        try {
+            threshold = std::stod(text, &parsed);
+        } catch (const std::exception&) {
+        }
+        if (parsed != text.size()) {
+            threshold = std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+    if (!(threshold >= 0 && threshold <= 1)) {
+        throw std::runtime_error("`cascade_threshold` must be a number between 0 and 1");
+    }
+    return threshold;
+}
+
+std::optional<LlmFilter::Cascade> LlmFilter::GetCascade(const nlohmann::json& model_details_json) {
+    if (!model_details_json.contains("cascade_model")) {
+        if (model_details_json.contains("cascade_threshold")) {
+            throw std::runtime_error("`cascade_threshold` requires a `cascade_model`");
+        }
+        return std::nullopt;
+    }
+
+    Cascade cascade;
+    const auto& cascade_model = model_details_json.at("cascade_model");
+    if (cascade_model.is_string()) {
+        // Batch sizes, secrets, tuple formats and the like carry over; what picks the first model does not
+        cascade.model_json = model_details_json;
+        for (const auto& key : {"model", "provider", "cascade_model", "cascade_threshold"}) {
+            cascade.model_json.erase(key);
+        }
+        cascade.model_json["model_name"] = cascade_model;
+    } else if (cascade_model.is_object() && cascade_model.contains("model_name")) {
+        cascade.model_json = cascade_model;
+    } else {
+        throw std::runtime_error("`cascade_model` must be a model name or a struct of model settings with a "
+                                 "`model_name`");
+    }
+    if (model_details_json.contains("cascade_threshold")) {
+        cascade.threshold = GetCascadeThreshold(model_details_json.at("cascade_threshold"));
+    }
+    return cascade;
+}
+
+std::optional<bool> LlmFilter::GetConfidentAnswer(const nlohmann::json& response, const double threshold) {
+    if (!response.is_object() || !response.contains("answer") || !response.contains("confidence")) {
+        return std::nullopt;
+    }
+
+    const auto& answer = response["answer"];
+    const auto& confidence = response["confidence"];
+    if (!answer.is_boolean() || !confidence.is_number() || confidence.get<double>() < threshold) {
+        return std::nullopt;
+    }
+    return answer.get<bool>();
+}
+
+nlohmann::json LlmFilter::CascadeAndComplete(const std::vector<nlohmann::json>& tuples, const std::string& user_prompt,
+                                             Model& model, const double threshold,
+                                             const std::function<Model&()>& get_cascade_model) {
+    auto responses = BatchAndComplete(tuples, user_prompt, ScalarFunctionType::FILTER_CONFIDENCE, model);
+
+    std::vector<size_t> escalated;
+    std::vector<nlohmann::json> escalated_tuples;
+    for (size_t i = 0; i < responses.size(); i++) {
+        if (const auto answer = GetConfidentAnswer(responses[i], threshold)) {
+            responses[i] = *answer;
+        } else {
+            escalated.push_back(i);
+            escalated_tuples.push_back(tuples[i]);
+        }
+    }
+    Profiler::RecordCascade(tuples.size(), escalated.size());
+    if (escalated.empty()) {
+        return responses;
+    }
+
+    const auto cascade_responses =
+        BatchAndComplete(escalated_tuples, user_prompt, ScalarFunctionType::FILTER, get_cascade_model());
+    for (size_t i = 0; i < escalated.size(); i++) {
+        responses[escalated[i]] = i < cascade_responses.size() ? cascade_responses[i] : nlohmann::json();
+    }
+    return responses;
+}
+
+std::vector<std::string> LlmFilter::Operation(duckdb::DataChunk& args, QueryModelsState& models) {
     LlmFilter::ValidateArguments(args);
 
     auto model_details_json = CastVectorOfStructsToJson(args.data[0], 1)[0];
+    const auto cascade = GetCascade(model_details_json);
     Model model(model_details_json);
     auto prompt_details_json = CastVectorOfStructsToJson(args.data[1], 1)[0];
     auto prompt_details = PromptManager::CreatePromptDetails(prompt_details_json);
 
     auto tuples = CastVectorOfStructsToJson(args.data[2], args.size());
 
-    auto responses = BatchAndComplete(tuples, prompt_details.prompt, ScalarFunctionType::FILTER, model);
+    // The cascade model is built once per query, and only if a tuple is escalated
+    const auto get_cascade_model = [&]() -> Model& { return *models.GetModel(cascade->model_json); };
+    auto responses =
+        cascade ? CascadeAndComplete(tuples, prompt_details.prompt, model, cascade->threshold, get_cascade_model)
+                : BatchAndComplete(tuples, prompt_details.prompt, ScalarFunctionType::FILTER, model);
 
     std::vector<std::string> results;
     results.reserve(responses.size());
@@ -45,7 +141,8 @@ std::vector<std::string> LlmFilter::Operation(duckdb::DataChunk& args) {
 }
 
 void LlmFilter::Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
-    const auto results = LlmFilter::Operation(args);
+    const auto query_scope = ScopeToQuery(state);
+    const auto results = LlmFilter::Operation(args, *Config::GetQueryModels(state.GetContext()));
 
     auto index = 0;
     for (const auto& res : results) {
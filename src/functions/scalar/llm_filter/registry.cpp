@@ -7,7 +7,9 @@ void ScalarRegistry::RegisterLlmFilter(duckdb::DatabaseInstance& db) {
     duckdb::ExtensionUtil::RegisterFunction(
         db, duckdb::ScalarFunction("llm_filter",
                                    {duckdb::LogicalType::ANY, duckdb::LogicalType::ANY, duckdb::LogicalType::ANY},
-                                   duckdb::LogicalType::VARCHAR, LlmFilter::Execute));
+                                   duckdb::LogicalType::VARCHAR, LlmFilter::Execute, nullptr, nullptr, nullptr,
+                                   nullptr, duckdb::LogicalType(duckdb::LogicalTypeId::INVALID),
+                                   duckdb::FunctionStability::VOLATILE));
 }
 
 } // namespace flockmtl
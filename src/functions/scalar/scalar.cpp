@@ -1,25 +1,142 @@
 #include "flockmtl/functions/scalar/scalar.hpp"
 
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
 namespace flockmtl {
 
+nlohmann::json ScalarFunctionBase::CompletePrompt(const std::string& prompt, bool json_response, Model& model,
+                                                  const SemanticCache::Options& cache_options) {
+    if (!cache_options.cache) {
+        return model.CallComplete(prompt, json_response);
+    }
+
+    auto& embedding_model = *cache_options.embedding_model;
+    const auto embedding = embedding_model.CallEmbedding({prompt})[0].get<std::vector<float>>();
+    // Embeddings of different models are not comparable, and a text response does not answer a JSON request
+    const auto key =
+        model.GetRateLimitKey() + "|" + embedding_model.GetRateLimitKey() + (json_response ? "|json" : "|text");
+    if (auto cached = cache_options.cache->Lookup(key, embedding, cache_options.threshold)) {
+        Profiler::RecordCacheHit(1);
+        return std::move(*cached);
+    }
+
+    auto response = model.CallComplete(prompt, json_response);
+    cache_options.cache->Insert(key, embedding, response);
+    return response;
+}
+
 nlohmann::json ScalarFunctionBase::Complete(const nlohmann::json& tuples, const std::string& user_prompt,
                                             ScalarFunctionType function_type, Model& model) {
     nlohmann::json data;
     const auto prompt = PromptManager::Render(user_prompt, tuples, function_type, model.GetModelDetails().tuple_format);
+    Profiler::RecordBatch(tuples.size());
     auto response = model.CallComplete(prompt);
     return response["tuples"];
 };
 
-nlohmann::json ScalarFunctionBase::BatchAndComplete(const std::vector<nlohmann::json>& tuples,
-                                                    const std::string& user_prompt,
-                                                    const ScalarFunctionType function_type, Model& model) {
+FunctionScope ScalarFunctionBase::ScopeToQuery(duckdb::ExpressionState& state) {
+    auto& context = state.GetContext();
+    return FunctionScope(Config::GetQueryBudgets(context).get(), &context, context.transaction.GetActiveQuery(),
+                         state.expr.Cast<duckdb::BoundFunctionExpression>().function.name,
+                         Config::GetQueryLimits(context));
+}
+
+void ScalarFunctionBase::AlignResponse(nlohmann::json& response, const size_t num_tuples) {
+    if (!response.is_array()) {
+        response = nlohmann::json::array();
+    }
+    while (response.size() < num_tuples) {
+        response.push_back(nullptr);
+    }
+    if (response.size() > num_tuples) {
+        response.erase(response.begin() + static_cast<std::ptrdiff_t>(num_tuples), response.end());
+    }
+}
+
+nlohmann::json ScalarFunctionBase::CompleteWithSplit(const nlohmann::json& tuples, const std::string& user_prompt,
+                                                     const ScalarFunctionType function_type, Model& model,
+                                                     const bool concurrently) {
+    try {
+        auto response = Complete(tuples, user_prompt, function_type, model);
+        AlignResponse(response, tuples.size());
+        return response;
+    } catch (const ExceededMaxOutputTokensError&) {
+        if (tuples.size() <= 1) {
+            throw;
+        }
+    }
+    return SplitAndComplete(tuples, user_prompt, function_type, model, concurrently);
+}
+
+nlohmann::json ScalarFunctionBase::SplitAndComplete(const nlohmann::json& tuples, const std::string& user_prompt,
+                                                    const ScalarFunctionType function_type, Model& model,
+                                                    const bool concurrently) {
+    // Bisect the failed batch and retry both halves; each half splits again if it still overflows. Only the first split
+    // of a batch completes its halves at the same time, so a batch never holds more than two threads, and the halves
+    // split further on the thread that completes them.
+    const auto middle = static_cast<std::ptrdiff_t>(tuples.size() / 2);
+    const auto first_half = nlohmann::json(std::vector<nlohmann::json>(tuples.begin(), tuples.begin() + middle));
+    const auto second_half = nlohmann::json(std::vector<nlohmann::json>(tuples.begin() + middle, tuples.end()));
+
+    nlohmann::json response;
+    nlohmann::json second_response;
+    if (concurrently) {
+        auto first_future = std::async(std::launch::async, [&, scope_context = FunctionScope::Current()]() {
+            const FunctionScope scope(scope_context);
+            return CompleteWithSplit(first_half, user_prompt, function_type, model, false);
+        });
+        second_response = CompleteWithSplit(second_half, user_prompt, function_type, model, false);
+        response = first_future.get();
+    } else {
+        response = CompleteWithSplit(first_half, user_prompt, function_type, model, false);
+        second_response = CompleteWithSplit(second_half, user_prompt, function_type, model, false);
+    }
+
+    for (auto& tuple : second_response) {
+        response.push_back(std::move(tuple));
+    }
+    return response;
+}
+
+int ScalarFunctionBase::GetAvailableTokens(const std::string& user_prompt, const ScalarFunctionType function_type,
+                                           const ModelDetails& model_details) {
     const auto llm_template = PromptManager::GetTemplate(function_type);
 
     int num_tokens_meta_and_user_prompt = 0;
     num_tokens_meta_and_user_prompt += Tiktoken::GetNumTokens(user_prompt);
     num_tokens_meta_and_user_prompt += Tiktoken::GetNumTokens(llm_template);
+    return model_details.context_window - num_tokens_meta_and_user_prompt;
+}
+
+int ScalarFunctionBase::FitBatch(const std::vector<nlohmann::json>& tuples, const int start, const int batch_size,
+                                 const int available_tokens) {
+    auto accumulated_tuples_tokens =
+        Tiktoken::GetNumTokens(PromptManager::ConstructNumTuples(static_cast<int>(tuples.size())));
+    accumulated_tuples_tokens += Tiktoken::GetNumTokens(PromptManager::ConstructInputTuplesHeader(tuples[start]));
+    auto end = start;
+    while (end < static_cast<int>(tuples.size()) && end - start < batch_size) {
+        const auto num_tokens = Tiktoken::GetNumTokens(PromptManager::ConstructSingleInputTuple(tuples[end]));
+        if (end > start && accumulated_tuples_tokens + num_tokens > available_tokens) {
+            break;
+        }
+        accumulated_tuples_tokens += num_tokens;
+        end++;
+    }
+    return end;
+}
+
+std::string ScalarFunctionBase::GetBatchSizeKey(const ModelDetails& model_details,
+                                                const ScalarFunctionType function_type,
+                                                const std::string& user_prompt) {
+    return model_details.model_name + '\n' + model_details.model + '\n' +
+           std::to_string(static_cast<int>(function_type)) + '\n' + user_prompt;
+}
+
+nlohmann::json ScalarFunctionBase::BatchAndComplete(const std::vector<nlohmann::json>& tuples,
+                                                    const std::string& user_prompt,
+                                                    const ScalarFunctionType function_type, Model& model) {
     const auto model_details = model.GetModelDetails();
-    const auto available_tokens = model_details.context_window - num_tokens_meta_and_user_prompt;
+    const auto available_tokens = GetAvailableTokens(user_prompt, function_type, model_details);
     auto batch_size = model_details.batch_size;
 
     auto responses = nlohmann::json::array();
@@ -31,54 +148,40 @@ nlohmann::json ScalarFunctionBase::BatchAndComplete(const std::vector<nlohmann::
         int start_index = 0;
 
         if (batch_size == 0) {
-            auto accumulated_tuples_tokens = 0u;
-            batch_size = static_cast<int>(tuples.size());
+            const auto controller_key = GetBatchSizeKey(model_details, function_type, user_prompt);
             do {
-                accumulated_tuples_tokens +=
-                    Tiktoken::GetNumTokens(PromptManager::ConstructNumTuples(static_cast<int>(tuples.size())));
-                accumulated_tuples_tokens +=
-                    Tiktoken::GetNumTokens(PromptManager::ConstructInputTuplesHeader(tuples[start_index]));
-                while (accumulated_tuples_tokens < static_cast<unsigned int>(available_tokens) &&
-                       start_index < static_cast<int>(tuples.size()) && batch_tuples.size() < batch_size) {
-                    const auto num_tokens =
-                        Tiktoken::GetNumTokens(PromptManager::ConstructSingleInputTuple(tuples[start_index]));
-                    if (accumulated_tuples_tokens + num_tokens > static_cast<unsigned int>(available_tokens)) {
-                        break;
-                    }
-                    batch_tuples.push_back(tuples[start_index]);
-                    accumulated_tuples_tokens += num_tokens;
-                    start_index++;
+                const auto remaining = static_cast<int>(tuples.size()) - start_index;
+                batch_size =
+                    BatchSizeController::GetBatchSize(controller_key, model_details.max_output_tokens, remaining);
+                const auto end_index = FitBatch(tuples, start_index, batch_size, available_tokens);
+                for (auto i = start_index; i < end_index; i++) {
+                    batch_tuples.push_back(tuples[i]);
                 }
 
                 nlohmann::json response;
+                const auto started = std::chrono::steady_clock::now();
                 try {
                     response = Complete(batch_tuples, user_prompt, function_type, model);
+                    const auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - started);
+                    // The provider's count is exact; re-tokenizing the response is the fallback for those without one
+                    const auto output_tokens = Model::TakeCompletionTokens();
+                    AlignResponse(response, batch_tuples.size());
+                    BatchSizeController::RecordSuccess(
+                        controller_key, static_cast<int>(batch_tuples.size()),
+                        output_tokens.has_value() ? *output_tokens : Tiktoken::GetNumTokens(response.dump()), latency);
                 } catch (const ExceededMaxOutputTokensError&) {
-                    batch_tuples.clear();
-                    const auto new_batch_size = static_cast<int>(batch_size / 10);
-                    batch_size = batch_size == 1 ? new_batch_size == 0 : new_batch_size;
-                    accumulated_tuples_tokens = 0;
-                    start_index = 0;
-                    continue;
-                }
-
-                if (response.size() < batch_tuples.size()) {
-                    for (auto i = static_cast<int>(response.size()); i < batch_tuples.size(); i++) {
-                        response.push_back(nullptr);
-                    }
-                } else if (response.size() > batch_size) {
-                    auto new_response = nlohmann::json::array();
-                    for (auto i = 0; i < batch_size; i++) {
-                        new_response.push_back(response[i]);
+                    if (batch_tuples.size() == 1) {
+                        throw;
                     }
-                    response = new_response;
+                    // Shrink the following batches and recover this one by bisection; completed results are kept.
+                    BatchSizeController::RecordOverflow(controller_key, static_cast<int>(batch_tuples.size()),
+                                                        model_details.max_output_tokens);
+                    response = SplitAndComplete(batch_tuples, user_prompt, function_type, model);
                 }
 
-                auto output_tokens_per_tuple = Tiktoken::GetNumTokens(response.dump()) / batch_tuples.size();
-
-                batch_size = model_details.max_output_tokens / static_cast<int>(output_tokens_per_tuple);
+                start_index = end_index;
                 batch_tuples.clear();
-                accumulated_tuples_tokens = 0;
 
                 for (const auto& tuple : response) {
                     responses.push_back(tuple);
@@ -94,19 +197,7 @@ nlohmann::json ScalarFunctionBase::BatchAndComplete(const std::vector<nlohmann::
                 }
                 start_index += batch_size;
 
-                auto response = Complete(batch_tuples, user_prompt, function_type, model);
-
-                if (response.size() < batch_tuples.size()) {
-                    for (auto i = static_cast<int>(response.size()); i < batch_tuples.size(); i++) {
-                        response.push_back(nullptr);
-                    }
-                } else if (response.size() > batch_size) {
-                    auto new_response = nlohmann::json::array();
-                    for (auto i = 0; i < batch_size; i++) {
-                        new_response.push_back(response[i]);
-                    }
-                    response = new_response;
-                }
+                auto response = CompleteWithSplit(batch_tuples, user_prompt, function_type, model);
                 batch_tuples.clear();
                 for (const auto& tuple : response) {
                     responses.push_back(tuple);
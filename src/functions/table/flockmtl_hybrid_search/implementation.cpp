@@ -0,0 +1,288 @@
+#include "flockmtl/functions/table/flockmtl_hybrid_search.hpp"
+#include "flockmtl/core/config.hpp"
+#include "flockmtl/functions/aggregate/flockmtl_knn_agg.hpp"
+#include "flockmtl/functions/scalar/fusion_combanz.hpp"
+#include "flockmtl/functions/scalar/fusion_combmed.hpp"
+#include "flockmtl/functions/scalar/fusion_combmnz.hpp"
+#include "flockmtl/functions/scalar/fusion_combsum.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/common/types/value_map.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+
+#include <future>
+
+namespace flockmtl {
+
+FlockmtlHybridSearch::Fusion FlockmtlHybridSearch::ParseFusion(const std::string& fusion) {
+    if (fusion == "rrf") {
+        return Fusion::RRF;
+    }
+    if (fusion == "combsum") {
+        return Fusion::COMBSUM;
+    }
+    if (fusion == "combmnz") {
+        return Fusion::COMBMNZ;
+    }
+    if (fusion == "combmed") {
+        return Fusion::COMBMED;
+    }
+    if (fusion == "combanz") {
+        return Fusion::COMBANZ;
+    }
+    throw std::runtime_error("`fusion` must be one of rrf, combsum, combmnz, combmed or combanz.");
+}
+
+static std::vector<double> Normalize(const std::vector<double>& scores, const FusionNormalize::Mode mode) {
+    if (mode == FusionNormalize::Mode::RANK) {
+        return FusionNormalize::NormalizeRanks(scores);
+    }
+    FusionNormalize::ScoreStatistics statistics;
+    for (const auto score : scores) {
+        if (!std::isnan(score)) {
+            statistics.Update(score);
+        }
+    }
+    std::vector<double> normalized(scores.size());
+    for (size_t row = 0; row < scores.size(); row++) {
+        normalized[row] = std::isnan(scores[row]) ? scores[row] : statistics.Normalize(scores[row], mode);
+    }
+    return normalized;
+}
+
+std::vector<FusionRRFTopN::FusedEntry> FlockmtlHybridSearch::Fuse(const std::vector<std::vector<double>>& scores,
+                                                                  const size_t num_rows, const Options& options) {
+    if (options.fusion == Fusion::RRF) {
+        FusionRRFTopN::Options rrf_options;
+        rrf_options.top_n = options.k;
+        return FusionRRFTopN::FuseTopN(scores, num_rows, rrf_options);
+    }
+
+    void (*fuse)(duckdb::DataChunk&, double*);
+    switch (options.fusion) {
+    case Fusion::COMBSUM:
+        fuse = FusionCombSUM::Fuse;
+        break;
+    case Fusion::COMBMNZ:
+        fuse = FusionCombMNZ::Fuse;
+        break;
+    case Fusion::COMBMED:
+        fuse = FusionCombMED::Fuse;
+        break;
+    default:
+        fuse = FusionCombANZ::Fuse;
+        break;
+    }
+
+    // The score-based fusions treat NaN as not retrieved, like NULL
+    std::vector<std::vector<double>> normalized;
+    duckdb::vector<duckdb::LogicalType> types;
+    for (const auto& column : scores) {
+        normalized.push_back(Normalize(column, options.normalize));
+        types.push_back(duckdb::LogicalType::DOUBLE);
+    }
+    std::vector<double> fused(num_rows);
+    duckdb::DataChunk chunk;
+    chunk.Initialize(duckdb::Allocator::DefaultAllocator(), types);
+    for (size_t offset = 0; offset < num_rows; offset += STANDARD_VECTOR_SIZE) {
+        const auto count = std::min<size_t>(STANDARD_VECTOR_SIZE, num_rows - offset);
+        chunk.Reset();
+        for (size_t column = 0; column < normalized.size(); column++) {
+            std::copy_n(normalized[column].begin() + offset, count,
+                        duckdb::FlatVector::GetData<double>(chunk.data[column]));
+        }
+        chunk.SetCardinality(count);
+        fuse(chunk, fused.data() + offset);
+    }
+
+    std::vector<FusionRRFTopN::FusedEntry> best;
+    for (size_t row = 0; row < num_rows; row++) {
+        best.push_back({row, fused[row]});
+    }
+    const auto is_better = [](const FusionRRFTopN::FusedEntry& a, const FusionRRFTopN::FusedEntry& b) {
+        return a.score > b.score || (a.score == b.score && a.row < b.row);
+    };
+    const auto top = std::min(options.k, best.size());
+    std::partial_sort(best.begin(), best.begin() + top, best.end(), is_better);
+    best.resize(top);
+    return best;
+}
+
+static void ThrowOnError(duckdb::QueryResult& result) {
+    if (result.HasError()) {
+        throw std::runtime_error(result.GetError());
+    }
+}
+
+duckdb::unique_ptr<duckdb::FunctionData> FlockmtlHybridSearch::Bind(duckdb::ClientContext& context,
+                                                                    duckdb::TableFunctionBindInput& input,
+                                                                    duckdb::vector<duckdb::LogicalType>& return_types,
+                                                                    duckdb::vector<std::string>& names) {
+    for (const auto& argument : input.inputs) {
+        if (argument.IsNull()) {
+            throw std::runtime_error(
+                "Expected a table name, an id column, an embedding column, a text query and a query vector.");
+        }
+    }
+    // The table is looked up like the query would, so its catalog and schema are known even when left out
+    const auto qualified_name = duckdb::QualifiedName::Parse(input.inputs[0].ToString());
+    auto& table = duckdb::Catalog::GetEntry<duckdb::TableCatalogEntry>(context, qualified_name.catalog,
+                                                                       qualified_name.schema, qualified_name.name);
+    const auto& catalog = table.ParentCatalog().GetName();
+    const auto& schema = table.ParentSchema().name;
+    // The retrievers run on connections of their own, which see neither the temporary catalog nor the open transaction
+    if (table.temporary || catalog == duckdb::TEMP_CATALOG) {
+        throw std::runtime_error(duckdb_fmt::format(
+            "Table '{}' is temporary; flockmtl_hybrid_search only reads committed tables of a persistent catalog.",
+            input.inputs[0].ToString()));
+    }
+    if (table.timestamp >= duckdb::TRANSACTION_ID_START) {
+        throw std::runtime_error(duckdb_fmt::format(
+            "Table '{}' was created in the open transaction; flockmtl_hybrid_search only reads committed tables.",
+            input.inputs[0].ToString()));
+    }
+    const auto id_column = input.inputs[1].ToString();
+    if (!table.ColumnExists(id_column)) {
+        throw std::runtime_error(
+            duckdb_fmt::format("Table '{}' has no column '{}'.", input.inputs[0].ToString(), id_column));
+    }
+
+    auto bind_data = duckdb::make_uniq<BindData>();
+    bind_data->table_name = duckdb::KeywordHelper::WriteOptionallyQuoted(catalog) + "." +
+                            duckdb::KeywordHelper::WriteOptionallyQuoted(schema) + "." +
+                            duckdb::KeywordHelper::WriteOptionallyQuoted(table.name);
+    bind_data->id_column = duckdb::KeywordHelper::WriteOptionallyQuoted(id_column);
+    bind_data->embedding_column = duckdb::KeywordHelper::WriteOptionallyQuoted(input.inputs[2].ToString());
+    bind_data->query_text = input.inputs[3].ToString();
+    bind_data->query_vector = FlockmtlKnnAgg::GetQueryVector(input.inputs[4]);
+
+    auto& options = bind_data->options;
+    bind_data->metric = "cosine";
+    for (const auto& [name, value] : input.named_parameters) {
+        if (name == "k" || name == "candidates") {
+            if (value.IsNull() || value.GetValue<int64_t>() <= 0) {
+                throw std::runtime_error("`" + name + "` must be a positive integer.");
+            }
+            auto& option = name == "k" ? options.k : options.candidates;
+            option = value.GetValue<int64_t>();
+        } else if (name == "fusion") {
+            options.fusion = ParseFusion(value.ToString());
+        } else if (name == "normalize") {
+            options.normalize = FusionNormalize::ParseMode(value.ToString());
+        } else if (name == "metric") {
+            bind_data->metric = value.ToString();
+        }
+    }
+    options.metric = Distance::ParseMetric(bind_data->metric);
+
+    // PRAGMA create_fts_index puts the BM25 macro of `catalog.schema.table` into the schema
+    // catalog.fts_<schema>_<table>
+    const auto fts_schema = "fts_" + schema + "_" + table.name;
+    if (!duckdb::Catalog::GetSchema(context, catalog, fts_schema, duckdb::OnEntryNotFound::RETURN_NULL)) {
+        throw std::runtime_error(duckdb_fmt::format(
+            "Table '{}' has no full-text index; create one with PRAGMA create_fts_index.", input.inputs[0].ToString()));
+    }
+    bind_data->fts_schema = duckdb::KeywordHelper::WriteOptionallyQuoted(catalog) + "." +
+                            duckdb::KeywordHelper::WriteOptionallyQuoted(fts_schema);
+
+    names = {"id", "score", "rank", "bm25", "distance"};
+    return_types = {table.GetColumn(id_column).Type(), duckdb::LogicalType::DOUBLE, duckdb::LogicalType::BIGINT,
+                    duckdb::LogicalType::DOUBLE, duckdb::LogicalType::DOUBLE};
+    return std::move(bind_data);
+}
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState> FlockmtlHybridSearch::InitGlobal(duckdb::ClientContext&,
+                                                                                      duckdb::TableFunctionInitInput&) {
+    return duckdb::make_uniq<GlobalState>();
+}
+
+std::vector<FlockmtlHybridSearch::Result> FlockmtlHybridSearch::Search(const BindData& bind_data,
+                                                                      duckdb::DatabaseInstance& db) {
+    const auto& options = bind_data.options;
+    // DuckDB evaluates ORDER BY ... LIMIT with a bounded heap rather than a full sort
+    const auto lexical_sql = duckdb_fmt::format(
+        " SELECT id, score FROM (SELECT {0} AS id, {1}.match_bm25({0}, {2}) AS score FROM {3}) "
+        "  WHERE score IS NOT NULL ORDER BY score DESC LIMIT {4};",
+        bind_data.id_column, bind_data.fts_schema,
+        duckdb::Value(bind_data.query_text).ToSQLString(), bind_data.table_name, options.candidates);
+    duckdb::vector<duckdb::Value> query_values;
+    for (const auto element : bind_data.query_vector) {
+        query_values.push_back(duckdb::Value::FLOAT(element));
+    }
+    const auto vector_sql = duckdb_fmt::format(
+        " SELECT neighbour.id, neighbour.distance FROM (SELECT unnest(flockmtl_knn_agg({}, {}, {}, {}, {})) AS "
+        " neighbour FROM {});",
+        bind_data.id_column, bind_data.embedding_column,
+        duckdb::Value::LIST(duckdb::LogicalType::FLOAT, query_values).ToSQLString(), options.candidates,
+        duckdb::Value(bind_data.metric).ToSQLString(), bind_data.table_name);
+
+    // Table functions cannot run queries on the context executing them, so each retriever gets a connection of its own
+    // to the caller's database; the names in the queries are fully qualified.
+    const auto retrieve = [&db](const std::string& sql) {
+        duckdb::Connection con(db);
+        auto result = con.Query(sql);
+        ThrowOnError(*result);
+        return result;
+    };
+    auto lexical = std::async(std::launch::async, retrieve, lexical_sql);
+    auto vector = std::async(std::launch::async, retrieve, vector_sql);
+    const auto lexical_result = lexical.get();
+    const auto vector_result = vector.get();
+
+    // One row per document retrieved by either retriever, with NaN where the other did not return it
+    duckdb::value_map_t<size_t> rows;
+    std::vector<duckdb::Value> ids;
+    std::vector<std::vector<double>> scores(2);
+    const auto get_row = [&](const duckdb::Value& id) {
+        const auto [it, inserted] = rows.emplace(id, ids.size());
+        if (inserted) {
+            ids.push_back(id);
+            for (auto& column : scores) {
+                column.push_back(std::numeric_limits<double>::quiet_NaN());
+            }
+        }
+        return it->second;
+    };
+    for (duckdb::idx_t i = 0; i < lexical_result->RowCount(); i++) {
+        scores[0][get_row(lexical_result->GetValue(0, i))] = lexical_result->GetValue(1, i).GetValue<double>();
+    }
+    for (duckdb::idx_t i = 0; i < vector_result->RowCount(); i++) {
+        // closer is better, like a higher BM25 score
+        scores[1][get_row(vector_result->GetValue(0, i))] = -vector_result->GetValue(1, i).GetValue<double>();
+    }
+
+    std::vector<Result> results;
+    for (const auto& entry : Fuse(scores, ids.size(), options)) {
+        const auto bm25 = scores[0][entry.row];
+        const auto similarity = scores[1][entry.row];
+        results.push_back({ids[entry.row], entry.score,
+                           std::isnan(bm25) ? duckdb::Value(duckdb::LogicalType::DOUBLE) : duckdb::Value::DOUBLE(bm25),
+                           std::isnan(similarity) ? duckdb::Value(duckdb::LogicalType::DOUBLE)
+                                                  : duckdb::Value::DOUBLE(-similarity)});
+    }
+    return results;
+}
+
+void FlockmtlHybridSearch::Execute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                                   duckdb::DataChunk& output) {
+    auto& state = data.global_state->Cast<GlobalState>();
+    if (!state.done) {
+        state.results = Search(data.bind_data->Cast<BindData>(), *context.db);
+        state.done = true;
+    }
+
+    duckdb::idx_t count = 0;
+    for (; state.offset < state.results.size() && count < STANDARD_VECTOR_SIZE; state.offset++, count++) {
+        const auto& result = state.results[state.offset];
+        output.SetValue(0, count, result.id);
+        output.SetValue(1, count, duckdb::Value::DOUBLE(result.score));
+        output.SetValue(2, count, duckdb::Value::BIGINT(static_cast<int64_t>(state.offset + 1)));
+        output.SetValue(3, count, result.bm25);
+        output.SetValue(4, count, result.distance);
+    }
+    output.SetCardinality(count);
+}
+
+} // namespace flockmtl
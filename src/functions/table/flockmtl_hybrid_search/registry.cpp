@@ -0,0 +1,22 @@
+#include "flockmtl/functions/table/flockmtl_hybrid_search.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterFlockmtlHybridSearch(duckdb::DatabaseInstance& db) {
+    // table, id column, embedding column, text query and query vector
+    duckdb::TableFunction function("flockmtl_hybrid_search",
+                                   {duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR,
+                                    duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR,
+                                    duckdb::LogicalType::ANY},
+                                   FlockmtlHybridSearch::Execute, FlockmtlHybridSearch::Bind,
+                                   FlockmtlHybridSearch::InitGlobal);
+    function.named_parameters["k"] = duckdb::LogicalType::BIGINT;
+    function.named_parameters["candidates"] = duckdb::LogicalType::BIGINT;
+    function.named_parameters["fusion"] = duckdb::LogicalType::VARCHAR;
+    function.named_parameters["normalize"] = duckdb::LogicalType::VARCHAR;
+    function.named_parameters["metric"] = duckdb::LogicalType::VARCHAR;
+    duckdb::ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace flockmtl
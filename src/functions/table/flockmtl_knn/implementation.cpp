@@ -0,0 +1,92 @@
+#include "flockmtl/functions/table/flockmtl_knn.hpp"
+#include "flockmtl/functions/aggregate/flockmtl_knn_agg.hpp"
+
+#include "duckdb/parser/keyword_helper.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+
+namespace flockmtl {
+
+std::string FlockmtlKnn::QuoteQualifiedName(const std::string& name) {
+    const auto qualified_name = duckdb::QualifiedName::Parse(name);
+    std::string quoted;
+    for (const auto& part : {qualified_name.catalog, qualified_name.schema}) {
+        if (!part.empty()) {
+            quoted += duckdb::KeywordHelper::WriteOptionallyQuoted(part) + ".";
+        }
+    }
+    return quoted + duckdb::KeywordHelper::WriteOptionallyQuoted(qualified_name.name);
+}
+
+duckdb::unique_ptr<duckdb::TableRef> FlockmtlKnn::BindReplace(duckdb::ClientContext& context,
+                                                              duckdb::TableFunctionBindInput& input) {
+    for (const auto& argument : input.inputs) {
+        if (argument.IsNull()) {
+            throw std::runtime_error("Expected a table name, an embedding column and a query vector.");
+        }
+    }
+
+    int64_t k = 10;
+    std::string metric = "cosine";
+    std::string rescore;
+    int64_t oversample = 4;
+    for (const auto& [name, value] : input.named_parameters) {
+        if (name == "k") {
+            k = value.IsNull() ? 0 : value.GetValue<int64_t>();
+        } else if (name == "metric") {
+            metric = value.ToString();
+        } else if (name == "rescore") {
+            rescore = value.IsNull() ? "" : value.ToString();
+        } else if (name == "oversample") {
+            oversample = value.IsNull() ? 0 : value.GetValue<int64_t>();
+        }
+    }
+    if (k <= 0) {
+        throw std::runtime_error("`k` must be a positive integer.");
+    }
+    if (oversample <= 0) {
+        throw std::runtime_error("`oversample` must be a positive integer.");
+    }
+    Distance::ParseMetric(metric);
+
+    // Validated here so a bad query vector is reported against flockmtl_knn rather than the rewritten query.
+    const auto query = FlockmtlKnnAgg::GetQueryVector(input.inputs[2]);
+    duckdb::vector<duckdb::Value> query_values;
+    for (const auto element : query) {
+        query_values.push_back(duckdb::Value::FLOAT(element));
+    }
+
+    const auto table = QuoteQualifiedName(input.inputs[0].ToString());
+    const auto column = duckdb::KeywordHelper::WriteOptionallyQuoted(input.inputs[1].ToString());
+    const auto query_sql = duckdb::Value::LIST(duckdb::LogicalType::FLOAT, query_values).ToSQLString();
+    const auto metric_sql = duckdb::Value(metric).ToSQLString();
+
+    // Each neighbour's id is the whole row, which unnest() expands back into the table's columns.
+    std::string sql;
+    if (rescore.empty()) {
+        sql = duckdb::StringUtil::Format(
+            "SELECT unnest(neighbour.id), neighbour.distance FROM (SELECT unnest(flockmtl_knn_agg(knn_input, "
+            "knn_input.%s, %s, %d, %s)) AS neighbour FROM %s AS knn_input) ORDER BY neighbour.distance",
+            column, query_sql, k, metric_sql, table);
+    } else {
+        // The (typically quantized) column shortlists k * oversample rows by rowid, which are then ranked again on the
+        // full-precision `rescore` column.
+        sql = duckdb::StringUtil::Format(
+            "SELECT unnest(neighbour.id), neighbour.distance FROM (SELECT unnest(flockmtl_knn_agg(knn_input, "
+            "knn_input.%s, %s, %d, %s)) AS neighbour FROM %s AS knn_input WHERE knn_input.rowid IN (SELECT "
+            "candidate.id FROM (SELECT unnest(flockmtl_knn_agg(shortlist.rowid, shortlist.%s, %s, %d, %s)) AS "
+            "candidate FROM %s AS shortlist))) ORDER BY neighbour.distance",
+            duckdb::KeywordHelper::WriteOptionallyQuoted(rescore), query_sql, k, metric_sql, table, column, query_sql,
+            k * oversample, metric_sql, table);
+    }
+
+    duckdb::Parser parser;
+    parser.ParseQuery(sql);
+    auto select = duckdb::unique_ptr_cast<duckdb::SQLStatement, duckdb::SelectStatement>(
+        std::move(parser.statements[0]));
+    return duckdb::make_uniq<duckdb::SubqueryRef>(std::move(select));
+}
+
+} // namespace flockmtl
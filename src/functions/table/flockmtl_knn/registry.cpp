@@ -0,0 +1,19 @@
+#include "flockmtl/functions/table/flockmtl_knn.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterFlockmtlKnn(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction function("flockmtl_knn",
+                                   {duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR,
+                                    duckdb::LogicalType::ANY},
+                                   nullptr, nullptr);
+    function.bind_replace = FlockmtlKnn::BindReplace;
+    function.named_parameters["k"] = duckdb::LogicalType::BIGINT;
+    function.named_parameters["metric"] = duckdb::LogicalType::VARCHAR;
+    function.named_parameters["rescore"] = duckdb::LogicalType::VARCHAR;
+    function.named_parameters["oversample"] = duckdb::LogicalType::BIGINT;
+    duckdb::ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,106 @@
+#include "flockmtl/functions/table/flockmtl_profile.hpp"
+
+namespace flockmtl {
+
+duckdb::unique_ptr<duckdb::FunctionData> FlockmtlProfile::Bind(duckdb::ClientContext& context,
+                                                               duckdb::TableFunctionBindInput& input,
+                                                               duckdb::vector<duckdb::LogicalType>& return_types,
+                                                               duckdb::vector<std::string>& names) {
+    names = {"query_id",           "function",       "requests",       "failed_requests", "batches",
+             "tuples",             "avg_batch_size", "max_batch_size", "prompt_tokens",   "completion_tokens",
+             "cost",               "retries",        "cache_hits",     "escalations",     "escalation_rate",
+             "total_latency_ms",   "p50_latency_ms", "p95_latency_ms", "p99_latency_ms",  "max_latency_ms",
+             "latency_histogram"};
+    return_types = {duckdb::LogicalType::UBIGINT, duckdb::LogicalType::VARCHAR};
+    for (auto i = 0; i < 4; i++) {
+        return_types.push_back(duckdb::LogicalType::BIGINT);
+    }
+    return_types.push_back(duckdb::LogicalType::DOUBLE);
+    for (auto i = 0; i < 3; i++) {
+        return_types.push_back(duckdb::LogicalType::BIGINT);
+    }
+    return_types.push_back(duckdb::LogicalType::DOUBLE);
+    for (auto i = 0; i < 3; i++) {
+        return_types.push_back(duckdb::LogicalType::BIGINT);
+    }
+    for (auto i = 0; i < 6; i++) {
+        return_types.push_back(duckdb::LogicalType::DOUBLE);
+    }
+    return_types.push_back(duckdb::LogicalType::MAP(duckdb::LogicalType::DOUBLE, duckdb::LogicalType::BIGINT));
+    return duckdb::make_uniq<duckdb::TableFunctionData>();
+}
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState> FlockmtlProfile::InitGlobal(duckdb::ClientContext& context,
+                                                                                 duckdb::TableFunctionInitInput&) {
+    auto state = duckdb::make_uniq<GlobalState>();
+    const auto current_query = context.transaction.GetActiveQuery();
+    for (auto& profile : Profiler::GetProfiles(&context)) {
+        if (profile.query_id == current_query) {
+            continue;
+        }
+        for (auto& call_site : profile.call_sites) {
+            state->rows.emplace_back(profile.query_id, std::move(call_site));
+        }
+    }
+    return std::move(state);
+}
+
+static double ToMilliseconds(const std::chrono::microseconds duration) {
+    return static_cast<double>(duration.count()) / 1000.0;
+}
+
+void FlockmtlProfile::Execute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                              duckdb::DataChunk& output) {
+    auto& state = data.global_state->Cast<GlobalState>();
+    duckdb::idx_t count = 0;
+    for (; state.offset < state.rows.size() && count < STANDARD_VECTOR_SIZE; state.offset++, count++) {
+        const auto& [query_id, call_site] = state.rows[state.offset];
+        const auto& [function_name, profile] = call_site;
+
+        // The histogram maps each non-empty bucket's upper bound in milliseconds to its number of requests.
+        duckdb::vector<duckdb::Value> bounds;
+        duckdb::vector<duckdb::Value> counts;
+        for (size_t bucket = 0; bucket < CallSiteProfile::kLatencyBuckets; bucket++) {
+            if (profile.latency_histogram[bucket] > 0) {
+                bounds.push_back(duckdb::Value::DOUBLE(ToMilliseconds(CallSiteProfile::GetBucketUpperBound(bucket))));
+                counts.push_back(duckdb::Value::BIGINT(profile.latency_histogram[bucket]));
+            }
+        }
+
+        duckdb::idx_t column = 0;
+        output.SetValue(column++, count, duckdb::Value::UBIGINT(query_id));
+        output.SetValue(column++, count, duckdb::Value(function_name));
+        output.SetValue(column++, count, duckdb::Value::BIGINT(profile.requests));
+        output.SetValue(column++, count, duckdb::Value::BIGINT(profile.failed_requests));
+        output.SetValue(column++, count, duckdb::Value::BIGINT(profile.batches));
+        output.SetValue(column++, count, duckdb::Value::BIGINT(profile.tuples));
+        output.SetValue(column++, count,
+                        profile.batches > 0 ? duckdb::Value::DOUBLE(static_cast<double>(profile.tuples) /
+                                                                    static_cast<double>(profile.batches))
+                                            : duckdb::Value(duckdb::LogicalType::DOUBLE));
+        output.SetValue(column++, count, duckdb::Value::BIGINT(profile.max_batch_size));
+        output.SetValue(column++, count, duckdb::Value::BIGINT(profile.prompt_tokens));
+        output.SetValue(column++, count, duckdb::Value::BIGINT(profile.completion_tokens));
+        output.SetValue(column++, count, duckdb::Value::DOUBLE(profile.cost));
+        output.SetValue(column++, count, duckdb::Value::BIGINT(profile.retries));
+        output.SetValue(column++, count, duckdb::Value::BIGINT(profile.cache_hits));
+        output.SetValue(column++, count, duckdb::Value::BIGINT(profile.escalations));
+        output.SetValue(column++, count,
+                        profile.cascaded_tuples > 0
+                            ? duckdb::Value::DOUBLE(static_cast<double>(profile.escalations) /
+                                                    static_cast<double>(profile.cascaded_tuples))
+                            : duckdb::Value(duckdb::LogicalType::DOUBLE));
+        output.SetValue(column++, count, duckdb::Value::DOUBLE(ToMilliseconds(profile.total_latency)));
+        for (const auto percentile : {0.5, 0.95, 0.99}) {
+            output.SetValue(column++, count,
+                            duckdb::Value::DOUBLE(ToMilliseconds(profile.GetLatencyPercentile(percentile))));
+        }
+        output.SetValue(column++, count, duckdb::Value::DOUBLE(ToMilliseconds(profile.max_latency)));
+        output.SetValue(column++, count,
+                        duckdb::Value::MAP(duckdb::LogicalType::DOUBLE, duckdb::LogicalType::BIGINT, std::move(bounds),
+                                           std::move(counts)));
+    }
+    output.SetCardinality(count);
+}
+
+} // namespace flockmtl
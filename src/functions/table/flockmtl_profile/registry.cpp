@@ -0,0 +1,12 @@
+#include "flockmtl/functions/table/flockmtl_profile.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterFlockmtlProfile(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction function("flockmtl_profile", {}, FlockmtlProfile::Execute, FlockmtlProfile::Bind,
+                                   FlockmtlProfile::InitGlobal);
+    duckdb::ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace flockmtl
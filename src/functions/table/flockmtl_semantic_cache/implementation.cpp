@@ -0,0 +1,42 @@
+#include "flockmtl/functions/table/flockmtl_semantic_cache.hpp"
+#include "flockmtl/core/config.hpp"
+
+namespace flockmtl {
+
+duckdb::unique_ptr<duckdb::FunctionData> FlockmtlSemanticCache::Bind(duckdb::ClientContext& context,
+                                                                     duckdb::TableFunctionBindInput& input,
+                                                                     duckdb::vector<duckdb::LogicalType>& return_types,
+                                                                     duckdb::vector<std::string>& names) {
+    names = {"entries", "lookups", "hits", "misses", "hit_rate"};
+    return_types = {duckdb::LogicalType::BIGINT, duckdb::LogicalType::BIGINT, duckdb::LogicalType::BIGINT,
+                    duckdb::LogicalType::BIGINT, duckdb::LogicalType::DOUBLE};
+    return duckdb::make_uniq<duckdb::TableFunctionData>();
+}
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState>
+FlockmtlSemanticCache::InitGlobal(duckdb::ClientContext& context, duckdb::TableFunctionInitInput&) {
+    return duckdb::make_uniq<GlobalState>();
+}
+
+void FlockmtlSemanticCache::Execute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                                    duckdb::DataChunk& output) {
+    auto& state = data.global_state->Cast<GlobalState>();
+    if (state.done) {
+        output.SetCardinality(0);
+        return;
+    }
+    state.done = true;
+
+    const auto statistics = Config::GetSemanticCache(context)->GetStatistics();
+    output.SetValue(0, 0, duckdb::Value::BIGINT(statistics.entries));
+    output.SetValue(1, 0, duckdb::Value::BIGINT(statistics.lookups));
+    output.SetValue(2, 0, duckdb::Value::BIGINT(statistics.hits));
+    output.SetValue(3, 0, duckdb::Value::BIGINT(statistics.lookups - statistics.hits));
+    output.SetValue(4, 0,
+                    statistics.lookups > 0 ? duckdb::Value::DOUBLE(static_cast<double>(statistics.hits) /
+                                                                   static_cast<double>(statistics.lookups))
+                                           : duckdb::Value(duckdb::LogicalType::DOUBLE));
+    output.SetCardinality(1);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,12 @@
+#include "flockmtl/functions/table/flockmtl_semantic_cache.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterFlockmtlSemanticCache(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction function("flockmtl_semantic_cache", {}, FlockmtlSemanticCache::Execute,
+                                   FlockmtlSemanticCache::Bind, FlockmtlSemanticCache::InitGlobal);
+    duckdb::ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,314 @@
+#include "flockmtl/functions/table/flockmtl_vector_index.hpp"
+#include "flockmtl/core/config.hpp"
+#include "flockmtl/functions/aggregate/flockmtl_knn_agg.hpp"
+#include "flockmtl/functions/table/flockmtl_knn.hpp"
+
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+#include "duckdb/storage/object_cache.hpp"
+
+namespace flockmtl {
+
+// The loaded version of an index, kept in the object cache of its database so it is freed with it.
+class VectorIndexEntry : public duckdb::ObjectCacheEntry {
+public:
+    static std::string ObjectType() { return "flockmtl_vector_index"; }
+    std::string GetObjectType() override { return ObjectType(); }
+
+    std::mutex mutex;
+    // Creation time of the loaded version
+    std::string version;
+    std::shared_ptr<const HnswIndex> index;
+};
+
+static std::string GetCacheKey(const std::string& index_name) { return "flockmtl_vector_index:" + index_name; }
+
+static std::string GetIndexTable() { return Config::get_schema_name() + "." + Config::get_vector_indexes_table_name(); }
+
+static std::string GetPagesTable() {
+    return Config::get_schema_name() + "." + Config::get_vector_index_pages_table_name();
+}
+
+static std::string GetIndexName(const duckdb::Value& value) {
+    if (value.IsNull() || value.ToString().empty()) {
+        throw std::runtime_error("The index name must not be empty.");
+    }
+    return value.ToString();
+}
+
+static int64_t GetPositiveParameter(const duckdb::named_parameter_map_t& parameters, const std::string& name,
+                                    const int64_t default_value) {
+    const auto it = parameters.find(name);
+    if (it == parameters.end()) {
+        return default_value;
+    }
+    if (it->second.IsNull() || it->second.GetValue<int64_t>() <= 0) {
+        throw std::runtime_error("`" + name + "` must be a positive integer.");
+    }
+    return it->second.GetValue<int64_t>();
+}
+
+static void ThrowOnError(duckdb::QueryResult& result) {
+    if (result.HasError()) {
+        throw std::runtime_error(result.GetError());
+    }
+}
+
+// Streams the non-NULL embeddings of `column` to `visit(rowid, vector, dimensions)` rather than materializing them.
+template <class VISIT>
+static void ScanEmbeddings(duckdb::Connection& con, const std::string& table_name, const std::string& column_name,
+                           VISIT&& visit) {
+    auto result = con.SendQuery(duckdb_fmt::format("SELECT rowid, CAST({0} AS FLOAT[]) FROM {1} WHERE {0} IS NOT NULL;",
+                                                   duckdb::KeywordHelper::WriteOptionallyQuoted(column_name),
+                                                   FlockmtlKnn::QuoteQualifiedName(table_name)));
+    ThrowOnError(*result);
+    while (auto chunk = result->Fetch()) {
+        if (chunk->size() == 0) {
+            break;
+        }
+        chunk->Flatten();
+        const auto rowids = duckdb::FlatVector::GetData<int64_t>(chunk->data[0]);
+        const auto entries = duckdb::FlatVector::GetData<duckdb::list_entry_t>(chunk->data[1]);
+        auto& child = duckdb::ListVector::GetEntry(chunk->data[1]);
+        const auto child_data = duckdb::FlatVector::GetData<float>(child);
+        const auto& child_validity = duckdb::FlatVector::Validity(child);
+        for (duckdb::idx_t row = 0; row < chunk->size(); row++) {
+            const auto& entry = entries[row];
+            if (!child_validity.CheckAllValid(entry.offset + entry.length, entry.offset)) {
+                throw std::runtime_error("Embeddings must not contain NULL values.");
+            }
+            visit(rowids[row], child_data + entry.offset, static_cast<size_t>(entry.length));
+        }
+    }
+    ThrowOnError(*result);
+}
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState> FlockmtlVectorIndex::InitGlobal(duckdb::ClientContext&,
+                                                                                     duckdb::TableFunctionInitInput&) {
+    return duckdb::make_uniq<GlobalState>();
+}
+
+std::shared_ptr<const HnswIndex> FlockmtlVectorIndex::Load(duckdb::ClientContext& context,
+                                                           const std::string& index_name) {
+    duckdb::Connection con(*context.db);
+    const auto name = duckdb::Value(index_name).ToSQLString();
+    auto result = con.Query(
+        duckdb_fmt::format(" SELECT created_at::VARCHAR FROM {} WHERE index_name = {};", GetIndexTable(), name));
+    ThrowOnError(*result);
+    if (result->RowCount() == 0) {
+        throw std::runtime_error(duckdb_fmt::format("Vector index '{}' doesn't exist.", index_name));
+    }
+    const auto version = result->GetValue(0, 0).ToString();
+    const auto entry =
+        duckdb::ObjectCache::GetObjectCache(context).GetOrCreate<VectorIndexEntry>(GetCacheKey(index_name));
+    // Held while loading, so concurrent searches of a new version load it once
+    std::lock_guard<std::mutex> guard(entry->mutex);
+    if (entry->index && entry->version == version) {
+        return entry->index;
+    }
+
+    result = con.Query(
+        duckdb_fmt::format(" SELECT data FROM {} WHERE index_name = {} ORDER BY page;", GetPagesTable(), name));
+    ThrowOnError(*result);
+    std::string data;
+    for (duckdb::idx_t page = 0; page < result->RowCount(); page++) {
+        data += duckdb::StringValue::Get(result->GetValue(0, page));
+    }
+    try {
+        entry->index = HnswIndex::Deserialize(data);
+    } catch (const std::exception& e) {
+        throw std::runtime_error(duckdb_fmt::format("Cannot load vector index '{}': {}", index_name, e.what()));
+    }
+    entry->version = version;
+    return entry->index;
+}
+
+duckdb::unique_ptr<duckdb::FunctionData>
+FlockmtlVectorIndex::CreateBind(duckdb::ClientContext& context, duckdb::TableFunctionBindInput& input,
+                                duckdb::vector<duckdb::LogicalType>& return_types,
+                                duckdb::vector<std::string>& names) {
+    for (const auto& argument : input.inputs) {
+        if (argument.IsNull()) {
+            throw std::runtime_error("Expected an index name, a table name and an embedding column.");
+        }
+    }
+    auto bind_data = duckdb::make_uniq<CreateBindData>();
+    bind_data->index_name = GetIndexName(input.inputs[0]);
+    bind_data->table_name = input.inputs[1].ToString();
+    bind_data->column_name = input.inputs[2].ToString();
+    bind_data->metric = "cosine";
+    if (const auto it = input.named_parameters.find("metric"); it != input.named_parameters.end()) {
+        bind_data->metric = it->second.ToString();
+    }
+    bind_data->options.metric = Distance::ParseMetric(bind_data->metric);
+    bind_data->options.m = GetPositiveParameter(input.named_parameters, "m", 16);
+    bind_data->options.ef_construction = GetPositiveParameter(input.named_parameters, "ef_construction", 200);
+    if (bind_data->options.m < 2) {
+        throw std::runtime_error("`m` must be at least 2.");
+    }
+
+    names = {"index_name", "vectors", "dimensions"};
+    return_types = {duckdb::LogicalType::VARCHAR, duckdb::LogicalType::BIGINT, duckdb::LogicalType::BIGINT};
+    return std::move(bind_data);
+}
+
+void FlockmtlVectorIndex::CreateExecute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                                        duckdb::DataChunk& output) {
+    auto& state = data.global_state->Cast<GlobalState>();
+    if (state.done) {
+        output.SetCardinality(0);
+        return;
+    }
+    state.done = true;
+    const auto& bind_data = data.bind_data->Cast<CreateBindData>();
+
+    // Table functions cannot run queries on the context executing them, so this goes through a connection of its own
+    // to the caller's database
+    duckdb::Connection con(*context.db);
+    auto existing = con.Query(duckdb_fmt::format(" SELECT index_name FROM {} WHERE index_name = {};", GetIndexTable(),
+                                                 duckdb::Value(bind_data.index_name).ToSQLString()));
+    ThrowOnError(*existing);
+    if (existing->RowCount() != 0) {
+        throw std::runtime_error(duckdb_fmt::format("Vector index '{}' already exist.", bind_data.index_name));
+    }
+
+    size_t dimensions = 0;
+    std::vector<float> vectors;
+    std::vector<int64_t> ids;
+    ScanEmbeddings(con, bind_data.table_name, bind_data.column_name,
+                   [&](int64_t rowid, const float* vector, size_t length) {
+                       if (dimensions == 0) {
+                           dimensions = length;
+                       }
+                       if (length != dimensions || length == 0) {
+                           throw std::runtime_error("All embeddings of a vector index must have the same, non-zero, "
+                                                    "number of dimensions.");
+                       }
+                       vectors.insert(vectors.end(), vector, vector + length);
+                       ids.push_back(rowid);
+                   });
+    if (ids.empty()) {
+        throw std::runtime_error(
+            duckdb_fmt::format("Table '{}' has no embeddings to index.", bind_data.table_name));
+    }
+
+    HnswIndex index(dimensions, bind_data.options);
+    index.Build(std::move(vectors), std::move(ids), duckdb::TaskScheduler::GetScheduler(context).NumberOfThreads());
+
+    // The graph and the vectors are split into pages, so no single value has to hold all of them
+    const auto serialized = index.Serialize();
+    con.BeginTransaction();
+    auto statement = con.Prepare(duckdb_fmt::format(
+        " INSERT INTO {} (index_name, table_name, column_name, metric, m, ef_construction, dimensions, vectors) "
+        " VALUES ($1, $2, $3, $4, $5, $6, $7, $8);",
+        GetIndexTable()));
+    if (statement->HasError()) {
+        throw std::runtime_error(statement->GetError());
+    }
+    duckdb::vector<duckdb::Value> values = {
+        duckdb::Value(bind_data.index_name),
+        duckdb::Value(bind_data.table_name),
+        duckdb::Value(bind_data.column_name),
+        duckdb::Value(bind_data.metric),
+        duckdb::Value::INTEGER(static_cast<int32_t>(bind_data.options.m)),
+        duckdb::Value::INTEGER(static_cast<int32_t>(bind_data.options.ef_construction)),
+        duckdb::Value::INTEGER(static_cast<int32_t>(dimensions)),
+        duckdb::Value::BIGINT(static_cast<int64_t>(index.Size()))};
+    ThrowOnError(*statement->Execute(values, false));
+    statement = con.Prepare(
+        duckdb_fmt::format(" INSERT INTO {} (index_name, page, data) VALUES ($1, $2, $3);", GetPagesTable()));
+    if (statement->HasError()) {
+        throw std::runtime_error(statement->GetError());
+    }
+    for (size_t offset = 0, page = 0; offset < serialized.size(); offset += kPageSize, page++) {
+        const auto size = std::min(kPageSize, serialized.size() - offset);
+        duckdb::vector<duckdb::Value> page_values = {
+            duckdb::Value(bind_data.index_name), duckdb::Value::INTEGER(static_cast<int32_t>(page)),
+            duckdb::Value::BLOB(reinterpret_cast<duckdb::const_data_ptr_t>(serialized.data() + offset), size)};
+        ThrowOnError(*statement->Execute(page_values, false));
+    }
+    con.Commit();
+
+    output.SetValue(0, 0, duckdb::Value(bind_data.index_name));
+    output.SetValue(1, 0, duckdb::Value::BIGINT(static_cast<int64_t>(index.Size())));
+    output.SetValue(2, 0, duckdb::Value::BIGINT(static_cast<int64_t>(dimensions)));
+    output.SetCardinality(1);
+}
+
+duckdb::unique_ptr<duckdb::FunctionData>
+FlockmtlVectorIndex::SearchBind(duckdb::ClientContext& context, duckdb::TableFunctionBindInput& input,
+                                duckdb::vector<duckdb::LogicalType>& return_types,
+                                duckdb::vector<std::string>& names) {
+    auto bind_data = duckdb::make_uniq<SearchBindData>();
+    bind_data->index = Load(context, GetIndexName(input.inputs[0]));
+    bind_data->query = FlockmtlKnnAgg::GetQueryVector(input.inputs[1]);
+    if (bind_data->query.size() != bind_data->index->Dimensions()) {
+        throw std::runtime_error("The query vector has " + std::to_string(bind_data->query.size()) +
+                                 " dimensions but the index has " + std::to_string(bind_data->index->Dimensions()) +
+                                 ".");
+    }
+    bind_data->k = GetPositiveParameter(input.named_parameters, "k", 10);
+    bind_data->ef_search = GetPositiveParameter(input.named_parameters, "ef_search", 64);
+
+    names = {"rowid", "distance", "rank"};
+    return_types = {duckdb::LogicalType::BIGINT, duckdb::LogicalType::DOUBLE, duckdb::LogicalType::BIGINT};
+    return std::move(bind_data);
+}
+
+void FlockmtlVectorIndex::SearchExecute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                                        duckdb::DataChunk& output) {
+    auto& state = data.global_state->Cast<GlobalState>();
+    if (!state.done) {
+        const auto& bind_data = data.bind_data->Cast<SearchBindData>();
+        state.neighbours = bind_data.index->Search(bind_data.query.data(), bind_data.k, bind_data.ef_search);
+        state.done = true;
+    }
+
+    duckdb::idx_t count = 0;
+    for (; state.offset < state.neighbours.size() && count < STANDARD_VECTOR_SIZE; state.offset++, count++) {
+        const auto& neighbour = state.neighbours[state.offset];
+        output.SetValue(0, count, duckdb::Value::BIGINT(neighbour.item));
+        output.SetValue(1, count, duckdb::Value::DOUBLE(neighbour.distance));
+        output.SetValue(2, count, duckdb::Value::BIGINT(static_cast<int64_t>(state.offset + 1)));
+    }
+    output.SetCardinality(count);
+}
+
+duckdb::unique_ptr<duckdb::FunctionData>
+FlockmtlVectorIndex::DropBind(duckdb::ClientContext& context, duckdb::TableFunctionBindInput& input,
+                              duckdb::vector<duckdb::LogicalType>& return_types, duckdb::vector<std::string>& names) {
+    auto bind_data = duckdb::make_uniq<DropBindData>();
+    bind_data->index_name = GetIndexName(input.inputs[0]);
+    names = {"dropped"};
+    return_types = {duckdb::LogicalType::BOOLEAN};
+    return std::move(bind_data);
+}
+
+void FlockmtlVectorIndex::DropExecute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                                      duckdb::DataChunk& output) {
+    auto& state = data.global_state->Cast<GlobalState>();
+    if (state.done) {
+        output.SetCardinality(0);
+        return;
+    }
+    state.done = true;
+    const auto& bind_data = data.bind_data->Cast<DropBindData>();
+
+    duckdb::Connection con(*context.db);
+    const auto name = duckdb::Value(bind_data.index_name).ToSQLString();
+    con.BeginTransaction();
+    ThrowOnError(*con.Query(duckdb_fmt::format(" DELETE FROM {} WHERE index_name = {};", GetPagesTable(), name)));
+    auto result = con.Query(duckdb_fmt::format(" DELETE FROM {} WHERE index_name = {};", GetIndexTable(), name));
+    ThrowOnError(*result);
+    con.Commit();
+    if (const auto entry = duckdb::ObjectCache::GetObjectCache(context).Get<VectorIndexEntry>(
+            GetCacheKey(bind_data.index_name))) {
+        std::lock_guard<std::mutex> guard(entry->mutex);
+        entry->index.reset();
+    }
+    // DELETE reports the number of deleted rows
+    output.SetValue(0, 0, duckdb::Value::BOOLEAN(result->GetValue(0, 0).GetValue<int64_t>() > 0));
+    output.SetCardinality(1);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,30 @@
+#include "flockmtl/functions/table/flockmtl_vector_index.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterFlockmtlVectorIndex(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction create_function(
+        "flockmtl_create_vector_index",
+        {duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR},
+        FlockmtlVectorIndex::CreateExecute, FlockmtlVectorIndex::CreateBind, FlockmtlVectorIndex::InitGlobal);
+    create_function.named_parameters["m"] = duckdb::LogicalType::BIGINT;
+    create_function.named_parameters["ef_construction"] = duckdb::LogicalType::BIGINT;
+    create_function.named_parameters["metric"] = duckdb::LogicalType::VARCHAR;
+    duckdb::ExtensionUtil::RegisterFunction(db, create_function);
+
+    duckdb::TableFunction search_function("flockmtl_vector_search",
+                                          {duckdb::LogicalType::VARCHAR, duckdb::LogicalType::ANY},
+                                          FlockmtlVectorIndex::SearchExecute, FlockmtlVectorIndex::SearchBind,
+                                          FlockmtlVectorIndex::InitGlobal);
+    search_function.named_parameters["k"] = duckdb::LogicalType::BIGINT;
+    search_function.named_parameters["ef_search"] = duckdb::LogicalType::BIGINT;
+    duckdb::ExtensionUtil::RegisterFunction(db, search_function);
+
+    duckdb::TableFunction drop_function("flockmtl_drop_vector_index", {duckdb::LogicalType::VARCHAR},
+                                        FlockmtlVectorIndex::DropExecute, FlockmtlVectorIndex::DropBind,
+                                        FlockmtlVectorIndex::InitGlobal);
+    duckdb::ExtensionUtil::RegisterFunction(db, drop_function);
+}
+
+} // namespace flockmtl
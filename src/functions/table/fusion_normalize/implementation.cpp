@@ -0,0 +1,225 @@
+#include "flockmtl/functions/table/fusion_normalize.hpp"
+#include "flockmtl/functions/scalar/fusion.hpp"
+
+namespace flockmtl {
+
+FusionNormalize::Mode FusionNormalize::ParseMode(const std::string& mode) {
+    if (mode == "minmax") {
+        return Mode::MIN_MAX;
+    }
+    if (mode == "zscore") {
+        return Mode::Z_SCORE;
+    }
+    if (mode == "rank") {
+        return Mode::RANK;
+    }
+    throw std::runtime_error("`mode` must be one of minmax, zscore or rank.");
+}
+
+void FusionNormalize::ScoreStatistics::Update(const double score) {
+    count++;
+    min = std::min(min, score);
+    max = std::max(max, score);
+    const auto delta = score - mean;
+    mean += delta / static_cast<double>(count);
+    m2 += delta * (score - mean);
+}
+
+void FusionNormalize::ScoreStatistics::Combine(const ScoreStatistics& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    // Chan et al.'s update for the mean and the sum of squared deviations of two partitions
+    const auto total = static_cast<double>(count + other.count);
+    const auto delta = other.mean - mean;
+    mean += delta * static_cast<double>(other.count) / total;
+    m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / total;
+    count += other.count;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+double FusionNormalize::ScoreStatistics::Normalize(const double score, const Mode mode) const {
+    switch (mode) {
+    case Mode::MIN_MAX:
+        return max > min ? (score - min) / (max - min) : 0.0;
+    case Mode::Z_SCORE: {
+        const auto standard_deviation = count > 0 ? std::sqrt(m2 / static_cast<double>(count)) : 0.0;
+        return standard_deviation > 0 ? (score - mean) / standard_deviation : 0.0;
+    }
+    default:
+        return score;
+    }
+}
+
+std::vector<double> FusionNormalize::NormalizeRanks(const std::vector<double>& scores) {
+    std::vector<size_t> order;
+    for (size_t row = 0; row < scores.size(); row++) {
+        if (!std::isnan(scores[row])) {
+            order.push_back(row);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](const size_t a, const size_t b) { return scores[a] > scores[b]; });
+
+    std::vector<double> normalized(scores.size(), std::numeric_limits<double>::quiet_NaN());
+    const auto count = static_cast<double>(order.size());
+    size_t rank = 0;
+    for (size_t position = 0; position < order.size(); position++) {
+        if (position == 0 || scores[order[position]] != scores[order[position - 1]]) {
+            rank = position + 1;
+        }
+        normalized[order[position]] = (count - static_cast<double>(rank) + 1) / count;
+    }
+    return normalized;
+}
+
+duckdb::unique_ptr<duckdb::FunctionData> FusionNormalize::Bind(duckdb::ClientContext& context,
+                                                               duckdb::TableFunctionBindInput& input,
+                                                               duckdb::vector<duckdb::LogicalType>& return_types,
+                                                               duckdb::vector<std::string>& names) {
+    if (input.input_table_types.size() < 2) {
+        throw std::runtime_error("Expected an input relation with a document column and one or more score columns.");
+    }
+    for (size_t i = 1; i < input.input_table_types.size(); i++) {
+        if (!input.input_table_types[i].IsNumeric()) {
+            throw std::runtime_error("Score column `" + input.input_table_names[i] + "` must be numeric.");
+        }
+    }
+
+    auto bind_data = duckdb::make_uniq<BindData>();
+    bind_data->mode = Mode::MIN_MAX;
+    if (const auto it = input.named_parameters.find("mode"); it != input.named_parameters.end()) {
+        bind_data->mode = ParseMode(it->second.ToString());
+    }
+    bind_data->input_types = input.input_table_types;
+
+    names = input.input_table_names;
+    return_types = {input.input_table_types[0]};
+    return_types.resize(input.input_table_types.size(), duckdb::LogicalType::DOUBLE);
+    return std::move(bind_data);
+}
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState>
+FusionNormalize::InitGlobal(duckdb::ClientContext& context, duckdb::TableFunctionInitInput& input) {
+    const auto& bind_data = input.bind_data->Cast<BindData>();
+    auto state = duckdb::make_uniq<GlobalState>();
+    state->rows =
+        duckdb::make_uniq<duckdb::ColumnDataCollection>(duckdb::Allocator::Get(context), bind_data.input_types);
+    state->statistics.resize(bind_data.input_types.size() - 1);
+    if (bind_data.mode == Mode::RANK) {
+        state->scores.resize(bind_data.input_types.size() - 1);
+    }
+    return std::move(state);
+}
+
+duckdb::unique_ptr<duckdb::LocalTableFunctionState>
+FusionNormalize::InitLocal(duckdb::ExecutionContext& context, duckdb::TableFunctionInitInput& input,
+                           duckdb::GlobalTableFunctionState* global_state) {
+    const auto& bind_data = input.bind_data->Cast<BindData>();
+    global_state->Cast<GlobalState>().barrier.Register();
+    auto state = duckdb::make_uniq<LocalState>();
+    state->statistics.resize(bind_data.input_types.size() - 1);
+    return std::move(state);
+}
+
+duckdb::OperatorResultType FusionNormalize::Buffer(duckdb::ExecutionContext& context, duckdb::TableFunctionInput& data,
+                                                   duckdb::DataChunk& input, duckdb::DataChunk& output) {
+    const auto& bind_data = data.bind_data->Cast<BindData>();
+    auto& global_state = data.global_state->Cast<GlobalState>();
+    auto& state = data.local_state->Cast<LocalState>();
+    const auto count = input.size();
+
+    std::vector<std::vector<double>> chunk_scores(input.ColumnCount() - 1);
+    for (duckdb::idx_t column = 1; column < input.ColumnCount(); column++) {
+        const FusionInput<double> scores(input.data[column], count, duckdb::LogicalType::DOUBLE);
+        auto& statistics = state.statistics[column - 1];
+        for (duckdb::idx_t row = 0; row < count; row++) {
+            const auto score = scores.Get(row, std::numeric_limits<double>::quiet_NaN());
+            if (!std::isnan(score)) {
+                statistics.Update(score);
+            }
+            if (bind_data.mode == Mode::RANK) {
+                chunk_scores[column - 1].push_back(score);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(global_state.mutex);
+    global_state.rows->Append(input);
+    if (bind_data.mode == Mode::RANK) {
+        for (size_t column = 0; column < chunk_scores.size(); column++) {
+            global_state.scores[column].insert(global_state.scores[column].end(), chunk_scores[column].begin(),
+                                               chunk_scores[column].end());
+        }
+    }
+
+    output.SetCardinality(0);
+    return duckdb::OperatorResultType::NEED_MORE_INPUT;
+}
+
+duckdb::OperatorFinalizeResultType FusionNormalize::Finalize(duckdb::ExecutionContext& context,
+                                                             duckdb::TableFunctionInput& data,
+                                                             duckdb::DataChunk& output) {
+    const auto& bind_data = data.bind_data->Cast<BindData>();
+    auto& global_state = data.global_state->Cast<GlobalState>();
+    auto& state = data.local_state->Cast<LocalState>();
+    if (!state.arrived) {
+        state.arrived = true;
+        {
+            std::lock_guard<std::mutex> lock(global_state.mutex);
+            for (size_t column = 0; column < state.statistics.size(); column++) {
+                global_state.statistics[column].Combine(state.statistics[column]);
+            }
+        }
+        state.finalizes = global_state.barrier.Arrive();
+        if (state.finalizes) {
+            for (auto& scores : global_state.scores) {
+                scores = NormalizeRanks(scores);
+            }
+            global_state.rows->InitializeScan(state.scan_state);
+            global_state.rows->InitializeScanChunk(state.scan_chunk);
+        }
+    }
+    if (!state.finalizes) {
+        output.SetCardinality(0);
+        return duckdb::OperatorFinalizeResultType::FINISHED;
+    }
+
+    state.scan_chunk.Reset();
+    if (!global_state.rows->Scan(state.scan_state, state.scan_chunk)) {
+        output.SetCardinality(0);
+        return duckdb::OperatorFinalizeResultType::FINISHED;
+    }
+
+    const auto count = state.scan_chunk.size();
+    output.data[0].Reference(state.scan_chunk.data[0]);
+    for (duckdb::idx_t column = 1; column < output.ColumnCount(); column++) {
+        const FusionInput<double> scores(state.scan_chunk.data[column], count, duckdb::LogicalType::DOUBLE);
+        const auto& statistics = global_state.statistics[column - 1];
+        auto& result = output.data[column];
+        auto result_data = duckdb::FlatVector::GetData<double>(result);
+        auto& validity = duckdb::FlatVector::Validity(result);
+        for (duckdb::idx_t row = 0; row < count; row++) {
+            auto score = scores.Get(row, std::numeric_limits<double>::quiet_NaN());
+            if (bind_data.mode == Mode::RANK) {
+                score = global_state.scores[column - 1][state.emitted + row];
+            } else if (!std::isnan(score)) {
+                score = statistics.Normalize(score, bind_data.mode);
+            }
+            if (std::isnan(score)) {
+                validity.SetInvalid(row);
+            } else {
+                result_data[row] = score;
+            }
+        }
+    }
+    output.SetCardinality(count);
+    state.emitted += count;
+    return duckdb::OperatorFinalizeResultType::HAVE_MORE_OUTPUT;
+}
+
+} // namespace flockmtl
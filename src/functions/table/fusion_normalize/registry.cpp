@@ -0,0 +1,15 @@
+#include "flockmtl/functions/table/fusion_normalize.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterFusionNormalize(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction function("fusion_normalize", {duckdb::LogicalType::TABLE}, nullptr, FusionNormalize::Bind,
+                                   FusionNormalize::InitGlobal, FusionNormalize::InitLocal);
+    function.in_out_function = FusionNormalize::Buffer;
+    function.in_out_function_final = FusionNormalize::Finalize;
+    function.named_parameters["mode"] = duckdb::LogicalType::VARCHAR;
+    duckdb::ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace flockmtl
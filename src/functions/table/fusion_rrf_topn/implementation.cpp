@@ -0,0 +1,245 @@
+#include "flockmtl/functions/table/fusion_rrf_topn.hpp"
+#include "flockmtl/functions/scalar/fusion.hpp"
+
+namespace flockmtl {
+
+std::vector<FusionRRFTopN::FusedEntry> FusionRRFTopN::FuseTopN(const std::vector<std::vector<double>>& scores,
+                                                               const size_t num_rows, const Options& options) {
+    std::vector<double> fused(num_rows);
+    std::vector<bool> retrieved(num_rows);
+    const auto depth = options.depth > 0 ? options.depth : num_rows;
+    std::vector<size_t> order;
+    order.reserve(std::min(depth, num_rows));
+
+    for (size_t column = 0; column < scores.size(); column++) {
+        const auto& column_scores = scores[column];
+        const auto weight = options.weights.empty() ? 1.0 : options.weights[column];
+        const auto ranks_higher = [&](const size_t a, const size_t b) {
+            return column_scores[a] > column_scores[b] || (column_scores[a] == column_scores[b] && a < b);
+        };
+
+        // keep the retriever's best `depth` rows in a heap whose top is the worst of them
+        order.clear();
+        for (size_t row = 0; row < num_rows; row++) {
+            if (std::isnan(column_scores[row])) {
+                continue;
+            }
+            if (order.size() < depth) {
+                order.push_back(row);
+                std::push_heap(order.begin(), order.end(), ranks_higher);
+            } else if (ranks_higher(row, order.front())) {
+                std::pop_heap(order.begin(), order.end(), ranks_higher);
+                order.back() = row;
+                std::push_heap(order.begin(), order.end(), ranks_higher);
+            }
+        }
+        std::sort_heap(order.begin(), order.end(), ranks_higher);
+
+        size_t rank = 0;
+        for (size_t position = 0; position < order.size(); position++) {
+            const auto row = order[position];
+            if (position == 0 || column_scores[row] != column_scores[order[position - 1]]) {
+                rank = position + 1;
+            }
+            fused[row] += weight / (options.k + static_cast<double>(rank));
+            retrieved[row] = true;
+        }
+    }
+
+    // keep the best top_n rows in a heap whose top is the worst of them
+    const auto is_better = [](const FusedEntry& a, const FusedEntry& b) {
+        return a.score > b.score || (a.score == b.score && a.row < b.row);
+    };
+    std::vector<FusedEntry> top;
+    top.reserve(std::min(options.top_n, num_rows));
+    for (size_t row = 0; row < num_rows; row++) {
+        if (!retrieved[row]) {
+            continue;
+        }
+        const FusedEntry entry {row, fused[row]};
+        if (top.size() < options.top_n) {
+            top.push_back(entry);
+            std::push_heap(top.begin(), top.end(), is_better);
+        } else if (is_better(entry, top.front())) {
+            std::pop_heap(top.begin(), top.end(), is_better);
+            top.back() = entry;
+            std::push_heap(top.begin(), top.end(), is_better);
+        }
+    }
+    std::sort_heap(top.begin(), top.end(), is_better);
+    return top;
+}
+
+duckdb::vector<duckdb::Value> FusionRRFTopN::GatherIds(duckdb::ColumnDataCollection& ids,
+                                                        const std::vector<FusedEntry>& fused) {
+    // visit the fused rows in input order, so a single pass over the collection finds all of them
+    std::vector<size_t> positions(fused.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        positions[i] = i;
+    }
+    std::sort(positions.begin(), positions.end(),
+              [&](const size_t a, const size_t b) { return fused[a].row < fused[b].row; });
+
+    duckdb::vector<duckdb::Value> fused_ids(fused.size());
+    size_t next = 0;
+    size_t chunk_start = 0;
+    for (auto& chunk : ids.Chunks()) {
+        for (; next < positions.size() && fused[positions[next]].row < chunk_start + chunk.size(); next++) {
+            fused_ids[positions[next]] = chunk.GetValue(0, fused[positions[next]].row - chunk_start);
+        }
+        if (next == positions.size()) {
+            break;
+        }
+        chunk_start += chunk.size();
+    }
+    return fused_ids;
+}
+
+duckdb::unique_ptr<duckdb::FunctionData> FusionRRFTopN::Bind(duckdb::ClientContext& context,
+                                                             duckdb::TableFunctionBindInput& input,
+                                                             duckdb::vector<duckdb::LogicalType>& return_types,
+                                                             duckdb::vector<std::string>& names) {
+    if (input.input_table_types.size() < 2) {
+        throw std::runtime_error("Expected an input relation with a document column and one or more score columns.");
+    }
+    for (size_t i = 1; i < input.input_table_types.size(); i++) {
+        if (!input.input_table_types[i].IsNumeric()) {
+            throw std::runtime_error("Score column `" + input.input_table_names[i] + "` must be numeric.");
+        }
+    }
+    const auto num_scores = input.input_table_types.size() - 1;
+
+    auto bind_data = duckdb::make_uniq<BindData>();
+    bind_data->id_type = input.input_table_types[0];
+    auto& options = bind_data->options;
+    auto depth_given = false;
+    for (const auto& [name, value] : input.named_parameters) {
+        if (value.IsNull()) {
+            throw std::runtime_error("`" + name + "` must not be NULL.");
+        }
+        if (name == "top_n") {
+            const auto top_n = value.GetValue<int64_t>();
+            if (top_n <= 0) {
+                throw std::runtime_error("`top_n` must be a positive integer.");
+            }
+            options.top_n = static_cast<size_t>(top_n);
+        } else if (name == "k") {
+            options.k = value.GetValue<double>();
+            if (!(options.k >= 0)) {
+                throw std::runtime_error("`k` must be a non-negative number.");
+            }
+        } else if (name == "depth") {
+            const auto depth = value.GetValue<int64_t>();
+            if (depth < 0) {
+                throw std::runtime_error("`depth` must be a non-negative integer.");
+            }
+            options.depth = static_cast<size_t>(depth);
+            depth_given = true;
+        } else if (name == "weights") {
+            for (const auto& weight : duckdb::ListValue::GetChildren(value)) {
+                if (weight.IsNull() || !(weight.GetValue<double>() >= 0)) {
+                    throw std::runtime_error("`weights` must be non-negative numbers.");
+                }
+                options.weights.push_back(weight.GetValue<double>());
+            }
+            if (options.weights.size() != num_scores) {
+                throw std::runtime_error("`weights` must have one weight per score column, expected " +
+                                         std::to_string(num_scores) + ".");
+            }
+        }
+    }
+
+    // A document outside every retriever's best top_n can still make the fused top_n, so the default window is never
+    // narrower than the output.
+    if (!depth_given) {
+        options.depth = std::max(options.depth, options.top_n);
+    }
+
+    names = {input.input_table_names[0], "score", "rank"};
+    return_types = {input.input_table_types[0], duckdb::LogicalType::DOUBLE, duckdb::LogicalType::BIGINT};
+    return std::move(bind_data);
+}
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState> FusionRRFTopN::InitGlobal(duckdb::ClientContext& context,
+                                                                               duckdb::TableFunctionInitInput& input) {
+    const auto& bind_data = input.bind_data->Cast<BindData>();
+    auto state = duckdb::make_uniq<GlobalState>();
+    const duckdb::vector<duckdb::LogicalType> id_types {bind_data.id_type};
+    state->ids = duckdb::make_uniq<duckdb::ColumnDataCollection>(duckdb::Allocator::Get(context), id_types);
+    return std::move(state);
+}
+
+duckdb::unique_ptr<duckdb::LocalTableFunctionState>
+FusionRRFTopN::InitLocal(duckdb::ExecutionContext& context, duckdb::TableFunctionInitInput& input,
+                         duckdb::GlobalTableFunctionState* global_state) {
+    global_state->Cast<GlobalState>().barrier.Register();
+    return duckdb::make_uniq<LocalState>();
+}
+
+duckdb::OperatorResultType FusionRRFTopN::Collect(duckdb::ExecutionContext& context, duckdb::TableFunctionInput& data,
+                                                  duckdb::DataChunk& input, duckdb::DataChunk& output) {
+    auto& state = data.global_state->Cast<GlobalState>();
+    const auto count = input.size();
+
+    duckdb::DataChunk ids;
+    ids.InitializeEmpty({input.data[0].GetType()});
+    ids.data[0].Reference(input.data[0]);
+    ids.SetCardinality(count);
+    // NULL scores become NaN, which FuseTopN reads as not retrieved
+    std::vector<std::vector<double>> scores(input.ColumnCount() - 1);
+    for (duckdb::idx_t column = 1; column < input.ColumnCount(); column++) {
+        const FusionInput<double> column_input(input.data[column], count, duckdb::LogicalType::DOUBLE);
+        auto& column_scores = scores[column - 1];
+        column_scores.reserve(count);
+        for (duckdb::idx_t row = 0; row < count; row++) {
+            column_scores.push_back(column_input.Get(row, std::numeric_limits<double>::quiet_NaN()));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.ids->Append(ids);
+    state.scores.resize(scores.size());
+    for (size_t column = 0; column < scores.size(); column++) {
+        state.scores[column].insert(state.scores[column].end(), scores[column].begin(), scores[column].end());
+    }
+
+    output.SetCardinality(0);
+    return duckdb::OperatorResultType::NEED_MORE_INPUT;
+}
+
+duckdb::OperatorFinalizeResultType FusionRRFTopN::Finalize(duckdb::ExecutionContext& context,
+                                                           duckdb::TableFunctionInput& data,
+                                                           duckdb::DataChunk& output) {
+    const auto& bind_data = data.bind_data->Cast<BindData>();
+    auto& global_state = data.global_state->Cast<GlobalState>();
+    auto& state = data.local_state->Cast<LocalState>();
+    if (!state.arrived) {
+        state.arrived = true;
+        state.finalizes = global_state.barrier.Arrive();
+        if (state.finalizes) {
+            state.fused = FuseTopN(global_state.scores, global_state.ids->Count(), bind_data.options);
+            state.fused_ids = GatherIds(*global_state.ids, state.fused);
+        }
+    }
+    if (!state.finalizes) {
+        output.SetCardinality(0);
+        return duckdb::OperatorFinalizeResultType::FINISHED;
+    }
+
+    const auto count = std::min<size_t>(state.fused.size() - state.offset, STANDARD_VECTOR_SIZE);
+    auto scores = duckdb::FlatVector::GetData<double>(output.data[1]);
+    auto ranks = duckdb::FlatVector::GetData<int64_t>(output.data[2]);
+    for (size_t i = 0; i < count; i++) {
+        const auto& entry = state.fused[state.offset + i];
+        output.data[0].SetValue(i, state.fused_ids[state.offset + i]);
+        scores[i] = entry.score;
+        ranks[i] = static_cast<int64_t>(state.offset + i + 1);
+    }
+    output.SetCardinality(count);
+    state.offset += count;
+
+    return state.offset < state.fused.size() ? duckdb::OperatorFinalizeResultType::HAVE_MORE_OUTPUT
+                                             : duckdb::OperatorFinalizeResultType::FINISHED;
+}
+
+} // namespace flockmtl
@@ -0,0 +1,18 @@
+#include "flockmtl/functions/table/fusion_rrf_topn.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterFusionRRFTopN(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction function("fusion_rrf_topn", {duckdb::LogicalType::TABLE}, nullptr, FusionRRFTopN::Bind,
+                                   FusionRRFTopN::InitGlobal, FusionRRFTopN::InitLocal);
+    function.in_out_function = FusionRRFTopN::Collect;
+    function.in_out_function_final = FusionRRFTopN::Finalize;
+    function.named_parameters["top_n"] = duckdb::LogicalType::BIGINT;
+    function.named_parameters["k"] = duckdb::LogicalType::DOUBLE;
+    function.named_parameters["weights"] = duckdb::LogicalType::LIST(duckdb::LogicalType::DOUBLE);
+    function.named_parameters["depth"] = duckdb::LogicalType::BIGINT;
+    duckdb::ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace flockmtl
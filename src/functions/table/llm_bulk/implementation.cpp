@@ -0,0 +1,306 @@
+#include "flockmtl/functions/table/llm_bulk.hpp"
+
+#include <cstring>
+
+#include "flockmtl/model_manager/batch_client.hpp"
+
+namespace flockmtl {
+
+template <LlmBulk::Kind KIND>
+duckdb::unique_ptr<duckdb::FunctionData> LlmBulk::Bind(duckdb::ClientContext& context,
+                                                       duckdb::TableFunctionBindInput& input,
+                                                       duckdb::vector<duckdb::LogicalType>& return_types,
+                                                       duckdb::vector<std::string>& names) {
+    // The input relation is passed separately; the remaining arguments are the model and prompt structs.
+    const auto structs = CastStructValuesToJson(input.inputs);
+    const size_t expected_structs = KIND == Kind::EMBEDDING ? 1 : 2;
+    if (structs.size() != expected_structs || input.input_table_types.empty()) {
+        throw std::runtime_error(KIND == Kind::EMBEDDING
+                                     ? "Expected an input relation and a model struct."
+                                     : "Expected an input relation, a model struct and a prompt struct.");
+    }
+
+    auto bind_data = duckdb::make_uniq<BindData>();
+    bind_data->kind = KIND;
+    bind_data->function_name = input.table_function.name;
+    bind_data->model_json = structs[0];
+    if (KIND != Kind::EMBEDDING) {
+        bind_data->user_prompt = PromptManager::CreatePromptDetails(structs[1]).prompt;
+    }
+    bind_data->input_names = input.input_table_names;
+    bind_data->input_types = input.input_table_types;
+
+    return_types = input.input_table_types;
+    names = input.input_table_names;
+    return_types.push_back(KIND == Kind::EMBEDDING ? duckdb::LogicalType::LIST(duckdb::LogicalType::DOUBLE)
+                                                   : duckdb::LogicalType::VARCHAR);
+    names.emplace_back("result");
+    return std::move(bind_data);
+}
+
+template duckdb::unique_ptr<duckdb::FunctionData>
+LlmBulk::Bind<LlmBulk::Kind::COMPLETE>(duckdb::ClientContext&, duckdb::TableFunctionBindInput&,
+                                       duckdb::vector<duckdb::LogicalType>&, duckdb::vector<std::string>&);
+template duckdb::unique_ptr<duckdb::FunctionData>
+LlmBulk::Bind<LlmBulk::Kind::FILTER>(duckdb::ClientContext&, duckdb::TableFunctionBindInput&,
+                                     duckdb::vector<duckdb::LogicalType>&, duckdb::vector<std::string>&);
+template duckdb::unique_ptr<duckdb::FunctionData>
+LlmBulk::Bind<LlmBulk::Kind::EMBEDDING>(duckdb::ClientContext&, duckdb::TableFunctionBindInput&,
+                                        duckdb::vector<duckdb::LogicalType>&, duckdb::vector<std::string>&);
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState> LlmBulk::InitGlobal(duckdb::ClientContext& context,
+                                                                         duckdb::TableFunctionInitInput& input) {
+    const auto& bind_data = input.bind_data->Cast<BindData>();
+    auto state = duckdb::make_uniq<GlobalState>();
+    state->rows =
+        duckdb::make_uniq<duckdb::ColumnDataCollection>(duckdb::Allocator::Get(context), bind_data.input_types);
+    return std::move(state);
+}
+
+duckdb::unique_ptr<duckdb::LocalTableFunctionState> LlmBulk::InitLocal(duckdb::ExecutionContext& context,
+                                                                       duckdb::TableFunctionInitInput& input,
+                                                                       duckdb::GlobalTableFunctionState* global_state) {
+    global_state->Cast<GlobalState>().barrier.Register();
+    return duckdb::make_uniq<LocalState>();
+}
+
+duckdb::OperatorResultType LlmBulk::Buffer(duckdb::ExecutionContext& context, duckdb::TableFunctionInput& data,
+                                           duckdb::DataChunk& input, duckdb::DataChunk& output) {
+    const auto& bind_data = data.bind_data->Cast<BindData>();
+    auto& global_state = data.global_state->Cast<GlobalState>();
+    auto tuples = CastChunkToJson(input, bind_data.input_names);
+    {
+        std::lock_guard<std::mutex> lock(global_state.mutex);
+        global_state.rows->Append(input);
+        for (auto& tuple : tuples) {
+            global_state.tuples.push_back(std::move(tuple));
+        }
+    }
+    output.SetCardinality(0);
+    return duckdb::OperatorResultType::NEED_MORE_INPUT;
+}
+
+namespace {
+
+BatchClient MakeBatchClient(const LlmBulk::BindData& bind_data, const ModelDetails& model_details,
+                            const RequestOptions& request_options) {
+    if (GetProviderType(model_details.provider_name) != FLOCKMTL_OPENAI) {
+        throw std::runtime_error("Bulk mode needs an OpenAI-compatible provider, not " + model_details.provider_name);
+    }
+    const auto get_seconds = [&](const std::string& name, const double default_seconds) {
+        return std::chrono::milliseconds(static_cast<int64_t>(
+            (bind_data.model_json.contains(name) ? std::stod(bind_data.model_json.at(name).get<std::string>())
+                                                 : default_seconds) *
+            1000));
+    };
+    auto secret = model_details.secret;
+    return BatchClient(secret["api_key"], secret["base_url"], request_options,
+                       get_seconds("batch_poll_interval", LlmBulk::kDefaultPollIntervalSeconds),
+                       get_seconds("batch_timeout", LlmBulk::kDefaultTimeoutSeconds));
+}
+
+class VectorEmbeddingSink : public EmbeddingSink {
+public:
+    VectorEmbeddingSink(std::vector<std::vector<double>>& embeddings, const size_t offset)
+        : embeddings_(embeddings), offset_(offset) {}
+
+    // EmbeddingDecoder already rejects rows outside of the request; this guards the synchronous fallback too.
+    void Write(size_t row, const double* values, size_t count) override {
+        if (offset_ + row >= embeddings_.size()) {
+            throw std::runtime_error("The provider returned more embeddings than there are inputs");
+        }
+        embeddings_[offset_ + row].assign(values, values + count);
+    }
+
+private:
+    std::vector<std::vector<double>>& embeddings_;
+    size_t offset_;
+};
+
+} // namespace
+
+void LlmBulk::ExecuteCompletions(const BindData& bind_data, GlobalState& state) {
+    Model model(bind_data.model_json);
+    const auto model_details = model.GetModelDetails();
+    const OpenAIProvider provider(model_details);
+    const auto client = MakeBatchClient(bind_data, model_details, provider.GetRequestOptions());
+    const auto function_type =
+        bind_data.kind == Kind::FILTER ? ScalarFunctionType::FILTER : ScalarFunctionType::COMPLETE;
+
+    const auto available_tokens =
+        ScalarFunctionBase::GetAvailableTokens(bind_data.user_prompt, function_type, model_details);
+    if (available_tokens < 0) {
+        throw std::runtime_error("The total number of tokens in the prompt exceeds the model's maximum token limit");
+    }
+    // Without a fixed batch_size, batches are sized from what the synchronous path has learned about this prompt.
+    const auto batch_size = model_details.batch_size > 0
+                                ? model_details.batch_size
+                                : BatchSizeController::GetBatchSize(
+                                      ScalarFunctionBase::GetBatchSizeKey(model_details, function_type,
+                                                                          bind_data.user_prompt),
+                                      model_details.max_output_tokens, static_cast<int>(state.tuples.size()));
+
+    std::vector<std::pair<int, int>> ranges;
+    std::vector<BatchRequest> requests;
+    for (auto start = 0; start < static_cast<int>(state.tuples.size());) {
+        const auto end = ScalarFunctionBase::FitBatch(state.tuples, start, batch_size, available_tokens);
+        const auto batch_tuples = nlohmann::json(
+            std::vector<nlohmann::json>(state.tuples.begin() + start, state.tuples.begin() + end));
+        const auto prompt =
+            PromptManager::Render(bind_data.user_prompt, batch_tuples, function_type, model_details.tuple_format);
+        requests.push_back({"request-" + std::to_string(ranges.size()), provider.GetCompletionPayload(prompt, true)});
+        ranges.emplace_back(start, end);
+        start = end;
+    }
+
+    const auto bodies = client.Run("/v1/chat/completions", requests);
+
+    state.results.reserve(state.tuples.size());
+    for (size_t i = 0; i < ranges.size(); i++) {
+        const auto [start, end] = ranges[i];
+        const auto batch_tuples = nlohmann::json(
+            std::vector<nlohmann::json>(state.tuples.begin() + start, state.tuples.begin() + end));
+        nlohmann::json response;
+        auto completed = false;
+        if (const auto body = bodies.find(requests[i].custom_id); body != bodies.end()) {
+            try {
+                response = OpenAIProvider::ParseCompletion(body->second, true)["tuples"];
+                ScalarFunctionBase::AlignResponse(response, batch_tuples.size());
+                completed = true;
+            } catch (const std::exception&) {
+                // Overflowing or malformed answers are redone below.
+            }
+        }
+        // Requests the batch could not complete are redone synchronously, splitting them if they overflow.
+        if (!completed) {
+            response = ScalarFunctionBase::CompleteWithSplit(batch_tuples, bind_data.user_prompt, function_type, model);
+        }
+        for (auto& tuple : response) {
+            state.results.push_back(std::move(tuple));
+        }
+    }
+}
+
+void LlmBulk::ExecuteEmbeddings(const BindData& bind_data, GlobalState& state) {
+    Model model(bind_data.model_json);
+    const auto model_details = model.GetModelDetails();
+    const OpenAIProvider provider(model_details);
+    const auto client = MakeBatchClient(bind_data, model_details, provider.GetRequestOptions());
+
+    std::vector<std::string> inputs;
+    inputs.reserve(state.tuples.size());
+    for (const auto& tuple : state.tuples) {
+        std::string concat_input;
+        for (const auto& item : tuple.items()) {
+            concat_input += item.value().get<std::string>() + " ";
+        }
+        inputs.push_back(std::move(concat_input));
+    }
+
+    const auto batch_size =
+        model_details.batch_size > 0 ? static_cast<size_t>(model_details.batch_size) : kEmbeddingInputsPerRequest;
+    std::vector<BatchRequest> requests;
+    for (size_t start = 0; start < inputs.size(); start += batch_size) {
+        const auto end = std::min(inputs.size(), start + batch_size);
+        const std::vector<std::string> batch_inputs(inputs.begin() + start, inputs.begin() + end);
+        requests.push_back({"request-" + std::to_string(requests.size()), provider.GetEmbeddingPayload(batch_inputs)});
+    }
+
+    const auto bodies = client.Run("/v1/embeddings", requests);
+
+    state.embeddings.assign(inputs.size(), {});
+    for (size_t i = 0; i < requests.size(); i++) {
+        const auto start = i * batch_size;
+        const auto end = std::min(inputs.size(), start + batch_size);
+        VectorEmbeddingSink sink(state.embeddings, start);
+        if (const auto body = bodies.find(requests[i].custom_id); body != bodies.end()) {
+            EmbeddingDecoder::Decode(body->second, end - start, sink);
+        } else {
+            model.CallEmbeddingInto(std::vector<std::string>(inputs.begin() + start, inputs.begin() + end), sink);
+        }
+    }
+}
+
+void LlmBulk::WriteResults(const BindData& bind_data, const GlobalState& global_state, LocalState& state,
+                           duckdb::DataChunk& output) {
+    const auto count = state.scan_chunk.size();
+    for (duckdb::idx_t col = 0; col < state.scan_chunk.ColumnCount(); col++) {
+        output.data[col].Reference(state.scan_chunk.data[col]);
+    }
+
+    auto& result = output.data[state.scan_chunk.ColumnCount()];
+    result.SetVectorType(duckdb::VectorType::FLAT_VECTOR);
+    for (duckdb::idx_t row = 0; row < count; row++) {
+        const auto index = state.emitted + row;
+        if (bind_data.kind == Kind::EMBEDDING) {
+            const auto& embedding = global_state.embeddings[index];
+            if (embedding.empty()) {
+                duckdb::FlatVector::SetNull(result, row, true);
+                continue;
+            }
+            const auto list_size = duckdb::ListVector::GetListSize(result);
+            duckdb::ListVector::Reserve(result, list_size + embedding.size());
+            auto child_data = duckdb::FlatVector::GetData<double>(duckdb::ListVector::GetEntry(result));
+            std::memcpy(child_data + list_size, embedding.data(), embedding.size() * sizeof(double));
+            duckdb::ListVector::SetListSize(result, list_size + embedding.size());
+            duckdb::FlatVector::GetData<duckdb::list_entry_t>(result)[row] =
+                duckdb::list_entry_t(list_size, embedding.size());
+            continue;
+        }
+
+        // A row the model gave no answer for stays NULL, so it neither passes nor fails a filter unnoticed.
+        const auto& response = global_state.results[index];
+        if (response.is_null()) {
+            duckdb::FlatVector::SetNull(result, row, true);
+        } else {
+            result.SetValue(row, duckdb::Value(bind_data.kind != Kind::FILTER && response.is_string()
+                                                   ? response.get<std::string>()
+                                                   : response.dump()));
+        }
+    }
+    output.SetCardinality(count);
+    state.emitted += count;
+}
+
+duckdb::OperatorFinalizeResultType LlmBulk::Finalize(duckdb::ExecutionContext& context,
+                                                     duckdb::TableFunctionInput& data, duckdb::DataChunk& output) {
+    const auto& bind_data = data.bind_data->Cast<BindData>();
+    auto& global_state = data.global_state->Cast<GlobalState>();
+    auto& state = data.local_state->Cast<LocalState>();
+    if (!state.arrived) {
+        state.arrived = true;
+        state.finalizes = global_state.barrier.Arrive();
+    }
+    if (!state.finalizes) {
+        output.SetCardinality(0);
+        return duckdb::OperatorFinalizeResultType::FINISHED;
+    }
+
+    if (!state.executed) {
+        const FunctionScope query_scope(Config::GetQueryBudgets(context.client).get(), &context.client,
+                                        context.client.transaction.GetActiveQuery(), bind_data.function_name,
+                                        Config::GetQueryLimits(context.client));
+        // Lets an interrupted query stop waiting for its batches.
+        const RequestCancellation::Scope cancellation(&context.client.interrupted);
+        if (!global_state.tuples.empty()) {
+            if (bind_data.kind == Kind::EMBEDDING) {
+                ExecuteEmbeddings(bind_data, global_state);
+            } else {
+                ExecuteCompletions(bind_data, global_state);
+            }
+        }
+        global_state.rows->InitializeScan(state.scan_state);
+        global_state.rows->InitializeScanChunk(state.scan_chunk);
+        state.executed = true;
+    }
+
+    state.scan_chunk.Reset();
+    if (!global_state.rows->Scan(state.scan_state, state.scan_chunk)) {
+        output.SetCardinality(0);
+        return duckdb::OperatorFinalizeResultType::FINISHED;
+    }
+    WriteResults(bind_data, global_state, state, output);
+    return duckdb::OperatorFinalizeResultType::HAVE_MORE_OUTPUT;
+}
+
+} // namespace flockmtl
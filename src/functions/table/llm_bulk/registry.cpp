@@ -0,0 +1,32 @@
+#include "flockmtl/functions/table/llm_bulk.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+duckdb::TableFunction CreateBulkFunction(const std::string& name, duckdb::vector<duckdb::LogicalType> arguments,
+                                         const duckdb::table_function_bind_t bind) {
+    duckdb::TableFunction function(name, std::move(arguments), nullptr, bind, LlmBulk::InitGlobal, LlmBulk::InitLocal);
+    function.in_out_function = LlmBulk::Buffer;
+    function.in_out_function_final = LlmBulk::Finalize;
+    return function;
+}
+
+} // namespace
+
+void TableRegistry::RegisterLlmBulk(duckdb::DatabaseInstance& db) {
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, CreateBulkFunction("llm_complete_bulk",
+                               {duckdb::LogicalType::TABLE, duckdb::LogicalType::ANY, duckdb::LogicalType::ANY},
+                               LlmBulk::Bind<LlmBulk::Kind::COMPLETE>));
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, CreateBulkFunction("llm_filter_bulk",
+                               {duckdb::LogicalType::TABLE, duckdb::LogicalType::ANY, duckdb::LogicalType::ANY},
+                               LlmBulk::Bind<LlmBulk::Kind::FILTER>));
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, CreateBulkFunction("llm_embedding_bulk", {duckdb::LogicalType::TABLE, duckdb::LogicalType::ANY},
+                               LlmBulk::Bind<LlmBulk::Kind::EMBEDDING>));
+}
+
+} // namespace flockmtl
@@ -0,0 +1,132 @@
+#include "flockmtl/functions/table/llm_estimate.hpp"
+
+namespace flockmtl {
+
+duckdb::unique_ptr<duckdb::FunctionData> LlmEstimate::Bind(duckdb::ClientContext& context,
+                                                           duckdb::TableFunctionBindInput& input,
+                                                           duckdb::vector<duckdb::LogicalType>& return_types,
+                                                           duckdb::vector<std::string>& names) {
+    const auto structs = CastStructValuesToJson(input.inputs);
+    if (structs.size() != 2 || input.input_table_types.empty()) {
+        throw std::runtime_error("Expected an input relation, a model struct and a prompt struct.");
+    }
+
+    auto bind_data = duckdb::make_uniq<BindData>();
+    bind_data->function_name = "llm_complete";
+    if (const auto it = input.named_parameters.find("function"); it != input.named_parameters.end()) {
+        bind_data->function_name = it->second.ToString();
+    }
+    if (bind_data->function_name == "llm_complete") {
+        bind_data->function_type = ScalarFunctionType::COMPLETE;
+    } else if (bind_data->function_name == "llm_complete_json") {
+        bind_data->function_type = ScalarFunctionType::COMPLETE_JSON;
+    } else if (bind_data->function_name == "llm_filter") {
+        bind_data->function_type = ScalarFunctionType::FILTER;
+    } else {
+        throw std::runtime_error("`function` must be one of llm_complete, llm_complete_json or llm_filter.");
+    }
+    bind_data->model_json = structs[0];
+    bind_data->user_prompt = PromptManager::CreatePromptDetails(structs[1]).prompt;
+    bind_data->input_names = input.input_table_names;
+
+    names = {"function", "tuples", "batches", "prompt_tokens", "max_completion_tokens", "min_cost", "max_cost"};
+    return_types = {duckdb::LogicalType::VARCHAR, duckdb::LogicalType::BIGINT, duckdb::LogicalType::BIGINT,
+                    duckdb::LogicalType::BIGINT,  duckdb::LogicalType::BIGINT, duckdb::LogicalType::DOUBLE,
+                    duckdb::LogicalType::DOUBLE};
+    return std::move(bind_data);
+}
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState> LlmEstimate::InitGlobal(duckdb::ClientContext& context,
+                                                                             duckdb::TableFunctionInitInput& input) {
+    const auto& bind_data = input.bind_data->Cast<BindData>();
+    auto state = duckdb::make_uniq<GlobalState>();
+    state->model_details = Model(bind_data.model_json).GetModelDetails();
+    state->available_tokens =
+        ScalarFunctionBase::GetAvailableTokens(bind_data.user_prompt, bind_data.function_type, state->model_details);
+    if (state->available_tokens < 0) {
+        throw std::runtime_error("The total number of tokens in the prompt exceeds the model's maximum token limit");
+    }
+    return std::move(state);
+}
+
+duckdb::unique_ptr<duckdb::LocalTableFunctionState>
+LlmEstimate::InitLocal(duckdb::ExecutionContext& context, duckdb::TableFunctionInitInput& input,
+                       duckdb::GlobalTableFunctionState* global_state) {
+    global_state->Cast<GlobalState>().barrier.Register();
+    return duckdb::make_uniq<LocalState>();
+}
+
+duckdb::OperatorResultType LlmEstimate::Estimate(duckdb::ExecutionContext& context, duckdb::TableFunctionInput& data,
+                                                 duckdb::DataChunk& input, duckdb::DataChunk& output) {
+    const auto& bind_data = data.bind_data->Cast<BindData>();
+    const auto& global_state = data.global_state->Cast<GlobalState>();
+    auto& totals = data.local_state->Cast<LocalState>().totals;
+    const auto& model_details = global_state.model_details;
+
+    // The scalar functions batch each chunk separately, with the batch size BatchSizeController has learned so far
+    // unless the model fixes one.
+    const auto tuples = CastChunkToJson(input, bind_data.input_names);
+    const auto controller_key = ScalarFunctionBase::GetBatchSizeKey(model_details, bind_data.function_type,
+                                                                    bind_data.user_prompt);
+    for (auto start = 0; start < static_cast<int>(tuples.size());) {
+        const auto remaining = static_cast<int>(tuples.size()) - start;
+        const auto batch_size =
+            model_details.batch_size > 0
+                ? model_details.batch_size
+                : BatchSizeController::GetBatchSize(controller_key, model_details.max_output_tokens, remaining);
+        const auto end = model_details.batch_size > 0
+                             ? std::min(start + batch_size, static_cast<int>(tuples.size()))
+                             : ScalarFunctionBase::FitBatch(tuples, start, batch_size, global_state.available_tokens);
+        const auto batch_tuples =
+            nlohmann::json(std::vector<nlohmann::json>(tuples.begin() + start, tuples.begin() + end));
+        totals.prompt_tokens += Tiktoken::GetNumTokens(PromptManager::Render(
+            bind_data.user_prompt, batch_tuples, bind_data.function_type, model_details.tuple_format));
+        totals.batches++;
+        start = end;
+    }
+    totals.tuples += static_cast<int64_t>(tuples.size());
+
+    output.SetCardinality(0);
+    return duckdb::OperatorResultType::NEED_MORE_INPUT;
+}
+
+duckdb::OperatorFinalizeResultType LlmEstimate::Finalize(duckdb::ExecutionContext& context,
+                                                         duckdb::TableFunctionInput& data, duckdb::DataChunk& output) {
+    const auto& bind_data = data.bind_data->Cast<BindData>();
+    auto& global_state = data.global_state->Cast<GlobalState>();
+    auto& state = data.local_state->Cast<LocalState>();
+    output.SetCardinality(0);
+    if (state.arrived) {
+        return duckdb::OperatorFinalizeResultType::FINISHED;
+    }
+    state.arrived = true;
+    {
+        std::lock_guard<std::mutex> lock(global_state.mutex);
+        global_state.totals.tuples += state.totals.tuples;
+        global_state.totals.batches += state.totals.batches;
+        global_state.totals.prompt_tokens += state.totals.prompt_tokens;
+    }
+    if (!global_state.barrier.Arrive()) {
+        return duckdb::OperatorFinalizeResultType::FINISHED;
+    }
+
+    // Completions are bounded by max_output_tokens per batch; the real answers are usually much shorter.
+    const auto& model_details = global_state.model_details;
+    const auto& totals = global_state.totals;
+    const auto max_completion_tokens = totals.batches * model_details.max_output_tokens;
+    output.SetValue(0, 0, duckdb::Value(bind_data.function_name));
+    output.SetValue(1, 0, duckdb::Value::BIGINT(totals.tuples));
+    output.SetValue(2, 0, duckdb::Value::BIGINT(totals.batches));
+    output.SetValue(3, 0, duckdb::Value::BIGINT(totals.prompt_tokens));
+    output.SetValue(4, 0, duckdb::Value::BIGINT(max_completion_tokens));
+    output.SetValue(5, 0,
+                    duckdb::Value::DOUBLE(QueryBudget::GetCost(totals.prompt_tokens, 0, model_details.input_price,
+                                                               model_details.output_price)));
+    output.SetValue(6, 0,
+                    duckdb::Value::DOUBLE(QueryBudget::GetCost(totals.prompt_tokens, max_completion_tokens,
+                                                               model_details.input_price, model_details.output_price)));
+    output.SetCardinality(1);
+    return duckdb::OperatorFinalizeResultType::FINISHED;
+}
+
+} // namespace flockmtl
@@ -0,0 +1,16 @@
+#include "flockmtl/functions/table/llm_estimate.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterLlmEstimate(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction function("llm_estimate",
+                                   {duckdb::LogicalType::TABLE, duckdb::LogicalType::ANY, duckdb::LogicalType::ANY},
+                                   nullptr, LlmEstimate::Bind, LlmEstimate::InitGlobal, LlmEstimate::InitLocal);
+    function.in_out_function = LlmEstimate::Estimate;
+    function.in_out_function_final = LlmEstimate::Finalize;
+    function.named_parameters["function"] = duckdb::LogicalType::VARCHAR;
+    duckdb::ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace flockmtl
@@ -2,11 +2,15 @@
 
 #include "filesystem.hpp"
 #include "flockmtl/core/common.hpp"
+#include "flockmtl/model_manager/query_budget.hpp"
+#include "flockmtl/model_manager/semantic_cache.hpp"
 #include "flockmtl/registry/registry.hpp"
 #include <fmt/format.h>
 
 namespace flockmtl {
 
+class QueryModelsState;
+
 enum ConfigType { LOCAL,
                   GLOBAL };
 
@@ -20,12 +24,25 @@ public:
     static void ConfigureGlobal();
     static void ConfigureTables(duckdb::Connection& con, ConfigType type);
     static void ConfigureLocal(duckdb::DatabaseInstance& db);
+    static void ConfigureSettings(duckdb::DatabaseInstance& db);
+    // The token and cost limits the current session sets for each query.
+    static QueryBudget::Limits GetQueryLimits(duckdb::ClientContext& context);
+    // The budgets of the query the session is running.
+    static std::shared_ptr<QueryBudgets> GetQueryBudgets(duckdb::ClientContext& context);
+    // The semantic cache the current session puts in front of prompt-only completions, resolved once per query.
+    static SemanticCache::Options GetSemanticCacheOptions(duckdb::ClientContext& context);
+    // The semantic cache of the database `context` is connected to.
+    static std::shared_ptr<SemanticCache> GetSemanticCache(duckdb::ClientContext& context);
+    // The models built during the current query.
+    static std::shared_ptr<QueryModelsState> GetQueryModels(duckdb::ClientContext& context);
 
     static std::string get_schema_name();
     static std::filesystem::path get_global_storage_path();
     static std::string get_default_models_table_name();
     static std::string get_user_defined_models_table_name();
     static std::string get_prompts_table_name();
+    static std::string get_vector_indexes_table_name();
+    static std::string get_vector_index_pages_table_name();
     constexpr static int32_t default_context_window = 128000;
     constexpr static int32_t default_max_output_tokens = 4096;
 
@@ -34,8 +51,36 @@ private:
     static void ConfigSchema(duckdb::Connection& con, std::string& schema_name);
     static void ConfigPromptTable(duckdb::Connection& con, std::string& schema_name, ConfigType type);
     static void ConfigModelTable(duckdb::Connection& con, std::string& schema_name, ConfigType type);
+    static void ConfigVectorIndexTable(duckdb::Connection& con, std::string& schema_name, ConfigType type);
     static void SetupDefaultModelsConfig(duckdb::Connection& con, std::string& schema_name);
     static void SetupUserDefinedModelsConfig(duckdb::Connection& con, std::string& schema_name);
 };
 
+// Budgets are kept with the client until its query ends, so a closed connection does not leave its last ones behind.
+class QueryBudgetState : public duckdb::ClientContextState, public QueryBudgets {
+public:
+    void QueryEnd() override { EndQuery(); }
+};
+
+// Models that functions build for themselves, e.g. the semantic cache's embedding model, are kept until the query ends,
+// so each model's catalog entry and secret are read once per query rather than once per chunk.
+class QueryModelsState : public duckdb::ClientContextState {
+public:
+    // The model `model_json` describes, built on first use in the query.
+    std::shared_ptr<Model> GetModel(const nlohmann::json& model_json);
+    // The semantic cache settings of the session, read on first use in the query.
+    SemanticCache::Options GetSemanticCacheOptions(duckdb::ClientContext& context);
+
+    void QueryEnd() override {
+        std::lock_guard<std::mutex> guard(mutex_);
+        models_.clear();
+        semantic_cache_options_.reset();
+    }
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Model>> models_;
+    std::optional<SemanticCache::Options> semantic_cache_options_;
+};
+
 }// namespace flockmtl
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace flockmtl {
+
+// On-demand reader over a JSON document. Nothing is parsed up front: members and elements are located by skipping
+// over the raw bytes and handed back as views into the original buffer, so pulling a few fields out of a large
+// provider response never materializes a DOM.
+class JsonScanner {
+public:
+    static std::optional<std::string_view> GetMember(std::string_view object, std::string_view key);
+    static std::optional<std::string_view> GetElement(std::string_view array, size_t index);
+
+    template <typename Callback>
+    static size_t ForEachElement(std::string_view array, Callback&& callback) {
+        auto pos = Expect(array, SkipWhitespace(array, 0), '[');
+        size_t count = 0;
+        pos = SkipWhitespace(array, pos);
+        if (pos < array.size() && array[pos] == ']') {
+            return count;
+        }
+        while (true) {
+            pos = SkipWhitespace(array, pos);
+            const auto end = SkipValue(array, pos);
+            callback(array.substr(pos, end - pos));
+            count++;
+            pos = SkipWhitespace(array, end);
+            if (pos < array.size() && array[pos] == ',') {
+                pos++;
+                continue;
+            }
+            Expect(array, pos, ']');
+            return count;
+        }
+    }
+
+    static bool IsNull(std::string_view value);
+    static bool IsString(std::string_view value);
+    static std::string GetString(std::string_view value);
+    static double GetDouble(std::string_view value);
+    static int64_t GetInteger(std::string_view value);
+    static bool GetBool(std::string_view value);
+
+    static size_t SkipWhitespace(std::string_view json, size_t pos);
+    static size_t SkipValue(std::string_view json, size_t pos);
+
+private:
+    static size_t SkipString(std::string_view json, size_t pos);
+    static size_t Expect(std::string_view json, size_t pos, char expected);
+    static std::string_view Trim(std::string_view value);
+    static void AppendUtf8(std::string& out, uint32_t code_point);
+};
+
+} // namespace flockmtl
@@ -64,6 +64,8 @@ public:
     std::string ToSQL(const QueryStatement& statement) const;
 
 private:
+    // context_window and max_output_tokens are required; rate limits may be given on top of them.
+    static void ValidateModelArgs(const nlohmann::json& model_args);
     void ParseCreateModel(Tokenizer& tokenizer, std::unique_ptr<QueryStatement>& statement);
     void ParseDeleteModel(Tokenizer& tokenizer, std::unique_ptr<QueryStatement>& statement);
     void ParseUpdateModel(Tokenizer& tokenizer, std::unique_ptr<QueryStatement>& statement);
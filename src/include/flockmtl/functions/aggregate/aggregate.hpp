@@ -5,6 +5,7 @@
 
 #include "flockmtl/core/common.hpp"
 #include "flockmtl/model_manager/model.hpp"
+#include "flockmtl/model_manager/profiler.hpp"
 #include "flockmtl/functions/batch_response_builder.hpp"
 
 namespace flockmtl {
@@ -18,6 +19,31 @@ public:
     void Combine(const AggregateFunctionState& source);
 };
 
+// Remembers the query an aggregate was bound in, its budgets and its limits, so that the calls made while finalizing it
+// can be attributed.
+struct AggregateBindData : public duckdb::FunctionData {
+    std::shared_ptr<QueryBudgets> budgets;
+    const void* client;
+    uint64_t query_id;
+    std::string function_name;
+    QueryBudget::Limits limits;
+
+    AggregateBindData(std::shared_ptr<QueryBudgets> budgets, const void* client, const uint64_t query_id,
+                      std::string function_name, const QueryBudget::Limits limits)
+        : budgets(std::move(budgets)), client(client), query_id(query_id), function_name(std::move(function_name)),
+          limits(limits) {}
+
+    duckdb::unique_ptr<duckdb::FunctionData> Copy() const override {
+        return duckdb::make_uniq<AggregateBindData>(budgets, client, query_id, function_name, limits);
+    }
+    bool Equals(const duckdb::FunctionData& other) const override {
+        const auto& other_data = other.Cast<AggregateBindData>();
+        return budgets == other_data.budgets && client == other_data.client && query_id == other_data.query_id &&
+               function_name == other_data.function_name && limits.max_tokens == other_data.limits.max_tokens &&
+               limits.max_cost == other_data.limits.max_cost;
+    }
+};
+
 class AggregateFunctionBase {
 public:
     Model model;
@@ -34,6 +60,11 @@ public:
 
     static bool IgnoreNull() { return true; };
 
+    static duckdb::unique_ptr<duckdb::FunctionData>
+    Bind(duckdb::ClientContext& context, duckdb::AggregateFunction& function,
+         duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments);
+    static FunctionScope ScopeToQuery(const duckdb::AggregateInputData& aggr_input_data);
+
     template <class Derived>
     static void Initialize(const duckdb::AggregateFunction&, duckdb::data_ptr_t state_p) {
         auto state_ptr = reinterpret_cast<AggregateFunctionState*>(state_p);
@@ -49,6 +80,7 @@ public:
     static void Operation(duckdb::Vector inputs[], duckdb::AggregateInputData& aggr_input_data, idx_t input_count,
                           duckdb::Vector& states, idx_t count) {
         ValidateArguments(inputs, input_count);
+        const auto query_scope = ScopeToQuery(aggr_input_data);
 
         auto [model_details, prompt_details, tuples] = CastInputsToJson(inputs, count);
         auto function_instance = GetInstance<Derived>();
@@ -69,6 +101,7 @@ public:
     static void SimpleUpdate(duckdb::Vector inputs[], duckdb::AggregateInputData& aggr_input_data, idx_t input_count,
                              duckdb::data_ptr_t state_p, idx_t count) {
         ValidateArguments(inputs, input_count);
+        const auto query_scope = ScopeToQuery(aggr_input_data);
 
         auto [model_details, prompt_details, tuples] = CastInputsToJson(inputs, count);
         auto function_instance = GetInstance<Derived>();
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "flockmtl/core/common.hpp"
+#include "flockmtl/vector_search/distance.hpp"
+#include "flockmtl/vector_search/quantization.hpp"
+#include "flockmtl/vector_search/top_k.hpp"
+
+namespace flockmtl {
+
+// `flockmtl_knn_agg(id, embedding, query, k[, metric])` returns the `k` rows whose embeddings are closest to the
+// constant `query` as a list of {id, distance} structs, closest first. Every thread keeps its own bounded heap, which
+// DuckDB's parallel aggregation then merges. `embedding` may also be a BLOB made by flockmtl_quantize_int8 or
+// flockmtl_quantize_binary, in which case the query is quantized the same way before comparing.
+class FlockmtlKnnAgg {
+public:
+    struct BindData : public duckdb::FunctionData {
+        std::vector<float> query;
+        float query_norm;
+        size_t k;
+        DistanceMetric metric;
+        bool quantized;
+        std::string query_int8;
+        int32_t query_int8_squared_norm = 0;
+        std::string query_binary;
+
+        BindData(std::vector<float> query, const size_t k, const DistanceMetric metric, const bool quantized)
+            : query(std::move(query)), query_norm(Distance::Norm(this->query.data(), this->query.size())), k(k),
+              metric(metric), quantized(quantized) {
+            if (quantized) {
+                query_int8 = Quantization::QuantizeInt8(this->query.data(), this->query.size());
+                query_int8_squared_norm = Quantization::Int8SquaredNorm(query_int8);
+                query_binary = Quantization::QuantizeBinary(this->query.data(), this->query.size());
+            }
+        }
+
+        duckdb::unique_ptr<duckdb::FunctionData> Copy() const override {
+            return duckdb::make_uniq<BindData>(query, k, metric, quantized);
+        }
+        bool Equals(const duckdb::FunctionData& other) const override {
+            const auto& other_data = other.Cast<BindData>();
+            return query == other_data.query && k == other_data.k && metric == other_data.metric &&
+                   quantized == other_data.quantized;
+        }
+    };
+
+    struct State {
+        TopK<duckdb::Value>* neighbours;
+    };
+
+    static duckdb::unique_ptr<duckdb::FunctionData>
+    Bind(duckdb::ClientContext& context, duckdb::AggregateFunction& function,
+         duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments);
+    static void Initialize(const duckdb::AggregateFunction&, duckdb::data_ptr_t state_p);
+    static void Update(duckdb::Vector inputs[], duckdb::AggregateInputData& aggr_input_data, idx_t input_count,
+                       duckdb::Vector& states, idx_t count);
+    static void SimpleUpdate(duckdb::Vector inputs[], duckdb::AggregateInputData& aggr_input_data, idx_t input_count,
+                             duckdb::data_ptr_t state_p, idx_t count);
+    static void Combine(duckdb::Vector& source, duckdb::Vector& target, duckdb::AggregateInputData& aggr_input_data,
+                        idx_t count);
+    static void Finalize(duckdb::Vector& states, duckdb::AggregateInputData& aggr_input_data, duckdb::Vector& result,
+                         idx_t count, idx_t offset);
+    static void Destroy(duckdb::Vector& states, duckdb::AggregateInputData& aggr_input_data, idx_t count);
+
+    // Evaluates a constant argument of a k-NN function, e.g. the query vector, at bind time.
+    static duckdb::Value EvaluateConstant(duckdb::ClientContext& context, duckdb::Expression& argument,
+                                          const std::string& name);
+    // The query vector of a k-NN function as floats.
+    static std::vector<float> GetQueryVector(const duckdb::Value& query);
+
+private:
+    // Fills `distances` with each row's distance from the query and `valid` with whether the row has an embedding.
+    static void ComputeDistances(const BindData& bind_data, duckdb::Vector& embeddings, idx_t count, float* distances,
+                                 bool* valid);
+    static void ComputeQuantizedDistances(const BindData& bind_data, duckdb::Vector& embeddings, idx_t count,
+                                          float* distances, bool* valid);
+    // Adds the rows of a chunk to the state `get_state` returns for each row.
+    template <class GET_STATE>
+    static void Accumulate(const BindData& bind_data, duckdb::Vector& ids, duckdb::Vector& embeddings, idx_t count,
+                           GET_STATE&& get_state);
+};
+
+} // namespace flockmtl
@@ -1,12 +1,19 @@
 #pragma once
 #include <nlohmann/json.hpp>
 #include "flockmtl/core/common.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "flockmtl/model_manager/model.hpp"
 #include "flockmtl/prompt_manager/prompt_manager.hpp"
 #include "flockmtl/model_manager/tiktoken.hpp"
 
 namespace flockmtl {
 
+// One JSON object of strings per row of `struct_vector`; nested STRUCT fields become nested objects.
 std::vector<nlohmann::json> CastVectorOfStructsToJson(const duckdb::Vector& struct_vector, int size);
+// One JSON object per row of `chunk`, keyed by the column `names`.
+std::vector<nlohmann::json> CastChunkToJson(duckdb::DataChunk& chunk, const std::vector<std::string>& names);
+// The STRUCT constants among the arguments of a table function, e.g. its model and prompt, as JSON objects of strings
+// and nested objects.
+std::vector<nlohmann::json> CastStructValuesToJson(const duckdb::vector<duckdb::Value>& values);
 
 } // namespace flockmtl
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace flockmtl {
+
+// Picks batch sizes for the automatic batching mode of the scalar functions. Statistics are kept per (model, prompt)
+// key for the lifetime of the process, so every chunk and every query over the same prompt starts from what earlier
+// calls have already learned instead of rediscovering the batch size from scratch.
+class BatchSizeController {
+public:
+    // Largest batch to submit next; `upper_bound` is returned as-is until the key has been observed at least once.
+    static int GetBatchSize(const std::string& key, int max_output_tokens, int upper_bound);
+    static void RecordSuccess(const std::string& key, int num_tuples, int64_t output_tokens,
+                              std::chrono::milliseconds latency);
+    // The batch ran out of output tokens; shrinks the next batch so the failed one can be resubmitted in parts.
+    static void RecordOverflow(const std::string& key, int num_tuples, int max_output_tokens);
+    static void Reset();
+
+    // Weight of the newest observation in the moving averages.
+    static constexpr double kSmoothing = 0.3;
+    // Fraction of max_output_tokens a batch is planned to use, leaving room for variance between tuples.
+    static constexpr double kOutputHeadroom = 0.8;
+    // Largest factor a batch may grow by from one call to the next.
+    static constexpr double kMaxGrowth = 1.5;
+    // Calls expected to take longer than this are split up to keep tail latency and timeouts in check.
+    static constexpr double kTargetLatencyMs = 60000.0;
+
+private:
+    struct Statistics {
+        double output_tokens_per_tuple = 0;
+        double latency_ms_per_tuple = 0;
+        int batch_size = 0;
+        bool overflowed = false;
+        uint64_t last_used = 0;
+    };
+
+    static constexpr size_t kMaxEntries = 1024;
+
+    static Statistics& GetStatistics(const std::string& key);
+
+    static std::mutex mutex_;
+    static std::unordered_map<std::string, Statistics> statistics_;
+    static uint64_t clock_;
+};
+
+} // namespace flockmtl
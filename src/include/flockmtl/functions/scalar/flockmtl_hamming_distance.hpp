@@ -0,0 +1,14 @@
+#pragma once
+
+#include "flockmtl/functions/scalar/scalar.hpp"
+
+namespace flockmtl {
+
+// `flockmtl_hamming_distance(a, b)` counts the bits that differ between two embeddings quantized by
+// flockmtl_quantize_binary.
+class FlockmtlHammingDistance : public ScalarFunctionBase {
+public:
+    static void Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+};
+
+} // namespace flockmtl
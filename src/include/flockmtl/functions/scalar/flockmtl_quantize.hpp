@@ -0,0 +1,19 @@
+#pragma once
+
+#include "flockmtl/functions/scalar/scalar.hpp"
+
+namespace flockmtl {
+
+// `flockmtl_quantize_int8(embedding)` and `flockmtl_quantize_binary(embedding)` compress a float embedding into a BLOB
+// that flockmtl_knn and flockmtl_knn_agg search directly (see Quantization for the encodings).
+class FlockmtlQuantize : public ScalarFunctionBase {
+public:
+    static void ExecuteInt8(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+    static void ExecuteBinary(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+
+private:
+    template <std::string (*QUANTIZE)(const float*, size_t)>
+    static void Quantize(duckdb::DataChunk& args, duckdb::Vector& result);
+};
+
+} // namespace flockmtl
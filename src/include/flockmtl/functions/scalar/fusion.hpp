@@ -0,0 +1,56 @@
+#pragma once
+
+#include "flockmtl/core/common.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+
+namespace flockmtl {
+
+/**
+ * Typed view of one score column of a fusion function. The column is cast once to `type` unless it already has that
+ * type, and its values are then read straight from the unified vector format instead of as one Value per row.
+ */
+template <class T>
+class FusionInput {
+public:
+    FusionInput(duckdb::Vector& input, const duckdb::idx_t count, const duckdb::LogicalType& type)
+        : cast_(type, count) {
+        if (input.GetType() == type) {
+            input.ToUnifiedFormat(count, format_);
+        } else {
+            duckdb::VectorOperations::DefaultCast(input, cast_, count);
+            cast_.ToUnifiedFormat(count, format_);
+        }
+        data_ = duckdb::UnifiedVectorFormat::GetData<T>(format_);
+    }
+
+    /**
+     * Whether the column is a flat vector without NULLs, so that row i is simply Data()[i] and loops over it can be
+     * vectorized by the compiler.
+     */
+    bool IsDense() const { return !format_.sel->IsSet() && format_.validity.AllValid(); }
+    const T* Data() const { return data_; }
+
+    /**
+     * Value of a row, or `null_value` if it is NULL.
+     */
+    T Get(const duckdb::idx_t row, const T null_value) const {
+        const auto index = format_.sel->get_index(row);
+        return format_.validity.RowIsValid(index) ? data_[index] : null_value;
+    }
+
+private:
+    duckdb::Vector cast_;
+    duckdb::UnifiedVectorFormat format_;
+    const T* data_;
+};
+
+/**
+ * Writes the fused scores of a chunk into a flat DOUBLE result vector.
+ */
+template <void (*FUSE)(duckdb::DataChunk&, double*)>
+void ExecuteFusion(duckdb::DataChunk& args, duckdb::Vector& result) {
+    result.SetVectorType(duckdb::VectorType::FLAT_VECTOR);
+    FUSE(args, duckdb::FlatVector::GetData<double>(result));
+}
+
+} // namespace flockmtl
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "flockmtl/functions/scalar/fusion.hpp"
 #include "flockmtl/functions/scalar/scalar.hpp"
 
 namespace flockmtl {
@@ -13,6 +14,8 @@ namespace flockmtl {
 class FusionCombANZ : public ScalarFunctionBase {
 public:
     static std::vector<double> Operation(duckdb::DataChunk& args);
+    // Writes the fused score of every row of `args` into `scores`.
+    static void Fuse(duckdb::DataChunk& args, double* scores);
     static void Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
 };
 
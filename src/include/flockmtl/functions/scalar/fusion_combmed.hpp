@@ -1,5 +1,6 @@
 #pragma once
 
+#include "flockmtl/functions/scalar/fusion.hpp"
 #include "flockmtl/functions/scalar/scalar.hpp"
 
 namespace flockmtl {
@@ -13,9 +14,15 @@ namespace flockmtl {
 class FusionCombMED : public ScalarFunctionBase {
 public:
     static std::vector<double> Operation(duckdb::DataChunk& args);
+    // Writes the fused score of every row of `args` into `scores`.
+    static void Fuse(duckdb::DataChunk& args, double* scores);
     static void Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+    // Median of `size` scores, which are reordered in place.
+    static double calculateMedian(double* scores, size_t size);
+
 private:
-    static double calculateMedian(const std::vector<double>& scores);
+    // Up to this many scores per entry are sorted by insertion instead of selected with nth_element.
+    static constexpr size_t kInsertionSortThreshold = 8;
 };
 
 } // namespace flockmtl
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "flockmtl/functions/scalar/fusion.hpp"
 #include "flockmtl/functions/scalar/scalar.hpp"
 
 namespace flockmtl {
@@ -17,6 +18,10 @@ public:
      * @return A vector of rankings for the entries, which will be processed by FusionRRF::Execute
      */
     static std::vector<double> Operation(duckdb::DataChunk& args);
+    /**
+     * Writes the fused score of every row of `args` into `scores`
+     */
+    static void Fuse(duckdb::DataChunk& args, double* scores);
     static void Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
 };
 
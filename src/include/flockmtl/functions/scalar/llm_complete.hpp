@@ -7,7 +7,8 @@ namespace flockmtl {
 class LlmComplete : public ScalarFunctionBase {
 public:
     static void ValidateArguments(duckdb::DataChunk& args);
-    static std::vector<std::string> Operation(duckdb::DataChunk& args);
+    static std::vector<std::string> Operation(duckdb::DataChunk& args,
+                                              const SemanticCache::Options& cache_options = {});
     static void Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
 };
 
@@ -7,7 +7,7 @@ namespace flockmtl {
 class LlmEmbedding : public ScalarFunctionBase {
 public:
     static void ValidateArguments(duckdb::DataChunk& args);
-    static std::vector<duckdb::vector<duckdb::Value>> Operation(duckdb::DataChunk& args);
+    static void Operation(duckdb::DataChunk& args, duckdb::Vector& result);
     static void Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
 };
 
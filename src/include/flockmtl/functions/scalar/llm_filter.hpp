@@ -6,9 +6,26 @@ namespace flockmtl {
 
 class LlmFilter : public ScalarFunctionBase {
 public:
+    // A model cascade, set up in the model struct: the tuples the first model answers with a confidence below
+    // `cascade_threshold` are evaluated again by the stronger `cascade_model`. That is either a model name, which
+    // shares the other settings of the first model, or a struct of model settings of its own.
+    struct Cascade {
+        nlohmann::json model_json;
+        double threshold = 0.8;
+    };
+
     static void ValidateArguments(duckdb::DataChunk& args);
-    static std::vector<std::string> Operation(duckdb::DataChunk& args);
+    static std::vector<std::string> Operation(duckdb::DataChunk& args, QueryModelsState& models);
     static void Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+
+    static std::optional<Cascade> GetCascade(const nlohmann::json& model_details_json);
+    // The answer of a FILTER_CONFIDENCE response, or nothing if the response is malformed or below `threshold`.
+    static std::optional<bool> GetConfidentAnswer(const nlohmann::json& response, double threshold);
+    // Evaluates the tuples with the cascade's first model and re-evaluates its uncertain answers with the stronger one,
+    // which `get_cascade_model` is only asked for if there are any.
+    static nlohmann::json CascadeAndComplete(const std::vector<nlohmann::json>& tuples, const std::string& user_prompt,
+                                             Model& model, double threshold,
+                                             const std::function<Model&()>& get_cascade_model);
 };
 
 } // namespace flockmtl
@@ -1,13 +1,18 @@
 #pragma once
 
 #include <any>
+#include <chrono>
+#include <future>
 #include <nlohmann/json.hpp>
 
 #include "flockmtl/core/common.hpp"
 #include "flockmtl/model_manager/model.hpp"
+#include "flockmtl/model_manager/profiler.hpp"
+#include "flockmtl/model_manager/semantic_cache.hpp"
 #include "flockmtl/model_manager/tiktoken.hpp"
 #include "flockmtl/prompt_manager/prompt_manager.hpp"
 #include "flockmtl/functions/batch_response_builder.hpp"
+#include "flockmtl/functions/batch_size_controller.hpp"
 
 namespace flockmtl {
 
@@ -19,11 +24,37 @@ public:
     static std::vector<std::any> Operation(duckdb::DataChunk& args);
     static void Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
 
+    // Attributes the models created and the calls made while a chunk is processed to the running query and function,
+    // so they share the query's retry budget and show up in its profile.
+    static FunctionScope ScopeToQuery(duckdb::ExpressionState& state);
+
+    // Completes a prompt without tuples, reusing the response to a similar enough earlier prompt if the semantic cache
+    // is enabled.
+    static nlohmann::json CompletePrompt(const std::string& prompt, bool json_response, Model& model,
+                                         const SemanticCache::Options& cache_options);
     static nlohmann::json Complete(const nlohmann::json& tuples, const std::string& user_prompt,
                                    ScalarFunctionType function_type, Model& model);
+    // Completes `tuples`, bisecting and retrying the halves whenever the output does not fit.
+    static nlohmann::json CompleteWithSplit(const nlohmann::json& tuples, const std::string& user_prompt,
+                                            ScalarFunctionType function_type, Model& model, bool concurrently = true);
+    // Recovers a batch that overflowed max_output_tokens by completing its two halves, concurrently if `concurrently`.
+    static nlohmann::json SplitAndComplete(const nlohmann::json& tuples, const std::string& user_prompt,
+                                           ScalarFunctionType function_type, Model& model, bool concurrently);
     static nlohmann::json BatchAndComplete(const std::vector<nlohmann::json>& tuples,
                                            const std::string& user_prompt_name, ScalarFunctionType function_type,
                                            Model& model);
+
+    // Tokens of the context window left for input tuples once the prompt template and the user prompt are in.
+    static int GetAvailableTokens(const std::string& user_prompt, ScalarFunctionType function_type,
+                                  const ModelDetails& model_details);
+    // End (exclusive) of the batch starting at `start`: at most `batch_size` tuples whose rendering fits into
+    // `available_tokens`, but always at least one so an oversized tuple surfaces as a provider error.
+    static int FitBatch(const std::vector<nlohmann::json>& tuples, int start, int batch_size, int available_tokens);
+    // Key under which BatchSizeController learns the batch size of a model, function and prompt.
+    static std::string GetBatchSizeKey(const ModelDetails& model_details, ScalarFunctionType function_type,
+                                       const std::string& user_prompt);
+    // Pads with nulls or truncates so there is exactly one response per input tuple.
+    static void AlignResponse(nlohmann::json& response, size_t num_tuples);
 };
 
 } // namespace flockmtl
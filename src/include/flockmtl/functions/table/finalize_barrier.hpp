@@ -0,0 +1,37 @@
+#pragma once
+
+#include <mutex>
+
+namespace flockmtl {
+
+// In-out table functions run at the parallelism of their input: every thread gets its own local state and finalizes
+// it on its own, whatever MaxThreads says. Functions that need their whole input at once keep it in the global state
+// and let the local state that finalizes last produce the output.
+//
+// A thread creates its local state before it takes any input, so once every registered local state has arrived, all
+// of the input has been seen. Local states created after that saw no input and arrive without producing anything.
+class FinalizeBarrier {
+public:
+    // Called from init_local.
+    void Register() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_++;
+    }
+
+    // Called once per local state from in_out_function_final. True for exactly one of them, the last to arrive.
+    bool Arrive() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ > 0 || finalized_) {
+            return false;
+        }
+        finalized_ = true;
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    int pending_ = 0;
+    bool finalized_ = false;
+};
+
+} // namespace flockmtl
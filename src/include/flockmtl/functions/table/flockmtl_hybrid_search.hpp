@@ -0,0 +1,78 @@
+#pragma once
+
+#include "duckdb/function/table_function.hpp"
+
+#include "flockmtl/core/common.hpp"
+#include "flockmtl/functions/table/fusion_normalize.hpp"
+#include "flockmtl/functions/table/fusion_rrf_topn.hpp"
+#include "flockmtl/vector_search/distance.hpp"
+
+namespace flockmtl {
+
+// BM25 and vector retrieval fused in one call, e.g.
+// `FROM flockmtl_hybrid_search('documents', 'doc_id', 'embedding', 'duck migration', [0.1, 0.7, ...], k := 10)`.
+// The lexical retriever uses the table's full-text index (`PRAGMA create_fts_index`) and the vector retriever a
+// flockmtl_knn_agg scan. Both run concurrently and keep only their best `candidates` documents, which are fused in
+// memory, so neither the whole table is sorted nor the retrievers' results joined.
+// The retrievers run on connections of their own, so they read the committed rows of the table: changes of the caller's
+// open transaction are not seen, and temporary tables are rejected.
+class FlockmtlHybridSearch {
+public:
+    enum class Fusion { RRF, COMBSUM, COMBMNZ, COMBMED, COMBANZ };
+
+    static Fusion ParseFusion(const std::string& fusion);
+
+    struct Options {
+        size_t k = 10;
+        // Documents kept from each retriever.
+        size_t candidates = 100;
+        Fusion fusion = Fusion::RRF;
+        // How the scores are normalized before a score-based fusion; RRF only uses ranks.
+        FusionNormalize::Mode normalize = FusionNormalize::Mode::MIN_MAX;
+        DistanceMetric metric = DistanceMetric::COSINE;
+    };
+
+    // Fuses the scores of each retriever's candidates, higher being better and NaN where a retriever did not return
+    // the document, and returns the best `k` rows, best first.
+    static std::vector<FusionRRFTopN::FusedEntry> Fuse(const std::vector<std::vector<double>>& scores, size_t num_rows,
+                                                       const Options& options);
+
+    struct BindData : public duckdb::TableFunctionData {
+        std::string table_name;
+        std::string id_column;
+        std::string embedding_column;
+        // Qualified with the table's catalog.
+        std::string fts_schema;
+        std::string query_text;
+        std::vector<float> query_vector;
+        std::string metric;
+        Options options;
+    };
+
+    struct Result {
+        duckdb::Value id;
+        double score;
+        duckdb::Value bm25;
+        duckdb::Value distance;
+    };
+
+    struct GlobalState : public duckdb::GlobalTableFunctionState {
+        bool done = false;
+        std::vector<Result> results;
+        duckdb::idx_t offset = 0;
+    };
+
+    static duckdb::unique_ptr<duckdb::FunctionData> Bind(duckdb::ClientContext& context,
+                                                         duckdb::TableFunctionBindInput& input,
+                                                         duckdb::vector<duckdb::LogicalType>& return_types,
+                                                         duckdb::vector<std::string>& names);
+    static duckdb::unique_ptr<duckdb::GlobalTableFunctionState> InitGlobal(duckdb::ClientContext& context,
+                                                                           duckdb::TableFunctionInitInput& input);
+    static void Execute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data, duckdb::DataChunk& output);
+
+private:
+    // Runs both retrievers concurrently and fuses their candidates.
+    static std::vector<Result> Search(const BindData& bind_data, duckdb::DatabaseInstance& db);
+};
+
+} // namespace flockmtl
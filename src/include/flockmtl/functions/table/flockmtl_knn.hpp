@@ -0,0 +1,24 @@
+#pragma once
+
+#include "duckdb/function/table_function.hpp"
+
+#include "flockmtl/core/common.hpp"
+
+namespace flockmtl {
+
+// Exact k-nearest-neighbour search over an embedding column, e.g.
+// `FROM flockmtl_knn('documents', 'embedding', [0.1, 0.7, ...], k := 10, metric := 'cosine')`. Returns the `k` closest
+// rows of the table with their `distance`, closest first. The call is rewritten into a flockmtl_knn_agg scan, so the
+// table is read once, in parallel, and never sorted. With `rescore := 'embedding_full'`, the embedding column (e.g. a
+// quantized one) only shortlists `k * oversample` rows (`oversample` defaults to 4), which are then ranked on the
+// full-precision column.
+class FlockmtlKnn {
+public:
+    static duckdb::unique_ptr<duckdb::TableRef> BindReplace(duckdb::ClientContext& context,
+                                                            duckdb::TableFunctionBindInput& input);
+
+    // `name` with each part of a possibly qualified name quoted where needed.
+    static std::string QuoteQualifiedName(const std::string& name);
+};
+
+} // namespace flockmtl
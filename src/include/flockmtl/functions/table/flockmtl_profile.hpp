@@ -0,0 +1,28 @@
+#pragma once
+
+#include "duckdb/function/table_function.hpp"
+
+#include "flockmtl/core/common.hpp"
+#include "flockmtl/model_manager/profiler.hpp"
+
+namespace flockmtl {
+
+// `FROM flockmtl_profile()` lists, per query and function, what the recent queries of this connection spent on
+// providers. The query running flockmtl_profile() itself is left out.
+class FlockmtlProfile {
+public:
+    struct GlobalState : public duckdb::GlobalTableFunctionState {
+        std::vector<std::pair<uint64_t, std::pair<std::string, CallSiteProfile>>> rows;
+        duckdb::idx_t offset = 0;
+    };
+
+    static duckdb::unique_ptr<duckdb::FunctionData> Bind(duckdb::ClientContext& context,
+                                                         duckdb::TableFunctionBindInput& input,
+                                                         duckdb::vector<duckdb::LogicalType>& return_types,
+                                                         duckdb::vector<std::string>& names);
+    static duckdb::unique_ptr<duckdb::GlobalTableFunctionState> InitGlobal(duckdb::ClientContext& context,
+                                                                           duckdb::TableFunctionInitInput& input);
+    static void Execute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data, duckdb::DataChunk& output);
+};
+
+} // namespace flockmtl
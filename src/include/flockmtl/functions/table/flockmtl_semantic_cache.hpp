@@ -0,0 +1,27 @@
+#pragma once
+
+#include "duckdb/function/table_function.hpp"
+
+#include "flockmtl/core/common.hpp"
+#include "flockmtl/model_manager/semantic_cache.hpp"
+
+namespace flockmtl {
+
+// `FROM flockmtl_semantic_cache()` returns the size of the database's semantic cache and its hits and misses since the
+// database was opened.
+class FlockmtlSemanticCache {
+public:
+    struct GlobalState : public duckdb::GlobalTableFunctionState {
+        bool done = false;
+    };
+
+    static duckdb::unique_ptr<duckdb::FunctionData> Bind(duckdb::ClientContext& context,
+                                                         duckdb::TableFunctionBindInput& input,
+                                                         duckdb::vector<duckdb::LogicalType>& return_types,
+                                                         duckdb::vector<std::string>& names);
+    static duckdb::unique_ptr<duckdb::GlobalTableFunctionState> InitGlobal(duckdb::ClientContext& context,
+                                                                           duckdb::TableFunctionInitInput& input);
+    static void Execute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data, duckdb::DataChunk& output);
+};
+
+} // namespace flockmtl
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "duckdb/function/table_function.hpp"
+
+#include "flockmtl/core/common.hpp"
+#include "flockmtl/vector_search/hnsw.hpp"
+
+namespace flockmtl {
+
+// Approximate nearest-neighbour search through HNSW indexes, kept in the flockmtl_config schema:
+// - `flockmtl_create_vector_index(index_name, table, column, m := 16, ef_construction := 200, metric := 'cosine')`
+//   builds an index over the embeddings of a table, inserting them on all of DuckDB's threads;
+// - `flockmtl_vector_search(index_name, query, k := 10, ef_search := 64)` returns the `rowid`, `distance` and `rank` of
+//   the `k` rows closest to `query`, so the ranks can go straight into the fusion functions;
+// - `flockmtl_drop_vector_index(index_name)` deletes an index.
+// An index stores its graph and a copy of the vectors in pages, so loading it reads nothing from the indexed table.
+// It is a snapshot of the embeddings at creation time: rows changed since then are found by their old vectors until
+// the index is recreated.
+class FlockmtlVectorIndex {
+public:
+    struct CreateBindData : public duckdb::TableFunctionData {
+        std::string index_name;
+        std::string table_name;
+        std::string column_name;
+        std::string metric;
+        HnswIndex::Options options;
+    };
+
+    struct SearchBindData : public duckdb::TableFunctionData {
+        std::shared_ptr<const HnswIndex> index;
+        std::vector<float> query;
+        size_t k;
+        size_t ef_search;
+    };
+
+    struct DropBindData : public duckdb::TableFunctionData {
+        std::string index_name;
+    };
+
+    struct GlobalState : public duckdb::GlobalTableFunctionState {
+        bool done = false;
+        std::vector<TopK<int64_t>::Entry> neighbours;
+        duckdb::idx_t offset = 0;
+    };
+
+    static duckdb::unique_ptr<duckdb::FunctionData> CreateBind(duckdb::ClientContext& context,
+                                                               duckdb::TableFunctionBindInput& input,
+                                                               duckdb::vector<duckdb::LogicalType>& return_types,
+                                                               duckdb::vector<std::string>& names);
+    static void CreateExecute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                              duckdb::DataChunk& output);
+
+    static duckdb::unique_ptr<duckdb::FunctionData> SearchBind(duckdb::ClientContext& context,
+                                                               duckdb::TableFunctionBindInput& input,
+                                                               duckdb::vector<duckdb::LogicalType>& return_types,
+                                                               duckdb::vector<std::string>& names);
+    static void SearchExecute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                              duckdb::DataChunk& output);
+
+    static duckdb::unique_ptr<duckdb::FunctionData> DropBind(duckdb::ClientContext& context,
+                                                             duckdb::TableFunctionBindInput& input,
+                                                             duckdb::vector<duckdb::LogicalType>& return_types,
+                                                             duckdb::vector<std::string>& names);
+    static void DropExecute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                            duckdb::DataChunk& output);
+
+    static duckdb::unique_ptr<duckdb::GlobalTableFunctionState> InitGlobal(duckdb::ClientContext& context,
+                                                                           duckdb::TableFunctionInitInput& input);
+
+    // The index called `index_name` in the database of `context`, deserialized on first use and kept in the object
+    // cache of the database until it is dropped or recreated.
+    static std::shared_ptr<const HnswIndex> Load(duckdb::ClientContext& context, const std::string& index_name);
+
+    // Bytes of the serialized index per row of the pages table.
+    static constexpr size_t kPageSize = 256 * 1024;
+};
+
+} // namespace flockmtl
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <mutex>
+
+#include "duckdb/common/types/column/column_data_collection.hpp"
+#include "duckdb/function/table_function.hpp"
+
+#include "flockmtl/core/common.hpp"
+#include "flockmtl/functions/table/finalize_barrier.hpp"
+
+namespace flockmtl {
+
+// Normalizes retriever scores for the score-based fusion functions without window aggregates, e.g.
+// `SELECT id, fusion_combsum(bm25, similarity) FROM fusion_normalize((SELECT id, bm25, similarity FROM candidates))`.
+// The first input column passes through and every other column is a retriever's scores, which come out as DOUBLE. The
+// statistics are gathered while the input is buffered, so the input is read once; NULL and NaN scores stay NULL.
+class FusionNormalize {
+public:
+    enum class Mode { MIN_MAX, Z_SCORE, RANK };
+
+    static Mode ParseMode(const std::string& mode);
+
+    // Statistics of one score column, updated one score at a time. The variance uses Welford's algorithm.
+    struct ScoreStatistics {
+        int64_t count = 0;
+        double min = std::numeric_limits<double>::infinity();
+        double max = -std::numeric_limits<double>::infinity();
+        double mean = 0;
+        double m2 = 0;
+
+        void Update(double score);
+        // Adds the scores `other` has seen, as if they had been passed to Update.
+        void Combine(const ScoreStatistics& other);
+        // Min-max scales to [0, 1] and z-score to standard deviations from the mean; a column whose scores are all
+        // equal carries no signal and normalizes to 0.
+        double Normalize(double score, Mode mode) const;
+    };
+
+    // Maps the scores of a column to (0, 1] by rank: the best score becomes 1 and the worst 1/n for n scores. Equal
+    // scores share a rank and NaN scores stay NaN.
+    static std::vector<double> NormalizeRanks(const std::vector<double>& scores);
+
+    struct BindData : public duckdb::TableFunctionData {
+        Mode mode;
+        duckdb::vector<duckdb::LogicalType> input_types;
+    };
+
+    // The statistics have to cover the whole relation, so every thread buffers its input here and the last one to
+    // finalize normalizes and returns all of it.
+    struct GlobalState : public duckdb::GlobalTableFunctionState {
+        FinalizeBarrier barrier;
+        // Guards everything below; rows and scores are appended together so they stay in the same order.
+        std::mutex mutex;
+        duckdb::unique_ptr<duckdb::ColumnDataCollection> rows;
+        std::vector<ScoreStatistics> statistics;
+        // Every score of every column, kept for the rank mode only.
+        std::vector<std::vector<double>> scores;
+    };
+
+    struct LocalState : public duckdb::LocalTableFunctionState {
+        // Statistics of the input this thread has seen, combined into the global ones when it finalizes.
+        std::vector<ScoreStatistics> statistics;
+        bool arrived = false;
+        bool finalizes = false;
+        duckdb::ColumnDataScanState scan_state;
+        duckdb::DataChunk scan_chunk;
+        duckdb::idx_t emitted = 0;
+    };
+
+    static duckdb::unique_ptr<duckdb::FunctionData> Bind(duckdb::ClientContext& context,
+                                                         duckdb::TableFunctionBindInput& input,
+                                                         duckdb::vector<duckdb::LogicalType>& return_types,
+                                                         duckdb::vector<std::string>& names);
+    static duckdb::unique_ptr<duckdb::GlobalTableFunctionState> InitGlobal(duckdb::ClientContext& context,
+                                                                           duckdb::TableFunctionInitInput& input);
+    static duckdb::unique_ptr<duckdb::LocalTableFunctionState>
+    InitLocal(duckdb::ExecutionContext& context, duckdb::TableFunctionInitInput& input,
+              duckdb::GlobalTableFunctionState* global_state);
+    static duckdb::OperatorResultType Buffer(duckdb::ExecutionContext& context, duckdb::TableFunctionInput& data,
+                                             duckdb::DataChunk& input, duckdb::DataChunk& output);
+    static duckdb::OperatorFinalizeResultType Finalize(duckdb::ExecutionContext& context,
+                                                       duckdb::TableFunctionInput& data, duckdb::DataChunk& output);
+};
+
+} // namespace flockmtl
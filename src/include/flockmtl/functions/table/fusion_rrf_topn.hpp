@@ -0,0 +1,85 @@
+#pragma once
+
+#include <mutex>
+
+#include "duckdb/common/types/column/column_data_collection.hpp"
+#include "duckdb/function/table_function.hpp"
+
+#include "flockmtl/core/common.hpp"
+#include "flockmtl/functions/table/finalize_barrier.hpp"
+
+namespace flockmtl {
+
+// Reciprocal Rank Fusion over raw retriever scores, e.g.
+// `FROM fusion_rrf_topn((SELECT id, bm25, similarity FROM candidates), top_n := 10)`. The first input column identifies
+// the document and every other column holds one retriever's scores, higher being better and NULL meaning the retriever
+// did not return the document. The ranks are computed internally, so no ROW_NUMBER() window per retriever is needed,
+// and only the best `top_n` documents come out.
+class FusionRRFTopN {
+public:
+    // Rank window of each retriever unless `depth` is given; Bind raises it to `top_n`.
+    static constexpr size_t kDefaultDepth = 1000;
+
+    struct Options {
+        size_t top_n = 10;
+        // The RRF constant; each retriever adds weight / (k + rank) to a document's score.
+        double k = 60;
+        // One weight per retriever, all 1 if empty.
+        std::vector<double> weights;
+        // Only the best `depth` documents of each retriever are ranked, all of them if 0.
+        size_t depth = kDefaultDepth;
+    };
+
+    struct FusedEntry {
+        size_t row;
+        double score;
+    };
+
+    // Fuses one score column per retriever (NaN where a document was not retrieved) and returns the best rows, best
+    // first. Equal scores share a rank and equal fused scores are ordered by row.
+    static std::vector<FusedEntry> FuseTopN(const std::vector<std::vector<double>>& scores, size_t num_rows,
+                                            const Options& options);
+    // The ids of the fused rows, in the order of `fused`, from the buffered id column.
+    static duckdb::vector<duckdb::Value> GatherIds(duckdb::ColumnDataCollection& ids,
+                                                   const std::vector<FusedEntry>& fused);
+
+    struct BindData : public duckdb::TableFunctionData {
+        Options options;
+        duckdb::LogicalType id_type;
+    };
+
+    // Every document has to be seen before any can be ranked, so all threads collect here and the last one to
+    // finalize fuses and returns the top documents.
+    struct GlobalState : public duckdb::GlobalTableFunctionState {
+        FinalizeBarrier barrier;
+        // Guards everything below; ids and scores are appended together so they stay in the same order.
+        std::mutex mutex;
+        duckdb::unique_ptr<duckdb::ColumnDataCollection> ids;
+        std::vector<std::vector<double>> scores;
+    };
+
+    struct LocalState : public duckdb::LocalTableFunctionState {
+        bool arrived = false;
+        bool finalizes = false;
+        std::vector<FusedEntry> fused;
+        // The ids of the fused entries, in the same order.
+        duckdb::vector<duckdb::Value> fused_ids;
+        size_t offset = 0;
+    };
+
+    static duckdb::unique_ptr<duckdb::FunctionData> Bind(duckdb::ClientContext& context,
+                                                         duckdb::TableFunctionBindInput& input,
+                                                         duckdb::vector<duckdb::LogicalType>& return_types,
+                                                         duckdb::vector<std::string>& names);
+    static duckdb::unique_ptr<duckdb::GlobalTableFunctionState> InitGlobal(duckdb::ClientContext& context,
+                                                                           duckdb::TableFunctionInitInput& input);
+    static duckdb::unique_ptr<duckdb::LocalTableFunctionState>
+    InitLocal(duckdb::ExecutionContext& context, duckdb::TableFunctionInitInput& input,
+              duckdb::GlobalTableFunctionState* global_state);
+    static duckdb::OperatorResultType Collect(duckdb::ExecutionContext& context, duckdb::TableFunctionInput& data,
+                                              duckdb::DataChunk& input, duckdb::DataChunk& output);
+    static duckdb::OperatorFinalizeResultType Finalize(duckdb::ExecutionContext& context,
+                                                       duckdb::TableFunctionInput& data, duckdb::DataChunk& output);
+};
+
+} // namespace flockmtl
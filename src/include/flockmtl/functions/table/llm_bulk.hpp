@@ -0,0 +1,80 @@
+#pragma once
+
+#include <mutex>
+
+#include "duckdb/common/types/column/column_data_collection.hpp"
+#include "duckdb/function/table_function.hpp"
+
+#include "flockmtl/functions/scalar/scalar.hpp"
+#include "flockmtl/functions/table/finalize_barrier.hpp"
+
+namespace flockmtl {
+
+// Offline counterparts of llm_complete, llm_filter and llm_embedding. They take a whole input relation, e.g.
+// `FROM llm_complete_bulk((SELECT ...), {'model_name': ...}, {'prompt': ...})`, send all of it through the provider's
+// Batch API and return the input rows with a `result` column once every batch finished.
+class LlmBulk {
+public:
+    enum class Kind { COMPLETE, FILTER, EMBEDDING };
+
+    struct BindData : public duckdb::TableFunctionData {
+        Kind kind;
+        std::string function_name;
+        nlohmann::json model_json;
+        std::string user_prompt;
+        duckdb::vector<std::string> input_names;
+        duckdb::vector<duckdb::LogicalType> input_types;
+    };
+
+    // Every thread's input is collected here so the whole relation becomes one submission.
+    struct GlobalState : public duckdb::GlobalTableFunctionState {
+        FinalizeBarrier barrier;
+        // Guards rows and tuples while the threads buffer their input.
+        std::mutex mutex;
+        duckdb::unique_ptr<duckdb::ColumnDataCollection> rows;
+        std::vector<nlohmann::json> tuples;
+        std::vector<nlohmann::json> results;
+        std::vector<std::vector<double>> embeddings;
+    };
+
+    struct LocalState : public duckdb::LocalTableFunctionState {
+        bool arrived = false;
+        // Set on the one local state that submits the input and returns every row.
+        bool finalizes = false;
+        bool executed = false;
+        duckdb::ColumnDataScanState scan_state;
+        duckdb::DataChunk scan_chunk;
+        duckdb::idx_t emitted = 0;
+    };
+
+    template <Kind KIND>
+    static duckdb::unique_ptr<duckdb::FunctionData> Bind(duckdb::ClientContext& context,
+                                                         duckdb::TableFunctionBindInput& input,
+                                                         duckdb::vector<duckdb::LogicalType>& return_types,
+                                                         duckdb::vector<std::string>& names);
+    static duckdb::unique_ptr<duckdb::GlobalTableFunctionState> InitGlobal(duckdb::ClientContext& context,
+                                                                           duckdb::TableFunctionInitInput& input);
+    static duckdb::unique_ptr<duckdb::LocalTableFunctionState>
+    InitLocal(duckdb::ExecutionContext& context, duckdb::TableFunctionInitInput& input,
+              duckdb::GlobalTableFunctionState* global_state);
+    static duckdb::OperatorResultType Buffer(duckdb::ExecutionContext& context, duckdb::TableFunctionInput& data,
+                                             duckdb::DataChunk& input, duckdb::DataChunk& output);
+    static duckdb::OperatorFinalizeResultType Finalize(duckdb::ExecutionContext& context,
+                                                       duckdb::TableFunctionInput& data, duckdb::DataChunk& output);
+
+    // Seconds between two status checks of a submitted batch, unless the model struct sets `batch_poll_interval`.
+    static constexpr double kDefaultPollIntervalSeconds = 30;
+    // Seconds to wait for the batches before giving up on them, unless the model struct sets `batch_timeout`. The
+    // provider expires batches after their 24 hour completion window, which this leaves time for.
+    static constexpr double kDefaultTimeoutSeconds = 25 * 3600;
+    // Inputs per embedding request when the model does not set a batch_size.
+    static constexpr size_t kEmbeddingInputsPerRequest = 512;
+
+private:
+    static void ExecuteCompletions(const BindData& bind_data, GlobalState& state);
+    static void ExecuteEmbeddings(const BindData& bind_data, GlobalState& state);
+    static void WriteResults(const BindData& bind_data, const GlobalState& global_state, LocalState& state,
+                             duckdb::DataChunk& output);
+};
+
+} // namespace flockmtl
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <mutex>
+
+#include "duckdb/function/table_function.hpp"
+
+#include "flockmtl/functions/scalar/scalar.hpp"
+#include "flockmtl/functions/table/finalize_barrier.hpp"
+
+namespace flockmtl {
+
+// Pre-flight estimate of what running llm_complete, llm_complete_json or llm_filter over a relation would spend, e.g.
+// `FROM llm_estimate(TABLE reviews, {'model_name': ...}, {'prompt': ...}, function := 'llm_filter')`. The input is
+// batched and rendered like the scalar function would, and the prompts are counted with Tiktoken; nothing is sent.
+class LlmEstimate {
+public:
+    struct BindData : public duckdb::TableFunctionData {
+        std::string function_name;
+        ScalarFunctionType function_type;
+        nlohmann::json model_json;
+        std::string user_prompt;
+        duckdb::vector<std::string> input_names;
+    };
+
+    struct Totals {
+        int64_t tuples = 0;
+        int64_t batches = 0;
+        int64_t prompt_tokens = 0;
+    };
+
+    // Every thread adds its totals here, and the last one to finalize emits the single row of the estimate.
+    struct GlobalState : public duckdb::GlobalTableFunctionState {
+        ModelDetails model_details;
+        int available_tokens = 0;
+        FinalizeBarrier barrier;
+        std::mutex mutex;
+        Totals totals;
+    };
+
+    struct LocalState : public duckdb::LocalTableFunctionState {
+        Totals totals;
+        bool arrived = false;
+    };
+
+    static duckdb::unique_ptr<duckdb::FunctionData> Bind(duckdb::ClientContext& context,
+                                                         duckdb::TableFunctionBindInput& input,
+                                                         duckdb::vector<duckdb::LogicalType>& return_types,
+                                                         duckdb::vector<std::string>& names);
+    static duckdb::unique_ptr<duckdb::GlobalTableFunctionState> InitGlobal(duckdb::ClientContext& context,
+                                                                           duckdb::TableFunctionInitInput& input);
+    static duckdb::unique_ptr<duckdb::LocalTableFunctionState>
+    InitLocal(duckdb::ExecutionContext& context, duckdb::TableFunctionInitInput& input,
+              duckdb::GlobalTableFunctionState* global_state);
+    static duckdb::OperatorResultType Estimate(duckdb::ExecutionContext& context, duckdb::TableFunctionInput& data,
+                                               duckdb::DataChunk& input, duckdb::DataChunk& output);
+    static duckdb::OperatorFinalizeResultType Finalize(duckdb::ExecutionContext& context,
+                                                       duckdb::TableFunctionInput& data, duckdb::DataChunk& output);
+};
+
+} // namespace flockmtl
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "flockmtl/model_manager/providers/handlers/request_options.hpp"
+
+namespace flockmtl {
+
+struct BatchRequest {
+    std::string custom_id;
+    nlohmann::json body;
+};
+
+// Runs requests through an OpenAI-style Batch API: the requests are written to a JSONL file, uploaded, submitted as
+// one or more batches and polled until they finish. Batches trade latency (up to 24 hours) for a separate, larger
+// quota and a lower price.
+class BatchClient {
+public:
+    BatchClient(std::string api_key, std::string base_url, RequestOptions request_options,
+                std::chrono::milliseconds poll_interval, std::chrono::milliseconds timeout);
+
+    // Submits `requests` to `endpoint` (e.g. "/v1/chat/completions") and blocks until every batch is done. Returns
+    // the response body of each request that succeeded, keyed by custom_id; failed or expired requests are missing.
+    // Throws, after cancelling the batches still running, once `timeout` has passed, the calling thread's
+    // RequestCancellation fires or a part cannot be submitted. The input and output files are deleted from the
+    // provider's storage once their batch is done with.
+    std::unordered_map<std::string, std::string> Run(const std::string& endpoint,
+                                                     const std::vector<BatchRequest>& requests) const;
+
+    static std::string ToJsonl(const std::string& endpoint, const std::vector<BatchRequest>& requests, size_t begin,
+                               size_t end);
+    // Collects the bodies of the successful lines of a batch output file.
+    static void ParseOutput(const std::string& jsonl, std::unordered_map<std::string, std::string>& bodies);
+
+    // Limit of the OpenAI Batch API on the number of requests in one input file.
+    static constexpr size_t kMaxRequestsPerBatch = 50000;
+
+private:
+    struct Batch {
+        std::string id;
+        std::string input_file_id;
+    };
+
+    Batch Submit(const std::string& endpoint, const std::vector<BatchRequest>& requests, size_t begin,
+                 size_t end) const;
+    nlohmann::json Wait(const std::string& batch_id, std::chrono::steady_clock::time_point deadline) const;
+    // Best effort; the batch keeps its results if cancelling fails.
+    void Cancel(const std::string& batch_id) const;
+    // Best effort; a file left behind only takes up storage.
+    void DeleteFile(const std::string& file_id) const;
+    // Cancels the batches from `first` on, whose results nobody is going to collect, and deletes their input files.
+    void Abandon(const std::vector<Batch>& batches, size_t first) const;
+
+    std::string api_key_;
+    std::string base_url_;
+    RequestOptions request_options_;
+    std::chrono::milliseconds poll_interval_;
+    std::chrono::milliseconds timeout_;
+};
+
+} // namespace flockmtl
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace flockmtl {
+
+// Process-wide circuit breakers, one per endpoint URL. After kFailureThreshold consecutive failures (connection
+// errors, timeouts, 5xx) the circuit opens and requests to the endpoint fail immediately instead of piling up behind
+// a provider that is down. Once the open duration has passed a single probe is let through: its success closes the
+// circuit, its failure opens it again.
+class CircuitBreaker {
+public:
+    static bool Allow(const std::string& endpoint);
+    static void RecordSuccess(const std::string& endpoint);
+    static void RecordFailure(const std::string& endpoint);
+    static void Configure(int failure_threshold, std::chrono::milliseconds open_duration);
+    static void Reset();
+
+    static constexpr int kFailureThreshold = 5;
+    static constexpr std::chrono::milliseconds kOpenDuration {30000};
+
+private:
+    enum class State { CLOSED, OPEN, HALF_OPEN };
+
+    struct Circuit {
+        State state = State::CLOSED;
+        int consecutive_failures = 0;
+        // When the circuit opened, or when the current probe was let through.
+        std::chrono::steady_clock::time_point since;
+    };
+
+    static std::mutex mutex_;
+    static std::unordered_map<std::string, Circuit> circuits_;
+    static int failure_threshold_;
+    static std::chrono::milliseconds open_duration_;
+};
+
+} // namespace flockmtl
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace flockmtl {
+
+// Sliding window of recent successful call latencies per provider/secret/model key, used to decide when a call is
+// slow enough to hedge.
+class LatencyTracker {
+public:
+    static void Record(const std::string& key, std::chrono::milliseconds latency);
+    // The given percentile (0..1) of the window, or nullopt until kMinSamples latencies were recorded.
+    static std::optional<std::chrono::milliseconds> GetPercentile(const std::string& key, double percentile);
+    static void Reset();
+
+    static constexpr size_t kWindowSize = 256;
+    static constexpr size_t kMinSamples = 20;
+
+private:
+    struct Window {
+        std::vector<int64_t> samples;
+        size_t next = 0;
+    };
+
+    static std::mutex mutex_;
+    static std::unordered_map<std::string, Window> windows_;
+};
+
+} // namespace flockmtl
@@ -1,5 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <tuple>
 #include <vector>
 #include <string>
@@ -9,9 +18,15 @@
 
 #include "flockmtl/core/config.hpp"
 #include "flockmtl/model_manager/repository.hpp"
+#include "flockmtl/model_manager/latency_tracker.hpp"
+#include "flockmtl/model_manager/profiler.hpp"
+#include "flockmtl/model_manager/rate_limiter.hpp"
+#include "flockmtl/model_manager/tiktoken.hpp"
 #include "flockmtl/model_manager/providers/adapters/openai.hpp"
 #include "flockmtl/model_manager/providers/adapters/azure.hpp"
 #include "flockmtl/model_manager/providers/adapters/ollama.hpp"
+#include "flockmtl/model_manager/providers/adapters/pool.hpp"
+#include "flockmtl/model_manager/providers/adapters/replay.hpp"
 #include "flockmtl/model_manager/providers/handlers/ollama.hpp"
 #include "duckdb/main/connection.hpp"
 
@@ -21,17 +36,52 @@ class Model {
 public:
     explicit Model(const nlohmann::json& model_json);
     explicit Model() = default;
+    // Wraps an existing provider instead of a catalog model, e.g. a stub in benchmarks.
+    explicit Model(std::shared_ptr<IProvider> provider)
+        : provider_(std::move(provider)), model_details_(provider_->model_details_) {}
     nlohmann::json CallComplete(const std::string& prompt, const bool json_response = true);
     nlohmann::json CallEmbedding(const std::vector<std::string>& inputs);
+    void CallEmbeddingInto(const std::vector<std::string>& inputs, EmbeddingSink& sink);
     ModelDetails GetModelDetails();
+    // Provider, secret and model: the unit that rate limits and latency statistics are tracked for.
+    std::string GetRateLimitKey() const;
+    // Provider of the model that `model_json` describes, without building it.
+    static std::string GetProviderName(const nlohmann::json& model_json);
+    // Completion tokens the provider reported for the last CallComplete on this thread, if it reported any.
+    static std::optional<int64_t> TakeCompletionTokens() {
+        auto tokens = last_completion_tokens_;
+        last_completion_tokens_.reset();
+        return tokens;
+    }
+
+    // A hedged completion sends a duplicate request once the first one has taken longer than this percentile of
+    // recent latencies, and uses whichever answers first.
+    static constexpr double kHedgePercentile = 0.95;
 
 private:
     std::shared_ptr<IProvider> provider_;
     ModelDetails model_details_;
     void ConstructProvider();
     void LoadModelDetails(const nlohmann::json& model_json);
-    std::tuple<std::string, std::string, int32_t, int32_t> GetQueriedModel(const std::string& model_name);
+    static std::tuple<std::string, std::string, nlohmann::json> GetQueriedModel(const std::string& model_name);
+    nlohmann::json CallCompleteOnce(const std::string& prompt, int64_t prompt_tokens, bool json_response,
+                                    int64_t charged_tokens);
+    nlohmann::json CallCompleteHedged(const std::string& prompt, int64_t prompt_tokens, bool json_response,
+                                      std::chrono::milliseconds hedge_after);
+    // Pools and recording replay models pass calls on to other models, which profile them.
+    bool DelegatesCalls() const;
+    // Aborts the query if a request of `prompt_tokens` would exceed its token or cost budget.
+    void CheckQueryBudget(int64_t prompt_tokens) const;
+    // Charges a call to the query's budget and returns its cost.
+    double ChargeQueryBudget(int64_t prompt_tokens, int64_t completion_tokens) const;
+    void ProfileEmbedding(const std::vector<std::string>& inputs, const std::function<void()>& call);
+    static int64_t EstimateTokens(const std::vector<std::string>& inputs);
     std::string GetSecret(const std::string& secret_name);
+
+    // Pool and replay models being built on this thread, so one that reaches itself through its backends fails
+    // instead of recursing.
+    static inline thread_local std::vector<std::string> constructing_;
+    static inline thread_local std::optional<int64_t> last_completion_tokens_;
 };
 
 } // namespace flockmtl
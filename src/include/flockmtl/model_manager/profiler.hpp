@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flockmtl/model_manager/providers/handlers/request_options.hpp"
+#include "flockmtl/model_manager/query_budget.hpp"
+
+namespace flockmtl {
+
+// What one function (e.g. llm_filter) spent on providers during one query.
+struct CallSiteProfile {
+    // Request latencies in power-of-two buckets: bucket 0 holds latencies below 1 ms, bucket i those in
+    // [2^(i-1), 2^i) ms, and the last bucket everything slower.
+    static constexpr size_t kLatencyBuckets = 24;
+
+    int64_t requests = 0;
+    int64_t failed_requests = 0;
+    int64_t batches = 0;
+    int64_t tuples = 0;
+    int64_t max_batch_size = 0;
+    int64_t prompt_tokens = 0;
+    int64_t completion_tokens = 0;
+    int64_t retries = 0;
+    int64_t cache_hits = 0;
+    // Tuples a model cascade evaluated with its first model, and how many of them it escalated to the stronger one.
+    int64_t cascaded_tuples = 0;
+    int64_t escalations = 0;
+    // Estimated from the model's prices per million tokens, zero when it has none.
+    double cost = 0;
+    std::chrono::microseconds total_latency {0};
+    std::chrono::microseconds max_latency {0};
+    std::array<int64_t, kLatencyBuckets> latency_histogram {};
+
+    // Upper bound of the bucket that holds the given percentile (0..1) of request latencies, capped at the maximum.
+    std::chrono::microseconds GetLatencyPercentile(double percentile) const;
+    static size_t GetLatencyBucket(std::chrono::microseconds latency);
+    static std::chrono::microseconds GetBucketUpperBound(size_t bucket);
+};
+
+struct QueryProfile {
+    uint64_t query_id = 0;
+    std::map<std::string, CallSiteProfile> call_sites;
+};
+
+// Records provider requests, batches, token usage, retries, cache hits and escalations per query and calling function.
+// Events are attributed to the scope installed on the calling thread and dropped outside of any scope.
+class Profiler {
+public:
+    struct Context {
+        const void* client = nullptr;
+        uint64_t query_id = 0;
+        std::string function_name;
+    };
+
+    class Scope {
+    public:
+        Scope(const void* client, uint64_t query_id, std::string function_name);
+        // Carries a scope over to another thread, e.g. the attempts of a hedged request.
+        explicit Scope(Context context);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Context previous_;
+    };
+
+    static Context Current() { return current_; }
+
+    static void RecordRequest(std::chrono::microseconds latency, int64_t prompt_tokens, int64_t completion_tokens,
+                              double cost, bool failed);
+    static void RecordBatch(size_t tuples);
+    static void RecordRetry();
+    static void RecordCacheHit(size_t tuples);
+    static void RecordCascade(size_t tuples, size_t escalations);
+
+    // The latest queries of a client, oldest first.
+    static std::vector<QueryProfile> GetProfiles(const void* client);
+    static void Reset();
+
+    // Number of queries kept per client.
+    static constexpr size_t kMaxQueries = 16;
+
+private:
+    template <typename UPDATE>
+    static void Update(UPDATE&& update);
+
+    static thread_local Context current_;
+    static std::mutex mutex_;
+    static std::unordered_map<const void*, std::deque<QueryProfile>> profiles_;
+};
+
+// Attributes the provider calls made on this thread to the query and function issuing them, for the query's retry and
+// token budgets and for its profile.
+class FunctionScope {
+public:
+    // Everything the scopes of the calling thread mark, so that work handed to another thread is attributed the same.
+    struct Context {
+        QueryBudgets::Context budgets;
+        Profiler::Context profiler;
+        const std::atomic<bool>* cancellation = nullptr;
+    };
+
+    FunctionScope(QueryBudgets* budgets, const void* client, const uint64_t query_id, std::string function_name,
+                  const QueryBudget::Limits limits = {})
+        : budget_scope_({budgets, query_id, limits}), profiler_scope_(client, query_id, std::move(function_name)),
+          cancellation_scope_(RequestCancellation::Current()) {}
+    explicit FunctionScope(Context context)
+        : budget_scope_(context.budgets), profiler_scope_(std::move(context.profiler)),
+          cancellation_scope_(context.cancellation) {}
+
+    static Context Current() { return {QueryBudgets::Current(), Profiler::Current(), RequestCancellation::Current()}; }
+
+private:
+    QueryBudgets::Scope budget_scope_;
+    Profiler::Scope profiler_scope_;
+    RequestCancellation::Scope cancellation_scope_;
+};
+
+} // namespace flockmtl
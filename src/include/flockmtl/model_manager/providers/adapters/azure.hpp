@@ -11,6 +11,7 @@ public:
 
     nlohmann::json CallComplete(const std::string &prompt, bool json_response) override;
     nlohmann::json CallEmbedding(const std::vector<std::string> &inputs) override;
+    void CallEmbeddingInto(const std::vector<std::string> &inputs, EmbeddingSink &sink) override;
 };
 
 } // namespace flockmtl
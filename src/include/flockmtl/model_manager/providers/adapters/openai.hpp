@@ -11,6 +11,13 @@ public:
 
     nlohmann::json CallComplete(const std::string &prompt, bool json_response) override;
     nlohmann::json CallEmbedding(const std::vector<std::string> &inputs) override;
+    void CallEmbeddingInto(const std::vector<std::string> &inputs, EmbeddingSink &sink) override;
+
+    // Request bodies and response decoding, shared with the bulk mode that sends the same requests through the
+    // Batch API.
+    nlohmann::json GetCompletionPayload(const std::string &prompt, bool json_response) const;
+    nlohmann::json GetEmbeddingPayload(const std::vector<std::string> &inputs) const;
+    static nlohmann::json ParseCompletion(const std::string &response, bool json_response);
 };
 
 } // namespace flockmtl
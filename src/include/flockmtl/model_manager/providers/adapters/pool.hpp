@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "flockmtl/model_manager/providers/provider.hpp"
+
+namespace flockmtl {
+
+class Model;
+
+// Spreads the calls of one logical model over several backend models, e.g. deployments, secrets or local servers
+// that serve the same model. Each call goes to the healthy backend with the fewest outstanding requests relative to
+// its weight and fails over to the next backend when one is unreachable or unavailable (ProviderUnavailableError).
+// Backends keep their own rate limits, so a pool's throughput is the sum of theirs.
+class PoolProvider : public IProvider {
+public:
+    explicit PoolProvider(const ModelDetails& model_details);
+
+    nlohmann::json CallComplete(const std::string& prompt, bool json_response) override;
+    nlohmann::json CallEmbedding(const std::vector<std::string>& inputs) override;
+    void CallEmbeddingInto(const std::vector<std::string>& inputs, EmbeddingSink& sink) override;
+
+    struct BackendLoad {
+        double weight = 1;
+        int64_t outstanding_requests = 0;
+        int64_t outstanding_tokens = 0;
+        bool healthy = true;
+    };
+
+    // Index of the backend the next call should go to: the healthy one with the fewest outstanding requests per unit
+    // of weight, ties broken by outstanding tokens. Unhealthy backends are only chosen when no healthy one is left.
+    static size_t PickBackend(const std::vector<BackendLoad>& loads);
+    static void Reset();
+
+    // Consecutive failures after which a backend is skipped for kUnhealthyDuration.
+    static constexpr int kFailureThreshold = 3;
+    static constexpr std::chrono::milliseconds kUnhealthyDuration {30000};
+
+private:
+    struct Backend {
+        std::shared_ptr<Model> model;
+        std::string key;
+        double weight;
+    };
+
+    // Shared by every pool that uses the same backend, across queries and threads.
+    struct BackendState {
+        int64_t outstanding_requests = 0;
+        int64_t outstanding_tokens = 0;
+        int consecutive_failures = 0;
+        std::chrono::steady_clock::time_point unhealthy_until;
+    };
+
+    void Dispatch(int64_t estimated_tokens, const std::function<void(Model&)>& call);
+    size_t Acquire(const std::vector<bool>& tried, int64_t estimated_tokens);
+    static void Release(const std::string& key, int64_t estimated_tokens, bool healthy);
+
+    std::vector<Backend> backends_;
+
+    static std::mutex mutex_;
+    static std::unordered_map<std::string, BackendState> states_;
+};
+
+} // namespace flockmtl
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include "flockmtl/model_manager/providers/provider.hpp"
+#include "flockmtl/model_manager/replay_log.hpp"
+
+namespace flockmtl {
+
+class Model;
+
+// Serves completions and embeddings from a replay file instead of a provider, after a synthetic latency, so the
+// batching, rendering and parsing layers can be measured without a network. In record mode the calls go to a backend
+// model and every exchange is appended to the file.
+class ReplayProvider : public IProvider {
+public:
+    explicit ReplayProvider(const ModelDetails& model_details);
+
+    nlohmann::json CallComplete(const std::string& prompt, bool json_response) override;
+    nlohmann::json CallEmbedding(const std::vector<std::string>& inputs) override;
+
+    // Uniform in [latency - jitter, latency + jitter], never negative.
+    static std::chrono::milliseconds GetSyntheticLatency(std::chrono::milliseconds latency,
+                                                         std::chrono::milliseconds jitter);
+
+private:
+    nlohmann::json Replay(const nlohmann::json& request);
+
+    std::shared_ptr<ReplayLog> log_;
+    std::shared_ptr<Model> backend_;
+};
+
+} // namespace flockmtl
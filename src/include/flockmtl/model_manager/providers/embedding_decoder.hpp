@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flockmtl/core/json_scanner.hpp"
+
+namespace flockmtl {
+
+// Receives decoded embeddings one row at a time; `row` is the position of the input in the request batch.
+class EmbeddingSink {
+public:
+    virtual ~EmbeddingSink() = default;
+    virtual void Write(size_t row, const double* values, size_t count) = 0;
+};
+
+// Decodes `data[].embedding` out of an OpenAI-style embeddings response in a single pass and without building a DOM.
+// Float arrays go through a fast decimal parser and base64 payloads (`encoding_format: base64`) through a vectorized
+// decoder; either way each row reaches the sink as one contiguous run of doubles.
+class EmbeddingDecoder {
+public:
+    // Returns the number of rows written to the sink. `rows` is the number of inputs in the request; an item whose
+    // index falls outside of them or repeats an earlier one is rejected before it reaches the sink.
+    static size_t Decode(std::string_view response, size_t rows, EmbeddingSink& sink);
+
+    // Decodes the JSON number array starting at `pos` into `out` and returns the offset just past the closing ']'.
+    static size_t DecodeFloatArray(std::string_view json, size_t pos, std::vector<double>& out);
+    // Decodes base64-encoded little-endian float32 values into `out`.
+    static void DecodeBase64Floats(std::string_view encoded, std::vector<double>& out);
+    static void DecodeBase64(std::string_view encoded, std::vector<uint8_t>& out);
+
+    // Parses one JSON number starting at `pos` and advances `pos` past it.
+    static double ParseNumber(std::string_view json, size_t& pos);
+
+private:
+    static size_t DecodeItem(std::string_view json, size_t pos, size_t default_row, std::vector<bool>& written,
+                             EmbeddingSink& sink, std::vector<double>& values);
+};
+
+} // namespace flockmtl
@@ -18,6 +18,8 @@ public:
         _session.setToken(token, "");
     }
 
+    void SetRequestOptions(const RequestOptions& request_options) { _session.setRequestOptions(request_options); }
+
     AzureModelManager(const AzureModelManager&) = delete;
     AzureModelManager& operator=(const AzureModelManager&) = delete;
     AzureModelManager(AzureModelManager&&) = delete;
@@ -30,6 +32,13 @@ public:
         return execute_post(json.dump(), contentType);
     }
 
+    std::string CallCompleteText(const nlohmann::json& json, const std::string& contentType = "application/json") {
+        std::string url = "https://" + _resource_name + ".openai.azure.com/openai/deployments/" +
+                          _deployment_model_name + "/chat/completions?api-version=" + _api_version;
+        _session.setUrl(url);
+        return execute_post_text(json.dump(), contentType);
+    }
+
     nlohmann::json CallEmbedding(const nlohmann::json& json, const std::string& contentType = "application/json") {
         std::string url = "https://" + _resource_name + ".openai.azure.com/openai/deployments/" +
                           _deployment_model_name + "/embeddings?api-version=" + _api_version;
@@ -37,6 +46,13 @@ public:
         return execute_post(json.dump(), contentType);
     }
 
+    std::string CallEmbeddingText(const nlohmann::json& json, const std::string& contentType = "application/json") {
+        std::string url = "https://" + _resource_name + ".openai.azure.com/openai/deployments/" +
+                          _deployment_model_name + "/embeddings?api-version=" + _api_version;
+        _session.setUrl(url);
+        return execute_post_text(json.dump(), contentType);
+    }
+
     // I am adding it here since I want to keep provider specific calls
     // inside same file
     static const char* get_azure_api_key() {
@@ -103,9 +119,8 @@ private:
             trigger_error(response.error_message);
         }
 
-        nlohmann::json json {};
-        if (isJson(response.text)) {
-            json = nlohmann::json::parse(response.text);
+        auto json = nlohmann::json::parse(response.text, nullptr, false);
+        if (!json.is_discarded()) {
             checkResponse(json);
         } else {
             trigger_error("Response is not a valid JSON");
@@ -114,6 +129,15 @@ private:
         return json;
     }
 
+    std::string execute_post_text(const std::string& data, const std::string& contentType) {
+        setParameters(data, contentType);
+        auto response = _session.postPrepare(contentType);
+        if (response.is_error) {
+            trigger_error(response.error_message);
+        }
+        return std::move(response.text);
+    }
+
     void trigger_error(const std::string& msg) {
         if (_throw_exception) {
             throw std::runtime_error("[Azure] error. Reason: " + msg);
@@ -130,16 +154,6 @@ private:
         }
     }
 
-    bool isJson(const std::string& data) {
-        bool rc = true;
-        try {
-            auto json = nlohmann::json::parse(data); // throws if no json
-        } catch (std::exception&) {
-            rc = false;
-        }
-        return (rc);
-    }
-
     void setParameters(const std::string& data, const std::string& contentType = "") {
         if (contentType != "multipart/form-data") {
             _session.setBody(data);
@@ -14,6 +14,8 @@ class OllamaModelManager {
 public:
     OllamaModelManager(const std::string& url, const bool throw_exception)
         : _session("Ollama", throw_exception), _throw_exception(throw_exception), _url(url) {}
+    void SetRequestOptions(const RequestOptions& request_options) { _session.setRequestOptions(request_options); }
+
     OllamaModelManager(const OllamaModelManager&) = delete;
     OllamaModelManager& operator=(const OllamaModelManager&) = delete;
     OllamaModelManager(OllamaModelManager&&) = delete;
@@ -45,6 +47,12 @@ public:
         return execute_post(json.dump(), contentType);
     }
 
+    std::string CallCompleteText(const nlohmann::json& json, const std::string& contentType = "application/json") {
+        const std::string url = GetChatUrl();
+        _session.setUrl(url);
+        return execute_post_text(json.dump(), contentType);
+    }
+
     nlohmann::json CallEmbedding(const nlohmann::json& json, const std::string& contentType = "application/json") {
         const std::string url = GetEmbedUrl();
         _session.setUrl(url);
@@ -77,10 +85,8 @@ private:
             trigger_error(response.error_message);
         }
 
-        nlohmann::json json {};
-        if (isJson(response.text)) {
-
-            json = nlohmann::json::parse(response.text);
+        auto json = nlohmann::json::parse(response.text, nullptr, false);
+        if (!json.is_discarded()) {
             checkResponse(json);
         } else {
             trigger_error("Response is not a valid JSON");
@@ -89,6 +95,15 @@ private:
         return json;
     }
 
+    std::string execute_post_text(const std::string& data, const std::string& contentType) {
+        setParameters(data, contentType);
+        auto response = _session.postPrepareOllama(contentType);
+        if (response.is_error) {
+            trigger_error(response.error_message);
+        }
+        return std::move(response.text);
+    }
+
     void trigger_error(const std::string& msg) {
         if (_throw_exception) {
             throw std::runtime_error(msg);
@@ -105,16 +120,6 @@ private:
         }
     }
 
-    bool isJson(const std::string& data) {
-        bool rc = true;
-        try {
-            auto json = nlohmann::json::parse(data); // throws if no json
-        } catch (std::exception&) {
-            rc = false;
-        }
-        return (rc);
-    }
-
     void setParameters(const std::string& data, const std::string& contentType = "") {
         if (contentType != "multipart/form-data") {
             _session.setBody(data);
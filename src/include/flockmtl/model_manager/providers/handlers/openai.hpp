@@ -131,6 +131,7 @@ private:
 // Given a prompt, the model will return one or more predicted chat completions.
 struct CategoryChat {
     Json create(Json input);
+    std::string createText(const Json &input);
 
     CategoryChat(OpenAI &openai) : openai_ {openai} {}
 
@@ -180,6 +181,7 @@ private:
 // machine learning models and algorithms.
 struct CategoryEmbedding {
     Json create(Json input);
+    std::string createText(const Json &input);
     CategoryEmbedding(OpenAI &openai) : openai_ {openai} {}
 
 private:
@@ -200,6 +202,7 @@ struct CategoryFile {
     Json del(const std::string &file); // TODO
     Json retrieve(const std::string &file_id);
     Json content(const std::string &file_id);
+    std::string contentText(const std::string &file_id);
 
     CategoryFile(OpenAI &openai) : openai_ {openai} {}
 
@@ -207,6 +210,19 @@ private:
     OpenAI &openai_;
 };
 
+// https://platform.openai.com/docs/api-reference/batch
+// Runs a file of requests asynchronously, at a lower cost and with a separate quota.
+struct CategoryBatch {
+    Json create(Json input);
+    Json retrieve(const std::string &batch_id);
+    Json cancel(const std::string &batch_id);
+
+    CategoryBatch(OpenAI &openai) : openai_ {openai} {}
+
+private:
+    OpenAI &openai_;
+};
+
 // https://platform.openai.com/docs/api-reference/fine-tunes
 // Manage fine-tuning jobs to tailor a model to your specific training data.
 struct CategoryFineTune {
@@ -291,6 +307,8 @@ public:
 
     void setBeta(const std::string &beta) { session_.setBeta(beta); }
 
+    void setRequestOptions(const flockmtl::RequestOptions &request_options) { session_.setRequestOptions(request_options); }
+
     // void change_token(const std::string& token) { token_ = token; };
     void setThrowException(bool throw_exception) { throw_exception_ = throw_exception; }
 
@@ -306,21 +324,31 @@ public:
             trigger_error(response.error_message);
         }
 
-        Json json {};
-        if (isJson(response.text)) {
-
-            json = Json::parse(response.text);
+        auto json = Json::parse(response.text, nullptr, false);
+        if (!json.is_discarded()) {
             checkResponse(json);
         } else {
 #if OPENAI_VERBOSE_OUTPUT
             std::cerr << "Response is not a valid JSON";
             std::cout << "<< " << response.text << "\n";
 #endif
+            json = Json {};
         }
 
         return json;
     }
 
+    // Same as post() but hands back the raw body, leaving decoding to the caller.
+    std::string postText(const std::string &suffix, const std::string &data,
+                         const std::string &contentType = "application/json") {
+        setParameters(suffix, data, contentType);
+        auto response = session_.postPrepare(contentType);
+        if (response.is_error) {
+            trigger_error(response.error_message);
+        }
+        return std::move(response.text);
+    }
+
     Json get(const std::string &suffix, const std::string &data = "") {
         setParameters(suffix, data);
         auto response = session_.getPrepare();
@@ -328,9 +356,8 @@ public:
             trigger_error(response.error_message);
         }
 
-        Json json {};
-        if (isJson(response.text)) {
-            json = Json::parse(response.text);
+        auto json = Json::parse(response.text, nullptr, false);
+        if (!json.is_discarded()) {
             checkResponse(json);
         } else {
 #if OPENAI_VERBOSE_OUTPUT
@@ -342,6 +369,16 @@ public:
         return json;
     }
 
+    // Same as get() but hands back the raw body, e.g. for JSONL file contents.
+    std::string getText(const std::string &suffix) {
+        setParameters(suffix, "");
+        auto response = session_.getPrepare();
+        if (response.is_error) {
+            trigger_error(response.error_message);
+        }
+        return std::move(response.text);
+    }
+
     Json post(const std::string &suffix, const Json &json, const std::string &contentType = "application/json") {
         return post(suffix, json.dump(), contentType);
     }
@@ -353,15 +390,15 @@ public:
             trigger_error(response.error_message);
         }
 
-        Json json {};
-        if (isJson(response.text)) {
-            json = Json::parse(response.text);
+        auto json = Json::parse(response.text, nullptr, false);
+        if (!json.is_discarded()) {
             checkResponse(json);
         } else {
 #if OPENAI_VERBOSE_OUTPUT
             std::cerr << "Response is not a valid JSON\n";
             std::cout << "<< " << response.text << "\n";
 #endif
+            json = Json {};
         }
         return json;
     }
@@ -401,17 +438,6 @@ private:
         }
     }
 
-    // as of now the only way
-    bool isJson(const std::string &data) {
-        bool rc = true;
-        try {
-            auto json = Json::parse(data); // throws if no json
-        } catch (std::exception &) {
-            rc = false;
-        }
-        return (rc);
-    }
-
     void trigger_error(const std::string &msg) {
         if (throw_exception_) {
             throw std::runtime_error(msg);
@@ -429,6 +455,7 @@ public:
     CategoryImage image {*this};
     CategoryEmbedding embedding {*this};
     CategoryFile file {*this};
+    CategoryBatch batch {*this};
     CategoryFineTune fine_tune {*this};
     CategoryModeration moderation {*this};
     CategoryChat chat {*this};
@@ -671,6 +698,10 @@ inline Json CategoryCompletion::create(Json input) { return openai_.post("comple
 // Creates a chat completion for the provided prompt and parameters
 inline Json CategoryChat::create(Json input) { return openai_.post("chat/completions", input); }
 
+inline std::string CategoryChat::createText(const Json &input) {
+    return openai_.postText("chat/completions", input.dump());
+}
+
 // POST https://api.openai.com/v1/audio/transcriptions
 // Transcribes audio into the input language.
 inline Json CategoryAudio::transcribe(Json input) {
@@ -797,6 +828,10 @@ inline Json CategoryImage::variation(Json input) {
 
 inline Json CategoryEmbedding::create(Json input) { return openai_.post("embeddings", input); }
 
+inline std::string CategoryEmbedding::createText(const Json &input) {
+    return openai_.postText("embeddings", input.dump());
+}
+
 inline Json CategoryFile::list() { return openai_.get("files"); }
 
 inline Json CategoryFile::upload(Json input) {
@@ -812,6 +847,21 @@ inline Json CategoryFile::retrieve(const std::string &file_id) { return openai_.
 
 inline Json CategoryFile::content(const std::string &file_id) { return openai_.get("files/" + file_id + "/content"); }
 
+inline std::string CategoryFile::contentText(const std::string &file_id) {
+    return openai_.getText("files/" + file_id + "/content");
+}
+
+// POST https://api.openai.com/v1/batches
+inline Json CategoryBatch::create(Json input) { return openai_.post("batches", input); }
+
+// GET https://api.openai.com/v1/batches/{batch_id}
+inline Json CategoryBatch::retrieve(const std::string &batch_id) { return openai_.get("batches/" + batch_id); }
+
+// POST https://api.openai.com/v1/batches/{batch_id}/cancel
+inline Json CategoryBatch::cancel(const std::string &batch_id) {
+    return openai_.post("batches/" + batch_id + "/cancel", Json {});
+}
+
 inline Json CategoryFineTune::create(Json input) { return openai_.post("fine-tunes", input); }
 
 inline Json CategoryFineTune::list() { return openai_.get("fine-tunes"); }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "flockmtl/model_manager/rate_limiter.hpp"
+#include "flockmtl/model_manager/retry_budget.hpp"
+
+namespace flockmtl {
+
+struct RequestOptions {
+    int max_retries = 6;
+    std::chrono::milliseconds base_delay {500};
+    std::chrono::milliseconds max_delay {60000};
+    // Shared by all requests of a query; nullptr means only max_retries applies.
+    std::shared_ptr<RetryBudget> budget;
+    std::chrono::milliseconds connect_timeout {10000};
+    // Upper bound for a whole attempt, including the time the provider spends generating; zero disables it.
+    std::chrono::milliseconds request_timeout {300000};
+    // Retries are charged against the same rate limits as the first attempt; an empty key leaves them uncharged.
+    std::string rate_limit_key;
+    RateLimits rate_limits;
+};
+
+// Lets a caller abandon the requests issued on the current thread, e.g. the losing side of a hedged request.
+// Sessions poll the flag while transferring and between retries.
+class RequestCancellation {
+public:
+    class Scope {
+    public:
+        explicit Scope(const std::atomic<bool>* flag) : previous_(current_) { current_ = flag; }
+        ~Scope() { current_ = previous_; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const std::atomic<bool>* previous_;
+    };
+
+    static const std::atomic<bool>* Current() { return current_; }
+    static bool IsCancelled() { return current_ != nullptr && current_->load(); }
+
+private:
+    static inline thread_local const std::atomic<bool>* current_ = nullptr;
+};
+
+} // namespace flockmtl
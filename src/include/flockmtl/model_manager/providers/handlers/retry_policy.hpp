@@ -0,0 +1,204 @@
+#pragma once
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <map>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "flockmtl/model_manager/providers/handlers/request_options.hpp"
+
+namespace flockmtl {
+
+// A request that failed because the provider could not be reached or reported itself unavailable, rather than
+// because of the request itself; another deployment of the model may well serve it.
+class ProviderUnavailableError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Decides whether a failed HTTP exchange is worth repeating and how long to wait before doing so. The server's own
+// hints (Retry-After, retry-after-ms, x-ratelimit-*) take precedence over exponential backoff.
+class RetryPolicy {
+public:
+    static bool IsRetryable(const CURLcode curl_code, const long status_code, const std::string& body) {
+        switch (curl_code) {
+            case CURLE_OK:
+                break;
+            case CURLE_COULDNT_RESOLVE_HOST:
+            case CURLE_COULDNT_CONNECT:
+            case CURLE_OPERATION_TIMEDOUT:
+            case CURLE_SEND_ERROR:
+            case CURLE_RECV_ERROR:
+            case CURLE_GOT_NOTHING:
+            case CURLE_PARTIAL_FILE:
+            case CURLE_SSL_CONNECT_ERROR:
+            case CURLE_HTTP2:
+            case CURLE_HTTP2_STREAM:
+                return true;
+            default:
+                return false;
+        }
+        switch (status_code) {
+            case 429:
+                // An exhausted quota does not come back by waiting.
+                return body.find("insufficient_quota") == std::string::npos;
+            case 408:
+            case 500:
+            case 502:
+            case 503:
+            case 504:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Transport failures, timeouts, rate limiting and server errors, retryable or not once the retries ran out. A
+    // transfer the caller cancelled is not one.
+    static bool IsUnavailable(const CURLcode curl_code, const long status_code) {
+        if (curl_code != CURLE_OK) {
+            return curl_code != CURLE_ABORTED_BY_CALLBACK;
+        }
+        return status_code == 408 || status_code == 429 || status_code >= 500;
+    }
+
+    static std::chrono::milliseconds GetDelay(const int attempt, const std::map<std::string, std::string>& headers,
+                                              const RequestOptions& options) {
+        if (const auto server_delay = GetServerDelay(headers); server_delay.has_value()) {
+            // Spread clients that were told the same reset time over an extra 10%.
+            const auto jitter = static_cast<int64_t>(server_delay->count() * 0.1 * UniformRandom());
+            return std::min(options.max_delay, *server_delay + std::chrono::milliseconds(jitter));
+        }
+        return GetBackoff(attempt, options);
+    }
+
+    // Exponential backoff with equal jitter: half of the step is fixed, the other half random.
+    static std::chrono::milliseconds GetBackoff(const int attempt, const RequestOptions& options) {
+        const auto exponent = std::min(attempt, 20);
+        const auto step = std::min(static_cast<double>(options.max_delay.count()),
+                                   static_cast<double>(options.base_delay.count()) * static_cast<double>(1 << exponent));
+        return std::chrono::milliseconds(static_cast<int64_t>(step / 2 + step / 2 * UniformRandom()));
+    }
+
+    static std::optional<std::chrono::milliseconds> GetServerDelay(const std::map<std::string, std::string>& headers) {
+        if (const auto it = headers.find("retry-after-ms"); it != headers.end()) {
+            char* end = nullptr;
+            const auto ms = std::strtod(it->second.c_str(), &end);
+            if (end != it->second.c_str() && ms >= 0) {
+                return std::chrono::milliseconds(static_cast<int64_t>(ms));
+            }
+        }
+        if (const auto it = headers.find("retry-after"); it != headers.end()) {
+            char* end = nullptr;
+            const auto seconds = std::strtod(it->second.c_str(), &end);
+            if (end != it->second.c_str() && *end == '\0' && seconds >= 0) {
+                return std::chrono::milliseconds(static_cast<int64_t>(seconds * 1000));
+            }
+            // Otherwise an HTTP date.
+            const auto at = curl_getdate(it->second.c_str(), nullptr);
+            if (at >= 0) {
+                const auto delta = std::difftime(at, std::time(nullptr));
+                return std::chrono::milliseconds(static_cast<int64_t>(std::max(0.0, delta) * 1000));
+            }
+        }
+
+        // OpenAI-style budget headers: wait for whichever exhausted budget resets last.
+        std::optional<std::chrono::milliseconds> delay;
+        for (const auto* budget : {"requests", "tokens"}) {
+            const auto remaining = headers.find(std::string("x-ratelimit-remaining-") + budget);
+            const auto reset = headers.find(std::string("x-ratelimit-reset-") + budget);
+            if (remaining == headers.end() || reset == headers.end() || std::atof(remaining->second.c_str()) > 0) {
+                continue;
+            }
+            if (const auto reset_delay = ParseDuration(reset->second); reset_delay.has_value()) {
+                delay = delay.has_value() ? std::max(*delay, *reset_delay) : *reset_delay;
+            }
+        }
+        return delay;
+    }
+
+    // Parses durations such as "20ms", "1.5s" or "6m0s".
+    static std::optional<std::chrono::milliseconds> ParseDuration(const std::string& text) {
+        double total_ms = 0;
+        size_t pos = 0;
+        auto parsed_any = false;
+        while (pos < text.size()) {
+            char* end = nullptr;
+            const auto value = std::strtod(text.c_str() + pos, &end);
+            const auto consumed = static_cast<size_t>(end - (text.c_str() + pos));
+            if (consumed == 0) {
+                return std::nullopt;
+            }
+            pos += consumed;
+            auto unit_end = pos;
+            while (unit_end < text.size() && std::isalpha(static_cast<unsigned char>(text[unit_end]))) {
+                unit_end++;
+            }
+            const auto unit = text.substr(pos, unit_end - pos);
+            if (unit == "ms") {
+                total_ms += value;
+            } else if (unit == "s" || unit.empty()) {
+                total_ms += value * 1000;
+            } else if (unit == "m") {
+                total_ms += value * 60 * 1000;
+            } else if (unit == "h") {
+                total_ms += value * 60 * 60 * 1000;
+            } else {
+                return std::nullopt;
+            }
+            pos = unit_end;
+            parsed_any = true;
+        }
+        if (!parsed_any) {
+            return std::nullopt;
+        }
+        return std::chrono::milliseconds(static_cast<int64_t>(total_ms));
+    }
+
+    // Header names are lower-cased; only the headers of the last response in the exchange are kept.
+    static std::map<std::string, std::string> ParseHeaders(const std::string& header_string) {
+        std::map<std::string, std::string> headers;
+        size_t pos = 0;
+        while (pos < header_string.size()) {
+            auto line_end = header_string.find('\n', pos);
+            if (line_end == std::string::npos) {
+                line_end = header_string.size();
+            }
+            auto line = header_string.substr(pos, line_end - pos);
+            pos = line_end + 1;
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.compare(0, 5, "HTTP/") == 0) {
+                headers.clear();
+                continue;
+            }
+            const auto colon = line.find(':');
+            if (colon == std::string::npos) {
+                continue;
+            }
+            auto name = line.substr(0, colon);
+            std::transform(name.begin(), name.end(), name.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            const auto value_start = line.find_first_not_of(" \t", colon + 1);
+            headers[name] = value_start == std::string::npos ? "" : line.substr(value_start);
+        }
+        return headers;
+    }
+
+private:
+    static double UniformRandom() {
+        thread_local std::mt19937_64 generator {std::random_device {}()};
+        return std::uniform_real_distribution<double>(0.0, 1.0)(generator);
+    }
+};
+
+} // namespace flockmtl
@@ -5,12 +5,24 @@
 #include <string>
 #include <stdexcept>
 #include <iostream>
+#include <atomic>
+#include <chrono>
 #include <map>
+#include <string_view>
+#include <thread>
+
+#include "retry_policy.hpp"
+#include "flockmtl/model_manager/circuit_breaker.hpp"
+#include "flockmtl/model_manager/profiler.hpp"
+#include "flockmtl/model_manager/rate_limiter.hpp"
+#include "flockmtl/model_manager/tiktoken.hpp"
 
 struct Response {
     std::string text;
     bool is_error;
     std::string error_message;
+    long status_code = 0;
+    std::map<std::string, std::string> headers;
 };
 
 // Simple curl Session inspired by CPR
@@ -31,14 +43,16 @@ public:
 
     ~Session() {
         curl_easy_cleanup(curl_);
-        curl_global_cleanup();
         if (mime_form_ != nullptr) {
             curl_mime_free(mime_form_);
         }
     }
 
     void initCurl() {
-        curl_global_init(CURL_GLOBAL_ALL);
+        // curl_global_init is not thread-safe and must not be paired with a cleanup per session while other
+        // sessions are still running on other threads, so it happens exactly once per process.
+        static std::once_flag curl_global_flag;
+        std::call_once(curl_global_flag, []() { curl_global_init(CURL_GLOBAL_ALL); });
         curl_ = curl_easy_init();
         if (curl_ == nullptr) {
             throw std::runtime_error("curl cannot initialize"); // here we throw it shouldn't happen
@@ -61,6 +75,8 @@ public:
 
     void setBeta(const std::string &beta) { beta_ = beta; }
 
+    void setRequestOptions(const flockmtl::RequestOptions &request_options) { request_options_ = request_options; }
+
     void setBody(const std::string &data);
     void setMultiformPart(const std::pair<std::string, std::string> &filefield_and_filepath,
                           const std::map<std::string, std::string> &fields);
@@ -75,11 +91,49 @@ public:
     Response validOllamaModelsJson(const std::string &url);
 
 private:
+    Response perform();
+
     static size_t writeFunction(void *ptr, size_t size, size_t nmemb, std::string *data) {
         data->append((char *)ptr, size * nmemb);
         return size * nmemb;
     }
 
+    // Aborts the transfer once the calling thread's request was cancelled.
+    static int progressFunction(void *cancelled, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+        return static_cast<const std::atomic<bool> *>(cancelled)->load() ? 1 : 0;
+    }
+
+    // Returns false when the request was cancelled while waiting.
+    static bool sleepUnlessCancelled(std::chrono::milliseconds delay) {
+        const auto until = std::chrono::steady_clock::now() + delay;
+        while (!flockmtl::RequestCancellation::IsCancelled()) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= until) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(until - now,
+                                                                                      std::chrono::milliseconds(50)));
+        }
+        return false;
+    }
+
+    // Charges a retry against the rate limits like the caller charged the first attempt, waiting for budget unless
+    // the request is cancelled first. Returns false when it was.
+    bool acquireRateLimit() const {
+        const auto &key = request_options_.rate_limit_key;
+        const auto &limits = request_options_.rate_limits;
+        if (key.empty() || limits.IsUnlimited()) {
+            return true;
+        }
+        const auto tokens = flockmtl::Tiktoken::GetNumTokens(std::string(body_));
+        while (!flockmtl::RateLimiter::TryAcquire(key, limits, tokens).has_value()) {
+            if (!sleepUnlessCancelled(std::chrono::milliseconds(50))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
 private:
     CURL *curl_;
     CURLcode res_;
@@ -90,8 +144,11 @@ private:
     std::string organization_;
     std::string beta_;
     std::string provider_;
+    // The posted body, owned by the caller for the duration of the request.
+    std::string_view body_;
 
     bool throw_exception_;
+    flockmtl::RequestOptions request_options_;
     std::mutex mutex_request_;
 };
 
@@ -124,6 +181,7 @@ inline Response Session::validOllamaModelsJson(const std::string &url) {
 }
 
 inline void Session::setBody(const std::string &data) {
+    body_ = data;
     if (curl_) {
         curl_easy_setopt(curl_, CURLOPT_POSTFIELDSIZE, data.length());
         curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, data.data());
@@ -133,6 +191,7 @@ inline void Session::setBody(const std::string &data) {
 inline void Session::setMultiformPart(const std::pair<std::string, std::string> &fieldfield_and_filepath,
                                       const std::map<std::string, std::string> &fields) {
     // https://curl.se/libcurl/c/curl_mime_init.html
+    body_ = {};
     if (curl_) {
         if (mime_form_ != nullptr) {
             curl_mime_free(mime_form_);
@@ -157,6 +216,7 @@ inline void Session::setMultiformPart(const std::pair<std::string, std::string>
 }
 
 inline Response Session::getPrepare() {
+    body_ = {};
     if (curl_) {
         curl_easy_setopt(curl_, CURLOPT_HTTPGET, 1L);
         curl_easy_setopt(curl_, CURLOPT_POST, 0L);
@@ -174,29 +234,11 @@ inline Response Session::postPrepareOllama(const std::string &contentType) {
     curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
     curl_easy_setopt(curl_, CURLOPT_URL, url_.c_str());
 
-    std::string response_string;
-    std::string header_string;
-    curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, writeFunction);
-    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response_string);
-    curl_easy_setopt(curl_, CURLOPT_HEADERDATA, &header_string);
-
-    res_ = curl_easy_perform(curl_);
-
-    bool is_error = false;
-    std::string error_msg {};
-    if (res_ != CURLE_OK) {
-        is_error = true;
-        error_msg = provider_ + " curl_easy_perform() failed: " + std::string {curl_easy_strerror(res_)};
-        if (throw_exception_) {
-            throw std::runtime_error(error_msg);
-        } else {
-            std::cerr << error_msg << '\n';
-        }
-    }
-    return {response_string, is_error, error_msg};
+    return perform();
 }
 
 inline Response Session::deletePrepare() {
+    body_ = {};
     if (curl_) {
         curl_easy_setopt(curl_, CURLOPT_HTTPGET, 0L);
         curl_easy_setopt(curl_, CURLOPT_NOBODY, 0L);
@@ -214,6 +256,7 @@ inline void Session::set_auth_header(struct curl_slist **headers_ptr) {
         std::string auth_str = "api-key: " + token_;
         headers = curl_slist_append(headers, auth_str.c_str());
     }
+    *headers_ptr = headers;
 }
 
 inline Response Session::makeRequest(const std::string &contentType) {
@@ -247,27 +290,91 @@ inline Response Session::makeRequest(const std::string &contentType) {
     curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
     curl_easy_setopt(curl_, CURLOPT_URL, url_.c_str());
 
+    auto response = perform();
+    curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, NULL);
+    curl_slist_free_all(headers);
+    return response;
+}
+
+// Runs the prepared request, repeating it while RetryPolicy classifies the failure as transient and the retry
+// options (per-request attempts, the query's budget and the rate limits) allow another attempt. Every attempt is
+// bounded by the configured timeouts and goes through the endpoint's circuit breaker. Callers hold mutex_request_.
+inline Response Session::perform() {
     std::string response_string;
     std::string header_string;
     curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, writeFunction);
     curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response_string);
+    curl_easy_setopt(curl_, CURLOPT_HEADERFUNCTION, writeFunction);
     curl_easy_setopt(curl_, CURLOPT_HEADERDATA, &header_string);
+    curl_easy_setopt(curl_, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(request_options_.connect_timeout.count()));
+    curl_easy_setopt(curl_, CURLOPT_TIMEOUT_MS, static_cast<long>(request_options_.request_timeout.count()));
+    if (const auto *cancelled = flockmtl::RequestCancellation::Current(); cancelled != nullptr) {
+        curl_easy_setopt(curl_, CURLOPT_NOPROGRESS, 0L);
+        curl_easy_setopt(curl_, CURLOPT_XFERINFOFUNCTION, progressFunction);
+        curl_easy_setopt(curl_, CURLOPT_XFERINFODATA, cancelled);
+    } else {
+        curl_easy_setopt(curl_, CURLOPT_NOPROGRESS, 1L);
+    }
 
-    res_ = curl_easy_perform(curl_);
-
-    bool is_error = false;
-    std::string error_msg {};
-    if (res_ != CURLE_OK) {
-        is_error = true;
-        error_msg = provider_ + " curl_easy_perform() failed: " + std::string {curl_easy_strerror(res_)};
-        if (throw_exception_) {
-            throw std::runtime_error(error_msg);
-        } else {
+    for (auto attempt = 0;; attempt++) {
+        response_string.clear();
+        header_string.clear();
+        if (!flockmtl::CircuitBreaker::Allow(url_)) {
+            const auto error_msg = provider_ + " endpoint " + url_ + " is failing; the circuit breaker is open";
+            if (throw_exception_) {
+                throw flockmtl::ProviderUnavailableError(error_msg);
+            }
             std::cerr << error_msg << '\n';
+            return {"", true, error_msg};
         }
-    }
+        res_ = curl_easy_perform(curl_);
 
-    return {response_string, is_error, error_msg};
+        long status_code = 0;
+        if (res_ == CURLE_OK) {
+            curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &status_code);
+        }
+        // A cancelled transfer says nothing about the endpoint's health.
+        if (res_ != CURLE_ABORTED_BY_CALLBACK) {
+            if (res_ != CURLE_OK || status_code >= 500) {
+                flockmtl::CircuitBreaker::RecordFailure(url_);
+            } else {
+                flockmtl::CircuitBreaker::RecordSuccess(url_);
+            }
+        }
+        auto headers = flockmtl::RetryPolicy::ParseHeaders(header_string);
+
+        if (attempt < request_options_.max_retries &&
+            flockmtl::RetryPolicy::IsRetryable(res_, status_code, response_string) &&
+            (!request_options_.budget || request_options_.budget->TryConsume()) &&
+            sleepUnlessCancelled(flockmtl::RetryPolicy::GetDelay(attempt, headers, request_options_)) &&
+            acquireRateLimit()) {
+            flockmtl::Profiler::RecordRetry();
+            continue;
+        }
+
+        bool is_error = false;
+        std::string error_msg {};
+        if (res_ != CURLE_OK) {
+            is_error = true;
+            error_msg = provider_ + " curl_easy_perform() failed: " + std::string {curl_easy_strerror(res_)};
+            if (!throw_exception_) {
+                std::cerr << error_msg << '\n';
+            } else if (flockmtl::RetryPolicy::IsUnavailable(res_, status_code)) {
+                throw flockmtl::ProviderUnavailableError(error_msg);
+            } else {
+                throw std::runtime_error(error_msg);
+            }
+        } else if (status_code >= 400) {
+            is_error = true;
+            error_msg = provider_ + " request failed with HTTP status " + std::to_string(status_code) + ": " +
+                        response_string;
+            // Other client errors are left to the caller, which knows how to read the provider's error body.
+            if (throw_exception_ && flockmtl::RetryPolicy::IsUnavailable(res_, status_code)) {
+                throw flockmtl::ProviderUnavailableError(error_msg);
+            }
+        }
+        return {std::move(response_string), is_error, std::move(error_msg), status_code, std::move(headers)};
+    }
 }
 
 inline std::string Session::easyEscape(const std::string &text) {
@@ -4,6 +4,9 @@
 #include "fmt/format.h"
 
 #include "flockmtl/model_manager/repository.hpp"
+#include "flockmtl/model_manager/providers/embedding_decoder.hpp"
+#include "flockmtl/model_manager/providers/handlers/retry_policy.hpp"
+#include "flockmtl/model_manager/providers/response_parser.hpp"
 
 namespace flockmtl {
 
@@ -16,6 +19,50 @@ public:
 
     virtual nlohmann::json CallComplete(const std::string& prompt, bool json_response) = 0;
     virtual nlohmann::json CallEmbedding(const std::vector<std::string>& inputs) = 0;
+
+    // Streams embeddings straight into `sink`. Providers that can decode the raw response override this; the default
+    // goes through the JSON result of CallEmbedding.
+    virtual void CallEmbeddingInto(const std::vector<std::string>& inputs, EmbeddingSink& sink) {
+        const auto embeddings = CallEmbedding(inputs);
+        if (embeddings.size() > inputs.size()) {
+            throw std::runtime_error("The provider returned more embeddings than there are inputs");
+        }
+        std::vector<double> values;
+        for (size_t row = 0; row < embeddings.size(); row++) {
+            values.clear();
+            for (const auto& value : embeddings[row]) {
+                values.push_back(value.get<double>());
+            }
+            sink.Write(row, values.data(), values.size());
+        }
+    }
+
+    RequestOptions GetRequestOptions() const {
+        RequestOptions options;
+        options.max_retries = model_details_.max_retries;
+        options.budget = model_details_.retry_budget;
+        options.connect_timeout = model_details_.connect_timeout;
+        options.request_timeout = model_details_.request_timeout;
+        options.rate_limit_key = GetRateLimitKey(model_details_);
+        options.rate_limits = {model_details_.requests_per_minute, model_details_.tokens_per_minute};
+        return options;
+    }
+
+    // Requests sharing a provider, secret and model share one rate limit.
+    static std::string GetRateLimitKey(const ModelDetails& model_details) {
+        return model_details.provider_name + '\n' + model_details.secret_name + '\n' + model_details.model;
+    }
+
+    // Token usage reported by the last completion on the calling thread, consumed by the rate limiter.
+    static void RecordUsage(const TokenUsage& usage) { last_usage_ = usage; }
+    static std::optional<TokenUsage> TakeUsage() {
+        auto usage = last_usage_;
+        last_usage_.reset();
+        return usage;
+    }
+
+private:
+    static inline thread_local std::optional<TokenUsage> last_usage_;
 };
 
 class ExceededMaxOutputTokensError : public std::exception {
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "flockmtl/core/json_scanner.hpp"
+
+namespace flockmtl {
+
+struct TokenUsage {
+    int64_t prompt_tokens = 0;
+    int64_t completion_tokens = 0;
+};
+
+struct CompletionResponse {
+    std::string content;
+    std::string finish_reason;
+    std::optional<std::string> refusal;
+    TokenUsage usage;
+};
+
+// Decodes raw provider response bodies straight into the fields the adapters need. All lookups go through
+// JsonScanner, so swapping in a different (e.g. SIMD) parser only touches this class.
+class ResponseParser {
+public:
+    static std::optional<std::string> GetError(std::string_view response);
+    static CompletionResponse ParseChatCompletion(std::string_view response);
+    static CompletionResponse ParseOllamaGenerate(std::string_view response);
+};
+
+} // namespace flockmtl
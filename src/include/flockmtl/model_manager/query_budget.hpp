@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "flockmtl/model_manager/retry_budget.hpp"
+
+namespace flockmtl {
+
+// Tokens and estimated cost (in the currency of the model prices) a query may spend across all of its provider calls.
+class QueryBudget {
+public:
+    // From the flockmtl_max_tokens and flockmtl_max_cost settings; zero means no limit.
+    struct Limits {
+        int64_t max_tokens = 0;
+        double max_cost = 0;
+
+        bool IsUnlimited() const { return max_tokens <= 0 && max_cost <= 0; }
+    };
+
+    explicit QueryBudget(Limits limits) : limits_(limits) {}
+
+    // Throws if a request estimated at `tokens` and `cost` would take the query over one of its limits.
+    void Check(int64_t tokens, double cost) const;
+    void Charge(int64_t tokens, double cost);
+    int64_t GetTokens() const;
+    double GetCost() const;
+
+    // Cost of a call given prices per million prompt and completion tokens.
+    static double GetCost(int64_t prompt_tokens, int64_t completion_tokens, double input_price, double output_price);
+
+private:
+    const Limits limits_;
+    mutable std::mutex mutex_;
+    int64_t tokens_ = 0;
+    double cost_ = 0;
+};
+
+// The budgets of a client's query: the token and cost budget all of its models share, and a retry budget per model. A
+// client runs one query at a time, so only the budgets of its latest query are kept.
+class QueryBudgets {
+public:
+    // The query running on this thread, the budgets it draws from and its limits.
+    struct Context {
+        QueryBudgets* budgets = nullptr;
+        uint64_t query_id = 0;
+        QueryBudget::Limits limits;
+    };
+
+    // The token and cost budget of query `query_id`, or none when it has no limits.
+    std::shared_ptr<QueryBudget> GetQueryBudget(uint64_t query_id, QueryBudget::Limits limits);
+    // The retry budget of the model under `model_key` (its rate-limit key) in query `query_id`. It holds the `retries`
+    // of the model's first call in the query.
+    std::shared_ptr<RetryBudget> GetRetryBudget(uint64_t query_id, const std::string& model_key, int64_t retries);
+    // Drops the budgets of the query that just finished.
+    void EndQuery();
+
+    static Context Current() { return current_; }
+    // The budgets of the query running on this thread; a private retry budget and no token or cost budget when no
+    // query is active.
+    static std::shared_ptr<QueryBudget> GetCurrentQueryBudget();
+    static std::shared_ptr<RetryBudget> GetCurrentRetryBudget(const std::string& model_key, int64_t retries);
+
+    // Marks the query running on this thread for the lifetime of the scope.
+    class Scope {
+    public:
+        explicit Scope(const Context& context);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Context previous_;
+    };
+
+private:
+    // Starts over when `query_id` is not the query the budgets were made for. Expects `mutex_` to be held.
+    void StartQuery(uint64_t query_id);
+
+    std::mutex mutex_;
+    uint64_t query_id_ = 0;
+    std::shared_ptr<QueryBudget> query_budget_;
+    std::unordered_map<std::string, std::shared_ptr<RetryBudget>> retry_budgets_;
+
+    static thread_local Context current_;
+};
+
+} // namespace flockmtl
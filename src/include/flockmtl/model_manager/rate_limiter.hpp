@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace flockmtl {
+
+struct RateLimits {
+    int64_t requests_per_minute = 0;
+    int64_t tokens_per_minute = 0;
+
+    bool IsUnlimited() const { return requests_per_minute <= 0 && tokens_per_minute <= 0; }
+};
+
+// Process-wide token buckets, one pair (requests and tokens) per provider/secret/model key. Callers block in
+// Acquire until their request fits the budget instead of running into 429s, and Reconcile corrects the token
+// bucket once the provider reports the real usage.
+class RateLimiter {
+public:
+    // Waits until one request and `estimated_tokens` tokens are available and charges them. Returns the number of
+    // tokens actually charged, which is what Reconcile expects back.
+    static int64_t Acquire(const std::string& key, const RateLimits& limits, int64_t estimated_tokens);
+    // Like Acquire, but only charges budget that is available right now; nullopt otherwise.
+    static std::optional<int64_t> TryAcquire(const std::string& key, const RateLimits& limits,
+                                             int64_t estimated_tokens);
+    static void Reconcile(const std::string& key, int64_t charged_tokens, int64_t actual_tokens);
+    static void Reset();
+
+    // Share of the configured budgets that is handed out, so clock skew and estimation errors stay below the limit.
+    static constexpr double kBudgetUtilization = 0.95;
+
+private:
+    struct Bucket {
+        double capacity = 0;
+        double available = 0;
+        double refill_per_second = 0;
+
+        bool IsLimited() const { return capacity > 0; }
+        void Configure(int64_t per_minute);
+        void Refill(double elapsed_seconds);
+        // Seconds until `amount` is available; zero when it already is.
+        double WaitFor(double amount) const;
+    };
+
+    struct Budget {
+        Bucket requests;
+        Bucket tokens;
+        RateLimits limits;
+        std::chrono::steady_clock::time_point last_refill;
+    };
+
+    static Budget& GetBudget(const std::string& key, const RateLimits& limits);
+    static void Refill(Budget& budget);
+    static double ClampTokens(const Budget& budget, int64_t estimated_tokens);
+    static void Charge(Budget& budget, double tokens);
+
+    static std::mutex mutex_;
+    static std::condition_variable released_;
+    static std::unordered_map<std::string, Budget> budgets_;
+};
+
+} // namespace flockmtl
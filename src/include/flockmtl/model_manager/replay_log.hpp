@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "duckdb/common/file_system.hpp"
+
+namespace flockmtl {
+
+// Recorded provider exchanges, stored as one {"request": ..., "response": ...} JSON object per line. Requests are
+// matched on their full JSON, so a replayed call must render exactly the same prompt as the recorded one. The file is
+// accessed through DuckDB's file system; callers check that the database may access it before opening it.
+class ReplayLog {
+public:
+    explicit ReplayLog(std::string path);
+
+    // The log of a file, shared by every replay model that uses it for the lifetime of the process.
+    static std::shared_ptr<ReplayLog> Open(const std::string& path);
+    static void Reset();
+
+    // Appends the exchange to the file; a request that is recorded again replaces the earlier response.
+    void Append(const nlohmann::json& request, const nlohmann::json& response);
+    std::optional<nlohmann::json> Find(const nlohmann::json& request) const;
+    size_t Size() const;
+
+    static nlohmann::json CompletionRequest(const std::string& prompt, bool json_response);
+    static nlohmann::json EmbeddingRequest(const std::vector<std::string>& inputs);
+
+private:
+    std::string path_;
+    duckdb::unique_ptr<duckdb::FileSystem> fs_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, nlohmann::json> responses_;
+
+    static std::mutex logs_mutex_;
+    static std::unordered_map<std::string, std::shared_ptr<ReplayLog>> logs_;
+};
+
+} // namespace flockmtl
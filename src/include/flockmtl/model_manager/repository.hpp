@@ -1,27 +1,59 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <memory>
+#include <nlohmann/json.hpp>
 #include <string>
 #include <unordered_map>
 
+#include "flockmtl/model_manager/query_budget.hpp"
+#include "flockmtl/model_manager/retry_budget.hpp"
+
 namespace flockmtl {
 
 struct ModelDetails {
     std::string provider_name;
     std::string model_name;
     std::string model;
-    int32_t context_window;
-    int32_t max_output_tokens;
-    float temperature;
+    int32_t context_window = 0;
+    int32_t max_output_tokens = 0;
+    float temperature = 0;
     std::unordered_map<std::string, std::string> secret;
+    std::string secret_name;
     std::string tuple_format;
-    int batch_size;
+    int batch_size = 0;
+    std::string encoding_format;
+    // Embedding dimensions to request from providers that can shorten embeddings, 0 for the model's default.
+    int32_t dimensions = 0;
+    int64_t requests_per_minute = 0;
+    int64_t tokens_per_minute = 0;
+    int max_retries = 0;
+    std::shared_ptr<RetryBudget> retry_budget;
+    // Null unless the query sets a token or cost limit.
+    std::shared_ptr<QueryBudget> query_budget;
+    // Prices per million prompt and completion tokens, zero when unknown.
+    double input_price = 0;
+    double output_price = 0;
+    std::chrono::milliseconds connect_timeout {10000};
+    std::chrono::milliseconds request_timeout {300000};
+    bool hedged_requests = false;
+    // Backend model settings of a pool model, each a model_name with optional overrides and a weight, or the single
+    // model a replay model records.
+    nlohmann::json backends;
+    // Replay models serve calls from replay_file after a synthetic latency, or record them there.
+    std::string replay_file;
+    bool replay_record = false;
+    std::chrono::milliseconds replay_latency {0};
+    std::chrono::milliseconds replay_jitter {0};
 };
 
 const std::string OLLAMA = "ollama";
 const std::string OPENAI = "openai";
 const std::string AZURE = "azure";
+const std::string POOL = "pool";
+const std::string REPLAY = "replay";
 const std::string DEFAULT_PROVIDER = "default";
 const std::string EMPTY_PROVIDER = "";
 
@@ -29,6 +61,8 @@ enum SupportedProviders {
     FLOCKMTL_OPENAI = 0,
     FLOCKMTL_AZURE,
     FLOCKMTL_OLLAMA,
+    FLOCKMTL_POOL,
+    FLOCKMTL_REPLAY,
     FLOCKMTL_UNSUPPORTED_PROVIDER,
     FLOCKMTL_SUPPORTED_PROVIDER_COUNT
 };
@@ -41,6 +75,10 @@ inline SupportedProviders GetProviderType(std::string provider) {
         return FLOCKMTL_AZURE;
     if (provider == OLLAMA)
         return FLOCKMTL_OLLAMA;
+    if (provider == POOL)
+        return FLOCKMTL_POOL;
+    if (provider == REPLAY)
+        return FLOCKMTL_REPLAY;
 
     return FLOCKMTL_UNSUPPORTED_PROVIDER;
 }
@@ -53,6 +91,10 @@ inline std::string GetProviderName(SupportedProviders provider) {
             return AZURE;
         case FLOCKMTL_OLLAMA:
             return OLLAMA;
+        case FLOCKMTL_POOL:
+            return POOL;
+        case FLOCKMTL_REPLAY:
+            return REPLAY;
         default:
             return "";
     }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace flockmtl {
+
+// Number of retries a query may spend across all of its provider calls. A negative budget never runs out.
+class RetryBudget {
+public:
+    explicit RetryBudget(int64_t retries) : remaining_(retries) {}
+
+    bool TryConsume() {
+        auto remaining = remaining_.load();
+        while (true) {
+            if (remaining < 0) {
+                return true;
+            }
+            if (remaining == 0) {
+                return false;
+            }
+            if (remaining_.compare_exchange_weak(remaining, remaining - 1)) {
+                return true;
+            }
+        }
+    }
+
+    int64_t Remaining() const { return remaining_.load(); }
+
+private:
+    std::atomic<int64_t> remaining_;
+};
+
+} // namespace flockmtl
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace flockmtl {
+
+class Model;
+
+// Responses to prompt-only completions, looked up by the embedding of the prompt so that near-identical prompts
+// ("summarize Q3 returns", "summarise returns for Q3") are answered once. Each database has its own cache, and
+// responses are only shared between calls with the same key, i.e. the same model, secret, embedding model and response
+// format. Beyond kMaxEntriesPerKey the oldest entries of a key are evicted.
+// Lookups are exact: the embeddings of a key are stored contiguously and all of them are compared, which takes
+// milliseconds for a full key of large embeddings, against the seconds of the completion a hit saves. An approximate
+// index such as HnswIndex is built in one go and cannot evict entries, so it does not fit a cache filled one response
+// at a time.
+class SemanticCache {
+public:
+    struct Options {
+        // Embedding model of the cache, which is disabled if empty.
+        std::string model_name;
+        // Minimum cosine similarity of a cached prompt's embedding for its response to be reused.
+        double threshold = 0.95;
+        // Set when the cache is enabled: the cache of the query's database and the embedding model, built once per
+        // query.
+        std::shared_ptr<SemanticCache> cache;
+        std::shared_ptr<Model> embedding_model;
+    };
+
+    struct Statistics {
+        int64_t entries = 0;
+        int64_t lookups = 0;
+        int64_t hits = 0;
+    };
+
+    // The response of the cached prompt under `key` most similar to `embedding`, if similar enough.
+    std::optional<nlohmann::json> Lookup(const std::string& key, const std::vector<float>& embedding,
+                                         double threshold);
+    void Insert(const std::string& key, const std::vector<float>& embedding, nlohmann::json response);
+    Statistics GetStatistics() const;
+
+    static constexpr size_t kMaxEntriesPerKey = 10000;
+
+private:
+    // A ring of up to kMaxEntriesPerKey entries; once full, `next` is the oldest one, replaced by the next insert.
+    struct Entries {
+        size_t dimensions = 0;
+        // `responses.size()` embeddings of unit length, so cosine similarities are dot products
+        std::vector<float> embeddings;
+        std::vector<nlohmann::json> responses;
+        size_t next = 0;
+    };
+
+    static std::vector<float> Normalize(const std::vector<float>& embedding);
+
+    // Lookups only scan the entries of their key and share the lock; inserts take it exclusively.
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, Entries> entries_;
+    size_t size_ = 0;
+    std::atomic<int64_t> lookups_ {0};
+    std::atomic<int64_t> hits_ {0};
+};
+
+} // namespace flockmtl
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "duckdb/optimizer/optimizer_extension.hpp"
+#include "duckdb/planner/logical_operator.hpp"
+
+#include "flockmtl/core/common.hpp"
+
+namespace flockmtl {
+
+// DuckDB cannot tell that an LLM call costs orders of magnitude more than a comparison. After its own optimizers ran,
+// this rule moves the predicates that call LLM functions behind all others, so they only see the rows every cheap
+// predicate kept, and pushes cheap filters below projections that compute LLM results.
+class LlmPredicateOrdering {
+public:
+    static duckdb::OptimizerExtension GetExtension();
+    static void Optimize(duckdb::OptimizerExtensionInput& input, duckdb::unique_ptr<duckdb::LogicalOperator>& plan);
+
+    // Whether the expression calls one of the LLM functions FlockMTL registers (ScalarRegistry::GetLlmFunctionNames)
+    // anywhere.
+    static bool CallsLlm(const duckdb::Expression& expression);
+
+private:
+    static void OptimizeOperator(duckdb::unique_ptr<duckdb::LogicalOperator>& op);
+    // Stable-partitions the conjuncts so the ones calling an LLM come last, also inside nested ANDs.
+    static void OrderConjuncts(duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& conjuncts);
+    static void PushBelowProjection(duckdb::unique_ptr<duckdb::LogicalOperator>& op);
+};
+
+} // namespace flockmtl
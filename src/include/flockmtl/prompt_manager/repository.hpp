@@ -18,7 +18,8 @@ enum class AggregateFunctionType { REDUCE,
 
 enum class ScalarFunctionType { COMPLETE_JSON,
                                 COMPLETE,
-                                FILTER };
+                                FILTER,
+                                FILTER_CONFIDENCE };
 
 enum class TupleFormat { XML,
                          JSON,
@@ -70,6 +71,12 @@ public:
             "You should return the responses to the user's prompt for each tuple in a "
             "BOOL format that would be true/false.\n\tThe tool should respond in JSON format as "
             "follows:\n\n```json\n{\"tuples\": [<bool_response>, <bool_response>, ... , <bool_response>]}\n```";
+    static constexpr auto FILTER_CONFIDENCE =
+            "You should return the responses to the user's prompt for each tuple in a "
+            "BOOL format that would be true/false, together with your confidence in the response as a number between 0 "
+            "(a guess) and 1 (certain).\n\tThe tool should respond in JSON format as follows:\n\n```json\n{\"tuples\": "
+            "[{\"answer\": <bool_response>, \"confidence\": <confidence>}, ... , {\"answer\": <bool_response>, "
+            "\"confidence\": <confidence>}]}\n```";
 
     // Aggregate Functions
     static constexpr auto REDUCE =
@@ -14,6 +14,7 @@ private:
     static void RegisterLlmRerank(duckdb::DatabaseInstance& db);
     static void RegisterLlmReduce(duckdb::DatabaseInstance& db);
     static void RegisterLlmReduceJson(duckdb::DatabaseInstance& db);
+    static void RegisterFlockmtlKnnAgg(duckdb::DatabaseInstance& db);
 };
 
 } // namespace flockmtl
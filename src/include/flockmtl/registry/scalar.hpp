@@ -2,11 +2,16 @@
 
 #include "flockmtl/core/common.hpp"
 
+#include <string>
+#include <unordered_set>
+
 namespace flockmtl {
 
 class ScalarRegistry {
 public:
     static void Register(duckdb::DatabaseInstance& db);
+    // Names of the registered scalar functions that call a model.
+    static const std::unordered_set<std::string>& GetLlmFunctionNames();
 
 private:
     static void RegisterLlmCompleteJson(duckdb::DatabaseInstance& db);
@@ -18,6 +23,8 @@ private:
     static void RegisterFusionCombMED(duckdb::DatabaseInstance& db);
     static void RegisterFusionCombMNZ(duckdb::DatabaseInstance& db);
     static void RegisterFusionCombSUM(duckdb::DatabaseInstance& db);
+    static void RegisterFlockmtlQuantize(duckdb::DatabaseInstance& db);
+    static void RegisterFlockmtlHammingDistance(duckdb::DatabaseInstance& db);
 };
 
 } // namespace flockmtl
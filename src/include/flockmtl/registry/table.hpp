@@ -0,0 +1,23 @@
+#pragma once
+
+#include "flockmtl/core/common.hpp"
+
+namespace flockmtl {
+
+class TableRegistry {
+public:
+    static void Register(duckdb::DatabaseInstance& db);
+
+private:
+    static void RegisterLlmBulk(duckdb::DatabaseInstance& db);
+    static void RegisterFlockmtlProfile(duckdb::DatabaseInstance& db);
+    static void RegisterLlmEstimate(duckdb::DatabaseInstance& db);
+    static void RegisterFusionRRFTopN(duckdb::DatabaseInstance& db);
+    static void RegisterFusionNormalize(duckdb::DatabaseInstance& db);
+    static void RegisterFlockmtlKnn(duckdb::DatabaseInstance& db);
+    static void RegisterFlockmtlVectorIndex(duckdb::DatabaseInstance& db);
+    static void RegisterFlockmtlHybridSearch(duckdb::DatabaseInstance& db);
+    static void RegisterFlockmtlSemanticCache(duckdb::DatabaseInstance& db);
+};
+
+} // namespace flockmtl
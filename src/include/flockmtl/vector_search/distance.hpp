@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Where the toolchain supports function multiversioning, the vector kernels are also compiled for AVX2 and AVX-512 and
+// the best version is picked when the extension loads. Elsewhere (e.g. NEON on arm64) the baseline instruction set is
+// vectorized as is.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define FLOCKMTL_VECTOR_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define FLOCKMTL_VECTOR_KERNEL
+#endif
+
+namespace flockmtl {
+
+enum class DistanceMetric { COSINE, L2, DOT };
+
+// Distance kernels over contiguous float vectors. Smaller distances mean closer vectors for every metric: cosine is
+// 1 - cosine similarity, l2 the Euclidean distance and dot the negated inner product.
+class Distance {
+public:
+    static DistanceMetric ParseMetric(const std::string& metric);
+
+    static float Dot(const float* a, const float* b, size_t dimensions);
+    static float SquaredL2(const float* a, const float* b, size_t dimensions);
+    static float Norm(const float* vector, size_t dimensions);
+
+    // Distance of `vector` from a query whose norm was computed up front, as only cosine needs it.
+    static float Compute(DistanceMetric metric, const float* query, float query_norm, const float* vector,
+                         size_t dimensions);
+};
+
+} // namespace flockmtl
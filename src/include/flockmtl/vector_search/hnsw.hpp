@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "flockmtl/vector_search/distance.hpp"
+#include "flockmtl/vector_search/top_k.hpp"
+
+namespace flockmtl {
+
+// Hierarchical Navigable Small World graph (Malkov & Yashunin, https://arxiv.org/abs/1603.09320) over float vectors
+// identified by 64-bit ids. Searches are approximate: `ef_search` trades latency for recall.
+class HnswIndex {
+public:
+    struct Options {
+        // Links per node and level, twice as many on the bottom level.
+        size_t m = 16;
+        // Candidates considered when linking a new node.
+        size_t ef_construction = 200;
+        DistanceMetric metric = DistanceMetric::COSINE;
+    };
+
+    HnswIndex(size_t dimensions, Options options);
+
+    // Inserts the `ids.size()` vectors stored contiguously in `vectors`, on `num_threads` threads.
+    void Build(std::vector<float> vectors, std::vector<int64_t> ids, size_t num_threads);
+
+    // The `k` approximate nearest neighbours of `query` and their distances, closest first.
+    std::vector<TopK<int64_t>::Entry> Search(const float* query, size_t k, size_t ef_search) const;
+
+    // The graph followed by the vectors, so a loaded index needs nothing from the rows it was built from.
+    std::string Serialize() const;
+    // Throws if `data` was not written by Serialize.
+    static std::unique_ptr<HnswIndex> Deserialize(const std::string& data);
+
+    size_t Size() const { return ids_.size(); }
+    size_t Dimensions() const { return dimensions_; }
+    const Options& GetOptions() const { return options_; }
+
+private:
+    // A node and its distance from the vector being searched for.
+    using Candidate = std::pair<float, uint32_t>;
+
+    const float* GetVector(const uint32_t node) const { return vectors_.data() + node * dimensions_; }
+    size_t MaxLinks(const size_t level) const { return level == 0 ? 2 * options_.m : options_.m; }
+    float DistanceTo(const float* query, float query_norm, uint32_t node) const;
+    // The links of `node` on `level`. While the index is built other threads may be updating them, so they are copied
+    // under the node's lock; a built index is only read, so searches use them in place.
+    template <bool BUILDING>
+    using Links = std::conditional_t<BUILDING, std::vector<uint32_t>, const std::vector<uint32_t>&>;
+    template <bool BUILDING>
+    Links<BUILDING> GetLinks(uint32_t node, size_t level) const;
+
+    // Greedy walk down to `level`, from the entry point towards the node closest to `query`.
+    template <bool BUILDING>
+    Candidate Descend(const float* query, float query_norm, Candidate entry, int top_level, int level) const;
+    // The `ef` nodes of `level` closest to `query` reachable from `entry_points`, closest first.
+    template <bool BUILDING>
+    std::vector<Candidate> SearchLevel(const float* query, float query_norm, const std::vector<Candidate>& entry_points,
+                                       size_t ef, size_t level) const;
+    // Up to `max_links` of the `candidates` (closest first), skipping those closer to an already selected one than to
+    // the query so the links spread in every direction.
+    std::vector<uint32_t> SelectLinks(const std::vector<Candidate>& candidates, size_t max_links) const;
+    void Insert(uint32_t node);
+
+    size_t dimensions_;
+    Options options_;
+    std::vector<float> vectors_;
+    std::vector<float> norms_;
+    std::vector<int64_t> ids_;
+    std::vector<uint8_t> levels_;
+    // links_[node][level] are the neighbours of `node` on `level`
+    std::vector<std::vector<std::vector<uint32_t>>> links_;
+    // One per node while the index is built.
+    std::unique_ptr<std::mutex[]> link_locks_;
+    mutable std::mutex entry_lock_;
+    uint32_t entry_point_ = 0;
+    int max_level_ = -1;
+};
+
+} // namespace flockmtl
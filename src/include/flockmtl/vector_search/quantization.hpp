@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "flockmtl/vector_search/distance.hpp"
+
+namespace flockmtl {
+
+// Compact encodings of float embeddings, stored as BLOBs whose first byte names the encoding:
+// - int8: the byte 1, a float scale and one signed byte per dimension, value = scale * byte (about 4x smaller);
+// - binary: the byte 2 and one bit per dimension, set for positive values, least significant bit first (32x smaller).
+class Quantization {
+public:
+    enum class Encoding : uint8_t { INT8 = 1, BINARY = 2 };
+
+    static std::string QuantizeInt8(const float* vector, size_t dimensions);
+    static std::string QuantizeBinary(const float* vector, size_t dimensions);
+
+    // Throws unless `data` is an encoded vector.
+    static Encoding GetEncoding(const char* data, size_t size);
+
+    static int32_t Int8Dot(const int8_t* a, const int8_t* b, size_t dimensions);
+    static uint64_t Hamming(const uint8_t* a, const uint8_t* b, size_t bytes);
+
+    // Dot product of the values of an int8 vector with themselves, its squared length before scaling.
+    static int32_t Int8SquaredNorm(const std::string& vector);
+
+    // Distance between two vectors of the same encoding and size, smaller being closer as for Distance::Compute.
+    // int8 vectors follow the metric; binary vectors are compared by Hamming distance whatever the metric.
+    static float Compute(DistanceMetric metric, const std::string& query, const char* vector, size_t size);
+    // As above, with Int8SquaredNorm of an int8 query computed once by the caller rather than for every vector.
+    static float Compute(DistanceMetric metric, const std::string& query, int32_t query_squared_norm,
+                         const char* vector, size_t size);
+
+    static constexpr size_t kInt8HeaderSize = 1 + sizeof(float);
+};
+
+} // namespace flockmtl
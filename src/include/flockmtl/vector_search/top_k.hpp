@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace flockmtl {
+
+// The k closest items seen so far, kept in a max-heap on distance so the farthest of them is replaced first.
+template <class T>
+class TopK {
+public:
+    struct Entry {
+        float distance;
+        T item;
+    };
+
+    // `k` comes from the query, so only a bounded amount is reserved up front.
+    explicit TopK(const size_t k) : k_(k) { heap_.reserve(std::min(k, kMaxReserved)); }
+
+    // Whether an item at `distance` would be kept, so callers can skip building items that would not. NaN distances,
+    // e.g. from an embedding holding NaN, are never kept since they cannot be ordered.
+    bool Accepts(const float distance) const {
+        return !std::isnan(distance) && (heap_.size() < k_ || (!heap_.empty() && distance < heap_.front().distance));
+    }
+
+    void Push(const float distance, T item) {
+        if (!Accepts(distance)) {
+            return;
+        }
+        if (heap_.size() == k_) {
+            std::pop_heap(heap_.begin(), heap_.end(), IsCloser);
+            heap_.pop_back();
+        }
+        heap_.push_back({distance, std::move(item)});
+        std::push_heap(heap_.begin(), heap_.end(), IsCloser);
+    }
+
+    void Merge(TopK& other) {
+        for (auto& entry : other.heap_) {
+            Push(entry.distance, std::move(entry.item));
+        }
+        other.heap_.clear();
+    }
+
+    size_t Size() const { return heap_.size(); }
+
+    // The kept items, closest first. Leaves the heap empty.
+    std::vector<Entry> TakeSorted() {
+        std::sort_heap(heap_.begin(), heap_.end(), IsCloser);
+        auto sorted = std::move(heap_);
+        heap_.clear();
+        return sorted;
+    }
+
+    static constexpr size_t kMaxReserved = 1024;
+
+private:
+    static bool IsCloser(const Entry& a, const Entry& b) { return a.distance < b.distance; }
+
+    size_t k_;
+    std::vector<Entry> heap_;
+};
+
+} // namespace flockmtl
@@ -0,0 +1,197 @@
+#include "flockmtl/model_manager/batch_client.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+
+#include "flockmtl/model_manager/providers/handlers/openai.hpp"
+
+namespace flockmtl {
+
+BatchClient::BatchClient(std::string api_key, std::string base_url, RequestOptions request_options,
+                         const std::chrono::milliseconds poll_interval, const std::chrono::milliseconds timeout)
+    : api_key_(std::move(api_key)), base_url_(std::move(base_url)), request_options_(std::move(request_options)),
+      poll_interval_(poll_interval), timeout_(timeout) {}
+
+std::string BatchClient::ToJsonl(const std::string& endpoint, const std::vector<BatchRequest>& requests,
+                                 const size_t begin, const size_t end) {
+    std::string jsonl;
+    for (auto i = begin; i < end; i++) {
+        jsonl += nlohmann::json {{"custom_id", requests[i].custom_id},
+                                 {"method", "POST"},
+                                 {"url", endpoint},
+                                 {"body", requests[i].body}}
+                     .dump();
+        jsonl += '\n';
+    }
+    return jsonl;
+}
+
+void BatchClient::ParseOutput(const std::string& jsonl, std::unordered_map<std::string, std::string>& bodies) {
+    size_t pos = 0;
+    while (pos < jsonl.size()) {
+        auto line_end = jsonl.find('\n', pos);
+        if (line_end == std::string::npos) {
+            line_end = jsonl.size();
+        }
+        const auto line = nlohmann::json::parse(jsonl.begin() + static_cast<std::ptrdiff_t>(pos),
+                                                jsonl.begin() + static_cast<std::ptrdiff_t>(line_end), nullptr, false);
+        pos = line_end + 1;
+        if (line.is_discarded() || !line.is_object() || !line.contains("custom_id")) {
+            continue;
+        }
+        const auto& response = line.value("response", nlohmann::json());
+        if (response.is_object() && response.value("status_code", 0) == 200 && response.contains("body")) {
+            bodies[line["custom_id"].get<std::string>()] = response["body"].dump();
+        }
+    }
+}
+
+BatchClient::Batch BatchClient::Submit(const std::string& endpoint, const std::vector<BatchRequest>& requests,
+                                       const size_t begin, const size_t end) const {
+    std::random_device random;
+    const auto path = std::filesystem::temp_directory_path() /
+                      ("flockmtl_batch_" + std::to_string(random()) + "_" + std::to_string(begin) + ".jsonl");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << ToJsonl(endpoint, requests, begin, end);
+        if (!file) {
+            throw std::runtime_error("Could not write the batch input file " + path.string());
+        }
+    }
+
+    openai::OpenAI openai(api_key_, "", true, base_url_);
+    openai.setRequestOptions(request_options_);
+    nlohmann::json uploaded;
+    try {
+        uploaded = openai.file.upload({{"file", path.string()}, {"purpose", "batch"}});
+    } catch (...) {
+        std::filesystem::remove(path);
+        throw;
+    }
+    std::filesystem::remove(path);
+    if (!uploaded.contains("id")) {
+        throw std::runtime_error("Uploading the batch input file failed: " + uploaded.dump());
+    }
+
+    const auto input_file_id = uploaded["id"].get<std::string>();
+    nlohmann::json batch;
+    try {
+        openai::OpenAI batches(api_key_, "", true, base_url_);
+        batches.setRequestOptions(request_options_);
+        batch = batches.batch.create(
+            {{"input_file_id", input_file_id}, {"endpoint", endpoint}, {"completion_window", "24h"}});
+    } catch (...) {
+        DeleteFile(input_file_id);
+        throw;
+    }
+    if (!batch.contains("id")) {
+        DeleteFile(input_file_id);
+        throw std::runtime_error("Creating the batch failed: " + batch.dump());
+    }
+    return {batch["id"].get<std::string>(), input_file_id};
+}
+
+nlohmann::json BatchClient::Wait(const std::string& batch_id,
+                                 const std::chrono::steady_clock::time_point deadline) const {
+    while (true) {
+        openai::OpenAI openai(api_key_, "", true, base_url_);
+        openai.setRequestOptions(request_options_);
+        auto batch = openai.batch.retrieve(batch_id);
+        const auto status = batch.value("status", "");
+        if (status == "completed" || status == "expired" || status == "cancelled") {
+            return batch;
+        }
+        if (status == "failed") {
+            throw std::runtime_error("Batch " + batch_id + " failed: " + batch.value("errors", nlohmann::json()).dump());
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            throw std::runtime_error(
+                "Batch " + batch_id + " did not finish within " +
+                std::to_string(std::chrono::duration_cast<std::chrono::seconds>(timeout_).count()) + " seconds");
+        }
+        const auto until = std::min<std::chrono::steady_clock::time_point>(deadline, now + poll_interval_);
+        while (std::chrono::steady_clock::now() < until) {
+            if (RequestCancellation::IsCancelled()) {
+                throw std::runtime_error("Stopped waiting for batch " + batch_id + ": the request was cancelled");
+            }
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                until - std::chrono::steady_clock::now(), std::chrono::milliseconds(50)));
+        }
+    }
+}
+
+void BatchClient::Cancel(const std::string& batch_id) const {
+    // The calling thread may be the one that was cancelled; this request has to go out regardless.
+    const RequestCancellation::Scope uncancelled(nullptr);
+    try {
+        openai::OpenAI openai(api_key_, "", true, base_url_);
+        openai.setRequestOptions(request_options_);
+        openai.batch.cancel(batch_id);
+    } catch (const std::exception&) {
+    }
+}
+
+void BatchClient::DeleteFile(const std::string& file_id) const {
+    const RequestCancellation::Scope uncancelled(nullptr);
+    try {
+        openai::OpenAI openai(api_key_, "", true, base_url_);
+        openai.setRequestOptions(request_options_);
+        openai.file.del(file_id);
+    } catch (const std::exception&) {
+    }
+}
+
+void BatchClient::Abandon(const std::vector<Batch>& batches, const size_t first) const {
+    for (auto i = first; i < batches.size(); i++) {
+        Cancel(batches[i].id);
+        DeleteFile(batches[i].input_file_id);
+    }
+}
+
+std::unordered_map<std::string, std::string> BatchClient::Run(const std::string& endpoint,
+                                                              const std::vector<BatchRequest>& requests) const {
+    const auto deadline = std::chrono::steady_clock::now() + timeout_;
+    // Submit every part first so the provider works on all of them while we poll.
+    std::vector<Batch> batches;
+    try {
+        for (size_t begin = 0; begin < requests.size(); begin += kMaxRequestsPerBatch) {
+            const auto end = std::min(requests.size(), begin + kMaxRequestsPerBatch);
+            batches.push_back(Submit(endpoint, requests, begin, end));
+        }
+    } catch (...) {
+        Abandon(batches, 0);
+        throw;
+    }
+
+    std::unordered_map<std::string, std::string> bodies;
+    for (size_t i = 0; i < batches.size(); i++) {
+        nlohmann::json batch;
+        try {
+            batch = Wait(batches[i].id, deadline);
+        } catch (...) {
+            Abandon(batches, i);
+            throw;
+        }
+        DeleteFile(batches[i].input_file_id);
+        // Expired and cancelled batches still hand back whatever finished.
+        if (const auto output_file_id = batch.value("output_file_id", nlohmann::json()); output_file_id.is_string()) {
+            try {
+                openai::OpenAI openai(api_key_, "", true, base_url_);
+                openai.setRequestOptions(request_options_);
+                ParseOutput(openai.file.contentText(output_file_id.get<std::string>()), bodies);
+            } catch (...) {
+                Abandon(batches, i + 1);
+                throw;
+            }
+            DeleteFile(output_file_id.get<std::string>());
+        }
+    }
+    return bodies;
+}
+
+} // namespace flockmtl
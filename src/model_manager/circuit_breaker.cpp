@@ -0,0 +1,59 @@
+#include "flockmtl/model_manager/circuit_breaker.hpp"
+
+namespace flockmtl {
+
+std::mutex CircuitBreaker::mutex_;
+std::unordered_map<std::string, CircuitBreaker::Circuit> CircuitBreaker::circuits_;
+int CircuitBreaker::failure_threshold_ = kFailureThreshold;
+std::chrono::milliseconds CircuitBreaker::open_duration_ = kOpenDuration;
+
+bool CircuitBreaker::Allow(const std::string& endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = circuits_.find(endpoint);
+    if (it == circuits_.end() || it->second.state == State::CLOSED) {
+        return true;
+    }
+    auto& circuit = it->second;
+    const auto now = std::chrono::steady_clock::now();
+    // An open circuit waits out the open duration. A half-open one lets another probe through after the same time,
+    // so a probe that never reported back (e.g. it was cancelled) does not keep the circuit closed to traffic.
+    if (now - circuit.since < open_duration_) {
+        return false;
+    }
+    circuit.state = State::HALF_OPEN;
+    circuit.since = now;
+    return true;
+}
+
+void CircuitBreaker::RecordSuccess(const std::string& endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = circuits_.find(endpoint);
+    if (it != circuits_.end()) {
+        it->second = Circuit();
+    }
+}
+
+void CircuitBreaker::RecordFailure(const std::string& endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& circuit = circuits_[endpoint];
+    circuit.consecutive_failures++;
+    if (circuit.state == State::HALF_OPEN || circuit.consecutive_failures >= failure_threshold_) {
+        circuit.state = State::OPEN;
+        circuit.since = std::chrono::steady_clock::now();
+    }
+}
+
+void CircuitBreaker::Configure(const int failure_threshold, const std::chrono::milliseconds open_duration) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    failure_threshold_ = failure_threshold;
+    open_duration_ = open_duration;
+}
+
+void CircuitBreaker::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    circuits_.clear();
+    failure_threshold_ = kFailureThreshold;
+    open_duration_ = kOpenDuration;
+}
+
+} // namespace flockmtl
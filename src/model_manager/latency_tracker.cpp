@@ -0,0 +1,42 @@
+#include "flockmtl/model_manager/latency_tracker.hpp"
+
+#include <algorithm>
+
+namespace flockmtl {
+
+std::mutex LatencyTracker::mutex_;
+std::unordered_map<std::string, LatencyTracker::Window> LatencyTracker::windows_;
+
+void LatencyTracker::Record(const std::string& key, const std::chrono::milliseconds latency) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& window = windows_[key];
+    if (window.samples.size() < kWindowSize) {
+        window.samples.push_back(latency.count());
+    } else {
+        window.samples[window.next] = latency.count();
+        window.next = (window.next + 1) % kWindowSize;
+    }
+}
+
+std::optional<std::chrono::milliseconds> LatencyTracker::GetPercentile(const std::string& key,
+                                                                       const double percentile) {
+    std::vector<int64_t> samples;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = windows_.find(key);
+        if (it == windows_.end() || it->second.samples.size() < kMinSamples) {
+            return std::nullopt;
+        }
+        samples = it->second.samples;
+    }
+    const auto rank = std::min(samples.size() - 1, static_cast<size_t>(percentile * static_cast<double>(samples.size())));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(rank), samples.end());
+    return std::chrono::milliseconds(samples[rank]);
+}
+
+void LatencyTracker::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    windows_.clear();
+}
+
+} // namespace flockmtl
@@ -5,7 +5,34 @@ namespace flockmtl {
 
 Model::Model(const nlohmann::json& model_json) {
     LoadModelDetails(model_json);
-    ConstructProvider();
+    const auto provider_type = GetProviderType(model_details_.provider_name);
+    if (provider_type != FLOCKMTL_POOL && provider_type != FLOCKMTL_REPLAY) {
+        ConstructProvider();
+        return;
+    }
+    const auto& model_name = model_details_.model_name;
+    if (std::find(constructing_.begin(), constructing_.end(), model_name) != constructing_.end()) {
+        throw std::invalid_argument(duckdb_fmt::format("Model '{}' calls itself through its backends", model_name));
+    }
+    constructing_.push_back(model_name);
+    try {
+        ConstructProvider();
+    } catch (...) {
+        constructing_.pop_back();
+        throw;
+    }
+    constructing_.pop_back();
+}
+
+std::string Model::GetProviderName(const nlohmann::json& model_json) {
+    if (model_json.contains("provider")) {
+        return model_json.at("provider").get<std::string>();
+    }
+    const auto model_name = model_json.contains("model_name") ? model_json.at("model_name").get<std::string>() : "";
+    if (model_name.empty()) {
+        throw std::invalid_argument("`model_name` is required in model settings");
+    }
+    return std::get<1>(GetQueriedModel(model_name));
 }
 
 void Model::LoadModelDetails(const nlohmann::json& model_json) {
@@ -18,28 +45,91 @@ void Model::LoadModelDetails(const nlohmann::json& model_json) {
         model_json.contains("model") ? model_json.at("model").get<std::string>() : std::get<0>(query_result);
     model_details_.provider_name =
         model_json.contains("provider") ? model_json.at("provider").get<std::string>() : std::get<1>(query_result);
-    auto secret_name = "__default_" + model_details_.provider_name;
-    if (model_details_.provider_name == AZURE)
-        secret_name += "_llm";
-    if (model_json.contains("secret_name")) {
-        secret_name = model_json["secret_name"].get<std::string>();
+    const auto& model_args = std::get<2>(query_result);
+    const auto provider_type = GetProviderType(model_details_.provider_name);
+    // Pool and replay models have no credentials of their own; the models they call resolve theirs.
+    if (provider_type != FLOCKMTL_POOL && provider_type != FLOCKMTL_REPLAY) {
+        auto secret_name = "__default_" + model_details_.provider_name;
+        if (model_details_.provider_name == AZURE)
+            secret_name += "_llm";
+        if (model_json.contains("secret_name")) {
+            secret_name = model_json["secret_name"].get<std::string>();
+        }
+        model_details_.secret = SecretManager::GetSecret(secret_name);
+        model_details_.secret_name = secret_name;
+    }
+    model_details_.backends = model_args.value("backends", nlohmann::json::array());
+    if (provider_type == FLOCKMTL_POOL && model_details_.backends.empty()) {
+        throw std::invalid_argument("A pool model needs at least one entry in `backends`");
+    }
+    model_details_.replay_file = model_args.value("replay_file", "");
+    model_details_.replay_record = model_args.value("replay_mode", "replay") == "record";
+    model_details_.replay_latency = std::chrono::milliseconds(model_args.value("latency_ms", int64_t(0)));
+    model_details_.replay_jitter = std::chrono::milliseconds(model_args.value("jitter_ms", int64_t(0)));
+    if (provider_type == FLOCKMTL_REPLAY) {
+        if (model_details_.replay_file.empty()) {
+            throw std::invalid_argument("A replay model needs a `replay_file`");
+        }
+        if (model_details_.replay_record) {
+            if (!model_args.contains("backend")) {
+                throw std::invalid_argument("A replay model in record mode needs the `backend` model to record");
+            }
+            model_details_.backends = nlohmann::json::array({model_args["backend"]});
+        }
     }
-    model_details_.secret = SecretManager::GetSecret(secret_name);
     model_details_.context_window = model_json.contains("context_window")
                                         ? std::stoi(model_json.at("context_window").get<std::string>())
-                                        : std::get<2>(query_result);
+                                        : model_args.at("context_window").get<int32_t>();
     model_details_.max_output_tokens = model_json.contains("max_output_tokens")
                                            ? std::stoi(model_json.at("max_output_tokens").get<std::string>())
-                                           : std::get<3>(query_result);
+                                           : model_args.at("max_output_tokens").get<int32_t>();
     model_details_.temperature =
         model_json.contains("temperature") ? std::stof(model_json.at("temperature").get<std::string>()) : 0;
     model_details_.tuple_format =
         model_json.contains("tuple_format") ? model_json.at("tuple_format").get<std::string>() : "XML";
     model_details_.batch_size =
         model_json.contains("batch_size") ? std::stoi(model_json.at("batch_size").get<std::string>()) : 0;
+    model_details_.encoding_format =
+        model_json.contains("encoding_format") ? model_json.at("encoding_format").get<std::string>() : "float";
+    if (model_details_.encoding_format != "float" && model_details_.encoding_format != "base64") {
+        throw std::invalid_argument("`encoding_format` must be either 'float' or 'base64'");
+    }
+    model_details_.dimensions = model_json.contains("dimensions")
+                                    ? std::stoi(model_json.at("dimensions").get<std::string>())
+                                    : model_args.value("dimensions", 0);
+    if (model_details_.dimensions < 0) {
+        throw std::invalid_argument("`dimensions` must be a positive number of embedding dimensions");
+    }
+    model_details_.requests_per_minute = model_json.contains("requests_per_minute")
+                                             ? std::stoll(model_json.at("requests_per_minute").get<std::string>())
+                                             : model_args.value("requests_per_minute", int64_t(0));
+    model_details_.tokens_per_minute = model_json.contains("tokens_per_minute")
+                                           ? std::stoll(model_json.at("tokens_per_minute").get<std::string>())
+                                           : model_args.value("tokens_per_minute", int64_t(0));
+    model_details_.max_retries =
+        model_json.contains("max_retries") ? std::stoi(model_json.at("max_retries").get<std::string>()) : 6;
+    model_details_.retry_budget = QueryBudgets::GetCurrentRetryBudget(
+        GetRateLimitKey(),
+        model_json.contains("retry_budget") ? std::stoll(model_json.at("retry_budget").get<std::string>()) : -1);
+    model_details_.query_budget = QueryBudgets::GetCurrentQueryBudget();
+    model_details_.input_price = model_args.value("input_price", 0.0);
+    model_details_.output_price = model_args.value("output_price", 0.0);
+    // Timeouts are given in seconds.
+    const auto to_milliseconds = [](const double seconds) {
+        return std::chrono::milliseconds(static_cast<int64_t>(seconds * 1000));
+    };
+    model_details_.connect_timeout = to_milliseconds(
+        model_json.contains("connect_timeout") ? std::stod(model_json.at("connect_timeout").get<std::string>())
+                                               : model_args.value("connect_timeout", 10.0));
+    model_details_.request_timeout = to_milliseconds(
+        model_json.contains("request_timeout") ? std::stod(model_json.at("request_timeout").get<std::string>())
+                                               : model_args.value("request_timeout", 300.0));
+    model_details_.hedged_requests = model_json.contains("hedged_requests")
+                                         ? model_json.at("hedged_requests").get<std::string>() == "true"
+                                         : model_args.value("hedged_requests", false);
 }
 
-std::tuple<std::string, std::string, int32_t, int32_t> Model::GetQueriedModel(const std::string& model_name) {
+std::tuple<std::string, std::string, nlohmann::json> Model::GetQueriedModel(const std::string& model_name) {
     const std::string query =
         duckdb_fmt::format(" SELECT model, provider_name, model_args "
                            " FROM flockmtl_storage.flockmtl_config.FLOCKMTL_MODEL_USER_DEFINED_INTERNAL_TABLE"
@@ -69,7 +159,7 @@ std::tuple<std::string, std::string, int32_t, int32_t> Model::GetQueriedModel(co
     auto provider_name = query_result->GetValue(1, 0).ToString();
     auto model_args = nlohmann::json::parse(query_result->GetValue(2, 0).ToString());
 
-    return {model, provider_name, model_args["context_window"], model_args["max_output_tokens"]};
+    return {model, provider_name, model_args};
 }
 
 void Model::ConstructProvider() {
@@ -83,6 +173,12 @@ void Model::ConstructProvider() {
     case FLOCKMTL_OLLAMA:
         provider_ = std::make_shared<OllamaProvider>(model_details_);
         break;
+    case FLOCKMTL_POOL:
+        provider_ = std::make_shared<PoolProvider>(model_details_);
+        break;
+    case FLOCKMTL_REPLAY:
+        provider_ = std::make_shared<ReplayProvider>(model_details_);
+        break;
     default:
         throw std::invalid_argument(duckdb_fmt::format("Unsupported provider: {}", model_details_.provider_name));
     }
@@ -90,10 +186,210 @@ void Model::ConstructProvider() {
 
 ModelDetails Model::GetModelDetails() { return model_details_; }
 
+bool Model::DelegatesCalls() const {
+    const auto provider_type = GetProviderType(model_details_.provider_name);
+    return provider_type == FLOCKMTL_POOL || (provider_type == FLOCKMTL_REPLAY && model_details_.replay_record);
+}
+
+std::string Model::GetRateLimitKey() const { return IProvider::GetRateLimitKey(model_details_); }
+
+void Model::CheckQueryBudget(const int64_t prompt_tokens) const {
+    if (model_details_.query_budget && !DelegatesCalls()) {
+        const auto cost =
+            QueryBudget::GetCost(prompt_tokens, 0, model_details_.input_price, model_details_.output_price);
+        model_details_.query_budget->Check(prompt_tokens, cost);
+    }
+}
+
+double Model::ChargeQueryBudget(const int64_t prompt_tokens, const int64_t completion_tokens) const {
+    const auto cost =
+        QueryBudget::GetCost(prompt_tokens, completion_tokens, model_details_.input_price, model_details_.output_price);
+    if (model_details_.query_budget) {
+        model_details_.query_budget->Charge(prompt_tokens + completion_tokens, cost);
+    }
+    return cost;
+}
+
 nlohmann::json Model::CallComplete(const std::string& prompt, bool json_response) {
-    return provider_->CallComplete(prompt, json_response);
+    last_completion_tokens_.reset();
+    const auto key = GetRateLimitKey();
+    const auto prompt_tokens = Tiktoken::GetNumTokens(prompt);
+    CheckQueryBudget(prompt_tokens);
+    if (model_details_.hedged_requests) {
+        if (const auto hedge_after = LatencyTracker::GetPercentile(key, kHedgePercentile); hedge_after.has_value()) {
+            return CallCompleteHedged(prompt, prompt_tokens, json_response, *hedge_after);
+        }
+    }
+    const RateLimits limits {model_details_.requests_per_minute, model_details_.tokens_per_minute};
+    return CallCompleteOnce(prompt, prompt_tokens, json_response, RateLimiter::Acquire(key, limits, prompt_tokens));
+}
+
+nlohmann::json Model::CallCompleteOnce(const std::string& prompt, const int64_t prompt_tokens, const bool json_response,
+                                       const int64_t charged_tokens) {
+    const auto key = GetRateLimitKey();
+    const auto started = std::chrono::steady_clock::now();
+    // Settle the pre-charged estimate against what the provider reports, and charge and profile the call, whether or
+    // not it succeeded.
+    const auto finish = [&](const bool failed) {
+        auto usage = IProvider::TakeUsage().value_or(TokenUsage {});
+        if (charged_tokens > 0 && usage.prompt_tokens + usage.completion_tokens > 0) {
+            RateLimiter::Reconcile(key, charged_tokens, usage.prompt_tokens + usage.completion_tokens);
+        }
+        const auto latency = std::chrono::steady_clock::now() - started;
+        // Pools and replay models report nothing themselves; keep what the model they called reported.
+        if (!failed && usage.completion_tokens > 0) {
+            last_completion_tokens_ = usage.completion_tokens;
+        }
+        if (!DelegatesCalls()) {
+            if (!failed && usage.prompt_tokens + usage.completion_tokens == 0) {
+                usage.prompt_tokens = prompt_tokens;
+            }
+            Profiler::RecordRequest(std::chrono::duration_cast<std::chrono::microseconds>(latency),
+                                    usage.prompt_tokens, usage.completion_tokens,
+                                    ChargeQueryBudget(usage.prompt_tokens, usage.completion_tokens), failed);
+        }
+        return std::chrono::duration_cast<std::chrono::milliseconds>(latency);
+    };
+    IProvider::TakeUsage();
+    try {
+        auto response = provider_->CallComplete(prompt, json_response);
+        LatencyTracker::Record(key, finish(false));
+        return response;
+    } catch (...) {
+        finish(true);
+        throw;
+    }
 }
 
-nlohmann::json Model::CallEmbedding(const std::vector<std::string>& inputs) { return provider_->CallEmbedding(inputs); }
+nlohmann::json Model::CallCompleteHedged(const std::string& prompt, const int64_t prompt_tokens,
+                                         const bool json_response, const std::chrono::milliseconds hedge_after) {
+    // Cancels and joins its thread when it goes out of scope, including when starting the second attempt throws.
+    struct Attempt {
+        std::atomic<bool> cancelled {false};
+        bool finished = false;
+        nlohmann::json response;
+        std::optional<int64_t> completion_tokens;
+        std::exception_ptr error;
+        std::thread thread;
+
+        ~Attempt() {
+            if (thread.joinable()) {
+                cancelled = true;
+                thread.join();
+            }
+        }
+    };
+
+    const auto key = GetRateLimitKey();
+    const RateLimits limits {model_details_.requests_per_minute, model_details_.tokens_per_minute};
+    std::mutex mutex;
+    std::condition_variable finished;
+    // After the mutex and condition variable the threads use, so it is destroyed, and they are joined, first.
+    Attempt attempts[2];
+
+    const auto start = [&](Attempt& attempt, const int64_t charged_tokens) {
+        attempt.thread = std::thread([&, charged_tokens, profiler_context = Profiler::Current()]() {
+            const RequestCancellation::Scope cancellation(&attempt.cancelled);
+            const Profiler::Scope profiler_scope(profiler_context);
+            nlohmann::json response;
+            std::exception_ptr error;
+            try {
+                response = CallCompleteOnce(prompt, prompt_tokens, json_response, charged_tokens);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            attempt.completion_tokens = TakeCompletionTokens();
+            attempt.response = std::move(response);
+            attempt.error = error;
+            attempt.finished = true;
+            finished.notify_all();
+        });
+    };
+
+    start(attempts[0], RateLimiter::Acquire(key, limits, prompt_tokens));
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!finished.wait_for(lock, hedge_after, [&]() { return attempts[0].finished; })) {
+        // The duplicate only uses rate-limit budget that is spare right now; otherwise keep waiting for the primary.
+        if (const auto charged_tokens = RateLimiter::TryAcquire(key, limits, prompt_tokens); charged_tokens.has_value()) {
+            start(attempts[1], *charged_tokens);
+        }
+    }
+
+    // Take the first attempt that succeeds, or give up once every started attempt failed.
+    Attempt* winner = nullptr;
+    finished.wait(lock, [&]() {
+        auto failed = 0;
+        auto started = 0;
+        for (auto& attempt : attempts) {
+            if (!attempt.thread.joinable()) {
+                continue;
+            }
+            started++;
+            if (attempt.finished && !attempt.error) {
+                winner = &attempt;
+                return true;
+            }
+            failed += attempt.finished ? 1 : 0;
+        }
+        return failed == started;
+    });
+    lock.unlock();
+
+    // Cancel the loser right away; the destructors wait for it.
+    for (auto& attempt : attempts) {
+        attempt.cancelled = true;
+    }
+    if (winner == nullptr) {
+        std::rethrow_exception(attempts[0].error);
+    }
+    last_completion_tokens_ = winner->completion_tokens;
+    return std::move(winner->response);
+}
+
+nlohmann::json Model::CallEmbedding(const std::vector<std::string>& inputs) {
+    nlohmann::json embeddings;
+    ProfileEmbedding(inputs, [&]() { embeddings = provider_->CallEmbedding(inputs); });
+    return embeddings;
+}
+
+void Model::CallEmbeddingInto(const std::vector<std::string>& inputs, EmbeddingSink& sink) {
+    ProfileEmbedding(inputs, [&]() { provider_->CallEmbeddingInto(inputs, sink); });
+}
+
+void Model::ProfileEmbedding(const std::vector<std::string>& inputs, const std::function<void()>& call) {
+    // Embedding responses carry no completion tokens, and the prompt tokens are our own estimate.
+    const auto tokens = EstimateTokens(inputs);
+    RateLimiter::Acquire(GetRateLimitKey(), {model_details_.requests_per_minute, model_details_.tokens_per_minute},
+                         tokens);
+    if (DelegatesCalls()) {
+        call();
+        return;
+    }
+    CheckQueryBudget(tokens);
+    Profiler::RecordBatch(inputs.size());
+    const auto started = std::chrono::steady_clock::now();
+    const auto record = [&](const bool failed) {
+        const auto cost = failed ? 0 : ChargeQueryBudget(tokens, 0);
+        Profiler::RecordRequest(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started), tokens,
+            0, cost, failed);
+    };
+    try {
+        call();
+        record(false);
+    } catch (...) {
+        record(true);
+        throw;
+    }
+}
+
+int64_t Model::EstimateTokens(const std::vector<std::string>& inputs) {
+    int64_t tokens = 0;
+    for (const auto& input : inputs) {
+        tokens += Tiktoken::GetNumTokens(input);
+    }
+    return tokens;
+}
 
 } // namespace flockmtl
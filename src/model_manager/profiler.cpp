@@ -0,0 +1,119 @@
+#include "flockmtl/model_manager/profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace flockmtl {
+
+thread_local Profiler::Context Profiler::current_;
+std::mutex Profiler::mutex_;
+std::unordered_map<const void*, std::deque<QueryProfile>> Profiler::profiles_;
+
+size_t CallSiteProfile::GetLatencyBucket(const std::chrono::microseconds latency) {
+    auto milliseconds = latency.count() / 1000;
+    size_t bucket = 0;
+    while (milliseconds > 0 && bucket + 1 < kLatencyBuckets) {
+        milliseconds >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+std::chrono::microseconds CallSiteProfile::GetBucketUpperBound(const size_t bucket) {
+    return std::chrono::microseconds(int64_t(1000) << bucket);
+}
+
+std::chrono::microseconds CallSiteProfile::GetLatencyPercentile(const double percentile) const {
+    int64_t total = 0;
+    for (const auto count : latency_histogram) {
+        total += count;
+    }
+    if (total == 0) {
+        return std::chrono::microseconds(0);
+    }
+    const auto rank = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(percentile * static_cast<double>(total))));
+    int64_t seen = 0;
+    for (size_t bucket = 0; bucket < kLatencyBuckets; bucket++) {
+        seen += latency_histogram[bucket];
+        if (seen >= rank) {
+            return std::min(GetBucketUpperBound(bucket), max_latency);
+        }
+    }
+    return max_latency;
+}
+
+Profiler::Scope::Scope(const void* client, const uint64_t query_id, std::string function_name)
+    : Scope(Context {client, query_id, std::move(function_name)}) {}
+
+Profiler::Scope::Scope(Context context) : previous_(std::move(current_)) { current_ = std::move(context); }
+
+Profiler::Scope::~Scope() { current_ = std::move(previous_); }
+
+template <typename UPDATE>
+void Profiler::Update(UPDATE&& update) {
+    if (current_.client == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& queries = profiles_[current_.client];
+    if (queries.empty() || queries.back().query_id != current_.query_id) {
+        queries.push_back({current_.query_id, {}});
+        if (queries.size() > kMaxQueries) {
+            queries.pop_front();
+        }
+    }
+    update(queries.back().call_sites[current_.function_name]);
+}
+
+void Profiler::RecordRequest(const std::chrono::microseconds latency, const int64_t prompt_tokens,
+                             const int64_t completion_tokens, const double cost, const bool failed) {
+    Update([&](CallSiteProfile& profile) {
+        profile.requests++;
+        profile.failed_requests += failed ? 1 : 0;
+        profile.prompt_tokens += prompt_tokens;
+        profile.completion_tokens += completion_tokens;
+        profile.cost += cost;
+        profile.total_latency += latency;
+        profile.max_latency = std::max(profile.max_latency, latency);
+        profile.latency_histogram[CallSiteProfile::GetLatencyBucket(latency)]++;
+    });
+}
+
+void Profiler::RecordBatch(const size_t tuples) {
+    Update([&](CallSiteProfile& profile) {
+        profile.batches++;
+        profile.tuples += static_cast<int64_t>(tuples);
+        profile.max_batch_size = std::max(profile.max_batch_size, static_cast<int64_t>(tuples));
+    });
+}
+
+void Profiler::RecordRetry() {
+    Update([](CallSiteProfile& profile) { profile.retries++; });
+}
+
+void Profiler::RecordCacheHit(const size_t tuples) {
+    Update([&](CallSiteProfile& profile) { profile.cache_hits += static_cast<int64_t>(tuples); });
+}
+
+void Profiler::RecordCascade(const size_t tuples, const size_t escalations) {
+    Update([&](CallSiteProfile& profile) {
+        profile.cascaded_tuples += static_cast<int64_t>(tuples);
+        profile.escalations += static_cast<int64_t>(escalations);
+    });
+}
+
+std::vector<QueryProfile> Profiler::GetProfiles(const void* client) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = profiles_.find(client);
+    if (it == profiles_.end()) {
+        return {};
+    }
+    return {it->second.begin(), it->second.end()};
+}
+
+void Profiler::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    profiles_.clear();
+}
+
+} // namespace flockmtl
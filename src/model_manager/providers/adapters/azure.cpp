@@ -6,6 +6,7 @@ nlohmann::json AzureProvider::CallComplete(const std::string& prompt, const bool
     auto azure_model_manager_uptr =
         std::make_unique<AzureModelManager>(model_details_.secret["api_key"], model_details_.secret["resource_name"],
                                             model_details_.model, model_details_.secret["api_version"], true);
+    azure_model_manager_uptr->SetRequestOptions(GetRequestOptions());
 
     // Create a JSON request payload with the provided parameters
     nlohmann::json request_payload = {{"messages", {{{"role", "user"}, {"content", prompt}}}},
@@ -18,47 +19,53 @@ nlohmann::json AzureProvider::CallComplete(const std::string& prompt, const bool
     }
 
     // Make a request to the Azure API
-    auto completion = azure_model_manager_uptr->CallComplete(request_payload);
+    const auto response = azure_model_manager_uptr->CallCompleteText(request_payload);
+    if (const auto error = ResponseParser::GetError(response); error.has_value()) {
+        throw std::runtime_error("[Azure] error. Reason: " + *error);
+    }
+    const auto completion = ResponseParser::ParseChatCompletion(response);
+    RecordUsage(completion.usage);
 
     // Check if the conversation was too long for the context window
-    if (completion["choices"][0]["finish_reason"] == "length") {
+    if (completion.finish_reason == "length") {
         // Handle the error when the context window is too long
         throw ExceededMaxOutputTokensError();
     }
 
     // Check if the safety system refused the request
-    if (completion["choices"][0]["message"]["refusal"] != nullptr) {
+    if (completion.refusal.has_value()) {
         // Handle refusal error
-        throw std::runtime_error(
-            duckdb_fmt::format("The request was refused due to Azure's safety system.{{\"refusal\": \"{}\"}}",
-                               completion["choices"][0]["message"]["refusal"].get<std::string>()));
+        throw std::runtime_error(duckdb_fmt::format(
+            "The request was refused due to Azure's safety system.{{\"refusal\": \"{}\"}}", *completion.refusal));
     }
 
     // Check if the model's output included restricted content
-    if (completion["choices"][0]["finish_reason"] == "content_filter") {
+    if (completion.finish_reason == "content_filter") {
         // Handle content filtering
         throw std::runtime_error("The content filter was triggered, resulting in incomplete JSON.");
     }
 
-    std::string content_str = completion["choices"][0]["message"]["content"];
-
     if (json_response) {
-        return nlohmann::json::parse(content_str);
+        return nlohmann::json::parse(completion.content);
     }
 
-    return content_str;
+    return completion.content;
 }
 
 nlohmann::json AzureProvider::CallEmbedding(const std::vector<std::string>& inputs) {
     auto azure_model_manager_uptr =
         std::make_unique<AzureModelManager>(model_details_.secret["api_key"], model_details_.secret["resource_name"],
                                             model_details_.model, model_details_.secret["api_version"], true);
+    azure_model_manager_uptr->SetRequestOptions(GetRequestOptions());
 
     // Create a JSON request payload with the provided parameters
     nlohmann::json request_payload = {
         {"model", model_details_.model},
         {"input", inputs},
     };
+    if (model_details_.dimensions > 0) {
+        request_payload["dimensions"] = model_details_.dimensions;
+    }
 
     // Make a request to the Azure API
     auto completion = azure_model_manager_uptr->CallEmbedding(request_payload);
@@ -78,4 +85,28 @@ nlohmann::json AzureProvider::CallEmbedding(const std::vector<std::string>& inpu
     return embeddings;
 }
 
+void AzureProvider::CallEmbeddingInto(const std::vector<std::string>& inputs, EmbeddingSink& sink) {
+    auto azure_model_manager_uptr =
+        std::make_unique<AzureModelManager>(model_details_.secret["api_key"], model_details_.secret["resource_name"],
+                                            model_details_.model, model_details_.secret["api_version"], true);
+    azure_model_manager_uptr->SetRequestOptions(GetRequestOptions());
+
+    // Create a JSON request payload with the provided parameters
+    nlohmann::json request_payload = {
+        {"model", model_details_.model},
+        {"input", inputs},
+        {"encoding_format", model_details_.encoding_format},
+    };
+    if (model_details_.dimensions > 0) {
+        request_payload["dimensions"] = model_details_.dimensions;
+    }
+
+    // Make a request to the Azure API and decode the embeddings straight from the response body
+    const auto response = azure_model_manager_uptr->CallEmbeddingText(request_payload);
+    if (const auto error = ResponseParser::GetError(response); error.has_value()) {
+        throw std::runtime_error("[Azure] error. Reason: " + *error);
+    }
+    EmbeddingDecoder::Decode(response, inputs.size(), sink);
+}
+
 } // namespace flockmtl
\ No newline at end of file
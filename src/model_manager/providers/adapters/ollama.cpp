@@ -4,6 +4,7 @@ namespace flockmtl {
 
 nlohmann::json OllamaProvider::CallComplete(const std::string& prompt, const bool json_response) {
     auto ollama_model_manager_uptr = std::make_unique<OllamaModelManager>(model_details_.secret["api_url"], true);
+    ollama_model_manager_uptr->SetRequestOptions(GetRequestOptions());
 
     // Create a JSON request payload with the provided parameters
     nlohmann::json request_payload = {{"model", model_details_.model},
@@ -21,31 +22,41 @@ nlohmann::json OllamaProvider::CallComplete(const std::string& prompt, const boo
         request_payload["format"] = "json";
     }
 
-    nlohmann::json completion;
+    std::string response;
     try {
-        completion = ollama_model_manager_uptr->CallComplete(request_payload);
+        response = ollama_model_manager_uptr->CallCompleteText(request_payload);
+    } catch (const ProviderUnavailableError& e) {
+        throw ProviderUnavailableError(duckdb_fmt::format("Error in making request to Ollama API: {}", e.what()));
     } catch (const std::exception& e) {
         throw std::runtime_error(duckdb_fmt::format("Error in making request to Ollama API: {}", e.what()));
     }
+    if (const auto error = ResponseParser::GetError(response); error.has_value()) {
+        throw std::runtime_error(duckdb_fmt::format("Error in making request to Ollama API: {}", *error));
+    }
+    const auto completion = ResponseParser::ParseOllamaGenerate(response);
+    RecordUsage(completion.usage);
+
+    // Check if the generation was cut by the output token limit
+    if (completion.finish_reason == "length") {
+        throw ExceededMaxOutputTokensError();
+    }
 
     // Check if the call was not succesfull
-    if ((completion.contains("done_reason") && completion["done_reason"] != "stop") ||
-        (completion.contains("done") && !completion["done"].is_null() && completion["done"].get<bool>() != true)) {
+    if (completion.finish_reason != "stop") {
         // Handle refusal error
         throw std::runtime_error("The request was refused due to some internal error with Ollama API");
     }
 
-    std::string content_str = completion["response"];
-
     if (json_response) {
-        return nlohmann::json::parse(content_str);
+        return nlohmann::json::parse(completion.content);
     }
 
-    return content_str;
+    return completion.content;
 }
 
 nlohmann::json OllamaProvider::CallEmbedding(const std::vector<std::string>& inputs) {
     auto ollama_model_manager_uptr = std::make_unique<OllamaModelManager>(model_details_.secret["api_url"], true);
+    ollama_model_manager_uptr->SetRequestOptions(GetRequestOptions());
 
     auto embeddings = nlohmann::json::array();
     for (const auto& input : inputs) {
@@ -58,6 +69,9 @@ nlohmann::json OllamaProvider::CallEmbedding(const std::vector<std::string>& inp
         nlohmann::json completion;
         try {
             completion = ollama_model_manager_uptr->CallEmbedding(request_payload);
+        } catch (const ProviderUnavailableError& e) {
+            throw ProviderUnavailableError(
+                    duckdb_fmt::format("Error in making request to Ollama API: {}", e.what()));
         } catch (const std::exception& e) {
             throw std::runtime_error(duckdb_fmt::format("Error in making request to Ollama API: {}", e.what()));
         }
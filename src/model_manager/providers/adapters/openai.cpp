@@ -8,7 +8,21 @@ nlohmann::json OpenAIProvider::CallComplete(const std::string& prompt, bool json
         base_url = it->second;
     }
     auto openai = openai::OpenAI(model_details_.secret["api_key"], "", true, base_url);
+    openai.setRequestOptions(GetRequestOptions());
 
+    // Make a request to the OpenAI API
+    std::string response;
+    try {
+        response = openai.chat.createText(GetCompletionPayload(prompt, json_response));
+    } catch (const ProviderUnavailableError& e) {
+        throw ProviderUnavailableError("Error in making request to OpenAI API: " + std::string(e.what()));
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Error in making request to OpenAI API: " + std::string(e.what()));
+    }
+    return ParseCompletion(response, json_response);
+}
+
+nlohmann::json OpenAIProvider::GetCompletionPayload(const std::string& prompt, const bool json_response) const {
     // Create a JSON request payload with the provided parameters
     nlohmann::json request_payload = {{"model", model_details_.model},
                                       {"messages", {{{"role", "user"}, {"content", prompt}}}},
@@ -19,41 +33,52 @@ nlohmann::json OpenAIProvider::CallComplete(const std::string& prompt, bool json
     if (json_response) {
         request_payload["response_format"] = {{"type", "json_object"}};
     }
+    return request_payload;
+}
 
-    // Make a request to the OpenAI API
-    nlohmann::json completion;
-    try {
-        completion = openai.chat.create(request_payload);
-    } catch (const std::exception& e) {
-        throw std::runtime_error("Error in making request to OpenAI API: " + std::string(e.what()));
+nlohmann::json OpenAIProvider::GetEmbeddingPayload(const std::vector<std::string>& inputs) const {
+    nlohmann::json request_payload = {
+        {"model", model_details_.model},
+        {"input", inputs},
+        {"encoding_format", model_details_.encoding_format},
+    };
+    if (model_details_.dimensions > 0) {
+        request_payload["dimensions"] = model_details_.dimensions;
+    }
+    return request_payload;
+}
+
+nlohmann::json OpenAIProvider::ParseCompletion(const std::string& response, const bool json_response) {
+    if (const auto error = ResponseParser::GetError(response); error.has_value()) {
+        throw std::runtime_error("Error in making request to OpenAI API: " + *error);
     }
+    const auto completion = ResponseParser::ParseChatCompletion(response);
+    RecordUsage(completion.usage);
+
     // Check if the conversation was too long for the context window
-    if (completion["choices"][0]["finish_reason"] == "length") {
+    if (completion.finish_reason == "length") {
         // Handle the error when the context window is too long
         throw ExceededMaxOutputTokensError();
     }
 
     // Check if the OpenAI safety system refused the request
-    if (completion["choices"][0]["message"]["refusal"] != nullptr) {
+    if (completion.refusal.has_value()) {
         // Handle refusal error
-        throw std::runtime_error(
-            duckdb_fmt::format("The request was refused due to OpenAI's safety system.{{\"refusal\": \"{}\"}}",
-                               completion["choices"][0]["message"]["refusal"].get<std::string>()));
+        throw std::runtime_error(duckdb_fmt::format(
+            "The request was refused due to OpenAI's safety system.{{\"refusal\": \"{}\"}}", *completion.refusal));
     }
 
     // Check if the model's output included restricted content
-    if (completion["choices"][0]["finish_reason"] == "content_filter") {
+    if (completion.finish_reason == "content_filter") {
         // Handle content filtering
         throw std::runtime_error("The content filter was triggered, resulting in incomplete JSON.");
     }
 
-    std::string content_str = completion["choices"][0]["message"]["content"];
-
     if (json_response) {
-        return nlohmann::json::parse(content_str);
+        return nlohmann::json::parse(completion.content);
     }
 
-    return content_str;
+    return completion.content;
 }
 
 nlohmann::json OpenAIProvider::CallEmbedding(const std::vector<std::string>& inputs) {
@@ -62,12 +87,16 @@ nlohmann::json OpenAIProvider::CallEmbedding(const std::vector<std::string>& inp
         base_url = it->second;
     }
     auto openai = openai::OpenAI(model_details_.secret["api_key"], "", true, base_url);
+    openai.setRequestOptions(GetRequestOptions());
 
     // Create a JSON request payload with the provided parameters
     nlohmann::json request_payload = {
         {"model", model_details_.model},
         {"input", inputs},
     };
+    if (model_details_.dimensions > 0) {
+        request_payload["dimensions"] = model_details_.dimensions;
+    }
 
     // Make a request to the OpenAI API
     auto completion = openai.embedding.create(request_payload);
@@ -86,4 +115,27 @@ nlohmann::json OpenAIProvider::CallEmbedding(const std::vector<std::string>& inp
     return embeddings;
 }
 
+void OpenAIProvider::CallEmbeddingInto(const std::vector<std::string>& inputs, EmbeddingSink& sink) {
+    auto base_url = std::string("");
+    if (const auto it = model_details_.secret.find("base_url"); it != model_details_.secret.end()) {
+        base_url = it->second;
+    }
+    auto openai = openai::OpenAI(model_details_.secret["api_key"], "", true, base_url);
+    openai.setRequestOptions(GetRequestOptions());
+
+    // Make a request to the OpenAI API and decode the embeddings straight from the response body
+    std::string response;
+    try {
+        response = openai.embedding.createText(GetEmbeddingPayload(inputs));
+    } catch (const ProviderUnavailableError& e) {
+        throw ProviderUnavailableError("Error in making request to OpenAI API: " + std::string(e.what()));
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Error in making request to OpenAI API: " + std::string(e.what()));
+    }
+    if (const auto error = ResponseParser::GetError(response); error.has_value()) {
+        throw std::runtime_error("Error in making request to OpenAI API: " + *error);
+    }
+    EmbeddingDecoder::Decode(response, inputs.size(), sink);
+}
+
 } // namespace flockmtl
@@ -0,0 +1,140 @@
+#include "flockmtl/model_manager/providers/adapters/pool.hpp"
+
+#include <algorithm>
+
+#include "flockmtl/model_manager/model.hpp"
+
+namespace flockmtl {
+
+std::mutex PoolProvider::mutex_;
+std::unordered_map<std::string, PoolProvider::BackendState> PoolProvider::states_;
+
+PoolProvider::PoolProvider(const ModelDetails& model_details) : IProvider(model_details) {
+    for (const auto& backend : model_details_.backends) {
+        // Backends take the same settings as the model struct of a function call, where every value is a string.
+        nlohmann::json model_json = nlohmann::json::object();
+        for (const auto& [key, value] : backend.items()) {
+            if (key != "weight") {
+                model_json[key] = value.is_string() ? value.get<std::string>() : value.dump();
+            }
+        }
+        // Checked before the backend is built, which for a pool would build its backends in turn.
+        if (GetProviderType(Model::GetProviderName(model_json)) == FLOCKMTL_POOL) {
+            throw std::invalid_argument("A pool cannot contain another pool: " + model_json.value("model_name", ""));
+        }
+        auto model = std::make_shared<Model>(model_json);
+        const auto key = model->GetRateLimitKey();
+        backends_.push_back({std::move(model), key, backend.value("weight", 1.0)});
+    }
+}
+
+size_t PoolProvider::PickBackend(const std::vector<BackendLoad>& loads) {
+    const auto any_healthy = std::any_of(loads.begin(), loads.end(), [](const BackendLoad& load) { return load.healthy; });
+    size_t best = loads.size();
+    for (size_t i = 0; i < loads.size(); i++) {
+        if (any_healthy && !loads[i].healthy) {
+            continue;
+        }
+        if (best == loads.size()) {
+            best = i;
+            continue;
+        }
+        const auto requests = (loads[i].outstanding_requests + 1) / loads[i].weight;
+        const auto best_requests = (loads[best].outstanding_requests + 1) / loads[best].weight;
+        if (requests < best_requests ||
+            (requests == best_requests &&
+             loads[i].outstanding_tokens / loads[i].weight < loads[best].outstanding_tokens / loads[best].weight)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+size_t PoolProvider::Acquire(const std::vector<bool>& tried, const int64_t estimated_tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<size_t> candidates;
+    std::vector<BackendLoad> loads;
+    for (size_t i = 0; i < backends_.size(); i++) {
+        if (tried[i]) {
+            continue;
+        }
+        const auto& state = states_[backends_[i].key];
+        candidates.push_back(i);
+        loads.push_back({backends_[i].weight, state.outstanding_requests, state.outstanding_tokens,
+                         now >= state.unhealthy_until});
+    }
+    const auto index = candidates[PickBackend(loads)];
+    auto& state = states_[backends_[index].key];
+    state.outstanding_requests++;
+    state.outstanding_tokens += estimated_tokens;
+    return index;
+}
+
+void PoolProvider::Release(const std::string& key, const int64_t estimated_tokens, const bool healthy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& state = states_[key];
+    state.outstanding_requests--;
+    state.outstanding_tokens -= estimated_tokens;
+    if (healthy) {
+        state.consecutive_failures = 0;
+        state.unhealthy_until = {};
+    } else if (++state.consecutive_failures >= kFailureThreshold) {
+        state.unhealthy_until = std::chrono::steady_clock::now() + kUnhealthyDuration;
+    }
+}
+
+void PoolProvider::Dispatch(const int64_t estimated_tokens, const std::function<void(Model&)>& call) {
+    std::vector<bool> tried(backends_.size(), false);
+    std::exception_ptr last_error;
+    for (size_t attempt = 0; attempt < backends_.size(); attempt++) {
+        const auto index = Acquire(tried, estimated_tokens);
+        tried[index] = true;
+        const auto& backend = backends_[index];
+        try {
+            call(*backend.model);
+            Release(backend.key, estimated_tokens, true);
+            return;
+        } catch (const ProviderUnavailableError&) {
+            Release(backend.key, estimated_tokens, false);
+            last_error = std::current_exception();
+        } catch (...) {
+            // Refusals, malformed responses, batches too large for max_output_tokens and aborted queries would fail
+            // the same way on every backend, and say nothing about this one's health.
+            Release(backend.key, estimated_tokens, true);
+            throw;
+        }
+    }
+    std::rethrow_exception(last_error);
+}
+
+nlohmann::json PoolProvider::CallComplete(const std::string& prompt, const bool json_response) {
+    nlohmann::json response;
+    Dispatch(Tiktoken::GetNumTokens(prompt), [&](Model& model) { response = model.CallComplete(prompt, json_response); });
+    return response;
+}
+
+nlohmann::json PoolProvider::CallEmbedding(const std::vector<std::string>& inputs) {
+    nlohmann::json embeddings;
+    int64_t tokens = 0;
+    for (const auto& input : inputs) {
+        tokens += Tiktoken::GetNumTokens(input);
+    }
+    Dispatch(tokens, [&](Model& model) { embeddings = model.CallEmbedding(inputs); });
+    return embeddings;
+}
+
+void PoolProvider::CallEmbeddingInto(const std::vector<std::string>& inputs, EmbeddingSink& sink) {
+    int64_t tokens = 0;
+    for (const auto& input : inputs) {
+        tokens += Tiktoken::GetNumTokens(input);
+    }
+    Dispatch(tokens, [&](Model& model) { model.CallEmbeddingInto(inputs, sink); });
+}
+
+void PoolProvider::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    states_.clear();
+}
+
+} // namespace flockmtl
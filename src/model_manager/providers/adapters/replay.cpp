@@ -0,0 +1,89 @@
+#include "flockmtl/model_manager/providers/adapters/replay.hpp"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+#include "duckdb/main/config.hpp"
+#include "flockmtl/model_manager/model.hpp"
+
+namespace flockmtl {
+
+ReplayProvider::ReplayProvider(const ModelDetails& model_details) : IProvider(model_details) {
+    // Replay files are local files like any other, so they follow the database's enable_external_access and
+    // allowed_paths settings.
+    if (!duckdb::DBConfig::GetConfig(*Config::db)
+                 .CanAccessFile(model_details_.replay_file, duckdb::FileType::FILE_TYPE_REGULAR)) {
+        throw std::runtime_error("Cannot access replay file " + model_details_.replay_file +
+                                 ": file system access is disabled by the database configuration");
+    }
+    log_ = ReplayLog::Open(model_details_.replay_file);
+    if (!model_details_.replay_record) {
+        return;
+    }
+    // The recorded model takes the same settings as the model struct of a function call, where every value is a
+    // string.
+    nlohmann::json model_json = nlohmann::json::object();
+    for (const auto& [key, value] : model_details_.backends.at(0).items()) {
+        model_json[key] = value.is_string() ? value.get<std::string>() : value.dump();
+    }
+    // Checked before the backend is built, which for a replay model would open its own backend in turn.
+    if (GetProviderType(Model::GetProviderName(model_json)) == FLOCKMTL_REPLAY) {
+        throw std::invalid_argument("A replay model cannot record another replay model: " +
+                                    model_json.value("model_name", ""));
+    }
+    backend_ = std::make_shared<Model>(model_json);
+}
+
+std::chrono::milliseconds ReplayProvider::GetSyntheticLatency(const std::chrono::milliseconds latency,
+                                                              const std::chrono::milliseconds jitter) {
+    if (jitter.count() <= 0) {
+        return std::max(latency, std::chrono::milliseconds(0));
+    }
+    thread_local std::mt19937_64 generator {std::random_device {}()};
+    std::uniform_int_distribution<int64_t> distribution(latency.count() - jitter.count(),
+                                                        latency.count() + jitter.count());
+    return std::chrono::milliseconds(std::max<int64_t>(0, distribution(generator)));
+}
+
+nlohmann::json ReplayProvider::Replay(const nlohmann::json& request) {
+    auto response = log_->Find(request);
+    if (!response.has_value()) {
+        throw std::runtime_error("No recorded response in " + model_details_.replay_file +
+                                 " for this request; record it first with \"replay_mode\": \"record\".");
+    }
+
+    // Wait like a provider would, but give up as soon as the caller cancels, e.g. the losing side of a hedge.
+    const auto until = std::chrono::steady_clock::now() +
+                       GetSyntheticLatency(model_details_.replay_latency, model_details_.replay_jitter);
+    while (std::chrono::steady_clock::now() < until) {
+        if (RequestCancellation::IsCancelled()) {
+            throw std::runtime_error("Replayed request was cancelled.");
+        }
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+            until - std::chrono::steady_clock::now(), std::chrono::milliseconds(10)));
+    }
+    return std::move(*response);
+}
+
+nlohmann::json ReplayProvider::CallComplete(const std::string& prompt, const bool json_response) {
+    const auto request = ReplayLog::CompletionRequest(prompt, json_response);
+    if (!backend_) {
+        return Replay(request);
+    }
+    auto response = backend_->CallComplete(prompt, json_response);
+    log_->Append(request, response);
+    return response;
+}
+
+nlohmann::json ReplayProvider::CallEmbedding(const std::vector<std::string>& inputs) {
+    const auto request = ReplayLog::EmbeddingRequest(inputs);
+    if (!backend_) {
+        return Replay(request);
+    }
+    auto embeddings = backend_->CallEmbedding(inputs);
+    log_->Append(request, embeddings);
+    return embeddings;
+}
+
+} // namespace flockmtl
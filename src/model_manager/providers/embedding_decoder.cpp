@@ -0,0 +1,360 @@
+#include "flockmtl/model_manager/providers/embedding_decoder.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define FLOCKMTL_BASE64_AVX2
+#include <immintrin.h>
+#endif
+
+namespace flockmtl {
+
+namespace {
+
+constexpr uint8_t kInvalidBase64 = 0xFF;
+
+std::array<uint8_t, 256> BuildBase64Table() {
+    std::array<uint8_t, 256> table {};
+    table.fill(kInvalidBase64);
+    const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (uint8_t i = 0; i < 64; i++) {
+        table[static_cast<uint8_t>(alphabet[i])] = i;
+    }
+    return table;
+}
+
+const std::array<uint8_t, 256> kBase64Table = BuildBase64Table();
+
+constexpr double kPowersOfTen[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+inline bool IsDigit(const char c) { return c >= '0' && c <= '9'; }
+
+[[noreturn]] void ThrowMalformed(const std::string& what, const size_t pos) {
+    throw std::runtime_error("Malformed embedding response: " + what + " at offset " + std::to_string(pos));
+}
+
+// Decodes groups of four base64 characters without padding; returns false on any character outside the alphabet.
+bool DecodeBase64Scalar(const char* in, const size_t length, uint8_t* out) {
+    for (size_t i = 0; i < length; i += 4) {
+        const auto a = kBase64Table[static_cast<uint8_t>(in[i])];
+        const auto b = kBase64Table[static_cast<uint8_t>(in[i + 1])];
+        const auto c = kBase64Table[static_cast<uint8_t>(in[i + 2])];
+        const auto d = kBase64Table[static_cast<uint8_t>(in[i + 3])];
+        if (((a | b | c | d) & 0xC0) != 0) {
+            return false;
+        }
+        const uint32_t triple = (a << 18) | (b << 12) | (c << 6) | d;
+        *out++ = static_cast<uint8_t>(triple >> 16);
+        *out++ = static_cast<uint8_t>(triple >> 8);
+        *out++ = static_cast<uint8_t>(triple);
+    }
+    return true;
+}
+
+#ifdef FLOCKMTL_BASE64_AVX2
+// Translates 32 characters into 24 bytes per iteration (nibble-lookup validation and translation, then two
+// multiply-adds to pack the 6-bit values). Stops at the first block holding padding or an invalid character and
+// returns the number of characters consumed so the scalar path can finish the tail.
+__attribute__((target("avx2"))) size_t DecodeBase64Avx2(const char* in, const size_t length, uint8_t* out) {
+    const auto lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B,
+                                         0x1B, 0x1B, 0x1A, 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                         0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const auto lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                         0x10, 0x10, 0x10, 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10,
+                                         0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const auto lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16, 19, 4, -65,
+                                           -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const auto pack_bytes = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4,
+                                             10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const auto pack_lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+    const auto nibble_mask = _mm256_set1_epi8(0x0F);
+    const auto slash = _mm256_set1_epi8('/');
+
+    size_t consumed = 0;
+    while (consumed + 32 <= length) {
+        const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + consumed));
+        const auto hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(chars, 4), nibble_mask);
+        const auto lo_nibbles = _mm256_and_si256(chars, nibble_mask);
+        const auto lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        const auto hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        if (!_mm256_testz_si256(lo, hi)) {
+            break;
+        }
+
+        const auto roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(_mm256_cmpeq_epi8(chars, slash), hi_nibbles));
+        const auto sextets = _mm256_add_epi8(chars, roll);
+        const auto pairs = _mm256_maddubs_epi16(sextets, _mm256_set1_epi32(0x01400140));
+        const auto words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        const auto packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(words, pack_bytes), pack_lanes);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(packed, 1));
+        consumed += 32;
+        out += 24;
+    }
+    return consumed;
+}
+
+bool HasAvx2() {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+#endif
+
+} // namespace
+
+double EmbeddingDecoder::ParseNumber(std::string_view json, size_t& pos) {
+    const auto start = pos;
+    const auto* p = json.data() + pos;
+    const auto* const end = json.data() + json.size();
+
+    auto negative = false;
+    if (p < end && *p == '-') {
+        negative = true;
+        p++;
+    }
+
+    // Accumulate up to 19 significant digits; anything longer, or outside the exactly representable range below,
+    // is handed to strtod.
+    uint64_t mantissa = 0;
+    auto significant_digits = 0;
+    auto exponent = 0;
+    auto truncated = false;
+    const auto* digits_start = p;
+    while (p < end && IsDigit(*p)) {
+        if (significant_digits < 19) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            significant_digits += mantissa != 0;
+        } else {
+            exponent++;
+            truncated = true;
+        }
+        p++;
+    }
+    if (p == digits_start) {
+        ThrowMalformed("expected a number", start);
+    }
+    if (p < end && *p == '.') {
+        p++;
+        const auto* fraction_start = p;
+        while (p < end && IsDigit(*p)) {
+            if (significant_digits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                significant_digits += mantissa != 0;
+                exponent--;
+            } else {
+                truncated = true;
+            }
+            p++;
+        }
+        if (p == fraction_start) {
+            ThrowMalformed("expected digits after the decimal point", start);
+        }
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        auto exponent_negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            exponent_negative = *p == '-';
+            p++;
+        }
+        if (p == end || !IsDigit(*p)) {
+            ThrowMalformed("expected an exponent", start);
+        }
+        auto explicit_exponent = 0;
+        while (p < end && IsDigit(*p)) {
+            if (explicit_exponent < 100000) {
+                explicit_exponent = explicit_exponent * 10 + (*p - '0');
+            }
+            p++;
+        }
+        exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+    }
+    pos = static_cast<size_t>(p - json.data());
+
+    // Both the mantissa and the power of ten are exact doubles here, so a single multiply or divide is correctly
+    // rounded.
+    if (!truncated && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+        auto value = static_cast<double>(mantissa);
+        value = exponent < 0 ? value / kPowersOfTen[-exponent] : value * kPowersOfTen[exponent];
+        return negative ? -value : value;
+    }
+
+    const std::string text(json.substr(start, pos - start));
+    return std::strtod(text.c_str(), nullptr);
+}
+
+size_t EmbeddingDecoder::DecodeFloatArray(std::string_view json, size_t pos, std::vector<double>& out) {
+    out.clear();
+    pos = JsonScanner::SkipWhitespace(json, pos);
+    if (pos >= json.size() || json[pos] != '[') {
+        ThrowMalformed("expected '['", pos);
+    }
+    pos = JsonScanner::SkipWhitespace(json, pos + 1);
+    if (pos < json.size() && json[pos] == ']') {
+        return pos + 1;
+    }
+    while (true) {
+        out.push_back(ParseNumber(json, pos));
+        pos = JsonScanner::SkipWhitespace(json, pos);
+        if (pos < json.size() && json[pos] == ',') {
+            pos = JsonScanner::SkipWhitespace(json, pos + 1);
+            continue;
+        }
+        if (pos < json.size() && json[pos] == ']') {
+            return pos + 1;
+        }
+        ThrowMalformed("expected ',' or ']'", pos);
+    }
+}
+
+void EmbeddingDecoder::DecodeBase64(std::string_view encoded, std::vector<uint8_t>& out) {
+    if (encoded.size() % 4 != 0) {
+        throw std::runtime_error("Malformed embedding response: base64 payload length is not a multiple of 4");
+    }
+    if (encoded.empty()) {
+        out.clear();
+        return;
+    }
+
+    size_t padding = 0;
+    if (encoded.back() == '=') {
+        padding = encoded[encoded.size() - 2] == '=' ? 2 : 1;
+    }
+    out.resize(encoded.size() / 4 * 3 - padding);
+
+    // Everything but the last group is free of padding and can be decoded in bulk.
+    const auto body_length = encoded.size() - 4;
+    size_t consumed = 0;
+#ifdef FLOCKMTL_BASE64_AVX2
+    if (HasAvx2()) {
+        consumed = DecodeBase64Avx2(encoded.data(), body_length, out.data());
+    }
+#endif
+    if (!DecodeBase64Scalar(encoded.data() + consumed, body_length - consumed, out.data() + consumed / 4 * 3)) {
+        throw std::runtime_error("Malformed embedding response: invalid base64 character");
+    }
+
+    char last[4];
+    std::memcpy(last, encoded.data() + body_length, 4);
+    for (size_t i = 4 - padding; i < 4; i++) {
+        last[i] = 'A';
+    }
+    uint8_t tail[3];
+    if (!DecodeBase64Scalar(last, 4, tail)) {
+        throw std::runtime_error("Malformed embedding response: invalid base64 character");
+    }
+    std::memcpy(out.data() + body_length / 4 * 3, tail, 3 - padding);
+}
+
+void EmbeddingDecoder::DecodeBase64Floats(std::string_view encoded, std::vector<double>& out) {
+    thread_local std::vector<uint8_t> bytes;
+    DecodeBase64(encoded, bytes);
+    if (bytes.size() % sizeof(float) != 0) {
+        throw std::runtime_error("Malformed embedding response: base64 payload is not a float32 array");
+    }
+    // The payload is little-endian float32, which matches every platform the extension is built for.
+    const auto count = bytes.size() / sizeof(float);
+    out.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        float value;
+        std::memcpy(&value, bytes.data() + i * sizeof(float), sizeof(float));
+        out[i] = value;
+    }
+}
+
+size_t EmbeddingDecoder::DecodeItem(std::string_view json, size_t pos, const size_t default_row,
+                                    std::vector<bool>& written, EmbeddingSink& sink, std::vector<double>& values) {
+    pos = JsonScanner::SkipWhitespace(json, pos);
+    if (pos >= json.size() || json[pos] != '{') {
+        ThrowMalformed("expected '{'", pos);
+    }
+    pos = JsonScanner::SkipWhitespace(json, pos + 1);
+
+    auto row = default_row;
+    auto has_embedding = false;
+    while (pos < json.size() && json[pos] != '}') {
+        const auto key_end = JsonScanner::SkipValue(json, pos);
+        const auto key = json.substr(pos, key_end - pos);
+        pos = JsonScanner::SkipWhitespace(json, key_end);
+        if (pos >= json.size() || json[pos] != ':') {
+            ThrowMalformed("expected ':'", pos);
+        }
+        pos = JsonScanner::SkipWhitespace(json, pos + 1);
+
+        if (key == "\"embedding\"") {
+            if (pos < json.size() && json[pos] == '"') {
+                const auto value_end = JsonScanner::SkipValue(json, pos);
+                const auto value = json.substr(pos, value_end - pos);
+                if (value.find('\\') == std::string_view::npos) {
+                    DecodeBase64Floats(value.substr(1, value.size() - 2), values);
+                } else {
+                    DecodeBase64Floats(JsonScanner::GetString(value), values);
+                }
+                pos = value_end;
+            } else {
+                pos = DecodeFloatArray(json, pos, values);
+            }
+            has_embedding = true;
+        } else {
+            const auto value_end = JsonScanner::SkipValue(json, pos);
+            if (key == "\"index\"") {
+                row = static_cast<size_t>(JsonScanner::GetInteger(json.substr(pos, value_end - pos)));
+            }
+            pos = value_end;
+        }
+
+        pos = JsonScanner::SkipWhitespace(json, pos);
+        if (pos < json.size() && json[pos] == ',') {
+            pos = JsonScanner::SkipWhitespace(json, pos + 1);
+        }
+    }
+    if (pos >= json.size()) {
+        ThrowMalformed("unterminated object", pos);
+    }
+    if (!has_embedding) {
+        throw std::runtime_error("Malformed embedding response: item without an embedding");
+    }
+    if (row >= written.size()) {
+        throw std::runtime_error("Malformed embedding response: index " + std::to_string(static_cast<int64_t>(row)) +
+                                 " is outside of the " + std::to_string(written.size()) + " inputs");
+    }
+    if (written[row]) {
+        throw std::runtime_error("Malformed embedding response: index " + std::to_string(row) + " is repeated");
+    }
+    written[row] = true;
+    sink.Write(row, values.data(), values.size());
+    return pos + 1;
+}
+
+size_t EmbeddingDecoder::Decode(std::string_view response, const size_t rows, EmbeddingSink& sink) {
+    const auto data = JsonScanner::GetMember(response, "data");
+    if (!data.has_value() || JsonScanner::IsNull(*data)) {
+        throw std::runtime_error("The response does not contain any embeddings");
+    }
+
+    thread_local std::vector<double> values;
+    const auto array = *data;
+    auto pos = JsonScanner::SkipWhitespace(array, 0);
+    if (pos >= array.size() || array[pos] != '[') {
+        ThrowMalformed("expected '['", pos);
+    }
+    pos = JsonScanner::SkipWhitespace(array, pos + 1);
+
+    std::vector<bool> written(rows, false);
+    size_t decoded = 0;
+    while (pos < array.size() && array[pos] != ']') {
+        pos = DecodeItem(array, pos, decoded++, written, sink, values);
+        pos = JsonScanner::SkipWhitespace(array, pos);
+        if (pos < array.size() && array[pos] == ',') {
+            pos = JsonScanner::SkipWhitespace(array, pos + 1);
+        }
+    }
+    return decoded;
+}
+
+} // namespace flockmtl
@@ -0,0 +1,87 @@
+#include "flockmtl/model_manager/providers/response_parser.hpp"
+
+namespace flockmtl {
+
+std::optional<std::string> ResponseParser::GetError(std::string_view response) {
+    const auto error = JsonScanner::GetMember(response, "error");
+    if (!error.has_value() || JsonScanner::IsNull(*error)) {
+        return std::nullopt;
+    }
+    if (JsonScanner::IsString(*error)) {
+        return JsonScanner::GetString(*error);
+    }
+    // OpenAI-style errors are objects such as {"message": ..., "type": ..., "code": ...}.
+    if (const auto message = JsonScanner::GetMember(*error, "message");
+        message.has_value() && JsonScanner::IsString(*message)) {
+        return JsonScanner::GetString(*message);
+    }
+    return std::string(*error);
+}
+
+CompletionResponse ResponseParser::ParseChatCompletion(std::string_view response) {
+    CompletionResponse completion;
+
+    const auto choices = JsonScanner::GetMember(response, "choices");
+    const auto choice = choices.has_value() ? JsonScanner::GetElement(*choices, 0) : std::nullopt;
+    if (!choice.has_value()) {
+        throw std::runtime_error("The response does not contain any choices");
+    }
+
+    if (const auto finish_reason = JsonScanner::GetMember(*choice, "finish_reason");
+        finish_reason.has_value() && JsonScanner::IsString(*finish_reason)) {
+        completion.finish_reason = JsonScanner::GetString(*finish_reason);
+    }
+
+    if (const auto message = JsonScanner::GetMember(*choice, "message"); message.has_value()) {
+        if (const auto refusal = JsonScanner::GetMember(*message, "refusal");
+            refusal.has_value() && !JsonScanner::IsNull(*refusal)) {
+            completion.refusal = JsonScanner::GetString(*refusal);
+        }
+        if (const auto content = JsonScanner::GetMember(*message, "content");
+            content.has_value() && !JsonScanner::IsNull(*content)) {
+            completion.content = JsonScanner::GetString(*content);
+        }
+    }
+
+    if (const auto usage = JsonScanner::GetMember(response, "usage"); usage.has_value() && !JsonScanner::IsNull(*usage)) {
+        if (const auto prompt_tokens = JsonScanner::GetMember(*usage, "prompt_tokens"); prompt_tokens.has_value()) {
+            completion.usage.prompt_tokens = JsonScanner::GetInteger(*prompt_tokens);
+        }
+        if (const auto completion_tokens = JsonScanner::GetMember(*usage, "completion_tokens");
+            completion_tokens.has_value()) {
+            completion.usage.completion_tokens = JsonScanner::GetInteger(*completion_tokens);
+        }
+    }
+
+    return completion;
+}
+
+CompletionResponse ResponseParser::ParseOllamaGenerate(std::string_view response) {
+    CompletionResponse completion;
+
+    auto done = true;
+    if (const auto done_value = JsonScanner::GetMember(response, "done");
+        done_value.has_value() && !JsonScanner::IsNull(*done_value)) {
+        done = JsonScanner::GetBool(*done_value);
+    }
+    if (const auto done_reason = JsonScanner::GetMember(response, "done_reason"); done_reason.has_value()) {
+        completion.finish_reason = JsonScanner::GetString(*done_reason);
+    } else {
+        completion.finish_reason = done ? "stop" : "incomplete";
+    }
+
+    if (const auto content = JsonScanner::GetMember(response, "response"); content.has_value()) {
+        completion.content = JsonScanner::GetString(*content);
+    }
+
+    if (const auto prompt_tokens = JsonScanner::GetMember(response, "prompt_eval_count"); prompt_tokens.has_value()) {
+        completion.usage.prompt_tokens = JsonScanner::GetInteger(*prompt_tokens);
+    }
+    if (const auto completion_tokens = JsonScanner::GetMember(response, "eval_count"); completion_tokens.has_value()) {
+        completion.usage.completion_tokens = JsonScanner::GetInteger(*completion_tokens);
+    }
+
+    return completion;
+}
+
+} // namespace flockmtl
@@ -0,0 +1,102 @@
+#include "flockmtl/model_manager/query_budget.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace flockmtl {
+
+thread_local QueryBudgets::Context QueryBudgets::current_;
+
+void QueryBudget::Check(const int64_t tokens, const double cost) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (limits_.max_tokens > 0 && tokens_ + tokens > limits_.max_tokens) {
+        throw std::runtime_error("Query aborted: it has used " + std::to_string(tokens_) +
+                                 " tokens and the next request needs about " + std::to_string(tokens) +
+                                 " more, exceeding flockmtl_max_tokens = " + std::to_string(limits_.max_tokens));
+    }
+    if (limits_.max_cost > 0 && cost_ + cost > limits_.max_cost) {
+        std::ostringstream message;
+        message << "Query aborted: it has cost " << cost_ << " and the next request about " << cost
+                << " more, exceeding flockmtl_max_cost = " << limits_.max_cost;
+        throw std::runtime_error(message.str());
+    }
+}
+
+void QueryBudget::Charge(const int64_t tokens, const double cost) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tokens_ += tokens;
+    cost_ += cost;
+}
+
+int64_t QueryBudget::GetTokens() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tokens_;
+}
+
+double QueryBudget::GetCost() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cost_;
+}
+
+double QueryBudget::GetCost(const int64_t prompt_tokens, const int64_t completion_tokens, const double input_price,
+                            const double output_price) {
+    return (static_cast<double>(prompt_tokens) * input_price + static_cast<double>(completion_tokens) * output_price) /
+           1e6;
+}
+
+void QueryBudgets::StartQuery(const uint64_t query_id) {
+    if (query_id != query_id_) {
+        query_id_ = query_id;
+        query_budget_.reset();
+        retry_budgets_.clear();
+    }
+}
+
+std::shared_ptr<QueryBudget> QueryBudgets::GetQueryBudget(const uint64_t query_id, const QueryBudget::Limits limits) {
+    if (limits.IsUnlimited()) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    StartQuery(query_id);
+    if (!query_budget_) {
+        query_budget_ = std::make_shared<QueryBudget>(limits);
+    }
+    return query_budget_;
+}
+
+std::shared_ptr<RetryBudget> QueryBudgets::GetRetryBudget(const uint64_t query_id, const std::string& model_key,
+                                                          const int64_t retries) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    StartQuery(query_id);
+    auto& budget = retry_budgets_[model_key];
+    if (!budget) {
+        budget = std::make_shared<RetryBudget>(retries);
+    }
+    return budget;
+}
+
+void QueryBudgets::EndQuery() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    query_budget_.reset();
+    retry_budgets_.clear();
+}
+
+std::shared_ptr<QueryBudget> QueryBudgets::GetCurrentQueryBudget() {
+    if (current_.budgets == nullptr) {
+        return nullptr;
+    }
+    return current_.budgets->GetQueryBudget(current_.query_id, current_.limits);
+}
+
+std::shared_ptr<RetryBudget> QueryBudgets::GetCurrentRetryBudget(const std::string& model_key, const int64_t retries) {
+    if (current_.budgets == nullptr) {
+        return std::make_shared<RetryBudget>(retries);
+    }
+    return current_.budgets->GetRetryBudget(current_.query_id, model_key, retries);
+}
+
+QueryBudgets::Scope::Scope(const Context& context) : previous_(current_) { current_ = context; }
+
+QueryBudgets::Scope::~Scope() { current_ = previous_; }
+
+} // namespace flockmtl
@@ -0,0 +1,139 @@
+#include "flockmtl/model_manager/rate_limiter.hpp"
+
+#include <algorithm>
+
+namespace flockmtl {
+
+std::mutex RateLimiter::mutex_;
+std::condition_variable RateLimiter::released_;
+std::unordered_map<std::string, RateLimiter::Budget> RateLimiter::budgets_;
+
+void RateLimiter::Bucket::Configure(const int64_t per_minute) {
+    if (per_minute <= 0) {
+        capacity = 0;
+        available = 0;
+        refill_per_second = 0;
+        return;
+    }
+    const auto new_capacity = static_cast<double>(per_minute) * kBudgetUtilization;
+    // A fresh bucket starts full; a resized one keeps what it has, up to the new capacity.
+    available = capacity > 0 ? std::min(available, new_capacity) : new_capacity;
+    capacity = new_capacity;
+    refill_per_second = new_capacity / 60.0;
+}
+
+void RateLimiter::Bucket::Refill(const double elapsed_seconds) {
+    if (IsLimited()) {
+        available = std::min(capacity, available + elapsed_seconds * refill_per_second);
+    }
+}
+
+double RateLimiter::Bucket::WaitFor(const double amount) const {
+    if (!IsLimited() || available >= amount) {
+        return 0;
+    }
+    return (amount - available) / refill_per_second;
+}
+
+RateLimiter::Budget& RateLimiter::GetBudget(const std::string& key, const RateLimits& limits) {
+    auto it = budgets_.find(key);
+    if (it == budgets_.end()) {
+        it = budgets_.emplace(key, Budget()).first;
+        it->second.last_refill = std::chrono::steady_clock::now();
+        it->second.limits = RateLimits {-1, -1};
+    }
+    auto& budget = it->second;
+    if (budget.limits.requests_per_minute != limits.requests_per_minute) {
+        budget.requests.Configure(limits.requests_per_minute);
+    }
+    if (budget.limits.tokens_per_minute != limits.tokens_per_minute) {
+        budget.tokens.Configure(limits.tokens_per_minute);
+    }
+    budget.limits = limits;
+    return budget;
+}
+
+void RateLimiter::Refill(Budget& budget) {
+    const auto now = std::chrono::steady_clock::now();
+    const auto elapsed = std::chrono::duration<double>(now - budget.last_refill).count();
+    budget.requests.Refill(elapsed);
+    budget.tokens.Refill(elapsed);
+    budget.last_refill = now;
+}
+
+double RateLimiter::ClampTokens(const Budget& budget, const int64_t estimated_tokens) {
+    // A single request larger than the whole bucket could never be admitted; let it through once the bucket is full.
+    return budget.tokens.IsLimited()
+               ? std::min(static_cast<double>(std::max<int64_t>(estimated_tokens, 0)), budget.tokens.capacity)
+               : 0.0;
+}
+
+void RateLimiter::Charge(Budget& budget, const double tokens) {
+    if (budget.requests.IsLimited()) {
+        budget.requests.available -= 1;
+    }
+    if (budget.tokens.IsLimited()) {
+        budget.tokens.available -= tokens;
+    }
+}
+
+int64_t RateLimiter::Acquire(const std::string& key, const RateLimits& limits, const int64_t estimated_tokens) {
+    if (limits.IsUnlimited()) {
+        return 0;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto& budget = GetBudget(key, limits);
+    const auto tokens = ClampTokens(budget, estimated_tokens);
+    while (true) {
+        Refill(budget);
+        const auto wait_seconds = std::max(budget.requests.WaitFor(1), budget.tokens.WaitFor(tokens));
+        if (wait_seconds <= 0) {
+            break;
+        }
+        released_.wait_for(lock, std::chrono::duration<double>(wait_seconds));
+    }
+
+    Charge(budget, tokens);
+    return static_cast<int64_t>(tokens);
+}
+
+std::optional<int64_t> RateLimiter::TryAcquire(const std::string& key, const RateLimits& limits,
+                                               const int64_t estimated_tokens) {
+    if (limits.IsUnlimited()) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& budget = GetBudget(key, limits);
+    const auto tokens = ClampTokens(budget, estimated_tokens);
+    Refill(budget);
+    if (budget.requests.WaitFor(1) > 0 || budget.tokens.WaitFor(tokens) > 0) {
+        return std::nullopt;
+    }
+    Charge(budget, tokens);
+    return static_cast<int64_t>(tokens);
+}
+
+void RateLimiter::Reconcile(const std::string& key, const int64_t charged_tokens, const int64_t actual_tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = budgets_.find(key);
+    if (it == budgets_.end() || !it->second.tokens.IsLimited()) {
+        return;
+    }
+    auto& budget = it->second;
+    Refill(budget);
+    // Under-estimates leave the bucket in debt, which later callers wait out; over-estimates are handed back.
+    budget.tokens.available = std::min(budget.tokens.capacity,
+                                       budget.tokens.available + static_cast<double>(charged_tokens - actual_tokens));
+    if (charged_tokens > actual_tokens) {
+        released_.notify_all();
+    }
+}
+
+void RateLimiter::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    budgets_.clear();
+}
+
+} // namespace flockmtl
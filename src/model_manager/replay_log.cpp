@@ -0,0 +1,92 @@
+#include "flockmtl/model_manager/replay_log.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace flockmtl {
+
+std::mutex ReplayLog::logs_mutex_;
+std::unordered_map<std::string, std::shared_ptr<ReplayLog>> ReplayLog::logs_;
+
+ReplayLog::ReplayLog(std::string path) : path_(std::move(path)), fs_(duckdb::FileSystem::CreateLocal()) {
+    std::string contents;
+    try {
+        const auto handle = fs_->OpenFile(path_, duckdb::FileFlags::FILE_FLAGS_READ |
+                                                     duckdb::FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+        if (handle) {
+            contents.resize(handle->GetFileSize());
+            handle->Read(contents.data(), contents.size());
+        }
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Cannot read replay file " + path_ + ": " + e.what());
+    }
+
+    std::istringstream file(contents);
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        auto entry = nlohmann::json::parse(line, nullptr, false);
+        if (entry.is_discarded() || !entry.is_object() || !entry.contains("request") || !entry.contains("response")) {
+            throw std::runtime_error("Invalid entry on line " + std::to_string(line_number) + " of replay file " +
+                                     path_);
+        }
+        responses_[entry["request"].dump()] = std::move(entry["response"]);
+    }
+}
+
+std::shared_ptr<ReplayLog> ReplayLog::Open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(logs_mutex_);
+    auto& log = logs_[path];
+    if (!log) {
+        log = std::make_shared<ReplayLog>(path);
+    }
+    return log;
+}
+
+void ReplayLog::Reset() {
+    std::lock_guard<std::mutex> lock(logs_mutex_);
+    logs_.clear();
+}
+
+void ReplayLog::Append(const nlohmann::json& request, const nlohmann::json& response) {
+    const nlohmann::json entry = {{"request", request}, {"response", response}};
+    auto line = entry.dump() + '\n';
+    std::lock_guard<std::mutex> lock(mutex_);
+    try {
+        const auto handle = fs_->OpenFile(path_, duckdb::FileFlags::FILE_FLAGS_WRITE |
+                                                     duckdb::FileFlags::FILE_FLAGS_FILE_CREATE |
+                                                     duckdb::FileFlags::FILE_FLAGS_APPEND);
+        handle->Write(line.data(), line.size());
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Cannot write to replay file " + path_ + ": " + e.what());
+    }
+    responses_[request.dump()] = response;
+}
+
+std::optional<nlohmann::json> ReplayLog::Find(const nlohmann::json& request) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = responses_.find(request.dump());
+    if (it == responses_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+size_t ReplayLog::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return responses_.size();
+}
+
+nlohmann::json ReplayLog::CompletionRequest(const std::string& prompt, const bool json_response) {
+    return {{"type", "complete"}, {"json_response", json_response}, {"prompt", prompt}};
+}
+
+nlohmann::json ReplayLog::EmbeddingRequest(const std::vector<std::string>& inputs) {
+    return {{"type", "embedding"}, {"inputs", inputs}};
+}
+
+} // namespace flockmtl
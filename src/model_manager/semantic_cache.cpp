@@ -0,0 +1,74 @@
+#include "flockmtl/model_manager/semantic_cache.hpp"
+#include "flockmtl/vector_search/distance.hpp"
+
+namespace flockmtl {
+
+std::vector<float> SemanticCache::Normalize(const std::vector<float>& embedding) {
+    const auto norm = Distance::Norm(embedding.data(), embedding.size());
+    auto normalized = embedding;
+    if (norm > 0) {
+        for (auto& element : normalized) {
+            element /= norm;
+        }
+    }
+    return normalized;
+}
+
+std::optional<nlohmann::json> SemanticCache::Lookup(const std::string& key, const std::vector<float>& embedding,
+                                                    const double threshold) {
+    const auto query = Normalize(embedding);
+    lookups_++;
+    std::shared_lock<std::shared_mutex> guard(mutex_);
+    const auto it = entries_.find(key);
+    if (it == entries_.end() || it->second.dimensions != query.size()) {
+        return std::nullopt;
+    }
+    const auto& entries = it->second;
+    const auto dimensions = entries.dimensions;
+    size_t best = entries.responses.size();
+    auto best_similarity = threshold;
+    for (size_t entry = 0; entry < entries.responses.size(); entry++) {
+        const auto similarity = Distance::Dot(query.data(), entries.embeddings.data() + entry * dimensions, dimensions);
+        if (similarity >= best_similarity) {
+            best = entry;
+            best_similarity = similarity;
+        }
+    }
+    if (best == entries.responses.size()) {
+        return std::nullopt;
+    }
+    hits_++;
+    return entries.responses[best];
+}
+
+void SemanticCache::Insert(const std::string& key, const std::vector<float>& embedding, nlohmann::json response) {
+    const auto normalized = Normalize(embedding);
+    std::unique_lock<std::shared_mutex> guard(mutex_);
+    auto& entries = entries_[key];
+    if (entries.dimensions != normalized.size()) {
+        // Keys include the embedding model, so this only happens if the model changed its dimensions
+        size_ -= entries.responses.size();
+        entries = Entries();
+        entries.dimensions = normalized.size();
+    }
+    if (entries.responses.size() < kMaxEntriesPerKey) {
+        entries.embeddings.insert(entries.embeddings.end(), normalized.begin(), normalized.end());
+        entries.responses.push_back(std::move(response));
+        size_++;
+        return;
+    }
+    std::copy(normalized.begin(), normalized.end(), entries.embeddings.begin() + entries.next * entries.dimensions);
+    entries.responses[entries.next] = std::move(response);
+    entries.next = (entries.next + 1) % kMaxEntriesPerKey;
+}
+
+SemanticCache::Statistics SemanticCache::GetStatistics() const {
+    Statistics statistics;
+    statistics.lookups = lookups_;
+    statistics.hits = hits_;
+    std::shared_lock<std::shared_mutex> guard(mutex_);
+    statistics.entries = static_cast<int64_t>(size_);
+    return statistics;
+}
+
+} // namespace flockmtl
@@ -0,0 +1,120 @@
+#include "flockmtl/optimizer/llm_predicate_ordering.hpp"
+
+#include <algorithm>
+
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression_iterator.hpp"
+#include "duckdb/planner/operator/logical_filter.hpp"
+#include "duckdb/planner/operator/logical_projection.hpp"
+#include "flockmtl/registry/scalar.hpp"
+
+namespace flockmtl {
+
+duckdb::OptimizerExtension LlmPredicateOrdering::GetExtension() {
+    duckdb::OptimizerExtension extension;
+    extension.optimize_function = Optimize;
+    return extension;
+}
+
+void LlmPredicateOrdering::Optimize(duckdb::OptimizerExtensionInput&,
+                                    duckdb::unique_ptr<duckdb::LogicalOperator>& plan) {
+    OptimizeOperator(plan);
+}
+
+bool LlmPredicateOrdering::CallsLlm(const duckdb::Expression& expression) {
+    if (expression.GetExpressionClass() == duckdb::ExpressionClass::BOUND_FUNCTION &&
+        ScalarRegistry::GetLlmFunctionNames().count(expression.Cast<duckdb::BoundFunctionExpression>().function.name)) {
+        return true;
+    }
+    auto calls_llm = false;
+    duckdb::ExpressionIterator::EnumerateChildren(
+        expression, [&](const duckdb::Expression& child) { calls_llm = calls_llm || CallsLlm(child); });
+    return calls_llm;
+}
+
+void LlmPredicateOrdering::OrderConjuncts(duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& conjuncts) {
+    for (auto& conjunct : conjuncts) {
+        if (conjunct->GetExpressionType() == duckdb::ExpressionType::CONJUNCTION_AND) {
+            OrderConjuncts(conjunct->Cast<duckdb::BoundConjunctionExpression>().children);
+        }
+    }
+    std::stable_partition(conjuncts.begin(), conjuncts.end(),
+                          [](const duckdb::unique_ptr<duckdb::Expression>& conjunct) { return !CallsLlm(*conjunct); });
+}
+
+namespace {
+
+// Whether every column the predicate reads is computed by the projection without an LLM call.
+bool CanPushThrough(const duckdb::Expression& predicate, const duckdb::LogicalProjection& projection) {
+    if (predicate.GetExpressionClass() == duckdb::ExpressionClass::BOUND_COLUMN_REF) {
+        const auto& column = predicate.Cast<duckdb::BoundColumnRefExpression>();
+        if (column.depth > 0 || column.binding.table_index != projection.table_index) {
+            return false;
+        }
+        const auto& source = *projection.expressions[column.binding.column_index];
+        return !source.IsVolatile() && !LlmPredicateOrdering::CallsLlm(source);
+    }
+    auto can_push = !predicate.IsVolatile();
+    duckdb::ExpressionIterator::EnumerateChildren(
+        predicate, [&](const duckdb::Expression& child) { can_push = can_push && CanPushThrough(child, projection); });
+    return can_push;
+}
+
+// Replaces the references to the projection's outputs by the expressions computing them.
+void InlineProjection(duckdb::unique_ptr<duckdb::Expression>& predicate, const duckdb::LogicalProjection& projection) {
+    if (predicate->GetExpressionClass() == duckdb::ExpressionClass::BOUND_COLUMN_REF) {
+        const auto& column = predicate->Cast<duckdb::BoundColumnRefExpression>();
+        predicate = projection.expressions[column.binding.column_index]->Copy();
+        return;
+    }
+    duckdb::ExpressionIterator::EnumerateChildren(
+        *predicate, [&](duckdb::unique_ptr<duckdb::Expression>& child) { InlineProjection(child, projection); });
+}
+
+} // namespace
+
+void LlmPredicateOrdering::PushBelowProjection(duckdb::unique_ptr<duckdb::LogicalOperator>& op) {
+    auto& filter = op->Cast<duckdb::LogicalFilter>();
+    if (!filter.projection_map.empty() || filter.children[0]->type != duckdb::LogicalOperatorType::LOGICAL_PROJECTION) {
+        return;
+    }
+    auto& projection = filter.children[0]->Cast<duckdb::LogicalProjection>();
+    if (std::none_of(projection.expressions.begin(), projection.expressions.end(),
+                     [](const duckdb::unique_ptr<duckdb::Expression>& expression) { return CallsLlm(*expression); })) {
+        return;
+    }
+
+    auto pushed = duckdb::make_uniq<duckdb::LogicalFilter>();
+    for (auto it = filter.expressions.begin(); it != filter.expressions.end();) {
+        if (CallsLlm(**it) || !CanPushThrough(**it, projection)) {
+            ++it;
+            continue;
+        }
+        InlineProjection(*it, projection);
+        pushed->expressions.push_back(std::move(*it));
+        it = filter.expressions.erase(it);
+    }
+    if (pushed->expressions.empty()) {
+        return;
+    }
+    pushed->children.push_back(std::move(projection.children[0]));
+    projection.children[0] = std::move(pushed);
+    if (filter.expressions.empty()) {
+        op = std::move(op->children[0]);
+    }
+}
+
+void LlmPredicateOrdering::OptimizeOperator(duckdb::unique_ptr<duckdb::LogicalOperator>& op) {
+    for (auto& child : op->children) {
+        OptimizeOperator(child);
+    }
+    if (op->type != duckdb::LogicalOperatorType::LOGICAL_FILTER) {
+        return;
+    }
+    OrderConjuncts(op->expressions);
+    PushBelowProjection(op);
+}
+
+} // namespace flockmtl
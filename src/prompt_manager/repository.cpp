@@ -23,6 +23,8 @@ std::string RESPONSE_FORMAT::Get(const ScalarFunctionType option) {
             return RESPONSE_FORMAT::COMPLETE;
         case ScalarFunctionType::FILTER:
             return RESPONSE_FORMAT::FILTER;
+        case ScalarFunctionType::FILTER_CONFIDENCE:
+            return RESPONSE_FORMAT::FILTER_CONFIDENCE;
         default:
             return "";
     }
@@ -8,6 +8,7 @@ void AggregateRegistry::Register(duckdb::DatabaseInstance& db) {
     RegisterLlmRerank(db);
     RegisterLlmReduce(db);
     RegisterLlmReduceJson(db);
+    RegisterFlockmtlKnnAgg(db);
 }
 
 } // namespace flockmtl
@@ -5,10 +5,13 @@ namespace flockmtl {
 void Registry::Register(duckdb::DatabaseInstance& db) {
     RegisterAggregateFunctions(db);
     RegisterScalarFunctions(db);
+    RegisterTableFunctions(db);
 }
 
 void Registry::RegisterAggregateFunctions(duckdb::DatabaseInstance& db) { AggregateRegistry::Register(db); }
 
 void Registry::RegisterScalarFunctions(duckdb::DatabaseInstance& db) { ScalarRegistry::Register(db); }
 
+void Registry::RegisterTableFunctions(duckdb::DatabaseInstance& db) { TableRegistry::Register(db); }
+
 } // namespace flockmtl
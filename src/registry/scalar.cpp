@@ -12,6 +12,14 @@ void ScalarRegistry::Register(duckdb::DatabaseInstance& db) {
     RegisterFusionCombMED(db);
     RegisterFusionCombMNZ(db);
     RegisterFusionCombSUM(db);
+    RegisterFlockmtlQuantize(db);
+    RegisterFlockmtlHammingDistance(db);
+}
+
+const std::unordered_set<std::string>& ScalarRegistry::GetLlmFunctionNames() {
+    static const std::unordered_set<std::string> names = {"llm_complete", "llm_complete_json", "llm_embedding",
+                                                          "llm_filter"};
+    return names;
 }
 
 } // namespace flockmtl
@@ -0,0 +1,17 @@
+#include "flockmtl/registry/table.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::Register(duckdb::DatabaseInstance& db) {
+    RegisterLlmBulk(db);
+    RegisterFlockmtlProfile(db);
+    RegisterLlmEstimate(db);
+    RegisterFusionRRFTopN(db);
+    RegisterFusionNormalize(db);
+    RegisterFlockmtlKnn(db);
+    RegisterFlockmtlVectorIndex(db);
+    RegisterFlockmtlHybridSearch(db);
+    RegisterFlockmtlSemanticCache(db);
+}
+
+} // namespace flockmtl
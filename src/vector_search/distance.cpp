@@ -0,0 +1,82 @@
+#include "flockmtl/vector_search/distance.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace flockmtl {
+
+// Independent partial sums let the compiler vectorize the reductions without reassociating floating-point math.
+static constexpr size_t kLanes = 16;
+
+DistanceMetric Distance::ParseMetric(const std::string& metric) {
+    if (metric == "cosine") {
+        return DistanceMetric::COSINE;
+    }
+    if (metric == "l2") {
+        return DistanceMetric::L2;
+    }
+    if (metric == "dot") {
+        return DistanceMetric::DOT;
+    }
+    throw std::runtime_error("`metric` must be one of cosine, l2 or dot.");
+}
+
+FLOCKMTL_VECTOR_KERNEL
+float Distance::Dot(const float* a, const float* b, const size_t dimensions) {
+    float sums[kLanes] = {};
+    size_t i = 0;
+    for (; i + kLanes <= dimensions; i += kLanes) {
+        for (size_t lane = 0; lane < kLanes; lane++) {
+            sums[lane] += a[i + lane] * b[i + lane];
+        }
+    }
+    for (; i < dimensions; i++) {
+        sums[0] += a[i] * b[i];
+    }
+    float sum = 0;
+    for (const auto partial : sums) {
+        sum += partial;
+    }
+    return sum;
+}
+
+FLOCKMTL_VECTOR_KERNEL
+float Distance::SquaredL2(const float* a, const float* b, const size_t dimensions) {
+    float sums[kLanes] = {};
+    size_t i = 0;
+    for (; i + kLanes <= dimensions; i += kLanes) {
+        for (size_t lane = 0; lane < kLanes; lane++) {
+            const auto difference = a[i + lane] - b[i + lane];
+            sums[lane] += difference * difference;
+        }
+    }
+    for (; i < dimensions; i++) {
+        const auto difference = a[i] - b[i];
+        sums[0] += difference * difference;
+    }
+    float sum = 0;
+    for (const auto partial : sums) {
+        sum += partial;
+    }
+    return sum;
+}
+
+float Distance::Norm(const float* vector, const size_t dimensions) { return std::sqrt(Dot(vector, vector, dimensions)); }
+
+float Distance::Compute(const DistanceMetric metric, const float* query, const float query_norm, const float* vector,
+                        const size_t dimensions) {
+    switch (metric) {
+    case DistanceMetric::COSINE: {
+        const auto norms = query_norm * Norm(vector, dimensions);
+        // a zero vector is as far from everything as an orthogonal one
+        return norms > 0 ? 1 - Dot(query, vector, dimensions) / norms : 1;
+    }
+    case DistanceMetric::L2:
+        return std::sqrt(SquaredL2(query, vector, dimensions));
+    case DistanceMetric::DOT:
+        return -Dot(query, vector, dimensions);
+    }
+    return 0;
+}
+
+} // namespace flockmtl
@@ -0,0 +1,367 @@
+#include "flockmtl/vector_search/hnsw.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+
+namespace flockmtl {
+
+static constexpr char kMagic[] = "FLKHNSW3";
+static constexpr size_t kMagicSize = sizeof(kMagic) - 1;
+// Levels are drawn from a fixed seed so an index built twice from the same rows has the same shape.
+static constexpr uint64_t kLevelSeed = 42;
+
+HnswIndex::HnswIndex(const size_t dimensions, Options options) : dimensions_(dimensions), options_(options) {
+    if (dimensions_ == 0) {
+        throw std::runtime_error("Vector indexes need at least one dimension.");
+    }
+    if (options_.m < 2) {
+        throw std::runtime_error("`m` must be at least 2.");
+    }
+    if (options_.ef_construction == 0) {
+        throw std::runtime_error("`ef_construction` must be a positive integer.");
+    }
+}
+
+float HnswIndex::DistanceTo(const float* query, const float query_norm, const uint32_t node) const {
+    if (options_.metric == DistanceMetric::COSINE) {
+        // the norms of the indexed vectors are computed once, when they are added
+        const auto norms = query_norm * norms_[node];
+        return norms > 0 ? 1 - Distance::Dot(query, GetVector(node), dimensions_) / norms : 1;
+    }
+    return Distance::Compute(options_.metric, query, query_norm, GetVector(node), dimensions_);
+}
+
+template <bool BUILDING>
+HnswIndex::Links<BUILDING> HnswIndex::GetLinks(const uint32_t node, const size_t level) const {
+    if constexpr (BUILDING) {
+        std::lock_guard<std::mutex> guard(link_locks_[node]);
+        return links_[node][level];
+    } else {
+        return links_[node][level];
+    }
+}
+
+template <bool BUILDING>
+HnswIndex::Candidate HnswIndex::Descend(const float* query, const float query_norm, Candidate entry,
+                                        const int top_level, const int level) const {
+    for (auto current_level = top_level; current_level > level; current_level--) {
+        auto changed = true;
+        while (changed) {
+            changed = false;
+            for (const auto neighbour : GetLinks<BUILDING>(entry.second, current_level)) {
+                const auto distance = DistanceTo(query, query_norm, neighbour);
+                if (distance < entry.first) {
+                    entry = {distance, neighbour};
+                    changed = true;
+                }
+            }
+        }
+    }
+    return entry;
+}
+
+template <bool BUILDING>
+std::vector<HnswIndex::Candidate> HnswIndex::SearchLevel(const float* query, const float query_norm,
+                                                         const std::vector<Candidate>& entry_points, const size_t ef,
+                                                         const size_t level) const {
+    std::unordered_set<uint32_t> visited;
+    // closest candidate on top, to expand next
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>> candidates;
+    // farthest result on top, to evict next
+    std::priority_queue<Candidate> results;
+    for (const auto& entry_point : entry_points) {
+        if (visited.insert(entry_point.second).second) {
+            candidates.push(entry_point);
+            results.push(entry_point);
+        }
+    }
+    while (results.size() > ef) {
+        results.pop();
+    }
+
+    while (!candidates.empty()) {
+        const auto closest = candidates.top();
+        if (closest.first > results.top().first && results.size() >= ef) {
+            break;
+        }
+        candidates.pop();
+        for (const auto neighbour : GetLinks<BUILDING>(closest.second, level)) {
+            if (!visited.insert(neighbour).second) {
+                continue;
+            }
+            const auto distance = DistanceTo(query, query_norm, neighbour);
+            if (results.size() < ef || distance < results.top().first) {
+                candidates.emplace(distance, neighbour);
+                results.emplace(distance, neighbour);
+                if (results.size() > ef) {
+                    results.pop();
+                }
+            }
+        }
+    }
+
+    std::vector<Candidate> sorted(results.size());
+    for (auto i = sorted.size(); i > 0; i--) {
+        sorted[i - 1] = results.top();
+        results.pop();
+    }
+    return sorted;
+}
+
+std::vector<uint32_t> HnswIndex::SelectLinks(const std::vector<Candidate>& candidates, const size_t max_links) const {
+    std::vector<uint32_t> selected;
+    for (const auto& [distance, candidate] : candidates) {
+        if (selected.size() >= max_links) {
+            break;
+        }
+        auto keep = true;
+        for (const auto other : selected) {
+            if (DistanceTo(GetVector(candidate), norms_[candidate], other) < distance) {
+                keep = false;
+                break;
+            }
+        }
+        if (keep) {
+            selected.push_back(candidate);
+        }
+    }
+    return selected;
+}
+
+void HnswIndex::Insert(const uint32_t node) {
+    const int level = levels_[node];
+    std::unique_lock<std::mutex> entry_guard(entry_lock_);
+    const auto top_level = max_level_;
+    const auto entry_point = entry_point_;
+    if (top_level < 0) {
+        entry_point_ = node;
+        max_level_ = level;
+        return;
+    }
+    // A node that raises the top level becomes the new entry point, so it keeps other insertions out until linked
+    if (level <= top_level) {
+        entry_guard.unlock();
+    }
+
+    const auto query = GetVector(node);
+    const auto query_norm = norms_[node];
+    const auto entry = Descend<true>(query, query_norm, {DistanceTo(query, query_norm, entry_point), entry_point},
+                                     top_level, level);
+
+    std::vector<Candidate> entry_points = {entry};
+    for (auto current_level = std::min(level, top_level); current_level >= 0; current_level--) {
+        auto candidates = SearchLevel<true>(query, query_norm, entry_points, options_.ef_construction, current_level);
+        const auto neighbours = SelectLinks(candidates, options_.m);
+        {
+            std::lock_guard<std::mutex> guard(link_locks_[node]);
+            links_[node][current_level] = neighbours;
+        }
+        for (const auto neighbour : neighbours) {
+            std::lock_guard<std::mutex> guard(link_locks_[neighbour]);
+            auto& links = links_[neighbour][current_level];
+            links.push_back(node);
+            if (links.size() > MaxLinks(current_level)) {
+                std::vector<Candidate> linked;
+                for (const auto other : links) {
+                    linked.emplace_back(DistanceTo(GetVector(neighbour), norms_[neighbour], other), other);
+                }
+                std::sort(linked.begin(), linked.end());
+                links = SelectLinks(linked, MaxLinks(current_level));
+            }
+        }
+        entry_points = std::move(candidates);
+    }
+
+    if (level > top_level) {
+        entry_point_ = node;
+        max_level_ = level;
+    }
+}
+
+void HnswIndex::Build(std::vector<float> vectors, std::vector<int64_t> ids, const size_t num_threads) {
+    if (!ids_.empty()) {
+        throw std::runtime_error("The vector index is already built.");
+    }
+    if (vectors.size() != ids.size() * dimensions_) {
+        throw std::runtime_error("Expected " + std::to_string(dimensions_) + " dimensions per vector.");
+    }
+    if (ids.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Vector indexes hold at most 2^32 - 1 vectors.");
+    }
+    vectors_ = std::move(vectors);
+    ids_ = std::move(ids);
+    const auto size = ids_.size();
+
+    norms_.resize(size);
+    levels_.resize(size);
+    links_.resize(size);
+    link_locks_ = std::make_unique<std::mutex[]>(size);
+    std::mt19937_64 generator(kLevelSeed);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    const auto level_multiplier = 1 / std::log(static_cast<double>(options_.m));
+    for (size_t node = 0; node < size; node++) {
+        norms_[node] = Distance::Norm(GetVector(node), dimensions_);
+        const auto level = std::floor(-std::log(1 - uniform(generator)) * level_multiplier);
+        levels_[node] = static_cast<uint8_t>(std::min(level, 255.0));
+        links_[node].resize(levels_[node] + 1);
+    }
+
+    std::atomic<size_t> next_node(0);
+    const auto insert_nodes = [&]() {
+        for (auto node = next_node++; node < size; node = next_node++) {
+            Insert(static_cast<uint32_t>(node));
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < num_threads; i++) {
+        threads.emplace_back(insert_nodes);
+    }
+    insert_nodes();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    link_locks_.reset();
+}
+
+std::vector<TopK<int64_t>::Entry> HnswIndex::Search(const float* query, const size_t k, const size_t ef_search) const {
+    if (ids_.empty() || k == 0) {
+        return {};
+    }
+    const auto query_norm = Distance::Norm(query, dimensions_);
+    const auto entry = Descend<false>(query, query_norm, {DistanceTo(query, query_norm, entry_point_), entry_point_},
+                                      max_level_, 0);
+    const auto candidates = SearchLevel<false>(query, query_norm, {entry}, std::max(ef_search, k), 0);
+
+    std::vector<TopK<int64_t>::Entry> neighbours;
+    for (size_t i = 0; i < std::min(k, candidates.size()); i++) {
+        neighbours.push_back({candidates[i].first, ids_[candidates[i].second]});
+    }
+    return neighbours;
+}
+
+template <class T>
+static void Write(std::string& data, const T value) {
+    data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+static T Read(const std::string& data, size_t& offset) {
+    if (offset + sizeof(T) > data.size()) {
+        throw std::runtime_error("The vector index is corrupted.");
+    }
+    T value;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+}
+
+std::string HnswIndex::Serialize() const {
+    std::string data(kMagic, kMagicSize);
+    Write<uint64_t>(data, dimensions_);
+    Write<uint64_t>(data, options_.m);
+    Write<uint64_t>(data, options_.ef_construction);
+    Write<uint8_t>(data, static_cast<uint8_t>(options_.metric));
+    Write<uint64_t>(data, ids_.size());
+    Write<int32_t>(data, max_level_);
+    Write<uint32_t>(data, entry_point_);
+    for (size_t node = 0; node < ids_.size(); node++) {
+        Write<int64_t>(data, ids_[node]);
+        Write<uint8_t>(data, levels_[node]);
+        for (const auto& links : links_[node]) {
+            Write<uint32_t>(data, static_cast<uint32_t>(links.size()));
+            data.append(reinterpret_cast<const char*>(links.data()), links.size() * sizeof(uint32_t));
+        }
+    }
+    data.append(reinterpret_cast<const char*>(vectors_.data()), vectors_.size() * sizeof(float));
+    return data;
+}
+
+std::unique_ptr<HnswIndex> HnswIndex::Deserialize(const std::string& data) {
+    if (data.compare(0, kMagicSize, kMagic) != 0) {
+        throw std::runtime_error("The vector index is corrupted.");
+    }
+    size_t offset = kMagicSize;
+    const auto dimensions = Read<uint64_t>(data, offset);
+    Options options;
+    options.m = Read<uint64_t>(data, offset);
+    options.ef_construction = Read<uint64_t>(data, offset);
+    const auto metric = Read<uint8_t>(data, offset);
+    if (metric > static_cast<uint8_t>(DistanceMetric::DOT)) {
+        throw std::runtime_error("The vector index is corrupted.");
+    }
+    options.metric = static_cast<DistanceMetric>(metric);
+    auto index = std::make_unique<HnswIndex>(dimensions, options);
+
+    const auto size = Read<uint64_t>(data, offset);
+    // every node takes more than a byte, so this bounds the allocations below
+    if (size > data.size()) {
+        throw std::runtime_error("The vector index is corrupted.");
+    }
+    index->max_level_ = Read<int32_t>(data, offset);
+    index->entry_point_ = Read<uint32_t>(data, offset);
+    if (size > 0 && index->entry_point_ >= size) {
+        throw std::runtime_error("The vector index is corrupted.");
+    }
+    index->ids_.resize(size);
+    index->levels_.resize(size);
+    index->links_.resize(size);
+    for (size_t node = 0; node < size; node++) {
+        index->ids_[node] = Read<int64_t>(data, offset);
+        index->levels_[node] = Read<uint8_t>(data, offset);
+        index->links_[node].resize(index->levels_[node] + 1);
+        for (auto& links : index->links_[node]) {
+            const auto count = Read<uint32_t>(data, offset);
+            if (count > (data.size() - offset) / sizeof(uint32_t)) {
+                throw std::runtime_error("The vector index is corrupted.");
+            }
+            links.resize(count);
+            for (auto& link : links) {
+                link = Read<uint32_t>(data, offset);
+                if (link >= size) {
+                    throw std::runtime_error("The vector index is corrupted.");
+                }
+            }
+        }
+    }
+
+    const auto vector_bytes = data.size() - offset;
+    if (vector_bytes % (dimensions * sizeof(float)) != 0 || vector_bytes / (dimensions * sizeof(float)) != size) {
+        throw std::runtime_error("The vector index is corrupted.");
+    }
+    index->vectors_.resize(size * dimensions);
+    std::memcpy(index->vectors_.data(), data.data() + offset, data.size() - offset);
+    // Searches walk down from the entry point on the top level and only follow links to nodes that exist on the level
+    // of the link.
+    if (size > 0 && index->levels_[index->entry_point_] != index->max_level_) {
+        throw std::runtime_error("The vector index is corrupted.");
+    }
+    for (size_t node = 0; node < size; node++) {
+        if (index->levels_[node] > index->max_level_) {
+            throw std::runtime_error("The vector index is corrupted.");
+        }
+        for (size_t level = 0; level < index->links_[node].size(); level++) {
+            for (const auto link : index->links_[node][level]) {
+                if (index->levels_[link] < level) {
+                    throw std::runtime_error("The vector index is corrupted.");
+                }
+            }
+        }
+    }
+
+    index->norms_.resize(size);
+    for (size_t node = 0; node < size; node++) {
+        index->norms_[node] = Distance::Norm(index->GetVector(node), dimensions);
+    }
+    return index;
+}
+
+} // namespace flockmtl
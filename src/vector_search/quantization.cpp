@@ -0,0 +1,154 @@
+#include "flockmtl/vector_search/quantization.hpp"
+
+#include <bitset>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define FLOCKMTL_POPCOUNT_KERNEL __attribute__((target_clones("popcnt", "default")))
+#else
+#define FLOCKMTL_POPCOUNT_KERNEL
+#endif
+
+namespace flockmtl {
+
+// Independent partial sums let the compiler vectorize the reductions.
+static constexpr size_t kLanes = 32;
+
+static uint64_t PopCount(const uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    return std::bitset<64>(word).count();
+#endif
+}
+
+std::string Quantization::QuantizeInt8(const float* vector, const size_t dimensions) {
+    float max_magnitude = 0;
+    for (size_t i = 0; i < dimensions; i++) {
+        max_magnitude = std::max(max_magnitude, std::fabs(vector[i]));
+    }
+    const float scale = max_magnitude > 0 ? max_magnitude / 127 : 1;
+
+    std::string encoded(kInt8HeaderSize + dimensions, '\0');
+    encoded[0] = static_cast<char>(Encoding::INT8);
+    std::memcpy(&encoded[1], &scale, sizeof(float));
+    for (size_t i = 0; i < dimensions; i++) {
+        encoded[kInt8HeaderSize + i] = static_cast<char>(static_cast<int8_t>(std::lround(vector[i] / scale)));
+    }
+    return encoded;
+}
+
+std::string Quantization::QuantizeBinary(const float* vector, const size_t dimensions) {
+    std::string encoded(1 + (dimensions + 7) / 8, '\0');
+    encoded[0] = static_cast<char>(Encoding::BINARY);
+    for (size_t i = 0; i < dimensions; i++) {
+        if (vector[i] > 0) {
+            encoded[1 + i / 8] = static_cast<char>(static_cast<uint8_t>(encoded[1 + i / 8]) | (1u << (i % 8)));
+        }
+    }
+    return encoded;
+}
+
+Quantization::Encoding Quantization::GetEncoding(const char* data, const size_t size) {
+    if (size > 0 && static_cast<uint8_t>(data[0]) == static_cast<uint8_t>(Encoding::INT8) && size > kInt8HeaderSize) {
+        return Encoding::INT8;
+    }
+    if (size > 1 && static_cast<uint8_t>(data[0]) == static_cast<uint8_t>(Encoding::BINARY)) {
+        return Encoding::BINARY;
+    }
+    throw std::runtime_error("Expected an embedding quantized by flockmtl_quantize_int8 or flockmtl_quantize_binary.");
+}
+
+FLOCKMTL_VECTOR_KERNEL
+int32_t Quantization::Int8Dot(const int8_t* a, const int8_t* b, const size_t dimensions) {
+    int32_t sums[kLanes] = {};
+    size_t i = 0;
+    for (; i + kLanes <= dimensions; i += kLanes) {
+        for (size_t lane = 0; lane < kLanes; lane++) {
+            sums[lane] += static_cast<int16_t>(a[i + lane]) * static_cast<int16_t>(b[i + lane]);
+        }
+    }
+    for (; i < dimensions; i++) {
+        sums[0] += static_cast<int16_t>(a[i]) * static_cast<int16_t>(b[i]);
+    }
+    int32_t sum = 0;
+    for (const auto partial : sums) {
+        sum += partial;
+    }
+    return sum;
+}
+
+FLOCKMTL_POPCOUNT_KERNEL
+uint64_t Quantization::Hamming(const uint8_t* a, const uint8_t* b, const size_t bytes) {
+    uint64_t distance = 0;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t)) {
+        uint64_t word_a;
+        uint64_t word_b;
+        std::memcpy(&word_a, a + i, sizeof(uint64_t));
+        std::memcpy(&word_b, b + i, sizeof(uint64_t));
+        distance += PopCount(word_a ^ word_b);
+    }
+    for (; i < bytes; i++) {
+        distance += PopCount(static_cast<uint64_t>(a[i] ^ b[i]));
+    }
+    return distance;
+}
+
+int32_t Quantization::Int8SquaredNorm(const std::string& vector) {
+    if (GetEncoding(vector.data(), vector.size()) != Encoding::INT8) {
+        throw std::runtime_error("Expected an embedding quantized by flockmtl_quantize_int8.");
+    }
+    const auto values = reinterpret_cast<const int8_t*>(vector.data()) + kInt8HeaderSize;
+    return Int8Dot(values, values, vector.size() - kInt8HeaderSize);
+}
+
+float Quantization::Compute(const DistanceMetric metric, const std::string& query, const char* vector,
+                            const size_t size) {
+    const auto query_squared_norm =
+        GetEncoding(query.data(), query.size()) == Encoding::INT8 ? Int8SquaredNorm(query) : 0;
+    return Compute(metric, query, query_squared_norm, vector, size);
+}
+
+float Quantization::Compute(const DistanceMetric metric, const std::string& query, const int32_t query_squared_norm,
+                            const char* vector, const size_t size) {
+    const auto encoding = GetEncoding(vector, size);
+    if (query.size() != size || GetEncoding(query.data(), query.size()) != encoding) {
+        throw std::runtime_error("The quantized embedding does not have the encoding and dimensions of the query.");
+    }
+    if (encoding == Encoding::BINARY) {
+        return static_cast<float>(Hamming(reinterpret_cast<const uint8_t*>(query.data()) + 1,
+                                          reinterpret_cast<const uint8_t*>(vector) + 1, size - 1));
+    }
+
+    float query_scale;
+    float vector_scale;
+    std::memcpy(&query_scale, query.data() + 1, sizeof(float));
+    std::memcpy(&vector_scale, vector + 1, sizeof(float));
+    const auto query_values = reinterpret_cast<const int8_t*>(query.data()) + kInt8HeaderSize;
+    const auto vector_values = reinterpret_cast<const int8_t*>(vector) + kInt8HeaderSize;
+    const auto dimensions = size - kInt8HeaderSize;
+
+    const auto dot = static_cast<float>(Int8Dot(query_values, vector_values, dimensions));
+    switch (metric) {
+    case DistanceMetric::COSINE: {
+        // the scales cancel out
+        const auto norms = std::sqrt(static_cast<float>(query_squared_norm) *
+                                     static_cast<float>(Int8Dot(vector_values, vector_values, dimensions)));
+        return norms > 0 ? 1 - dot / norms : 1;
+    }
+    case DistanceMetric::L2: {
+        const auto query_norm = query_scale * query_scale * static_cast<float>(query_squared_norm);
+        const auto vector_norm = vector_scale * vector_scale *
+                                 static_cast<float>(Int8Dot(vector_values, vector_values, dimensions));
+        return std::sqrt(std::max(0.0f, query_norm + vector_norm - 2 * query_scale * vector_scale * dot));
+    }
+    case DistanceMetric::DOT:
+        return -query_scale * vector_scale * dot;
+    }
+    return 0;
+}
+
+} // namespace flockmtl
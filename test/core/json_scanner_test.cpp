@@ -0,0 +1,38 @@
+#include "flockmtl/core/json_scanner.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace flockmtl;
+
+TEST(JsonScannerTest, GetMemberSkipsNestedValues) {
+    const std::string json = R"({"a": {"x": [1, 2, {"y": "}"}]}, "b" : "value", "c": null})";
+    EXPECT_EQ(JsonScanner::GetString(*JsonScanner::GetMember(json, "b")), "value");
+    EXPECT_TRUE(JsonScanner::IsNull(*JsonScanner::GetMember(json, "c")));
+    EXPECT_EQ(*JsonScanner::GetMember(json, "a"), R"({"x": [1, 2, {"y": "}"}]})");
+    EXPECT_FALSE(JsonScanner::GetMember(json, "missing").has_value());
+}
+
+TEST(JsonScannerTest, ForEachElement) {
+    const std::string json = R"([1.5, -2e3, "s", [3], {}])";
+    std::vector<std::string> elements;
+    const auto count = JsonScanner::ForEachElement(json, [&](std::string_view value) { elements.emplace_back(value); });
+    ASSERT_EQ(count, 5);
+    EXPECT_EQ(JsonScanner::GetDouble(elements[0]), 1.5);
+    EXPECT_EQ(JsonScanner::GetDouble(elements[1]), -2000.0);
+    EXPECT_EQ(elements[3], "[3]");
+    EXPECT_EQ(*JsonScanner::GetElement(json, 2), "\"s\"");
+    EXPECT_FALSE(JsonScanner::GetElement(json, 5).has_value());
+    EXPECT_EQ(JsonScanner::ForEachElement("[ ]", [](std::string_view) {}), 0);
+}
+
+TEST(JsonScannerTest, GetStringDecodesEscapes) {
+    EXPECT_EQ(JsonScanner::GetString(R"("a\"b\\c\nd")"), "a\"b\\c\nd");
+    EXPECT_EQ(JsonScanner::GetString(R"("\u00e9")"), "\xC3\xA9");
+    EXPECT_EQ(JsonScanner::GetString(R"("\ud83d\ude00")"), "\xF0\x9F\x98\x80");
+    EXPECT_THROW(JsonScanner::GetString("42"), std::runtime_error);
+}
+
+TEST(JsonScannerTest, MalformedInputThrows) {
+    EXPECT_THROW(JsonScanner::GetMember(R"({"a": "unterminated)", "a"), std::runtime_error);
+    EXPECT_THROW(JsonScanner::GetMember("[1, 2]", "a"), std::runtime_error);
+}
@@ -59,6 +59,53 @@ TEST(ModelParserTest, ParseInvalidCreateModel) {
     EXPECT_THROW(parser.Parse("CREATE MODEL ('test_model', 'model_data')", statement), std::runtime_error);
 }
 
+TEST(ModelParserTest, ParseCreateModelWithRateLimits) {
+    std::unique_ptr<QueryStatement> statement;
+    ModelParser parser;
+    EXPECT_NO_THROW(parser.Parse("CREATE MODEL ('test_model', 'model_data', 'provider', {\"context_window\": 512, \"max_output_tokens\": 128, \"requests_per_minute\": 500, \"tokens_per_minute\": 30000})", statement));
+    auto create_stmt = dynamic_cast<CreateModelStatement*>(statement.get());
+    ASSERT_NE(create_stmt, nullptr);
+    EXPECT_EQ(create_stmt->model_args["requests_per_minute"], 500);
+    EXPECT_EQ(create_stmt->model_args["tokens_per_minute"], 30000);
+    EXPECT_THROW(parser.Parse("CREATE MODEL ('test_model', 'model_data', 'provider', {\"context_window\": 512, \"max_output_tokens\": 128, \"unknown\": 1})", statement), std::runtime_error);
+    EXPECT_THROW(parser.Parse("CREATE MODEL ('test_model', 'model_data', 'provider', {\"context_window\": 512, \"requests_per_minute\": 500})", statement), std::runtime_error);
+}
+
+TEST(ModelParserTest, ParseCreateModelWithBackends) {
+    std::unique_ptr<QueryStatement> statement;
+    ModelParser parser;
+    EXPECT_NO_THROW(parser.Parse("CREATE MODEL ('gpt_pool', 'gpt-4o', 'pool', {\"context_window\": 128000, \"max_output_tokens\": 8000, \"backends\": [{\"model_name\": \"gpt-4o-east\", \"weight\": 2}, {\"model_name\": \"gpt-4o\", \"secret_name\": \"west\"}]})", statement));
+    auto create_stmt = dynamic_cast<CreateModelStatement*>(statement.get());
+    ASSERT_NE(create_stmt, nullptr);
+    EXPECT_EQ(create_stmt->model_args["backends"].size(), 2);
+    EXPECT_THROW(parser.Parse("CREATE MODEL ('gpt_pool', 'gpt-4o', 'pool', {\"context_window\": 128000, \"max_output_tokens\": 8000, \"backends\": []})", statement), std::runtime_error);
+    EXPECT_THROW(parser.Parse("CREATE MODEL ('gpt_pool', 'gpt-4o', 'pool', {\"context_window\": 128000, \"max_output_tokens\": 8000, \"backends\": [{\"weight\": 2}]})", statement), std::runtime_error);
+    EXPECT_THROW(parser.Parse("CREATE MODEL ('gpt_pool', 'gpt-4o', 'pool', {\"context_window\": 128000, \"max_output_tokens\": 8000, \"backends\": [{\"model_name\": \"a\", \"weight\": 0}]})", statement), std::runtime_error);
+}
+
+TEST(ModelParserTest, ParseCreateReplayModel) {
+    std::unique_ptr<QueryStatement> statement;
+    ModelParser parser;
+    EXPECT_NO_THROW(parser.Parse("CREATE MODEL ('gpt_replay', 'gpt-4o', 'replay', {\"context_window\": 128000, \"max_output_tokens\": 8000, \"replay_file\": \"calls.jsonl\", \"replay_mode\": \"record\", \"backend\": {\"model_name\": \"gpt-4o\"}, \"latency_ms\": 800, \"jitter_ms\": 200})", statement));
+    auto create_stmt = dynamic_cast<CreateModelStatement*>(statement.get());
+    ASSERT_NE(create_stmt, nullptr);
+    EXPECT_EQ(create_stmt->model_args["latency_ms"], 800);
+    EXPECT_THROW(parser.Parse("CREATE MODEL ('gpt_replay', 'gpt-4o', 'replay', {\"context_window\": 128000, \"max_output_tokens\": 8000, \"replay_file\": \"calls.jsonl\", \"replay_mode\": \"live\"})", statement), std::runtime_error);
+    EXPECT_THROW(parser.Parse("CREATE MODEL ('gpt_replay', 'gpt-4o', 'replay', {\"context_window\": 128000, \"max_output_tokens\": 8000, \"replay_file\": \"calls.jsonl\", \"jitter_ms\": -1})", statement), std::runtime_error);
+    EXPECT_THROW(parser.Parse("CREATE MODEL ('gpt_replay', 'gpt-4o', 'replay', {\"context_window\": 128000, \"max_output_tokens\": 8000, \"replay_file\": \"calls.jsonl\", \"backend\": \"gpt-4o\"})", statement), std::runtime_error);
+}
+
+TEST(ModelParserTest, ParseCreateModelWithPrices) {
+    std::unique_ptr<QueryStatement> statement;
+    ModelParser parser;
+    EXPECT_NO_THROW(parser.Parse("CREATE MODEL ('gpt_priced', 'gpt-4o', 'openai', {\"context_window\": 128000, \"max_output_tokens\": 8000, \"input_price\": 2.5, \"output_price\": 10})", statement));
+    auto create_stmt = dynamic_cast<CreateModelStatement*>(statement.get());
+    ASSERT_NE(create_stmt, nullptr);
+    EXPECT_EQ(create_stmt->model_args["input_price"], 2.5);
+    EXPECT_THROW(parser.Parse("CREATE MODEL ('gpt_priced', 'gpt-4o', 'openai', {\"context_window\": 128000, \"max_output_tokens\": 8000, \"output_price\": -1})", statement), std::runtime_error);
+    EXPECT_THROW(parser.Parse("CREATE MODEL ('gpt_priced', 'gpt-4o', 'openai', {\"context_window\": 128000, \"max_output_tokens\": 8000, \"input_price\": \"cheap\"})", statement), std::runtime_error);
+}
+
 /**************************************************
  *                 Delete Model                  *
  **************************************************/
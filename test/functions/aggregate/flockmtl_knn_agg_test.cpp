@@ -0,0 +1,34 @@
+#include "flockmtl_extension.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+TEST(FlockmtlKnnAgg, FindsNeighboursPerGroupAcrossThreads) {
+    const auto previous_db = Config::db;
+    {
+        duckdb::DuckDB db(nullptr);
+        db.LoadExtension<duckdb::FlockmtlExtension>();
+        duckdb::Connection con(db);
+        con.Query("SET threads = 4");
+        // Three row groups, so the partial neighbour lists of several threads are combined.
+        con.Query("CREATE TABLE documents AS SELECT i AS id, i % 3 AS category, [i::FLOAT, 0] AS embedding "
+                  "FROM range(250000) t(i)");
+
+        const auto result = con.Query("SELECT category, list_transform(flockmtl_knn_agg(id, embedding, [0, 0], 2, "
+                                      "'l2'), neighbour -> neighbour.id) FROM documents GROUP BY category "
+                                      "ORDER BY category");
+        ASSERT_FALSE(result->HasError()) << result->GetError();
+        ASSERT_EQ(result->RowCount(), 3);
+        EXPECT_EQ(result->GetValue(1, 0).ToString(), "[0, 3]");
+        EXPECT_EQ(result->GetValue(1, 1).ToString(), "[1, 4]");
+        EXPECT_EQ(result->GetValue(1, 2).ToString(), "[2, 5]");
+
+        const auto distances = con.Query("SELECT flockmtl_knn_agg(id, embedding, [10, 0], 1, 'l2')[1].distance, "
+                                         "flockmtl_knn_agg(id, embedding, [1, 0], 1, 'cosine')[1].distance "
+                                         "FROM documents WHERE id < 20");
+        ASSERT_FALSE(distances->HasError()) << distances->GetError();
+        EXPECT_NEAR(distances->GetValue(0, 0).GetValue<double>(), 0, 1e-6);
+        EXPECT_NEAR(distances->GetValue(1, 0).GetValue<double>(), 0, 1e-6);
+    }
+    Config::db = previous_db;
+}
@@ -0,0 +1,47 @@
+#include "flockmtl/functions/batch_size_controller.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+class BatchSizeControllerTest : public ::testing::Test {
+protected:
+    void SetUp() override { BatchSizeController::Reset(); }
+};
+
+TEST_F(BatchSizeControllerTest, UnobservedKeyUsesUpperBound) {
+    EXPECT_EQ(BatchSizeController::GetBatchSize("model\nprompt", 1000, 250), 250);
+}
+
+TEST_F(BatchSizeControllerTest, GrowsGraduallyTowardsOutputBudget) {
+    const std::string key = "model\nprompt";
+    // 10 output tokens per tuple with a 1000 token budget settles at 80 tuples (headroom included).
+    BatchSizeController::RecordSuccess(key, 10, 100, std::chrono::milliseconds(100));
+    EXPECT_EQ(BatchSizeController::GetBatchSize(key, 1000, 10000), 15);
+    auto batch_size = 15;
+    for (auto i = 0; i < 10; i++) {
+        BatchSizeController::RecordSuccess(key, batch_size, batch_size * 10, std::chrono::milliseconds(100));
+        const auto next = BatchSizeController::GetBatchSize(key, 1000, 10000);
+        EXPECT_LE(next, static_cast<int>(batch_size * BatchSizeController::kMaxGrowth) + 1);
+        batch_size = next;
+    }
+    EXPECT_EQ(batch_size, 80);
+}
+
+TEST_F(BatchSizeControllerTest, OverflowHalvesUntilSuccess) {
+    const std::string key = "model\nprompt";
+    BatchSizeController::RecordOverflow(key, 100, 1000);
+    EXPECT_EQ(BatchSizeController::GetBatchSize(key, 1000, 10000), 50);
+    BatchSizeController::RecordOverflow(key, 50, 1000);
+    EXPECT_EQ(BatchSizeController::GetBatchSize(key, 1000, 10000), 25);
+    BatchSizeController::RecordSuccess(key, 25, 900, std::chrono::milliseconds(100));
+    const auto next = BatchSizeController::GetBatchSize(key, 1000, 10000);
+    EXPECT_GE(next, 12);
+    EXPECT_LE(next, 27);
+}
+
+TEST_F(BatchSizeControllerTest, LatencyCapsBatchSize) {
+    const std::string key = "model\nprompt";
+    // One second per tuple caps batches at kTargetLatencyMs / 1000 tuples.
+    BatchSizeController::RecordSuccess(key, 100, 100, std::chrono::milliseconds(100000));
+    EXPECT_EQ(BatchSizeController::GetBatchSize(key, 100000, 10000), 60);
+}
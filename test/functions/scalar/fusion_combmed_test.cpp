@@ -201,4 +201,35 @@ TEST(FusionCombMED, WithOnlyNullNaNValues) {
     for (size_t i = 0; i < 5; ++i) {
         ASSERT_EQ(result[i], 0.0);
     }
-}
\ No newline at end of file
+}
+TEST(FusionCombMED, WithManyColumns) {
+    // More retrievers than the insertion sort handles, with an odd (11) and an even (12) number of columns
+    for (const size_t num_columns : {11, 12}) {
+        const duckdb::vector<duckdb::LogicalType> types(num_columns, duckdb::LogicalType::DOUBLE);
+
+        duckdb::DataChunk chunk;
+        auto& allocator = duckdb::Allocator::DefaultAllocator();
+        chunk.Initialize(allocator, types, 2);
+        chunk.SetCardinality(2);
+
+        // The first entry's scores are 0.1, 0.2, ... in reverse order, the second entry's are all NULL but one
+        for (size_t i = 0; i < num_columns; ++i) {
+            chunk.SetValue(i, 0, static_cast<double>(num_columns - i) / 10);
+            chunk.SetValue(i, 1, i == 0 ? duckdb::Value(1.0) : duckdb::Value());
+        }
+
+        const std::vector<double> result = flockmtl::FusionCombMED::Operation(chunk);
+
+        ASSERT_EQ(result.size(), 2);
+        const double expected = num_columns % 2 == 0 ? (0.6 + 0.7) / 2 : 0.6;
+        ASSERT_DOUBLE_EQ(result[0], expected);
+        ASSERT_EQ(result[1], 0.0);
+    }
+}
+
+TEST(FusionCombMED, CalculateMedianReordersInPlace) {
+    std::vector<double> scores = {0.9, 0.1, 0.5, 0.3, 0.7, 0.2, 0.8, 0.4, 0.6, 0.0};
+    ASSERT_DOUBLE_EQ(flockmtl::FusionCombMED::calculateMedian(scores.data(), scores.size()), (0.4 + 0.5) / 2);
+    ASSERT_EQ(flockmtl::FusionCombMED::calculateMedian(scores.data(), 0), 0.0);
+    ASSERT_EQ(flockmtl::FusionCombMED::calculateMedian(scores.data(), 1), scores[0]);
+}
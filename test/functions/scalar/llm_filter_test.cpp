@@ -0,0 +1,197 @@
+#include "../../mock_server/mock_server.hpp"
+#include "flockmtl/functions/scalar/llm_filter.hpp"
+#include "flockmtl_extension.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+TEST(LlmFilter, GetsCascadeFromModelDetails) {
+    EXPECT_FALSE(LlmFilter::GetCascade({{"model_name", "gpt-4o-mini"}}).has_value());
+
+    const auto cascade = LlmFilter::GetCascade(
+            {{"model_name", "gpt-4o-mini"}, {"secret_name", "team"}, {"batch_size", 5}, {"cascade_model", "gpt-4o"}});
+    ASSERT_TRUE(cascade.has_value());
+    // The cascade model shares the settings of the first one.
+    EXPECT_EQ(cascade->model_json,
+              nlohmann::json({{"model_name", "gpt-4o"}, {"secret_name", "team"}, {"batch_size", 5}}));
+    EXPECT_DOUBLE_EQ(cascade->threshold, 0.8);
+
+    const nlohmann::json own_settings = {{"model_name", "claude"}, {"secret_name", "other"}};
+    const auto tuned = LlmFilter::GetCascade(
+            {{"model_name", "gpt-4o-mini"}, {"cascade_model", own_settings}, {"cascade_threshold", "0.95"}});
+    EXPECT_EQ(tuned->model_json, own_settings);
+    EXPECT_DOUBLE_EQ(tuned->threshold, 0.95);
+    EXPECT_DOUBLE_EQ(
+            LlmFilter::GetCascade({{"model_name", "a"}, {"cascade_model", "b"}, {"cascade_threshold", 0.5}})->threshold,
+            0.5);
+
+    EXPECT_THROW(LlmFilter::GetCascade({{"model_name", "gpt-4o-mini"}, {"cascade_threshold", "0.9"}}),
+                 std::runtime_error);
+    EXPECT_THROW(LlmFilter::GetCascade({{"model_name", "gpt-4o-mini"}, {"cascade_model", 4}}), std::runtime_error);
+}
+
+TEST(LlmFilter, RejectsInvalidCascadeThresholds) {
+    for (const auto& threshold : {nlohmann::json("2"), nlohmann::json("high"), nlohmann::json("0.9x"),
+                                  nlohmann::json(""), nlohmann::json("nan"), nlohmann::json(-0.1)}) {
+        try {
+            LlmFilter::GetCascade({{"model_name", "a"}, {"cascade_model", "b"}, {"cascade_threshold", threshold}});
+            FAIL() << threshold;
+        } catch (const std::runtime_error& e) {
+            EXPECT_STREQ(e.what(), "`cascade_threshold` must be a number between 0 and 1");
+        }
+    }
+}
+
+TEST(LlmFilter, KeepsOnlyConfidentAnswers) {
+    EXPECT_EQ(LlmFilter::GetConfidentAnswer({{"answer", true}, {"confidence", 0.9}}, 0.8), true);
+    EXPECT_EQ(LlmFilter::GetConfidentAnswer({{"answer", false}, {"confidence", 0.8}}, 0.8), false);
+    EXPECT_FALSE(LlmFilter::GetConfidentAnswer({{"answer", true}, {"confidence", 0.5}}, 0.8).has_value());
+
+    // Malformed responses are escalated rather than guessed.
+    EXPECT_FALSE(LlmFilter::GetConfidentAnswer(nullptr, 0.8).has_value());
+    EXPECT_FALSE(LlmFilter::GetConfidentAnswer(true, 0.8).has_value());
+    EXPECT_FALSE(LlmFilter::GetConfidentAnswer({{"answer", true}}, 0.8).has_value());
+    EXPECT_FALSE(LlmFilter::GetConfidentAnswer({{"answer", "maybe"}, {"confidence", 0.99}}, 0.8).has_value());
+}
+
+// Answers each single-tuple prompt with the response given for the tuple it contains, and remembers the tuples asked.
+class ScriptedProvider : public IProvider {
+public:
+    explicit ScriptedProvider(std::map<std::string, nlohmann::json> responses)
+        : IProvider(GetModelDetails()), responses_(std::move(responses)) {}
+
+    nlohmann::json CallComplete(const std::string& prompt, bool) override {
+        for (const auto& [tuple, response] : responses_) {
+            if (prompt.find(tuple) != std::string::npos) {
+                std::lock_guard<std::mutex> guard(mutex_);
+                asked_.push_back(tuple);
+                return {{"tuples", {response}}};
+            }
+        }
+        throw std::runtime_error("unexpected prompt");
+    }
+
+    nlohmann::json CallEmbedding(const std::vector<std::string>&) override { return nlohmann::json::array(); }
+
+    std::vector<std::string> GetAsked() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        std::sort(asked_.begin(), asked_.end());
+        return asked_;
+    }
+
+private:
+    static ModelDetails GetModelDetails() {
+        ModelDetails model_details;
+        model_details.model_name = "scripted";
+        model_details.model = "scripted";
+        model_details.provider_name = OPENAI;
+        model_details.context_window = 128000;
+        model_details.max_output_tokens = 4000;
+        model_details.batch_size = 1;
+        return model_details;
+    }
+
+    std::map<std::string, nlohmann::json> responses_;
+    std::mutex mutex_;
+    std::vector<std::string> asked_;
+};
+
+TEST(LlmFilter, EscalatesOnlyUncertainAnswers) {
+    Profiler::Reset();
+    const int client = 0;
+    const Profiler::Scope scope(&client, 1, "llm_filter");
+
+    const auto first = std::make_shared<ScriptedProvider>(std::map<std::string, nlohmann::json> {
+            {"review-0", {{"answer", true}, {"confidence", 0.95}}},
+            {"review-1", {{"answer", false}, {"confidence", 0.3}}},
+            {"review-2", "not sure"},
+            {"review-3", {{"answer", false}, {"confidence", 0.9}}}});
+    const auto stronger = std::make_shared<ScriptedProvider>(
+            std::map<std::string, nlohmann::json> {{"review-1", true}, {"review-2", false}});
+    Model model(first);
+    Model cascade_model(stronger);
+    std::vector<nlohmann::json> tuples;
+    for (auto i = 0; i < 4; i++) {
+        tuples.push_back({{"text", "review-" + std::to_string(i)}});
+    }
+
+    const auto get_cascade_model = [&]() -> Model& { return cascade_model; };
+    const auto responses = LlmFilter::CascadeAndComplete(tuples, "Is it positive?", model, 0.8, get_cascade_model);
+    EXPECT_EQ(responses, nlohmann::json({true, true, false, false}));
+    EXPECT_EQ(stronger->GetAsked(), std::vector<std::string>({"review-1", "review-2"}));
+
+    const auto profiles = Profiler::GetProfiles(&client);
+    ASSERT_EQ(profiles.size(), 1u);
+    const auto& filter = profiles[0].call_sites.at("llm_filter");
+    EXPECT_EQ(filter.cascaded_tuples, 4);
+    EXPECT_EQ(filter.escalations, 2);
+}
+
+TEST(LlmFilter, OnlyBuildsTheCascadeModelWhenEscalating) {
+    const auto first = std::make_shared<ScriptedProvider>(
+            std::map<std::string, nlohmann::json> {{"review-0", {{"answer", true}, {"confidence", 0.99}}}});
+    Model model(first);
+    const auto responses =
+            LlmFilter::CascadeAndComplete({{{"text", "review-0"}}}, "Is it positive?", model, 0.8,
+                                          []() -> Model& { throw std::runtime_error("the cascade model was built"); });
+    EXPECT_EQ(responses, nlohmann::json({true}));
+}
+
+// Runs llm_filter end to end against the mock server, on a database of its own.
+class LlmFilterSqlTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        previous_db_ = Config::db;
+        db_ = std::make_unique<duckdb::DuckDB>(nullptr);
+        db_->LoadExtension<duckdb::FlockmtlExtension>();
+        con_ = std::make_unique<duckdb::Connection>(*db_);
+        for (const auto secret : {"filter_mock", "openai_secret"}) {
+            Run(std::string("CREATE SECRET ") + secret + " (TYPE OPENAI, API_KEY 'mock', BASE_URL '" +
+                server_.GetOpenAIUrl() + "')");
+        }
+        Run("CREATE MODEL('filter_llm', 'mock', 'openai', {\"context_window\": 16000, \"max_output_tokens\": 4000})");
+        Run("CREATE MODEL('cascade_llm', 'mock', 'openai', {\"context_window\": 16000, \"max_output_tokens\": 4000})");
+    }
+
+    void TearDown() override {
+        con_.reset();
+        db_.reset();
+        Config::db = previous_db_;
+    }
+
+    duckdb::unique_ptr<duckdb::MaterializedQueryResult> Run(const std::string& query) {
+        auto result = con_->Query(query);
+        EXPECT_FALSE(result->HasError()) << query << "\n" << result->GetError();
+        return result;
+    }
+
+    MockServer server_;
+    duckdb::DatabaseInstance* previous_db_ = nullptr;
+    std::unique_ptr<duckdb::DuckDB> db_;
+    std::unique_ptr<duckdb::Connection> con_;
+};
+
+TEST_F(LlmFilterSqlTest, EscalatesToACascadeModelWithSettingsOfItsOwn) {
+    // The first model is never confident, so every tuple goes on to the cascade model, which answers false.
+    std::atomic<int> first_prompts {0};
+    std::atomic<int> cascade_prompts {0};
+    server_.SetCompletionHandler([&](const std::string& prompt, bool) -> std::string {
+        if (prompt.find("confidence") != std::string::npos) {
+            first_prompts++;
+            return R"({"tuples": [{"answer": true, "confidence": 0.1}]})";
+        }
+        // The cascade model has no batch size of its own, so it gets the escalated tuples in one prompt
+        cascade_prompts++;
+        const auto tuples = MockServer::DefaultCompletion(prompt, true);
+        return nlohmann::json({{"tuples", std::vector<bool>(nlohmann::json::parse(tuples)["tuples"].size(), false)}})
+                .dump();
+    });
+    const auto result = Run("SELECT count(*) FILTER (WHERE answer = 'false') FROM (SELECT llm_filter("
+                            "{'model_name': 'filter_llm', 'secret_name': 'filter_mock', 'batch_size': '1', "
+                            "'cascade_model': {'model_name': 'cascade_llm', 'secret_name': 'openai_secret'}}, "
+                            "{'prompt': 'Is it positive?'}, {'text': 'Review ' || i}) AS answer FROM range(4) t(i))");
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 4);
+    EXPECT_EQ(first_prompts, 4);
+    EXPECT_EQ(cascade_prompts, 1);
+}
@@ -0,0 +1,145 @@
+#include "flockmtl/functions/table/flockmtl_hybrid_search.hpp"
+#include "flockmtl_extension.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+static constexpr double kNotRetrieved = std::numeric_limits<double>::quiet_NaN();
+
+TEST(FlockmtlHybridSearch, ParsesFusion) {
+    EXPECT_EQ(FlockmtlHybridSearch::ParseFusion("rrf"), FlockmtlHybridSearch::Fusion::RRF);
+    EXPECT_EQ(FlockmtlHybridSearch::ParseFusion("combmnz"), FlockmtlHybridSearch::Fusion::COMBMNZ);
+    EXPECT_THROW(FlockmtlHybridSearch::ParseFusion("borda"), std::runtime_error);
+}
+
+TEST(FlockmtlHybridSearch, FusesRanksWithRRF) {
+    // BM25 scores and negated distances; the second document is only found by the vector retriever.
+    const std::vector<std::vector<double>> scores = {{7.5, kNotRetrieved, 3.0}, {-0.4, -0.1, -0.2}};
+    FlockmtlHybridSearch::Options options;
+    options.k = 2;
+    const auto fused = FlockmtlHybridSearch::Fuse(scores, 3, options);
+
+    ASSERT_EQ(fused.size(), 2);
+    EXPECT_EQ(fused[0].row, 0);
+    EXPECT_DOUBLE_EQ(fused[0].score, 1.0 / 61 + 1.0 / 63);
+    EXPECT_EQ(fused[1].row, 2);
+    EXPECT_DOUBLE_EQ(fused[1].score, 1.0 / 62 + 1.0 / 62);
+}
+
+TEST(FlockmtlHybridSearch, FusesNormalizedScores) {
+    const std::vector<std::vector<double>> scores = {{10, 5, kNotRetrieved, 0}, {-0.5, kNotRetrieved, -0.1, -0.3}};
+    FlockmtlHybridSearch::Options options;
+    options.fusion = FlockmtlHybridSearch::Fusion::COMBSUM;
+    const auto fused = FlockmtlHybridSearch::Fuse(scores, 4, options);
+
+    // min-max: BM25 1, 0.5, -, 0 and similarity 0, -, 1, 0.5
+    ASSERT_EQ(fused.size(), 4);
+    EXPECT_EQ(fused[0].row, 0);
+    EXPECT_DOUBLE_EQ(fused[0].score, 1);
+    EXPECT_EQ(fused[1].row, 2);
+    EXPECT_DOUBLE_EQ(fused[1].score, 1);
+    EXPECT_EQ(fused[2].row, 1);
+    EXPECT_DOUBLE_EQ(fused[2].score, 0.5);
+    EXPECT_EQ(fused[3].row, 3);
+    EXPECT_DOUBLE_EQ(fused[3].score, 0.5);
+}
+
+// Runs flockmtl_hybrid_search end to end on a database of its own. A macro stands in for the match_bm25 macro of
+// PRAGMA create_fts_index, so the BM25 scores are known: 2 for document 1 and 1 for document 2.
+class FlockmtlHybridSearchSqlTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        previous_db_ = Config::db;
+        db_ = std::make_unique<duckdb::DuckDB>(nullptr);
+        db_->LoadExtension<duckdb::FlockmtlExtension>();
+        con_ = std::make_unique<duckdb::Connection>(*db_);
+        Run("CREATE TABLE documents (doc_id INTEGER, content VARCHAR, embedding FLOAT[])");
+        Run("INSERT INTO documents VALUES (1, 'duck', [0, 1]), (2, 'duck goose', [1, 1]), (3, 'goose', [1, 0]), "
+            "(4, 'swan', [-1, 0])");
+        Run("CREATE SCHEMA fts_main_documents");
+        Run("CREATE MACRO fts_main_documents.match_bm25(doc_id, query) AS "
+            "CASE WHEN query = 'duck' AND doc_id <= 2 THEN 3.0 - doc_id END");
+    }
+
+    void TearDown() override {
+        con_.reset();
+        db_.reset();
+        Config::db = previous_db_;
+    }
+
+    duckdb::unique_ptr<duckdb::MaterializedQueryResult> Run(const std::string& query) {
+        auto result = con_->Query(query);
+        EXPECT_FALSE(result->HasError()) << query << "\n" << result->GetError();
+        return result;
+    }
+
+    duckdb::DatabaseInstance* previous_db_ = nullptr;
+    std::unique_ptr<duckdb::DuckDB> db_;
+    std::unique_ptr<duckdb::Connection> con_;
+};
+
+TEST_F(FlockmtlHybridSearchSqlTest, FusesBM25AndVectorRetrieval) {
+    // Vector ranks are 3, 2, 1, 4, so RRF puts document 1 (1/61 + 1/63) just ahead of document 2 (2/62).
+    const auto result = Run("SELECT id, rank, bm25, distance FROM flockmtl_hybrid_search('documents', 'doc_id', "
+                            "'embedding', 'duck', [1, 0], k := 3)");
+    ASSERT_EQ(result->RowCount(), 3);
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int32_t>(), 1);
+    EXPECT_DOUBLE_EQ(result->GetValue(2, 0).GetValue<double>(), 2);
+    EXPECT_NEAR(result->GetValue(3, 0).GetValue<double>(), 1, 1e-6);
+    EXPECT_EQ(result->GetValue(0, 1).GetValue<int32_t>(), 2);
+    EXPECT_EQ(result->GetValue(1, 1).GetValue<int64_t>(), 2);
+    EXPECT_EQ(result->GetValue(0, 2).GetValue<int32_t>(), 3);
+    EXPECT_TRUE(result->GetValue(2, 2).IsNull());
+    EXPECT_NEAR(result->GetValue(3, 2).GetValue<double>(), 0, 1e-6);
+}
+
+TEST_F(FlockmtlHybridSearchSqlTest, KeepsTheBestCandidatesOfEachRetriever) {
+    const auto result = Run("SELECT id FROM flockmtl_hybrid_search('documents', 'doc_id', 'embedding', 'duck', "
+                            "[1, 0], candidates := 1)");
+    ASSERT_EQ(result->RowCount(), 2);
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int32_t>(), 1);
+    EXPECT_EQ(result->GetValue(0, 1).GetValue<int32_t>(), 3);
+}
+
+TEST_F(FlockmtlHybridSearchSqlTest, UsesTheFullTextIndexOfTheTablesCatalog) {
+    Run("ATTACH ':memory:' AS archive");
+    Run("CREATE TABLE archive.main.documents AS SELECT * FROM documents");
+    Run("CREATE SCHEMA archive.fts_main_documents");
+    Run("CREATE MACRO archive.fts_main_documents.match_bm25(doc_id, query) AS CASE WHEN doc_id = 4 THEN 1.0 END");
+    const auto result = Run("SELECT id, bm25 FROM flockmtl_hybrid_search('archive.main.documents', 'doc_id', "
+                            "'embedding', 'duck', [1, 0]) WHERE bm25 IS NOT NULL");
+    ASSERT_EQ(result->RowCount(), 1);
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int32_t>(), 4);
+}
+
+TEST_F(FlockmtlHybridSearchSqlTest, RequiresAFullTextIndex) {
+    Run("CREATE TABLE notes AS SELECT * FROM documents");
+    const auto result = con_->Query("SELECT * FROM flockmtl_hybrid_search('notes', 'doc_id', 'embedding', 'duck', "
+                                    "[1, 0])");
+    ASSERT_TRUE(result->HasError());
+    EXPECT_NE(result->GetError().find("no full-text index"), std::string::npos) << result->GetError();
+}
+
+TEST_F(FlockmtlHybridSearchSqlTest, ReadsCommittedDataOnly) {
+    const auto search = "SELECT id FROM flockmtl_hybrid_search('{}', 'doc_id', 'embedding', 'duck', [1, 0], k := 10)";
+    Run("CREATE TEMPORARY TABLE drafts AS SELECT * FROM documents");
+    auto result = con_->Query(duckdb_fmt::format(search, "drafts"));
+    ASSERT_TRUE(result->HasError());
+    EXPECT_NE(result->GetError().find("temporary"), std::string::npos) << result->GetError();
+
+    Run("BEGIN TRANSACTION");
+    Run("CREATE TABLE notes AS SELECT * FROM documents");
+    Run("CREATE SCHEMA fts_main_notes");
+    Run("CREATE MACRO fts_main_notes.match_bm25(doc_id, query) AS 1.0");
+    result = con_->Query(duckdb_fmt::format(search, "notes"));
+    ASSERT_TRUE(result->HasError());
+    EXPECT_NE(result->GetError().find("open transaction"), std::string::npos) << result->GetError();
+    Run("ROLLBACK");
+
+    // Rows of the open transaction are not retrieved
+    Run("BEGIN TRANSACTION");
+    Run("INSERT INTO documents VALUES (5, 'duck', [1, 0])");
+    EXPECT_EQ(Run(duckdb_fmt::format(search, "documents"))->RowCount(), 4);
+    Run("COMMIT");
+    EXPECT_EQ(Run(duckdb_fmt::format(search, "documents"))->RowCount(), 5);
+}
@@ -0,0 +1,57 @@
+#include "flockmtl_extension.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+// Runs flockmtl_knn end to end on a database of its own.
+class FlockmtlKnnTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        previous_db_ = Config::db;
+        db_ = std::make_unique<duckdb::DuckDB>(nullptr);
+        db_->LoadExtension<duckdb::FlockmtlExtension>();
+        con_ = std::make_unique<duckdb::Connection>(*db_);
+        Run("CREATE TABLE documents (id INTEGER, title VARCHAR, embedding FLOAT[])");
+        Run("INSERT INTO documents VALUES (1, 'east', [1, 0]), (2, 'north', [0, 1]), (3, 'north-east', [1, 1]), "
+            "(4, 'west', [-1, 0]), (5, 'broken', ['nan'::FLOAT, 0]), (6, 'missing', NULL)");
+    }
+
+    void TearDown() override {
+        con_.reset();
+        db_.reset();
+        Config::db = previous_db_;
+    }
+
+    duckdb::unique_ptr<duckdb::MaterializedQueryResult> Run(const std::string& query) {
+        auto result = con_->Query(query);
+        EXPECT_FALSE(result->HasError()) << query << "\n" << result->GetError();
+        return result;
+    }
+
+    duckdb::DatabaseInstance* previous_db_ = nullptr;
+    std::unique_ptr<duckdb::DuckDB> db_;
+    std::unique_ptr<duckdb::Connection> con_;
+};
+
+TEST_F(FlockmtlKnnTest, ReturnsClosestRowsFirst) {
+    const auto result = Run("SELECT id, title, distance FROM flockmtl_knn('documents', 'embedding', [1, 0.1], k := 2, "
+                            "metric := 'cosine')");
+    ASSERT_EQ(result->RowCount(), 2);
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int32_t>(), 1);
+    EXPECT_EQ(result->GetValue(1, 0).ToString(), "east");
+    EXPECT_EQ(result->GetValue(0, 1).GetValue<int32_t>(), 3);
+    EXPECT_LT(result->GetValue(2, 0).GetValue<double>(), result->GetValue(2, 1).GetValue<double>());
+}
+
+TEST_F(FlockmtlKnnTest, SkipsNullAndNaNEmbeddings) {
+    // A k far beyond the table returns every row that has a distance, without allocating for k of them.
+    const auto result = Run("SELECT list(id ORDER BY distance) FROM flockmtl_knn('documents', 'embedding', [1, 0], "
+                            "k := 1000000000000, metric := 'l2')");
+    EXPECT_EQ(result->GetValue(0, 0).ToString(), "[1, 3, 2, 4]");
+}
+
+TEST_F(FlockmtlKnnTest, RejectsInvalidArguments) {
+    EXPECT_TRUE(con_->Query("FROM flockmtl_knn('documents', 'embedding', [1, 0], k := 0)")->HasError());
+    EXPECT_TRUE(con_->Query("FROM flockmtl_knn('documents', 'embedding', [1, 0], metric := 'manhattan')")->HasError());
+    EXPECT_TRUE(con_->Query("FROM flockmtl_knn('documents', 'embedding', [1, 0, 0])")->HasError());
+}
@@ -0,0 +1,85 @@
+#include "flockmtl/functions/table/flockmtl_vector_index.hpp"
+#include "flockmtl_extension.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+// Runs the vector index functions end to end on a database of their own.
+class FlockmtlVectorIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        previous_db_ = Config::db;
+        db_ = std::make_unique<duckdb::DuckDB>(nullptr);
+        db_->LoadExtension<duckdb::FlockmtlExtension>();
+        con_ = std::make_unique<duckdb::Connection>(*db_);
+        Run("CREATE TABLE documents AS SELECT i AS id, [cos(i), sin(i), i % 7, 1]::FLOAT[] AS embedding "
+            "FROM range(5000) t(i)");
+    }
+
+    void TearDown() override {
+        con_.reset();
+        db_.reset();
+        Config::db = previous_db_;
+    }
+
+    duckdb::unique_ptr<duckdb::MaterializedQueryResult> Run(const std::string& query) {
+        auto result = con_->Query(query);
+        EXPECT_FALSE(result->HasError()) << query << "\n" << result->GetError();
+        return result;
+    }
+
+    duckdb::DatabaseInstance* previous_db_ = nullptr;
+    std::unique_ptr<duckdb::DuckDB> db_;
+    std::unique_ptr<duckdb::Connection> con_;
+};
+
+TEST_F(FlockmtlVectorIndexTest, StoresTheGraphInPagesAndSearchesIt) {
+    auto result = Run("SELECT * FROM flockmtl_create_vector_index('documents_index', 'documents', 'embedding', "
+                      "metric := 'l2')");
+    EXPECT_EQ(result->GetValue(1, 0).GetValue<int64_t>(), 5000);
+    EXPECT_EQ(result->GetValue(2, 0).GetValue<int64_t>(), 4);
+
+    result = Run("SELECT count(*), max(octet_length(data)) FROM "
+                 "flockmtl_config.FLOCKMTL_VECTOR_INDEX_PAGE_INTERNAL_TABLE WHERE index_name = 'documents_index'");
+    EXPECT_GT(result->GetValue(0, 0).GetValue<int64_t>(), 1);
+    EXPECT_LE(result->GetValue(1, 0).GetValue<int64_t>(), static_cast<int64_t>(FlockmtlVectorIndex::kPageSize));
+
+    result = Run("SELECT d.id, s.rank FROM flockmtl_vector_search('documents_index', [cos(42), sin(42), 0, 1], k := 1) "
+                 "s JOIN documents d ON d.rowid = s.rowid");
+    ASSERT_EQ(result->RowCount(), 1);
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), deleted);
+    EXPECT_EQ(result->GetValue(1, 0).GetValue<int64_t>(), 1);
+
+    result = Run("SELECT * FROM flockmtl_drop_vector_index('documents_index')");
+    EXPECT_TRUE(result->GetValue(0, 0).GetValue<bool>());
+    result = Run("SELECT count(*) FROM flockmtl_config.FLOCKMTL_VECTOR_INDEX_PAGE_INTERNAL_TABLE");
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 0);
+}
+
+TEST_F(FlockmtlVectorIndexTest, SearchesASnapshotOfTheTable) {
+    Run("SELECT * FROM flockmtl_create_vector_index('documents_index', 'documents', 'embedding', metric := 'l2')");
+    const auto deleted = Run("SELECT rowid FROM documents WHERE id = 42")->GetValue(0, 0).GetValue<int64_t>();
+    const auto updated = Run("SELECT rowid FROM documents WHERE id = 7")->GetValue(0, 0).GetValue<int64_t>();
+    Run("UPDATE documents SET embedding = [0, 0, 100, 1] WHERE id = 7");
+    Run("DELETE FROM documents WHERE id = 42");
+
+    // The index keeps the vectors it was built from
+    const auto search = "SELECT rowid FROM flockmtl_vector_search('documents_index', [cos(42), sin(42), 0, 1], k := 1)";
+    auto result = Run(search);
+    ASSERT_EQ(result->RowCount(), 1);
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 42);
+    result = Run("SELECT rowid FROM flockmtl_vector_search('documents_index', [0, 0, 100, 1], k := 1)");
+    ASSERT_EQ(result->RowCount(), 1);
+    EXPECT_NE(result->GetValue(0, 0).GetValue<int64_t>(), updated);
+
+    Run("SELECT * FROM flockmtl_drop_vector_index('documents_index')");
+    EXPECT_TRUE(con_->Query(search)->HasError());
+    Run("SELECT * FROM flockmtl_create_vector_index('documents_index', 'documents', 'embedding', metric := 'l2')");
+    result = Run("SELECT rowid FROM flockmtl_vector_search('documents_index', [0, 0, 100, 1], k := 1)");
+    ASSERT_EQ(result->RowCount(), 1);
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), updated);
+    EXPECT_EQ(Run("SELECT * FROM flockmtl_create_vector_index('documents_index2', 'documents', 'embedding')")
+                  ->GetValue(1, 0)
+                  .GetValue<int64_t>(),
+              4999);
+}
@@ -0,0 +1,97 @@
+#include "flockmtl/functions/table/fusion_normalize.hpp"
+#include "flockmtl_extension.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+static FusionNormalize::ScoreStatistics GetStatistics(const std::vector<double>& scores) {
+    FusionNormalize::ScoreStatistics statistics;
+    for (const auto score : scores) {
+        statistics.Update(score);
+    }
+    return statistics;
+}
+
+TEST(FusionNormalize, ParseMode) {
+    EXPECT_EQ(FusionNormalize::ParseMode("minmax"), FusionNormalize::Mode::MIN_MAX);
+    EXPECT_EQ(FusionNormalize::ParseMode("zscore"), FusionNormalize::Mode::Z_SCORE);
+    EXPECT_EQ(FusionNormalize::ParseMode("rank"), FusionNormalize::Mode::RANK);
+    EXPECT_THROW(FusionNormalize::ParseMode("softmax"), std::runtime_error);
+}
+
+TEST(FusionNormalize, MinMax) {
+    const auto statistics = GetStatistics({4.0, 12.0, 6.0});
+    EXPECT_DOUBLE_EQ(statistics.Normalize(4.0, FusionNormalize::Mode::MIN_MAX), 0.0);
+    EXPECT_DOUBLE_EQ(statistics.Normalize(6.0, FusionNormalize::Mode::MIN_MAX), 0.25);
+    EXPECT_DOUBLE_EQ(statistics.Normalize(12.0, FusionNormalize::Mode::MIN_MAX), 1.0);
+}
+
+TEST(FusionNormalize, ZScore) {
+    // Mean 5 and population standard deviation 2
+    const auto statistics = GetStatistics({2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0});
+    EXPECT_DOUBLE_EQ(statistics.Normalize(5.0, FusionNormalize::Mode::Z_SCORE), 0.0);
+    EXPECT_DOUBLE_EQ(statistics.Normalize(9.0, FusionNormalize::Mode::Z_SCORE), 2.0);
+    EXPECT_DOUBLE_EQ(statistics.Normalize(2.0, FusionNormalize::Mode::Z_SCORE), -1.5);
+}
+
+TEST(FusionNormalize, CombinesPartialStatistics) {
+    const auto whole = GetStatistics({2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0});
+    auto combined = GetStatistics({2.0, 4.0, 4.0});
+    combined.Combine(GetStatistics({4.0, 5.0, 5.0, 7.0, 9.0}));
+    combined.Combine({});
+
+    EXPECT_EQ(combined.count, whole.count);
+    EXPECT_DOUBLE_EQ(combined.min, 2.0);
+    EXPECT_DOUBLE_EQ(combined.max, 9.0);
+    EXPECT_DOUBLE_EQ(combined.mean, whole.mean);
+    EXPECT_DOUBLE_EQ(combined.m2, whole.m2);
+}
+
+TEST(FusionNormalize, ConstantColumnNormalizesToZero) {
+    const auto statistics = GetStatistics({0.7, 0.7, 0.7});
+    EXPECT_EQ(statistics.Normalize(0.7, FusionNormalize::Mode::MIN_MAX), 0.0);
+    EXPECT_EQ(statistics.Normalize(0.7, FusionNormalize::Mode::Z_SCORE), 0.0);
+}
+
+TEST(FusionNormalize, Ranks) {
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    const auto normalized = FusionNormalize::NormalizeRanks({0.2, nan, 0.9, 0.2, 0.5});
+
+    ASSERT_EQ(normalized.size(), 5);
+    EXPECT_DOUBLE_EQ(normalized[2], 1.0);
+    EXPECT_DOUBLE_EQ(normalized[4], 0.75);
+    // Both 0.2 scores share rank 3 of 4
+    EXPECT_DOUBLE_EQ(normalized[0], 0.5);
+    EXPECT_DOUBLE_EQ(normalized[3], 0.5);
+    EXPECT_TRUE(std::isnan(normalized[1]));
+}
+
+TEST(FusionNormalize, NormalizesParallelInputWithGlobalStatistics) {
+    const auto previous_db = Config::db;
+    {
+        duckdb::DuckDB db(nullptr);
+        db.LoadExtension<duckdb::FlockmtlExtension>();
+        duckdb::Connection con(db);
+        con.Query("SET threads = 4");
+        // Three row groups, so the input reaches the function on several threads.
+        con.Query("CREATE TABLE candidates AS SELECT i AS id, i AS score FROM range(250000) t(i)");
+
+        const auto n = 250000.0;
+        const auto standard_deviation = std::sqrt((n * n - 1) / 12);
+        const std::vector<std::tuple<std::string, double, double>> modes = {
+            {"minmax", 0.0, 1.0},
+            {"zscore", -(n - 1) / 2 / standard_deviation, (n - 1) / 2 / standard_deviation},
+            {"rank", 1 / n, 1.0}};
+        for (const auto& [mode, lowest, highest] : modes) {
+            const auto result = con.Query("SELECT count(*), min(score) FILTER (WHERE id = 0), "
+                                          "max(score) FILTER (WHERE id = 249999) FROM fusion_normalize("
+                                          "TABLE (SELECT id, score FROM candidates), mode := '" +
+                                          mode + "')");
+            ASSERT_FALSE(result->HasError()) << result->GetError();
+            EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 250000) << mode;
+            EXPECT_NEAR(result->GetValue(1, 0).GetValue<double>(), lowest, 1e-9) << mode;
+            EXPECT_NEAR(result->GetValue(2, 0).GetValue<double>(), highest, 1e-9) << mode;
+        }
+    }
+    Config::db = previous_db;
+}
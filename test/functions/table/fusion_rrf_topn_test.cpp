@@ -0,0 +1,126 @@
+#include "flockmtl/functions/table/fusion_rrf_topn.hpp"
+#include "flockmtl_extension.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+static constexpr double kNotRetrieved = std::numeric_limits<double>::quiet_NaN();
+
+TEST(FusionRRFTopN, RanksRawScores) {
+    // Ranks in the first column: 2, 1, 3. In the second: 1, 3, 2.
+    const std::vector<std::vector<double>> scores = {{0.5, 0.9, 0.1}, {12.0, 3.0, 7.5}};
+    const auto fused = FusionRRFTopN::FuseTopN(scores, 3, {});
+
+    ASSERT_EQ(fused.size(), 3);
+    EXPECT_EQ(fused[0].row, 0);
+    EXPECT_DOUBLE_EQ(fused[0].score, 1.0 / 62 + 1.0 / 61);
+    EXPECT_EQ(fused[1].row, 1);
+    EXPECT_DOUBLE_EQ(fused[1].score, 1.0 / 61 + 1.0 / 63);
+    EXPECT_EQ(fused[2].row, 2);
+    EXPECT_DOUBLE_EQ(fused[2].score, 1.0 / 63 + 1.0 / 62);
+}
+
+TEST(FusionRRFTopN, KeepsOnlyTopN) {
+    std::vector<std::vector<double>> scores(1);
+    for (auto row = 0; row < 1000; row++) {
+        scores[0].push_back(static_cast<double>((row * 7919) % 1000));
+    }
+    FusionRRFTopN::Options options;
+    options.top_n = 3;
+    const auto fused = FusionRRFTopN::FuseTopN(scores, 1000, options);
+
+    ASSERT_EQ(fused.size(), 3);
+    for (size_t i = 0; i < fused.size(); i++) {
+        EXPECT_EQ(scores[0][fused[i].row], 999 - i);
+        EXPECT_DOUBLE_EQ(fused[i].score, 1.0 / (60 + i + 1));
+    }
+}
+
+TEST(FusionRRFTopN, AppliesKWeightsAndDepth) {
+    const std::vector<std::vector<double>> scores = {{0.9, 0.8, 0.7}, {0.1, 0.2, 0.3}};
+    FusionRRFTopN::Options options;
+    options.k = 1;
+    options.weights = {1.0, 3.0};
+    options.depth = 2;
+    const auto fused = FusionRRFTopN::FuseTopN(scores, 3, options);
+
+    // Row 2 is only ranked by the second retriever, row 0 only by the first.
+    ASSERT_EQ(fused.size(), 3);
+    EXPECT_EQ(fused[0].row, 2);
+    EXPECT_DOUBLE_EQ(fused[0].score, 3.0 / 2);
+    EXPECT_EQ(fused[1].row, 1);
+    EXPECT_DOUBLE_EQ(fused[1].score, 1.0 / 3 + 3.0 / 3);
+    EXPECT_EQ(fused[2].row, 0);
+    EXPECT_DOUBLE_EQ(fused[2].score, 1.0 / 2);
+}
+
+TEST(FusionRRFTopN, SkipsUnretrievedDocumentsAndSharesTiedRanks) {
+    const std::vector<std::vector<double>> scores = {{0.5, kNotRetrieved, 0.5, 0.2},
+                                                     {kNotRetrieved, kNotRetrieved, 1.0, kNotRetrieved}};
+    const auto fused = FusionRRFTopN::FuseTopN(scores, 4, {});
+
+    ASSERT_EQ(fused.size(), 3);
+    EXPECT_EQ(fused[0].row, 2);
+    EXPECT_DOUBLE_EQ(fused[0].score, 1.0 / 61 + 1.0 / 61);
+    EXPECT_EQ(fused[1].row, 0);
+    EXPECT_DOUBLE_EQ(fused[1].score, 1.0 / 61);
+    EXPECT_EQ(fused[2].row, 3);
+    EXPECT_DOUBLE_EQ(fused[2].score, 1.0 / 63);
+}
+
+TEST(FusionRRFTopN, RanksOnlyTheDepthOfEachRetriever) {
+    std::vector<std::vector<double>> scores(1);
+    for (auto row = 0; row < 1500; row++) {
+        scores[0].push_back(static_cast<double>(row));
+    }
+    FusionRRFTopN::Options options;
+    options.top_n = 1500;
+    EXPECT_EQ(FusionRRFTopN::FuseTopN(scores, 1500, options).size(), FusionRRFTopN::kDefaultDepth);
+    options.depth = 0;
+    EXPECT_EQ(FusionRRFTopN::FuseTopN(scores, 1500, options).size(), 1500);
+}
+
+TEST(FusionRRFTopN, FusesParallelInputOnce) {
+    const auto previous_db = Config::db;
+    {
+        duckdb::DuckDB db(nullptr);
+        db.LoadExtension<duckdb::FlockmtlExtension>();
+        duckdb::Connection con(db);
+        con.Query("SET threads = 4");
+        // Three row groups, so the input reaches the function on several threads. The second retriever misses every
+        // tenth document.
+        con.Query("CREATE TABLE candidates AS SELECT i AS id, i::DOUBLE AS bm25, "
+                  "CASE WHEN i % 10 = 0 THEN NULL ELSE -i::DOUBLE END AS similarity FROM range(250000) t(i)");
+
+        // Every document is ranked, so the scores below do not depend on the default depth.
+        const auto result = con.Query("SELECT id, score, rank FROM fusion_rrf_topn("
+                                      "TABLE (SELECT id, bm25, similarity FROM candidates), top_n := 3, depth := 0) "
+                                      "ORDER BY rank");
+        ASSERT_FALSE(result->HasError()) << result->GetError();
+        ASSERT_EQ(result->RowCount(), 3);
+        // Document 249999 is ranked 1st by bm25 and last of the 225,000 retrieved by similarity; document 1 is 1st by
+        // similarity and 249,999th by bm25.
+        EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 249999);
+        EXPECT_DOUBLE_EQ(result->GetValue(1, 0).GetValue<double>(), 1.0 / 61 + 1.0 / (60 + 225000));
+        EXPECT_EQ(result->GetValue(0, 1).GetValue<int64_t>(), 1);
+        EXPECT_DOUBLE_EQ(result->GetValue(1, 1).GetValue<double>(), 1.0 / 61 + 1.0 / (60 + 249999));
+        EXPECT_EQ(result->GetValue(2, 2).GetValue<int64_t>(), 3);
+    }
+    Config::db = previous_db;
+}
+
+TEST(FusionRRFTopN, ReturnsIdsOfAnyType) {
+    const auto previous_db = Config::db;
+    {
+        duckdb::DuckDB db(nullptr);
+        db.LoadExtension<duckdb::FlockmtlExtension>();
+        duckdb::Connection con(db);
+        const auto result = con.Query("SELECT id, rank FROM fusion_rrf_topn(TABLE (SELECT 'doc-' || i AS id, "
+                                      "i::DOUBLE AS bm25 FROM range(5000) t(i)), top_n := 2) ORDER BY rank");
+        ASSERT_FALSE(result->HasError()) << result->GetError();
+        ASSERT_EQ(result->RowCount(), 2);
+        EXPECT_EQ(result->GetValue(0, 0).ToString(), "doc-4999");
+        EXPECT_EQ(result->GetValue(0, 1).ToString(), "doc-4998");
+    }
+    Config::db = previous_db;
+}
@@ -0,0 +1,95 @@
+#include "../../mock_server/mock_server.hpp"
+#include "flockmtl_extension.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+// Runs the bulk functions end to end against the Batch API of the mock server, on a database of their own.
+class LlmBulkTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        previous_db_ = Config::db;
+        db_ = std::make_unique<duckdb::DuckDB>(nullptr);
+        db_->LoadExtension<duckdb::FlockmtlExtension>();
+        con_ = std::make_unique<duckdb::Connection>(*db_);
+        Run("SET threads = 4");
+        Run("CREATE SECRET bulk_mock (TYPE OPENAI, API_KEY 'mock', BASE_URL '" + server_.GetOpenAIUrl() + "')");
+        Run("CREATE MODEL('bulk_llm', 'mock', 'openai', {\"context_window\": 16000, \"max_output_tokens\": 4000})");
+        Run("CREATE MODEL('bulk_embedding', 'mock-embedding', 'openai', "
+            "{\"context_window\": 8000, \"max_output_tokens\": 8000})");
+        // Three row groups, so the input reaches the function on several threads.
+        Run("CREATE TABLE reviews AS SELECT i AS id, 'Review ' || i AS text FROM range(250000) t(i)");
+    }
+
+    void TearDown() override {
+        con_.reset();
+        db_.reset();
+        Config::db = previous_db_;
+    }
+
+    duckdb::unique_ptr<duckdb::MaterializedQueryResult> Run(const std::string& query) {
+        auto result = con_->Query(query);
+        EXPECT_FALSE(result->HasError()) << query << "\n" << result->GetError();
+        return result;
+    }
+
+    MockServer server_;
+    duckdb::DatabaseInstance* previous_db_ = nullptr;
+    std::unique_ptr<duckdb::DuckDB> db_;
+    std::unique_ptr<duckdb::Connection> con_;
+};
+
+TEST_F(LlmBulkTest, SubmitsParallelInputAsOneBatch) {
+    const auto result = Run("SELECT count(*), count(DISTINCT text), bool_and(len(result) = 8) "
+                            "FROM llm_embedding_bulk(TABLE (SELECT text FROM reviews), "
+                            "{'model_name': 'bulk_embedding', 'secret_name': 'bulk_mock'})");
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 250000);
+    EXPECT_EQ(result->GetValue(1, 0).GetValue<int64_t>(), 250000);
+    EXPECT_TRUE(result->GetValue(2, 0).GetValue<bool>());
+    EXPECT_EQ(server_.GetStats().batches, 1);
+}
+
+TEST_F(LlmBulkTest, EmbeddingsLandOnTheirRows) {
+    const auto result = Run("SELECT result FROM llm_embedding_bulk(TABLE (SELECT text FROM reviews WHERE id < 1000), "
+                            "{'model_name': 'bulk_embedding', 'secret_name': 'bulk_mock'}) WHERE text = 'Review 7'");
+    ASSERT_EQ(result->RowCount(), 1);
+    const auto embedding = duckdb::ListValue::GetChildren(result->GetValue(0, 0));
+    // Tuple values are joined with a trailing space each.
+    const auto expected = MockServer::Embed("Review 7 ", 8);
+    ASSERT_EQ(embedding.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_NEAR(embedding[i].GetValue<double>(), expected[i], 1e-6);
+    }
+}
+
+TEST_F(LlmBulkTest, CompletesEveryRow) {
+    const auto result = Run("SELECT count(*), count(result) FROM llm_complete_bulk("
+                            "TABLE (SELECT text FROM reviews WHERE id < 100), "
+                            "{'model_name': 'bulk_llm', 'secret_name': 'bulk_mock'}, {'prompt': 'Summarize.'})");
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 100);
+    EXPECT_EQ(result->GetValue(1, 0).GetValue<int64_t>(), 100);
+    EXPECT_EQ(server_.GetStats().batches, 1);
+}
+
+TEST_F(LlmBulkTest, UnansweredFilterRowsStayNull) {
+    server_.SetCompletionHandler([](const std::string&, bool) { return R"({"tuples": [null]})"; });
+    const auto result = Run("SELECT count(*), count(result), count(*) FILTER (WHERE result = 'true') "
+                            "FROM llm_filter_bulk(TABLE (SELECT text FROM reviews WHERE id < 10), "
+                            "{'model_name': 'bulk_llm', 'secret_name': 'bulk_mock', 'batch_size': '1'}, "
+                            "{'prompt': 'Is it positive?'})");
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 10);
+    EXPECT_EQ(result->GetValue(1, 0).GetValue<int64_t>(), 0);
+    EXPECT_EQ(result->GetValue(2, 0).GetValue<int64_t>(), 0);
+}
+
+TEST_F(LlmBulkTest, GivesUpAfterTheBatchTimeout) {
+    MockServer::Options options;
+    options.hold_batches = true;
+    server_.SetOptions(options);
+    const auto result = con_->Query("SELECT count(*) FROM llm_complete_bulk("
+                                    "TABLE (SELECT text FROM reviews WHERE id < 10), "
+                                    "{'model_name': 'bulk_llm', 'secret_name': 'bulk_mock', "
+                                    "'batch_poll_interval': '0.01', 'batch_timeout': '0.2'}, {'prompt': 'Summarize.'})");
+    ASSERT_TRUE(result->HasError());
+    EXPECT_NE(result->GetError().find("did not finish"), std::string::npos) << result->GetError();
+}
@@ -0,0 +1,52 @@
+#include "flockmtl_extension.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+// Runs llm_estimate on a database of its own, with enough rows that the input reaches it on several threads.
+class LlmEstimateTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        previous_db_ = Config::db;
+        db_ = std::make_unique<duckdb::DuckDB>(nullptr);
+        db_->LoadExtension<duckdb::FlockmtlExtension>();
+        con_ = std::make_unique<duckdb::Connection>(*db_);
+        Run("SET threads = 4");
+        Run("CREATE SECRET estimate_secret (TYPE OPENAI, API_KEY 'unused')");
+        Run("CREATE MODEL('estimate_llm', 'gpt-4o-mini', 'openai', "
+            "{\"context_window\": 128000, \"max_output_tokens\": 100})");
+        // Three row groups.
+        Run("CREATE TABLE reviews AS SELECT 'Review ' || i AS text FROM range(250000) t(i)");
+    }
+
+    void TearDown() override {
+        con_.reset();
+        db_.reset();
+        Config::db = previous_db_;
+    }
+
+    duckdb::unique_ptr<duckdb::MaterializedQueryResult> Run(const std::string& query) {
+        auto result = con_->Query(query);
+        EXPECT_FALSE(result->HasError()) << query << "\n" << result->GetError();
+        return result;
+    }
+
+    duckdb::DatabaseInstance* previous_db_ = nullptr;
+    std::unique_ptr<duckdb::DuckDB> db_;
+    std::unique_ptr<duckdb::Connection> con_;
+};
+
+TEST_F(LlmEstimateTest, EmitsOneRowForParallelInput) {
+    const auto result = Run("SELECT tuples, batches, prompt_tokens, max_completion_tokens "
+                            "FROM llm_estimate(TABLE reviews, "
+                            "{'model_name': 'estimate_llm', 'secret_name': 'estimate_secret', 'batch_size': '10'}, "
+                            "{'prompt': 'Is this review positive?'}, function := 'llm_filter')");
+    ASSERT_EQ(result->RowCount(), 1);
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 250000);
+    // Chunks are batched separately, so a few batches come out short.
+    const auto batches = result->GetValue(1, 0).GetValue<int64_t>();
+    EXPECT_GE(batches, 25000);
+    EXPECT_LT(batches, 25200);
+    EXPECT_GT(result->GetValue(2, 0).GetValue<int64_t>(), 250000);
+    EXPECT_EQ(result->GetValue(3, 0).GetValue<int64_t>(), batches * 100);
+}
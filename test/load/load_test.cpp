@@ -0,0 +1,102 @@
+// End-to-end load test: runs llm_filter, llm_reduce and llm_embedding over a generated table against the in-process
+// mock server and reports throughput and the client-side CPU spent per request.
+//
+// Usage: flockmtl_load_test [--rows N] [--latency MS] [--jitter MS] [--rate-limit-every N] [--threads N]
+
+#include "../mock_server/mock_server.hpp"
+#include "flockmtl_extension.hpp"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+int64_t ProcessCpuMicros() {
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return (static_cast<int64_t>(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec) * 1000000 + usage.ru_utime.tv_usec +
+           usage.ru_stime.tv_usec;
+}
+
+void Run(duckdb::Connection& con, const std::string& query) {
+    const auto result = con.Query(query);
+    if (result->HasError()) {
+        std::cerr << query << "\n" << result->GetError() << std::endl;
+        std::exit(1);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int64_t rows = 10000;
+    int64_t threads = 4;
+    flockmtl::MockServer::Options options;
+    for (auto i = 1; i + 1 < argc; i += 2) {
+        const auto value = std::atoll(argv[i + 1]);
+        if (std::strcmp(argv[i], "--rows") == 0) {
+            rows = value;
+        } else if (std::strcmp(argv[i], "--latency") == 0) {
+            options.latency = std::chrono::milliseconds(value);
+        } else if (std::strcmp(argv[i], "--jitter") == 0) {
+            options.jitter = std::chrono::milliseconds(value);
+        } else if (std::strcmp(argv[i], "--rate-limit-every") == 0) {
+            options.rate_limit_every = static_cast<int>(value);
+        } else if (std::strcmp(argv[i], "--threads") == 0) {
+            threads = value;
+        } else {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    flockmtl::MockServer server;
+    server.SetOptions(options);
+
+    duckdb::DuckDB db(nullptr);
+    db.LoadExtension<duckdb::FlockmtlExtension>();
+    duckdb::Connection con(db);
+    Run(con, "SET threads = " + std::to_string(threads));
+    Run(con, "CREATE SECRET mock_openai (TYPE OPENAI, API_KEY 'mock', BASE_URL '" + server.GetOpenAIUrl() + "')");
+    Run(con, "CREATE MODEL('load_llm', 'mock', 'openai', {\"context_window\": 16000, \"max_output_tokens\": 4000})");
+    Run(con, "CREATE MODEL('load_embedding', 'mock-embedding', 'openai', "
+             "{\"context_window\": 8000, \"max_output_tokens\": 8000})");
+    Run(con, "CREATE TABLE reviews AS SELECT i AS id, 'Review ' || i || ': ' || repeat('quack ', 20 + i % 40) AS text "
+             "FROM range(" + std::to_string(rows) + ") t(i)");
+
+    const std::pair<const char*, std::string> workloads[] = {
+        {"llm_filter", "SELECT count(*) FROM reviews WHERE llm_filter({'model_name': 'load_llm', 'secret_name': "
+                       "'mock_openai'}, {'prompt': 'Is this review positive?'}, {'text': text})"},
+        {"llm_reduce", "SELECT id % 100, llm_reduce({'model_name': 'load_llm', 'secret_name': 'mock_openai'}, "
+                       "{'prompt': 'Summarize the reviews.'}, {'text': text}) FROM reviews GROUP BY id % 100"},
+        {"llm_embedding", "SELECT count(llm_embedding({'model_name': 'load_embedding', 'secret_name': "
+                          "'mock_openai'}, {'text': text})) FROM reviews"},
+    };
+
+    std::cout << std::left << std::setw(16) << "workload" << std::right << std::setw(10) << "rows/s" << std::setw(12)
+              << "requests" << std::setw(12) << "requests/s" << std::setw(12) << "tokens/s" << std::setw(10) << "429s"
+              << std::setw(16) << "client cpu/req" << std::endl;
+    for (const auto& [name, query] : workloads) {
+        server.ResetStats();
+        const auto cpu_start = ProcessCpuMicros();
+        const auto start = std::chrono::steady_clock::now();
+        Run(con, query);
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const auto stats = server.GetStats();
+        // The server runs in this process too, so its share of the CPU time is taken out.
+        const auto client_cpu = ProcessCpuMicros() - cpu_start - stats.cpu_time.count();
+        const auto served = std::max<int64_t>(stats.requests - stats.rate_limited, 1);
+        std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(10) << rows / seconds << std::setw(12) << stats.requests << std::setw(12)
+                  << stats.requests / seconds << std::setw(12)
+                  << (stats.prompt_tokens + stats.completion_tokens) / seconds << std::setw(10) << stats.rate_limited
+                  << std::setw(13) << std::setprecision(1) << client_cpu / 1000.0 / served << " ms" << std::endl;
+    }
+    return 0;
+}
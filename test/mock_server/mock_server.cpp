@@ -0,0 +1,592 @@
+#include "mock_server.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <stdexcept>
+
+namespace flockmtl {
+
+namespace {
+
+std::string StatusText(const int status) {
+    switch (status) {
+        case 200:
+            return "OK";
+        case 400:
+            return "Bad Request";
+        case 404:
+            return "Not Found";
+        case 429:
+            return "Too Many Requests";
+        default:
+            return "Error";
+    }
+}
+
+std::string Lower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+bool EndsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::string Base64Encode(const unsigned char* data, const size_t size) {
+    static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string encoded;
+    encoded.reserve((size + 2) / 3 * 4);
+    for (size_t i = 0; i < size; i += 3) {
+        const uint32_t chunk = data[i] << 16 | (i + 1 < size ? data[i + 1] << 8 : 0) | (i + 2 < size ? data[i + 2] : 0);
+        encoded += alphabet[chunk >> 18 & 63];
+        encoded += alphabet[chunk >> 12 & 63];
+        encoded += i + 1 < size ? alphabet[chunk >> 6 & 63] : '=';
+        encoded += i + 2 < size ? alphabet[chunk & 63] : '=';
+    }
+    return encoded;
+}
+
+int64_t ThreadCpuMicros() {
+    timespec now {};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
+} // namespace
+
+MockServer::MockServer() : handler_(DefaultCompletion) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error("MockServer: cannot create socket");
+    }
+    const int reuse = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listen_fd_, SOMAXCONN) != 0) {
+        close(listen_fd_);
+        throw std::runtime_error("MockServer: cannot listen on 127.0.0.1");
+    }
+    socklen_t length = sizeof(address);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+    accept_thread_ = std::thread([this]() { AcceptLoop(); });
+}
+
+MockServer::~MockServer() {
+    stopping_ = true;
+    accept_thread_.join();
+    for (auto& thread : connection_threads_) {
+        thread.join();
+    }
+    close(listen_fd_);
+}
+
+std::string MockServer::GetOpenAIUrl() const { return "http://127.0.0.1:" + std::to_string(port_) + "/v1/"; }
+
+std::string MockServer::GetOllamaUrl() const { return "127.0.0.1:" + std::to_string(port_); }
+
+void MockServer::SetOptions(const Options& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = options;
+}
+
+void MockServer::SetCompletionHandler(CompletionHandler handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    handler_ = std::move(handler);
+}
+
+MockServer::Stats MockServer::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto stats = stats_;
+    stats.stored_files = static_cast<int64_t>(files_.size());
+    return stats;
+}
+
+void MockServer::ResetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = {};
+}
+
+void MockServer::AcceptLoop() {
+    // Connection threads are only joined on shutdown; a test server sees few enough connections for that.
+    while (!stopping_) {
+        pollfd listener {listen_fd_, POLLIN, 0};
+        if (poll(&listener, 1, 50) <= 0) {
+            continue;
+        }
+        const auto fd = accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        const int no_delay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.connections++;
+        }
+        connection_threads_.emplace_back([this, fd]() { ServeConnection(fd); });
+    }
+}
+
+void MockServer::ServeConnection(const int fd) {
+    std::string buffer;
+    char chunk[16384];
+    const auto read_more = [&]() {
+        while (!stopping_) {
+            pollfd connection {fd, POLLIN, 0};
+            const auto ready = poll(&connection, 1, 50);
+            if (ready < 0) {
+                return false;
+            }
+            if (ready == 0) {
+                continue;
+            }
+            const auto received = recv(fd, chunk, sizeof(chunk), 0);
+            if (received <= 0) {
+                return false;
+            }
+            buffer.append(chunk, received);
+            return true;
+        }
+        return false;
+    };
+    const auto send_all = [&](const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            const auto written = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) {
+                return false;
+            }
+            sent += written;
+        }
+        return true;
+    };
+
+    // HTTP/1.1 with keep-alive: serve requests until the client closes the connection.
+    while (true) {
+        size_t header_end;
+        while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (!read_more()) {
+                close(fd);
+                return;
+            }
+        }
+        const auto head = buffer.substr(0, header_end);
+        buffer.erase(0, header_end + 4);
+
+        const auto request_line_end = head.find("\r\n");
+        const auto request_line = head.substr(0, request_line_end);
+        const auto method_end = request_line.find(' ');
+        const auto path_end = request_line.find(' ', method_end + 1);
+        const auto method = request_line.substr(0, method_end);
+        const auto path = request_line.substr(method_end + 1, path_end - method_end - 1);
+
+        size_t content_length = 0;
+        auto expect_continue = false;
+        auto close_connection = false;
+        size_t pos = request_line_end == std::string::npos ? head.size() : request_line_end + 2;
+        while (pos < head.size()) {
+            auto line_end = head.find("\r\n", pos);
+            if (line_end == std::string::npos) {
+                line_end = head.size();
+            }
+            const auto line = head.substr(pos, line_end - pos);
+            pos = line_end + 2;
+            const auto colon = line.find(':');
+            if (colon == std::string::npos) {
+                continue;
+            }
+            const auto name = Lower(line.substr(0, colon));
+            const auto value_start = line.find_first_not_of(' ', colon + 1);
+            const auto value = value_start == std::string::npos ? "" : Lower(line.substr(value_start));
+            if (name == "content-length") {
+                content_length = std::stoul(value);
+            } else if (name == "expect") {
+                expect_continue = value == "100-continue";
+            } else if (name == "connection") {
+                close_connection = value == "close";
+            }
+        }
+        if (expect_continue && buffer.size() < content_length && !send_all("HTTP/1.1 100 Continue\r\n\r\n")) {
+            break;
+        }
+        while (buffer.size() < content_length) {
+            if (!read_more()) {
+                close(fd);
+                return;
+            }
+        }
+        const auto body = buffer.substr(0, content_length);
+        buffer.erase(0, content_length);
+
+        const auto cpu_start = ThreadCpuMicros();
+        const auto response = Handle(method, path, body);
+        std::string message = "HTTP/1.1 " + std::to_string(response.status) + " " + StatusText(response.status) +
+                              "\r\nContent-Type: application/json\r\nContent-Length: " +
+                              std::to_string(response.body.size()) + "\r\n";
+        for (const auto& [name, value] : response.headers) {
+            message += name + ": " + value + "\r\n";
+        }
+        message += "\r\n" + response.body;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.cpu_time += std::chrono::microseconds(ThreadCpuMicros() - cpu_start);
+        }
+        if (!send_all(message) || close_connection) {
+            break;
+        }
+    }
+    close(fd);
+}
+
+MockServer::HttpResponse MockServer::Handle(const std::string& method, const std::string& path,
+                                            const std::string& body) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.requests++;
+    }
+    if (path.find("/files") != std::string::npos || path.find("/batches") != std::string::npos) {
+        return HandleBatchApi(method, path, body);
+    }
+    const auto request = nlohmann::json::parse(body, nullptr, false);
+    if (method != "POST" || request.is_discarded()) {
+        return {400, {}, R"({"error":{"message":"Expected a POST request with a JSON body"}})"};
+    }
+
+    if (ShouldRateLimit()) {
+        HttpResponse response {429, {}, R"({"error":{"message":"Rate limit reached","code":"rate_limit_exceeded"}})"};
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.rate_limited++;
+        response.headers["retry-after-ms"] = std::to_string(options_.retry_after.count());
+        return response;
+    }
+
+    Sleep();
+    if (EndsWith(path, "/chat/completions")) {
+        return HandleChatCompletion(request);
+    }
+    if (EndsWith(path, "/v1/embeddings")) {
+        return HandleEmbeddings(request);
+    }
+    if (path == "/api/generate") {
+        return HandleOllamaGenerate(request);
+    }
+    if (path == "/api/embeddings" || path == "/api/embed") {
+        return HandleOllamaEmbed(request, path == "/api/embed");
+    }
+    return {404, {}, R"({"error":{"message":"Unknown endpoint"}})"};
+}
+
+bool MockServer::ShouldRateLimit() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (options_.rate_limit_next > 0) {
+        options_.rate_limit_next--;
+        return true;
+    }
+    return options_.rate_limit_every > 0 && stats_.requests % options_.rate_limit_every == 0;
+}
+
+void MockServer::Sleep() const {
+    std::chrono::milliseconds latency;
+    std::chrono::milliseconds jitter;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        latency = options_.latency;
+        jitter = options_.jitter;
+    }
+    if (jitter.count() > 0) {
+        thread_local std::mt19937_64 generator {42};
+        latency += std::chrono::milliseconds(
+            std::uniform_int_distribution<int64_t>(-jitter.count(), jitter.count())(generator));
+    }
+    if (latency.count() > 0) {
+        std::this_thread::sleep_for(latency);
+    }
+}
+
+void MockServer::CountTokens(const int64_t prompt_tokens, const int64_t completion_tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.prompt_tokens += prompt_tokens;
+    stats_.completion_tokens += completion_tokens;
+}
+
+MockServer::HttpResponse MockServer::HandleChatCompletion(const nlohmann::json& request) {
+    const auto& messages = request.value("messages", nlohmann::json::array());
+    const auto prompt = messages.empty() ? std::string() : messages.back().value("content", std::string());
+    const auto json_response = request.contains("response_format");
+    CompletionHandler handler;
+    bool truncate;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handler = handler_;
+        truncate = options_.truncate;
+    }
+    auto content = handler(prompt, json_response);
+    if (truncate) {
+        content = content.substr(0, content.size() / 2);
+    }
+    const auto prompt_tokens = ApproximateTokens(prompt);
+    const auto completion_tokens = ApproximateTokens(content);
+    CountTokens(prompt_tokens, completion_tokens);
+
+    const nlohmann::json response = {
+        {"id", "chatcmpl-mock"},
+        {"object", "chat.completion"},
+        {"model", request.value("model", "mock")},
+        {"choices",
+         {{{"index", 0},
+           {"message", {{"role", "assistant"}, {"content", content}, {"refusal", nullptr}}},
+           {"finish_reason", truncate ? "length" : "stop"}}}},
+        {"usage",
+         {{"prompt_tokens", prompt_tokens},
+          {"completion_tokens", completion_tokens},
+          {"total_tokens", prompt_tokens + completion_tokens}}}};
+    return {200, {}, response.dump()};
+}
+
+MockServer::HttpResponse MockServer::HandleEmbeddings(const nlohmann::json& request) {
+    auto inputs = request.value("input", nlohmann::json::array());
+    if (inputs.is_string()) {
+        inputs = nlohmann::json::array({inputs});
+    }
+    const auto base64 = request.value("encoding_format", "float") == "base64";
+    size_t dimensions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dimensions = options_.embedding_dimensions;
+    }
+    // Like OpenAI's text-embedding-3 models, shorten the embeddings on request
+    dimensions = request.value("dimensions", dimensions);
+
+    auto data = nlohmann::json::array();
+    int64_t prompt_tokens = 0;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        const auto input = inputs[i].get<std::string>();
+        prompt_tokens += ApproximateTokens(input);
+        const auto embedding = Embed(input, dimensions);
+        nlohmann::json item = {{"object", "embedding"}, {"index", i}};
+        if (base64) {
+            item["embedding"] = Base64Encode(reinterpret_cast<const unsigned char*>(embedding.data()),
+                                             embedding.size() * sizeof(float));
+        } else {
+            item["embedding"] = embedding;
+        }
+        data.push_back(std::move(item));
+    }
+    CountTokens(prompt_tokens, 0);
+
+    const nlohmann::json response = {{"object", "list"},
+                                     {"data", data},
+                                     {"model", request.value("model", "mock")},
+                                     {"usage", {{"prompt_tokens", prompt_tokens}, {"total_tokens", prompt_tokens}}}};
+    return {200, {}, response.dump()};
+}
+
+MockServer::HttpResponse MockServer::HandleOllamaGenerate(const nlohmann::json& request) {
+    const auto prompt = request.value("prompt", "");
+    const auto json_response = request.contains("format");
+    CompletionHandler handler;
+    bool truncate;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handler = handler_;
+        truncate = options_.truncate;
+    }
+    auto content = handler(prompt, json_response);
+    if (truncate) {
+        content = content.substr(0, content.size() / 2);
+    }
+    const auto prompt_tokens = ApproximateTokens(prompt);
+    const auto completion_tokens = ApproximateTokens(content);
+    CountTokens(prompt_tokens, completion_tokens);
+
+    const nlohmann::json response = {{"model", request.value("model", "mock")},
+                                     {"response", content},
+                                     {"done", true},
+                                     {"done_reason", truncate ? "length" : "stop"},
+                                     {"prompt_eval_count", prompt_tokens},
+                                     {"eval_count", completion_tokens}};
+    return {200, {}, response.dump()};
+}
+
+MockServer::HttpResponse MockServer::HandleOllamaEmbed(const nlohmann::json& request, const bool batched) {
+    size_t dimensions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dimensions = options_.embedding_dimensions;
+    }
+    if (!batched) {
+        // The legacy endpoint embeds a single prompt.
+        const auto prompt = request.value("prompt", "");
+        CountTokens(ApproximateTokens(prompt), 0);
+        return {200, {}, nlohmann::json({{"embedding", Embed(prompt, dimensions)}}).dump()};
+    }
+
+    auto inputs = request.value("input", nlohmann::json::array());
+    if (inputs.is_string()) {
+        inputs = nlohmann::json::array({inputs});
+    }
+    auto embeddings = nlohmann::json::array();
+    int64_t prompt_tokens = 0;
+    for (const auto& input : inputs) {
+        prompt_tokens += ApproximateTokens(input.get<std::string>());
+        embeddings.push_back(Embed(input.get<std::string>(), dimensions));
+    }
+    CountTokens(prompt_tokens, 0);
+    const nlohmann::json response = {
+        {"model", request.value("model", "mock")}, {"embeddings", embeddings}, {"prompt_eval_count", prompt_tokens}};
+    return {200, {}, response.dump()};
+}
+
+MockServer::HttpResponse MockServer::HandleBatchApi(const std::string& method, const std::string& path,
+                                                    const std::string& body) {
+    const auto id_after = [&](const std::string& prefix) {
+        const auto start = path.find(prefix) + prefix.size();
+        return path.substr(start, path.find('/', start) - start);
+    };
+
+    if (method == "POST" && EndsWith(path, "/files")) {
+        // The multipart part named "file" holds the JSONL input.
+        const auto part = body.find("name=\"file\"");
+        const auto content_start = part == std::string::npos ? part : body.find("\r\n\r\n", part);
+        if (content_start == std::string::npos) {
+            return {400, {}, R"({"error":{"message":"Expected a multipart upload with a file part"}})"};
+        }
+        const auto content_end = body.find("\r\n--", content_start + 4);
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto id = "file-" + std::to_string(next_id_++);
+        files_[id] = body.substr(content_start + 4, content_end - content_start - 4);
+        return {200, {}, nlohmann::json({{"id", id}, {"object", "file"}, {"purpose", "batch"}}).dump()};
+    }
+    if (method == "GET" && EndsWith(path, "/content")) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto file = files_.find(id_after("/files/"));
+        if (file == files_.end()) {
+            return {404, {}, R"({"error":{"message":"No such file"}})"};
+        }
+        return {200, {}, file->second};
+    }
+    if (method == "DELETE" && path.find("/files/") != std::string::npos) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto id = id_after("/files/");
+        if (files_.erase(id) == 0) {
+            return {404, {}, R"({"error":{"message":"No such file"}})"};
+        }
+        return {200, {}, nlohmann::json({{"id", id}, {"object", "file"}, {"deleted", true}}).dump()};
+    }
+    if (method == "POST" && EndsWith(path, "/batches")) {
+        const auto request = nlohmann::json::parse(body, nullptr, false);
+        std::string input;
+        bool hold;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto file = request.is_object() ? files_.find(request.value("input_file_id", "")) : files_.end();
+            if (file == files_.end()) {
+                return {400, {}, R"({"error":{"message":"Unknown input_file_id"}})"};
+            }
+            if (options_.max_batches > 0 && stats_.batches >= options_.max_batches) {
+                return {400, {}, R"({"error":{"message":"Too many batches"}})"};
+            }
+            input = file->second;
+            hold = options_.hold_batches;
+            stats_.batches++;
+        }
+
+        std::string output;
+        for (size_t pos = 0; !hold && pos < input.size();) {
+            auto line_end = input.find('\n', pos);
+            if (line_end == std::string::npos) {
+                line_end = input.size();
+            }
+            const auto line = nlohmann::json::parse(input.substr(pos, line_end - pos), nullptr, false);
+            pos = line_end + 1;
+            if (!line.is_object()) {
+                continue;
+            }
+            const auto request = line.value("body", nlohmann::json::object());
+            const auto response = EndsWith(line.value("url", ""), "/embeddings") ? HandleEmbeddings(request)
+                                                                                 : HandleChatCompletion(request);
+            output += nlohmann::json({{"custom_id", line["custom_id"]},
+                                      {"response",
+                                       {{"status_code", response.status},
+                                        {"body", nlohmann::json::parse(response.body)}}},
+                                      {"error", nullptr}})
+                          .dump() +
+                      "\n";
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto id = "batch-" + std::to_string(next_id_++);
+        nlohmann::json batch = {{"id", id}, {"object", "batch"}, {"status", hold ? "in_progress" : "completed"}};
+        if (!hold) {
+            const auto output_file_id = "file-" + std::to_string(next_id_++);
+            files_[output_file_id] = std::move(output);
+            batch["output_file_id"] = output_file_id;
+        }
+        batches_[id] = batch;
+        return {200, {}, batch.dump()};
+    }
+    if (path.find("/batches/") != std::string::npos) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto batch = batches_.find(id_after("/batches/"));
+        if (batch == batches_.end()) {
+            return {404, {}, R"({"error":{"message":"No such batch"}})"};
+        }
+        if (method == "POST" && EndsWith(path, "/cancel")) {
+            batch->second["status"] = "cancelled";
+            stats_.cancelled_batches++;
+        }
+        return {200, {}, batch->second.dump()};
+    }
+    return {404, {}, R"({"error":{"message":"Unknown endpoint"}})"};
+}
+
+std::string MockServer::DefaultCompletion(const std::string& prompt, const bool json_response) {
+    if (!json_response) {
+        return "Quack.";
+    }
+    // The first <tuple> element is the header that names the columns.
+    int64_t tuples = -1;
+    for (auto pos = prompt.find("<tuple>"); pos != std::string::npos; pos = prompt.find("<tuple>", pos + 1)) {
+        tuples++;
+    }
+    const auto items = nlohmann::json(std::vector<bool>(std::max<int64_t>(tuples, 0), true));
+    return nlohmann::json({{"tuples", items}, {"output", "Quack."}}).dump();
+}
+
+std::vector<float> MockServer::Embed(const std::string& input, const size_t dimensions) {
+    std::mt19937 generator(static_cast<uint32_t>(std::hash<std::string> {}(input)));
+    std::normal_distribution<float> distribution;
+    std::vector<float> embedding(dimensions);
+    float norm = 0;
+    for (auto& value : embedding) {
+        value = distribution(generator);
+        norm += value * value;
+    }
+    norm = std::sqrt(norm);
+    for (auto& value : embedding) {
+        value = norm > 0 ? value / norm : 0;
+    }
+    return embedding;
+}
+
+int64_t MockServer::ApproximateTokens(const std::string& text) {
+    return static_cast<int64_t>((text.size() + 3) / 4);
+}
+
+} // namespace flockmtl
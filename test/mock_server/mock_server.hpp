@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace flockmtl {
+
+// In-process HTTP stand-in for OpenAI-compatible and Ollama servers, listening on an ephemeral port of 127.0.0.1.
+// It speaks the chat-completions, embeddings and Ollama generate/embeddings/embed wire formats, so the real Session and
+// curl path can be exercised without a network. Latency, 429 responses and truncated completions are programmable.
+// The files and batches endpoints of the Batch API run a batch as soon as it is created, without latency or 429s.
+class MockServer {
+public:
+    struct Options {
+        std::chrono::milliseconds latency {0};
+        std::chrono::milliseconds jitter {0};
+        // The next `rate_limit_next` requests are answered with 429, and afterwards every `rate_limit_every`-th one.
+        int rate_limit_next = 0;
+        int rate_limit_every = 0;
+        // Sent as retry-after-ms with every 429.
+        std::chrono::milliseconds retry_after {0};
+        // Completions stop with finish_reason "length".
+        bool truncate = false;
+        size_t embedding_dimensions = 8;
+        // Batches stay in_progress instead of completing, e.g. to exercise timeouts.
+        bool hold_batches = false;
+        // Creating more batches than this fails with a 400; zero means no limit.
+        int max_batches = 0;
+    };
+
+    struct Stats {
+        int64_t requests = 0;
+        int64_t rate_limited = 0;
+        int64_t connections = 0;
+        int64_t prompt_tokens = 0;
+        int64_t completion_tokens = 0;
+        int64_t batches = 0;
+        int64_t cancelled_batches = 0;
+        // Uploaded and generated files not deleted yet.
+        int64_t stored_files = 0;
+        // CPU time the server threads spent handling requests, excluding the synthetic latency.
+        std::chrono::microseconds cpu_time {0};
+    };
+
+    // Maps the prompt of a completion request to the content of the response.
+    using CompletionHandler = std::function<std::string(const std::string& prompt, bool json_response)>;
+
+    MockServer();
+    ~MockServer();
+    MockServer(const MockServer&) = delete;
+    MockServer& operator=(const MockServer&) = delete;
+
+    // Base URL of the OpenAI-compatible API, e.g. "http://127.0.0.1:12345/v1/".
+    std::string GetOpenAIUrl() const;
+    // Ollama API URL, e.g. "127.0.0.1:12345".
+    std::string GetOllamaUrl() const;
+
+    void SetOptions(const Options& options);
+    void SetCompletionHandler(CompletionHandler handler);
+    Stats GetStats() const;
+    void ResetStats();
+
+    // Answers the FlockMTL prompts with one `true` per XML tuple under "tuples" and a fixed summary under "output",
+    // which both the scalar and the aggregate functions accept.
+    static std::string DefaultCompletion(const std::string& prompt, bool json_response);
+    // Deterministic unit-length embedding of `input`.
+    static std::vector<float> Embed(const std::string& input, size_t dimensions);
+
+private:
+    struct HttpResponse {
+        int status = 200;
+        std::map<std::string, std::string> headers;
+        std::string body;
+    };
+
+    void AcceptLoop();
+    void ServeConnection(int fd);
+    HttpResponse Handle(const std::string& method, const std::string& path, const std::string& body);
+    HttpResponse HandleChatCompletion(const nlohmann::json& request);
+    HttpResponse HandleEmbeddings(const nlohmann::json& request);
+    HttpResponse HandleOllamaGenerate(const nlohmann::json& request);
+    HttpResponse HandleOllamaEmbed(const nlohmann::json& request, bool batched);
+    HttpResponse HandleBatchApi(const std::string& method, const std::string& path, const std::string& body);
+    bool ShouldRateLimit();
+    void Sleep() const;
+    void CountTokens(int64_t prompt_tokens, int64_t completion_tokens);
+
+    static int64_t ApproximateTokens(const std::string& text);
+
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::atomic<bool> stopping_ {false};
+    std::thread accept_thread_;
+    std::vector<std::thread> connection_threads_;
+
+    mutable std::mutex mutex_;
+    Options options_;
+    CompletionHandler handler_;
+    Stats stats_;
+    // Uploaded and generated files and the created batches, by id.
+    std::map<std::string, std::string> files_;
+    std::map<std::string, nlohmann::json> batches_;
+    int64_t next_id_ = 0;
+};
+
+} // namespace flockmtl
@@ -0,0 +1,110 @@
+#include "../mock_server/mock_server.hpp"
+#include "flockmtl/model_manager/batch_client.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace flockmtl;
+
+TEST(BatchClientTest, WritesOneRequestPerLine) {
+    const std::vector<BatchRequest> requests = {{"request-0", {{"model", "gpt-4o"}}},
+                                                {"request-1", {{"model", "gpt-4o-mini"}}},
+                                                {"request-2", {{"model", "o1"}}}};
+    const auto jsonl = BatchClient::ToJsonl("/v1/chat/completions", requests, 1, 3);
+    const auto newline = jsonl.find('\n');
+    ASSERT_NE(newline, std::string::npos);
+    const auto first = nlohmann::json::parse(jsonl.substr(0, newline));
+    EXPECT_EQ(first["custom_id"], "request-1");
+    EXPECT_EQ(first["method"], "POST");
+    EXPECT_EQ(first["url"], "/v1/chat/completions");
+    EXPECT_EQ(first["body"]["model"], "gpt-4o-mini");
+    EXPECT_EQ(nlohmann::json::parse(jsonl.substr(newline + 1))["custom_id"], "request-2");
+    EXPECT_EQ(jsonl.back(), '\n');
+}
+
+TEST(BatchClientTest, KeepsOnlySuccessfulOutputLines) {
+    const std::string output =
+        R"({"id":"batch_req_1","custom_id":"request-1","response":{"status_code":200,"body":{"choices":[]}},"error":null})"
+        "\n"
+        R"({"id":"batch_req_0","custom_id":"request-0","response":{"status_code":429,"body":{"error":{}}},"error":null})"
+        "\n"
+        R"({"id":"batch_req_2","custom_id":"request-2","response":null,"error":{"code":"batch_expired"}})"
+        "\n"
+        "not json\n";
+    std::unordered_map<std::string, std::string> bodies;
+    BatchClient::ParseOutput(output, bodies);
+    ASSERT_EQ(bodies.size(), 1u);
+    EXPECT_EQ(nlohmann::json::parse(bodies.at("request-1")), nlohmann::json::parse(R"({"choices":[]})"));
+}
+
+// Runs BatchClient against the Batch API of the in-process mock server.
+class BatchClientServerTest : public ::testing::Test {
+protected:
+    BatchClient MakeClient(const std::chrono::milliseconds timeout) const {
+        return BatchClient("mock-key", server_.GetOpenAIUrl(), RequestOptions(), std::chrono::milliseconds(10),
+                           timeout);
+    }
+
+    static std::vector<BatchRequest> MakeRequests() {
+        return {{"request-0", {{"model", "mock"}, {"messages", {{{"role", "user"}, {"content", "a"}}}}}},
+                {"request-1", {{"model", "mock"}, {"messages", {{{"role", "user"}, {"content", "b"}}}}}}};
+    }
+
+    MockServer server_;
+};
+
+TEST_F(BatchClientServerTest, ReturnsTheBodyOfEveryRequest) {
+    const auto bodies = MakeClient(std::chrono::milliseconds(5000)).Run("/v1/chat/completions", MakeRequests());
+    ASSERT_EQ(bodies.size(), 2u);
+    EXPECT_EQ(nlohmann::json::parse(bodies.at("request-1"))["choices"][0]["message"]["content"], "Quack.");
+    EXPECT_EQ(server_.GetStats().batches, 1);
+    // The input and output files are deleted once read.
+    EXPECT_EQ(server_.GetStats().stored_files, 0);
+}
+
+TEST_F(BatchClientServerTest, GivesUpOnBatchesThatOutliveTheTimeout) {
+    MockServer::Options options;
+    options.hold_batches = true;
+    server_.SetOptions(options);
+
+    const auto started = std::chrono::steady_clock::now();
+    EXPECT_THROW(MakeClient(std::chrono::milliseconds(100)).Run("/v1/chat/completions", MakeRequests()),
+                 std::runtime_error);
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(5));
+    EXPECT_EQ(server_.GetStats().cancelled_batches, 1);
+    EXPECT_EQ(server_.GetStats().stored_files, 0);
+}
+
+TEST_F(BatchClientServerTest, StopsWaitingOnceCancelled) {
+    MockServer::Options options;
+    options.hold_batches = true;
+    server_.SetOptions(options);
+
+    std::atomic<bool> cancelled {false};
+    std::thread canceller([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        cancelled = true;
+    });
+    const RequestCancellation::Scope scope(&cancelled);
+    const auto started = std::chrono::steady_clock::now();
+    EXPECT_THROW(MakeClient(std::chrono::hours(1)).Run("/v1/chat/completions", MakeRequests()), std::runtime_error);
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(5));
+    canceller.join();
+}
+
+TEST_F(BatchClientServerTest, CancelsTheSubmittedPartsWhenALaterOneFails) {
+    MockServer::Options options;
+    options.hold_batches = true;
+    options.max_batches = 1;
+    server_.SetOptions(options);
+
+    // One request more than a batch holds, so the second part is rejected while the first one runs.
+    std::vector<BatchRequest> requests(BatchClient::kMaxRequestsPerBatch + 1);
+    for (size_t i = 0; i < requests.size(); i++) {
+        requests[i] = {"request-" + std::to_string(i), {{"model", "mock"}}};
+    }
+    EXPECT_THROW(MakeClient(std::chrono::hours(1)).Run("/v1/chat/completions", requests), std::runtime_error);
+    const auto stats = server_.GetStats();
+    EXPECT_EQ(stats.batches, 1);
+    EXPECT_EQ(stats.cancelled_batches, 1);
+    EXPECT_EQ(stats.stored_files, 0);
+}
@@ -0,0 +1,49 @@
+#include "flockmtl/model_manager/circuit_breaker.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace flockmtl;
+
+class CircuitBreakerTest : public ::testing::Test {
+protected:
+    void SetUp() override { CircuitBreaker::Reset(); }
+    void TearDown() override { CircuitBreaker::Reset(); }
+};
+
+TEST_F(CircuitBreakerTest, OpensAfterConsecutiveFailures) {
+    const std::string endpoint = "https://api.openai.com/v1/chat/completions";
+    for (auto i = 0; i < CircuitBreaker::kFailureThreshold - 1; i++) {
+        EXPECT_TRUE(CircuitBreaker::Allow(endpoint));
+        CircuitBreaker::RecordFailure(endpoint);
+    }
+    // A success in between resets the count.
+    CircuitBreaker::RecordSuccess(endpoint);
+    for (auto i = 0; i < CircuitBreaker::kFailureThreshold - 1; i++) {
+        CircuitBreaker::RecordFailure(endpoint);
+    }
+    EXPECT_TRUE(CircuitBreaker::Allow(endpoint));
+    CircuitBreaker::RecordFailure(endpoint);
+    EXPECT_FALSE(CircuitBreaker::Allow(endpoint));
+    // Other endpoints are unaffected.
+    EXPECT_TRUE(CircuitBreaker::Allow("http://localhost:11434/api/generate"));
+}
+
+TEST_F(CircuitBreakerTest, HalfOpenProbeDecides) {
+    CircuitBreaker::Configure(1, std::chrono::milliseconds(50));
+    const std::string endpoint = "endpoint";
+    CircuitBreaker::RecordFailure(endpoint);
+    EXPECT_FALSE(CircuitBreaker::Allow(endpoint));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_TRUE(CircuitBreaker::Allow(endpoint));
+    // Only one probe at a time.
+    EXPECT_FALSE(CircuitBreaker::Allow(endpoint));
+    CircuitBreaker::RecordFailure(endpoint);
+    EXPECT_FALSE(CircuitBreaker::Allow(endpoint));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_TRUE(CircuitBreaker::Allow(endpoint));
+    CircuitBreaker::RecordSuccess(endpoint);
+    EXPECT_TRUE(CircuitBreaker::Allow(endpoint));
+    EXPECT_TRUE(CircuitBreaker::Allow(endpoint));
+}
@@ -0,0 +1,101 @@
+#include "flockmtl/model_manager/providers/embedding_decoder.hpp"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <map>
+
+using namespace flockmtl;
+
+class CollectingSink : public EmbeddingSink {
+public:
+    std::map<size_t, std::vector<double>> rows;
+    void Write(size_t row, const double* values, size_t count) override {
+        rows[row] = std::vector<double>(values, values + count);
+    }
+};
+
+static std::string EncodeBase64(const std::vector<float>& values) {
+    static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::vector<uint8_t> bytes(values.size() * sizeof(float));
+    std::memcpy(bytes.data(), values.data(), bytes.size());
+    std::string encoded;
+    for (size_t i = 0; i < bytes.size(); i += 3) {
+        uint32_t triple = bytes[i] << 16;
+        if (i + 1 < bytes.size()) triple |= bytes[i + 1] << 8;
+        if (i + 2 < bytes.size()) triple |= bytes[i + 2];
+        encoded += alphabet[(triple >> 18) & 0x3F];
+        encoded += alphabet[(triple >> 12) & 0x3F];
+        encoded += i + 1 < bytes.size() ? alphabet[(triple >> 6) & 0x3F] : '=';
+        encoded += i + 2 < bytes.size() ? alphabet[triple & 0x3F] : '=';
+    }
+    return encoded;
+}
+
+TEST(EmbeddingDecoderTest, DecodeFloatArrays) {
+    const std::string response = R"({
+        "object": "list",
+        "data": [
+            {"object": "embedding", "index": 1, "embedding": [0.5, -1.25e-3, 3]},
+            {"object": "embedding", "embedding": [ -0.0023064255 , 0.009327292 ], "index": 0}
+        ],
+        "model": "text-embedding-3-small",
+        "usage": {"prompt_tokens": 8, "total_tokens": 8}
+    })";
+    CollectingSink sink;
+    EXPECT_EQ(EmbeddingDecoder::Decode(response, 2, sink), 2);
+    EXPECT_EQ(sink.rows[1], (std::vector<double> {0.5, -1.25e-3, 3}));
+    EXPECT_EQ(sink.rows[0], (std::vector<double> {-0.0023064255, 0.009327292}));
+}
+
+TEST(EmbeddingDecoderTest, RejectsIndexesOutsideOfTheRequest) {
+    CollectingSink sink;
+    EXPECT_THROW(EmbeddingDecoder::Decode(R"({"data": [{"index": 2, "embedding": [1]}]})", 2, sink),
+                 std::runtime_error);
+    EXPECT_THROW(EmbeddingDecoder::Decode(R"({"data": [{"index": -1, "embedding": [1]}]})", 2, sink),
+                 std::runtime_error);
+    EXPECT_THROW(EmbeddingDecoder::Decode(
+                         R"({"data": [{"index": 1, "embedding": [1]}, {"index": 1, "embedding": [2]}]})", 2, sink),
+                 std::runtime_error);
+    // Items without an index fill the rows in order, so a surplus item is rejected as well.
+    EXPECT_THROW(EmbeddingDecoder::Decode(R"({"data": [{"embedding": [1]}, {"embedding": [2]}]})", 1, sink),
+                 std::runtime_error);
+    EXPECT_EQ(sink.rows.count(2), 0u);
+}
+
+TEST(EmbeddingDecoderTest, ParseNumberMatchesStrtod) {
+    const std::vector<std::string> numbers = {"0",        "-0.0",        "1e22",       "123456789012345678901",
+                                              "1.5E+300", "-2.5e-320",   "0.1",        "0.30000000000000004",
+                                              "9007199254740993", "-0.000001234567891234"};
+    for (const auto& number : numbers) {
+        size_t pos = 0;
+        EXPECT_EQ(EmbeddingDecoder::ParseNumber(number, pos), std::strtod(number.c_str(), nullptr)) << number;
+        EXPECT_EQ(pos, number.size());
+    }
+}
+
+TEST(EmbeddingDecoderTest, DecodeBase64Embeddings) {
+    // Long enough to take the vectorized path, with a length that leaves padding in the final group.
+    std::vector<float> values;
+    for (auto i = 0; i < 101; i++) {
+        values.push_back(static_cast<float>(i) * 0.37f - 11.0f);
+    }
+    const auto response = R"({"data": [{"index": 0, "embedding": ")" + EncodeBase64(values) + R"("}]})";
+    CollectingSink sink;
+    EXPECT_EQ(EmbeddingDecoder::Decode(response, 1, sink), 1);
+    ASSERT_EQ(sink.rows[0].size(), values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        EXPECT_EQ(sink.rows[0][i], static_cast<double>(values[i]));
+    }
+}
+
+TEST(EmbeddingDecoderTest, DecodeBase64Bytes) {
+    std::vector<uint8_t> bytes;
+    EmbeddingDecoder::DecodeBase64("aGVsbG8gd29ybGQ=", bytes);
+    EXPECT_EQ(std::string(bytes.begin(), bytes.end()), "hello world");
+    EmbeddingDecoder::DecodeBase64("TWFueSBoYW5kcyBtYWtlIGxpZ2h0IHdvcmsuIE1hbnkgaGFuZHMgbWFrZSBsaWdodCB3b3JrLg==",
+                                   bytes);
+    EXPECT_EQ(std::string(bytes.begin(), bytes.end()), "Many hands make light work. Many hands make light work.");
+    EXPECT_THROW(EmbeddingDecoder::DecodeBase64("aGVsbG8gd29yb*Q=", bytes), std::runtime_error);
+    EXPECT_THROW(EmbeddingDecoder::DecodeBase64("TWFueSBoYW5kcyBtYWtlIGxpZ2h0IHdvcmsuIE1hbnkgaGFu$HMgbWFrZSBsaWdodCB3b3JrLg==",
+                                                bytes),
+                 std::runtime_error);
+}
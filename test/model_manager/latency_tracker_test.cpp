@@ -0,0 +1,34 @@
+#include "flockmtl/model_manager/latency_tracker.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+using std::chrono::milliseconds;
+
+class LatencyTrackerTest : public ::testing::Test {
+protected:
+    void SetUp() override { LatencyTracker::Reset(); }
+};
+
+TEST_F(LatencyTrackerTest, NeedsMinimumSamples) {
+    for (size_t i = 1; i < LatencyTracker::kMinSamples; i++) {
+        LatencyTracker::Record("key", milliseconds(100));
+    }
+    EXPECT_FALSE(LatencyTracker::GetPercentile("key", 0.95).has_value());
+    LatencyTracker::Record("key", milliseconds(100));
+    EXPECT_EQ(LatencyTracker::GetPercentile("key", 0.95), milliseconds(100));
+}
+
+TEST_F(LatencyTrackerTest, PercentileOverSlidingWindow) {
+    for (auto i = 1; i <= 100; i++) {
+        LatencyTracker::Record("key", milliseconds(i * 10));
+    }
+    EXPECT_EQ(LatencyTracker::GetPercentile("key", 0.95), milliseconds(960));
+    EXPECT_EQ(LatencyTracker::GetPercentile("key", 0.5), milliseconds(510));
+
+    // Old latencies fall out of the window.
+    for (size_t i = 0; i < LatencyTracker::kWindowSize; i++) {
+        LatencyTracker::Record("key", milliseconds(20));
+    }
+    EXPECT_EQ(LatencyTracker::GetPercentile("key", 0.95), milliseconds(20));
+    EXPECT_FALSE(LatencyTracker::GetPercentile("other", 0.95).has_value());
+}
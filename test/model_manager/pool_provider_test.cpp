@@ -0,0 +1,44 @@
+#include "flockmtl/model_manager/model.hpp"
+#include "flockmtl/model_manager/providers/adapters/pool.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+TEST(PoolProviderTest, PicksLeastOutstandingRequestsPerWeight) {
+    // Backend 1 has twice the weight, so it takes two requests for every one on backend 0.
+    std::vector<PoolProvider::BackendLoad> loads = {{1, 0, 0, true}, {2, 0, 0, true}};
+    std::vector<int> assigned(2, 0);
+    for (auto i = 0; i < 30; i++) {
+        const auto index = PoolProvider::PickBackend(loads);
+        loads[index].outstanding_requests++;
+        assigned[index]++;
+    }
+    EXPECT_EQ(assigned[0], 10);
+    EXPECT_EQ(assigned[1], 20);
+}
+
+TEST(PoolProviderTest, BreaksTiesByOutstandingTokens) {
+    const std::vector<PoolProvider::BackendLoad> loads = {{1, 2, 9000, true}, {1, 2, 1000, true}};
+    EXPECT_EQ(PoolProvider::PickBackend(loads), 1u);
+}
+
+TEST(PoolProviderTest, SkipsUnhealthyBackendsUnlessNoneIsLeft) {
+    EXPECT_EQ(PoolProvider::PickBackend({{1, 0, 0, false}, {1, 5, 0, true}}), 1u);
+    EXPECT_EQ(PoolProvider::PickBackend({{1, 3, 0, false}, {1, 5, 0, false}}), 0u);
+}
+
+TEST(PoolProviderTest, RejectsPoolsThatReachThemselves) {
+    auto con = Config::GetConnection();
+    con.Query("INSERT OR REPLACE INTO flockmtl_config.FLOCKMTL_MODEL_USER_DEFINED_INTERNAL_TABLE VALUES "
+              "('self_pool', 'pool', 'pool', '{\"context_window\": 128000, \"max_output_tokens\": 1000, "
+              "\"backends\": [{\"model_name\": \"self_pool\"}]}'), "
+              "('outer_pool', 'pool', 'pool', '{\"context_window\": 128000, \"max_output_tokens\": 1000, "
+              "\"backends\": [{\"model_name\": \"self_pool\"}]}');");
+
+    // Both are rejected by looking up the backend's provider, before anything recurses into it.
+    EXPECT_THROW(Model(nlohmann::json {{"model_name", "self_pool"}}), std::invalid_argument);
+    EXPECT_THROW(Model(nlohmann::json {{"model_name", "outer_pool"}}), std::invalid_argument);
+
+    con.Query("DELETE FROM flockmtl_config.FLOCKMTL_MODEL_USER_DEFINED_INTERNAL_TABLE "
+              "WHERE model_name IN ('self_pool', 'outer_pool');");
+}
@@ -0,0 +1,112 @@
+#include "flockmtl/model_manager/profiler.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace flockmtl;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+class ProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override { Profiler::Reset(); }
+
+    const int client = 0;
+};
+
+TEST_F(ProfilerTest, LatencyBuckets) {
+    EXPECT_EQ(CallSiteProfile::GetLatencyBucket(microseconds(999)), 0u);
+    EXPECT_EQ(CallSiteProfile::GetLatencyBucket(milliseconds(1)), 1u);
+    EXPECT_EQ(CallSiteProfile::GetLatencyBucket(milliseconds(3)), 2u);
+    EXPECT_EQ(CallSiteProfile::GetLatencyBucket(milliseconds(4)), 3u);
+    EXPECT_EQ(CallSiteProfile::GetLatencyBucket(std::chrono::hours(100)), CallSiteProfile::kLatencyBuckets - 1);
+    EXPECT_EQ(CallSiteProfile::GetBucketUpperBound(3), milliseconds(8));
+}
+
+TEST_F(ProfilerTest, LatencyPercentiles) {
+    CallSiteProfile profile;
+    EXPECT_EQ(profile.GetLatencyPercentile(0.5), microseconds(0));
+    for (auto i = 0; i < 90; i++) {
+        profile.latency_histogram[CallSiteProfile::GetLatencyBucket(milliseconds(100))]++;
+    }
+    for (auto i = 0; i < 10; i++) {
+        profile.latency_histogram[CallSiteProfile::GetLatencyBucket(milliseconds(1500))]++;
+    }
+    profile.max_latency = milliseconds(1500);
+    EXPECT_EQ(profile.GetLatencyPercentile(0.5), milliseconds(128));
+    EXPECT_EQ(profile.GetLatencyPercentile(0.9), milliseconds(128));
+    // The slowest bucket is capped at the largest latency seen.
+    EXPECT_EQ(profile.GetLatencyPercentile(0.95), milliseconds(1500));
+}
+
+TEST_F(ProfilerTest, AttributesEventsToScope) {
+    Profiler::RecordRequest(milliseconds(5), 10, 10, 0, false);
+    {
+        const Profiler::Scope scope(&client, 1, "llm_filter");
+        Profiler::RecordBatch(4);
+        Profiler::RecordBatch(2);
+        Profiler::RecordRequest(milliseconds(5), 100, 20, 0.25, false);
+        Profiler::RecordRetry();
+        {
+            const Profiler::Scope nested(&client, 1, "llm_complete");
+            Profiler::RecordCacheHit(3);
+        }
+        Profiler::RecordCascade(6, 2);
+        // Another thread only records once the scope is carried over to it.
+        std::thread([context = Profiler::Current()] {
+            Profiler::RecordRequest(milliseconds(7), 1, 1, 0, false);
+            const Profiler::Scope scope(context);
+            Profiler::RecordRequest(milliseconds(9), 50, 5, 0.5, true);
+        }).join();
+    }
+    Profiler::RecordRetry();
+
+    const auto profiles = Profiler::GetProfiles(&client);
+    ASSERT_EQ(profiles.size(), 1u);
+    EXPECT_EQ(profiles[0].query_id, 1u);
+    ASSERT_EQ(profiles[0].call_sites.size(), 2u);
+
+    const auto& filter = profiles[0].call_sites.at("llm_filter");
+    EXPECT_EQ(filter.batches, 2);
+    EXPECT_EQ(filter.tuples, 6);
+    EXPECT_EQ(filter.max_batch_size, 4);
+    EXPECT_EQ(filter.requests, 2);
+    EXPECT_EQ(filter.failed_requests, 1);
+    EXPECT_EQ(filter.prompt_tokens, 150);
+    EXPECT_EQ(filter.completion_tokens, 25);
+    EXPECT_DOUBLE_EQ(filter.cost, 0.75);
+    EXPECT_EQ(filter.retries, 1);
+    EXPECT_EQ(filter.total_latency, milliseconds(14));
+    EXPECT_EQ(filter.max_latency, milliseconds(9));
+    EXPECT_EQ(filter.cascaded_tuples, 6);
+    EXPECT_EQ(filter.escalations, 2);
+    EXPECT_EQ(profiles[0].call_sites.at("llm_complete").cache_hits, 3);
+}
+
+TEST_F(ProfilerTest, KeepsLatestQueries) {
+    for (uint64_t query_id = 1; query_id <= Profiler::kMaxQueries + 2; query_id++) {
+        const Profiler::Scope scope(&client, query_id, "llm_reduce");
+        Profiler::RecordBatch(1);
+    }
+    const auto profiles = Profiler::GetProfiles(&client);
+    ASSERT_EQ(profiles.size(), Profiler::kMaxQueries);
+    EXPECT_EQ(profiles.front().query_id, 3u);
+    EXPECT_EQ(profiles.back().query_id, Profiler::kMaxQueries + 2);
+
+    const int other_client = 0;
+    EXPECT_TRUE(Profiler::GetProfiles(&other_client).empty());
+}
+
+TEST_F(ProfilerTest, FunctionScopeCarriesOverToAnotherThread) {
+    QueryBudgets budgets;
+    const std::atomic<bool> cancelled {true};
+    const RequestCancellation::Scope cancellation(&cancelled);
+    const FunctionScope scope(&budgets, &client, 1, "llm_filter", {100, 0});
+
+    std::thread([context = FunctionScope::Current()] {
+        const FunctionScope carried(context);
+        Profiler::RecordBatch(2);
+        EXPECT_TRUE(RequestCancellation::IsCancelled());
+        EXPECT_NE(QueryBudgets::GetCurrentQueryBudget(), nullptr);
+    }).join();
+    EXPECT_EQ(Profiler::GetProfiles(&client)[0].call_sites.at("llm_filter").tuples, 2);
+}
@@ -0,0 +1,135 @@
+#include "../mock_server/mock_server.hpp"
+#include "flockmtl/model_manager/providers/adapters/ollama.hpp"
+#include "flockmtl/model_manager/providers/adapters/openai.hpp"
+#include "flockmtl/model_manager/rate_limiter.hpp"
+#include <gtest/gtest.h>
+
+namespace flockmtl {
+
+// Drives the real providers, Session and curl against the in-process mock server.
+class ProviderHttpTest : public ::testing::Test {
+protected:
+    ModelDetails GetModelDetails(const std::string& provider) const {
+        ModelDetails model_details;
+        model_details.model_name = "mock_model";
+        model_details.model = "mock";
+        model_details.provider_name = provider;
+        model_details.context_window = 128000;
+        model_details.max_output_tokens = 1000;
+        model_details.temperature = 0;
+        model_details.encoding_format = "float";
+        model_details.dimensions = 0;
+        model_details.max_retries = 3;
+        model_details.connect_timeout = std::chrono::milliseconds(2000);
+        model_details.request_timeout = std::chrono::milliseconds(5000);
+        if (provider == OLLAMA) {
+            model_details.secret = {{"api_url", server_.GetOllamaUrl()}};
+        } else {
+            model_details.secret = {{"api_key", "mock-key"}, {"base_url", server_.GetOpenAIUrl()}};
+        }
+        return model_details;
+    }
+
+    MockServer server_;
+};
+
+TEST_F(ProviderHttpTest, RetriesRateLimitedCompletions) {
+    MockServer::Options options;
+    options.rate_limit_next = 2;
+    options.retry_after = std::chrono::milliseconds(1);
+    server_.SetOptions(options);
+
+    OpenAIProvider provider(GetModelDetails(OPENAI));
+    const auto response = provider.CallComplete("<tuple><col>a</col></tuple>\n<tuple><col>1</col></tuple>\n", true);
+    EXPECT_EQ(response["tuples"], nlohmann::json::array({true}));
+
+    const auto stats = server_.GetStats();
+    EXPECT_EQ(stats.requests, 3);
+    EXPECT_EQ(stats.rate_limited, 2);
+    EXPECT_GT(stats.prompt_tokens, 0);
+}
+
+TEST_F(ProviderHttpTest, ChargesRetriesAgainstTheRateLimit) {
+    RateLimiter::Reset();
+    MockServer::Options options;
+    options.rate_limit_next = 2;
+    options.retry_after = std::chrono::milliseconds(1);
+    server_.SetOptions(options);
+
+    // 3 requests per minute leave room for 2.85 requests, and each of the two retries takes one.
+    auto model_details = GetModelDetails(OPENAI);
+    model_details.requests_per_minute = 3;
+    OpenAIProvider provider(model_details);
+    provider.CallComplete("prompt", false);
+    EXPECT_EQ(server_.GetStats().requests, 3);
+
+    const RateLimits limits {model_details.requests_per_minute, 0};
+    EXPECT_FALSE(RateLimiter::TryAcquire(IProvider::GetRateLimitKey(model_details), limits, 0).has_value());
+    RateLimiter::Reset();
+}
+
+TEST_F(ProviderHttpTest, GivesUpAfterMaxRetries) {
+    MockServer::Options options;
+    options.rate_limit_next = 10;
+    options.retry_after = std::chrono::milliseconds(1);
+    server_.SetOptions(options);
+
+    // Still rate limited after every retry: a pool would fail over to its next backend.
+    OpenAIProvider provider(GetModelDetails(OPENAI));
+    EXPECT_THROW(provider.CallComplete("prompt", false), ProviderUnavailableError);
+    EXPECT_EQ(server_.GetStats().requests, 4);
+}
+
+TEST_F(ProviderHttpTest, TruncatedCompletionsExceedMaxOutputTokens) {
+    MockServer::Options options;
+    options.truncate = true;
+    server_.SetOptions(options);
+
+    OpenAIProvider openai(GetModelDetails(OPENAI));
+    EXPECT_THROW(openai.CallComplete("prompt", true), ExceededMaxOutputTokensError);
+    OllamaProvider ollama(GetModelDetails(OLLAMA));
+    EXPECT_THROW(ollama.CallComplete("prompt", true), ExceededMaxOutputTokensError);
+}
+
+TEST_F(ProviderHttpTest, EmbeddingsMatchInEveryEncoding) {
+    const std::vector<std::string> inputs = {"duck", "goose"};
+    auto model_details = GetModelDetails(OPENAI);
+    model_details.encoding_format = "base64";
+    OpenAIProvider openai(model_details);
+    std::vector<std::vector<double>> decoded(inputs.size());
+    struct Sink : EmbeddingSink {
+        explicit Sink(std::vector<std::vector<double>>& rows) : rows(rows) {}
+        void Write(size_t row, const double* values, size_t count) override { rows[row].assign(values, values + count); }
+        std::vector<std::vector<double>>& rows;
+    } sink(decoded);
+    openai.CallEmbeddingInto(inputs, sink);
+
+    OllamaProvider ollama(GetModelDetails(OLLAMA));
+    const auto ollama_embeddings = ollama.CallEmbedding(inputs);
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+        const auto expected = MockServer::Embed(inputs[i], 8);
+        ASSERT_EQ(decoded[i].size(), expected.size());
+        for (size_t j = 0; j < expected.size(); j++) {
+            EXPECT_FLOAT_EQ(decoded[i][j], expected[j]);
+            EXPECT_FLOAT_EQ(ollama_embeddings[i][j].get<float>(), expected[j]);
+        }
+    }
+}
+
+TEST_F(ProviderHttpTest, EmbeddingsHaveTheRequestedDimensions) {
+    auto model_details = GetModelDetails(OPENAI);
+    model_details.dimensions = 3;
+    OpenAIProvider openai(model_details);
+    const auto embeddings = openai.CallEmbedding({"duck"});
+    ASSERT_EQ(embeddings.size(), 1);
+    EXPECT_EQ(embeddings[0].size(), 3);
+}
+
+TEST_F(ProviderHttpTest, OllamaCompletionsUseTheHandler) {
+    server_.SetCompletionHandler([](const std::string& prompt, bool) { return "{\"tuples\": [\"" + prompt + "\"]}"; });
+    OllamaProvider provider(GetModelDetails(OLLAMA));
+    EXPECT_EQ(provider.CallComplete("quack", true)["tuples"][0], "quack");
+}
+
+} // namespace flockmtl
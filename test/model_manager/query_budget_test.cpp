@@ -0,0 +1,65 @@
+#include "flockmtl/model_manager/query_budget.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+TEST(QueryBudgetTest, Cost) {
+    EXPECT_DOUBLE_EQ(QueryBudget::GetCost(1000000, 0, 2.5, 10), 2.5);
+    EXPECT_DOUBLE_EQ(QueryBudget::GetCost(2000, 500, 2.5, 10), 0.01);
+    EXPECT_DOUBLE_EQ(QueryBudget::GetCost(2000, 500, 0, 0), 0);
+}
+
+TEST(QueryBudgetTest, AbortsOnceALimitWouldBeExceeded) {
+    QueryBudget tokens({1000, 0});
+    EXPECT_NO_THROW(tokens.Check(1000, 0));
+    tokens.Charge(900, 5);
+    EXPECT_NO_THROW(tokens.Check(100, 0));
+    EXPECT_THROW(tokens.Check(101, 0), std::runtime_error);
+    EXPECT_EQ(tokens.GetTokens(), 900);
+
+    QueryBudget cost({0, 1});
+    cost.Charge(1000000, 0.75);
+    EXPECT_NO_THROW(cost.Check(1000000, 0.25));
+    EXPECT_THROW(cost.Check(1, 0.5), std::runtime_error);
+    EXPECT_DOUBLE_EQ(cost.GetCost(), 0.75);
+}
+
+TEST(QueryBudgetTest, SharedWithinQuery) {
+    EXPECT_EQ(QueryBudgets::GetCurrentQueryBudget(), nullptr);
+
+    QueryBudgets budgets;
+    std::shared_ptr<QueryBudget> budget;
+    {
+        const QueryBudgets::Scope scope({&budgets, 1, {0, 0}});
+        EXPECT_EQ(QueryBudgets::GetCurrentQueryBudget(), nullptr);
+    }
+    {
+        const QueryBudgets::Scope scope({&budgets, 1, {100, 0}});
+        budget = QueryBudgets::GetCurrentQueryBudget();
+        ASSERT_NE(budget, nullptr);
+        EXPECT_EQ(budget, QueryBudgets::GetCurrentQueryBudget());
+    }
+    {
+        const QueryBudgets::Scope scope({&budgets, 1, {100, 0}});
+        EXPECT_EQ(budget, QueryBudgets::GetCurrentQueryBudget());
+    }
+    {
+        const QueryBudgets::Scope scope({&budgets, 2, {100, 0}});
+        EXPECT_NE(budget, QueryBudgets::GetCurrentQueryBudget());
+    }
+    EXPECT_EQ(QueryBudgets::GetCurrentQueryBudget(), nullptr);
+}
+
+TEST(QueryBudgetTest, DroppedWhenTheQueryEnds) {
+    QueryBudgets budgets;
+    const QueryBudgets::Scope scope({&budgets, 1, {100, 0}});
+    const auto budget = QueryBudgets::GetCurrentQueryBudget();
+    const auto retry_budget = QueryBudgets::GetCurrentRetryBudget("gpt-4o", 2);
+    EXPECT_EQ(budget.use_count(), 2);
+    EXPECT_EQ(retry_budget.use_count(), 2);
+
+    budgets.EndQuery();
+    EXPECT_EQ(budget.use_count(), 1);
+    EXPECT_EQ(retry_budget.use_count(), 1);
+    EXPECT_NE(budget, QueryBudgets::GetCurrentQueryBudget());
+}
@@ -0,0 +1,58 @@
+#include "flockmtl/model_manager/rate_limiter.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+class RateLimiterTest : public ::testing::Test {
+protected:
+    void SetUp() override { RateLimiter::Reset(); }
+
+    static double SecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+TEST_F(RateLimiterTest, UnlimitedNeverBlocks) {
+    for (auto i = 0; i < 1000; i++) {
+        EXPECT_EQ(RateLimiter::Acquire("openai\nsecret\nmodel", {}, 1000), 0);
+    }
+}
+
+TEST_F(RateLimiterTest, RequestsQueueOnceBudgetIsSpent) {
+    // 6000 RPM at 95% utilization: 5700 requests up front, then one every ~10.5ms.
+    const RateLimits limits {6000, 0};
+    const auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < 5700; i++) {
+        RateLimiter::Acquire("key", limits, 0);
+    }
+    EXPECT_LT(SecondsSince(start), 0.5);
+
+    const auto queued = std::chrono::steady_clock::now();
+    for (auto i = 0; i < 5; i++) {
+        RateLimiter::Acquire("key", limits, 0);
+    }
+    EXPECT_GE(SecondsSince(queued), 0.04);
+}
+
+TEST_F(RateLimiterTest, TokensAreReconciledWithUsage) {
+    // 60000 TPM: 57000 tokens up front, refilled at 950 tokens per second.
+    const RateLimits limits {0, 60000};
+    EXPECT_EQ(RateLimiter::Acquire("key", limits, 50000), 50000);
+    // The call only used 10000 tokens, so 40000 are handed back and the next acquire does not wait.
+    RateLimiter::Reconcile("key", 50000, 10000);
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(RateLimiter::Acquire("key", limits, 45000), 45000);
+    EXPECT_LT(SecondsSince(start), 0.5);
+}
+
+TEST_F(RateLimiterTest, OversizedRequestIsClampedToCapacity) {
+    const RateLimits limits {0, 1000};
+    EXPECT_EQ(RateLimiter::Acquire("key", limits, 5000), 950);
+}
+
+TEST_F(RateLimiterTest, TryAcquireNeverWaits) {
+    const RateLimits limits {0, 1000};
+    EXPECT_EQ(RateLimiter::TryAcquire("key", limits, 900), 900);
+    EXPECT_FALSE(RateLimiter::TryAcquire("key", limits, 900).has_value());
+    EXPECT_EQ(RateLimiter::TryAcquire("key", {}, 900), 0);
+}
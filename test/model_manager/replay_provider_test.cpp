@@ -0,0 +1,96 @@
+#include "flockmtl/model_manager/model.hpp"
+#include "flockmtl/model_manager/providers/adapters/replay.hpp"
+#include "flockmtl_extension.hpp"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+using std::chrono::milliseconds;
+
+class ReplayLogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = ::testing::TempDir() + "flockmtl_replay_test.jsonl";
+        std::remove(path_.c_str());
+        ReplayLog::Reset();
+    }
+    void TearDown() override {
+        std::remove(path_.c_str());
+        ReplayLog::Reset();
+    }
+
+    std::string path_;
+};
+
+TEST_F(ReplayLogTest, RecordedExchangesSurviveReload) {
+    const auto completion = ReplayLog::CompletionRequest("Summarize <tuple>x</tuple>", true);
+    const auto embedding = ReplayLog::EmbeddingRequest({"a", "b"});
+    {
+        ReplayLog log(path_);
+        EXPECT_FALSE(log.Find(completion).has_value());
+        log.Append(completion, {{"items", {"short"}}});
+        log.Append(embedding, {{0.5, 1.0}, {2.0, 3.0}});
+        log.Append(completion, {{"items", {"shorter"}}});
+    }
+
+    const ReplayLog log(path_);
+    EXPECT_EQ(log.Size(), 2u);
+    EXPECT_EQ(log.Find(completion), nlohmann::json({{"items", {"shorter"}}}));
+    EXPECT_EQ(log.Find(embedding)->at(1).at(0), 2.0);
+    // Requests only match when everything, including the response format, is the same.
+    EXPECT_FALSE(log.Find(ReplayLog::CompletionRequest("Summarize <tuple>x</tuple>", false)).has_value());
+}
+
+TEST_F(ReplayLogTest, OpenSharesOneLogPerFile) {
+    const auto log = ReplayLog::Open(path_);
+    EXPECT_EQ(log, ReplayLog::Open(path_));
+    log->Append(ReplayLog::CompletionRequest("p", false), "r");
+    EXPECT_EQ(ReplayLog::Open(path_)->Find(ReplayLog::CompletionRequest("p", false)), nlohmann::json("r"));
+}
+
+TEST_F(ReplayLogTest, RejectsMalformedFiles) {
+    std::ofstream(path_) << "{\"request\": {}}\n";
+    EXPECT_THROW(ReplayLog log(path_), std::runtime_error);
+}
+
+TEST(ReplayProviderTest, SyntheticLatencyStaysWithinJitter) {
+    EXPECT_EQ(ReplayProvider::GetSyntheticLatency(milliseconds(100), milliseconds(0)), milliseconds(100));
+    for (auto i = 0; i < 100; i++) {
+        const auto latency = ReplayProvider::GetSyntheticLatency(milliseconds(100), milliseconds(30));
+        EXPECT_GE(latency, milliseconds(70));
+        EXPECT_LE(latency, milliseconds(130));
+        EXPECT_GE(ReplayProvider::GetSyntheticLatency(milliseconds(10), milliseconds(50)), milliseconds(0));
+    }
+}
+
+TEST(ReplayProviderTest, RejectsRecordingAReplayModel) {
+    auto con = Config::GetConnection();
+    con.Query("INSERT OR REPLACE INTO flockmtl_config.FLOCKMTL_MODEL_USER_DEFINED_INTERNAL_TABLE VALUES "
+              "('self_recorder', 'gpt-4o', 'replay', '{\"context_window\": 128000, \"max_output_tokens\": 1000, "
+              "\"replay_file\": \"" + ::testing::TempDir() + "flockmtl_self_recorder.jsonl\", "
+              "\"replay_mode\": \"record\", \"backend\": {\"model_name\": \"self_recorder\"}}');");
+
+    // Rejected by looking up the backend's provider, before anything recurses into it.
+    EXPECT_THROW(Model(nlohmann::json {{"model_name", "self_recorder"}}), std::invalid_argument);
+
+    con.Query("DELETE FROM flockmtl_config.FLOCKMTL_MODEL_USER_DEFINED_INTERNAL_TABLE "
+              "WHERE model_name = 'self_recorder';");
+}
+
+TEST(ReplayProviderTest, HonorsEnableExternalAccess) {
+    const auto previous_db = Config::db;
+    {
+        duckdb::DuckDB db(nullptr);
+        db.LoadExtension<duckdb::FlockmtlExtension>();
+        duckdb::Connection con(db);
+        con.Query("CREATE MODEL('replayed', 'gpt-4o', 'replay', {\"context_window\": 128000, "
+                  "\"max_output_tokens\": 1000, \"replay_file\": \"" +
+                  ::testing::TempDir() + "flockmtl_replayed.jsonl\"})");
+        EXPECT_NO_THROW(Model(nlohmann::json {{"model_name", "replayed"}}));
+
+        con.Query("SET enable_external_access = false");
+        EXPECT_THROW(Model(nlohmann::json {{"model_name", "replayed"}}), std::runtime_error);
+    }
+    Config::db = previous_db;
+}
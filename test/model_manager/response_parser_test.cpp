@@ -0,0 +1,47 @@
+#include "flockmtl/model_manager/providers/response_parser.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+TEST(ResponseParserTest, ParseChatCompletion) {
+    const std::string response = R"({
+        "id": "chatcmpl-1",
+        "choices": [{"index": 0, "message": {"role": "assistant", "content": "{\"tuples\": [true]}", "refusal": null},
+                     "finish_reason": "stop"}],
+        "usage": {"prompt_tokens": 12, "completion_tokens": 5, "total_tokens": 17}
+    })";
+    const auto completion = ResponseParser::ParseChatCompletion(response);
+    EXPECT_EQ(completion.content, "{\"tuples\": [true]}");
+    EXPECT_EQ(completion.finish_reason, "stop");
+    EXPECT_FALSE(completion.refusal.has_value());
+    EXPECT_EQ(completion.usage.prompt_tokens, 12);
+    EXPECT_EQ(completion.usage.completion_tokens, 5);
+}
+
+TEST(ResponseParserTest, ParseChatCompletionRefusal) {
+    const std::string response =
+        R"({"choices": [{"message": {"content": null, "refusal": "no"}, "finish_reason": "stop"}]})";
+    const auto completion = ResponseParser::ParseChatCompletion(response);
+    ASSERT_TRUE(completion.refusal.has_value());
+    EXPECT_EQ(*completion.refusal, "no");
+    EXPECT_EQ(completion.content, "");
+}
+
+TEST(ResponseParserTest, ParseOllamaGenerate) {
+    const std::string response =
+        R"({"model": "llama3", "response": "hi", "done": true, "done_reason": "stop", "prompt_eval_count": 3, "eval_count": 1})";
+    const auto completion = ResponseParser::ParseOllamaGenerate(response);
+    EXPECT_EQ(completion.content, "hi");
+    EXPECT_EQ(completion.finish_reason, "stop");
+    EXPECT_EQ(completion.usage.prompt_tokens, 3);
+    EXPECT_EQ(completion.usage.completion_tokens, 1);
+
+    EXPECT_EQ(ResponseParser::ParseOllamaGenerate(R"({"response": "", "done": false})").finish_reason, "incomplete");
+}
+
+TEST(ResponseParserTest, GetError) {
+    EXPECT_EQ(*ResponseParser::GetError(R"({"error": "model not found"})"), "model not found");
+    EXPECT_EQ(*ResponseParser::GetError(R"({"error": {"message": "quota", "type": "insufficient_quota"}})"), "quota");
+    EXPECT_EQ(*ResponseParser::GetError(R"({"error": {"code": 500}})"), R"({"code": 500})");
+    EXPECT_FALSE(ResponseParser::GetError(R"({"choices": []})").has_value());
+}
@@ -0,0 +1,95 @@
+#include "flockmtl/model_manager/providers/handlers/retry_policy.hpp"
+#include "flockmtl/model_manager/query_budget.hpp"
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+using std::chrono::milliseconds;
+
+TEST(RetryPolicyTest, ParseHeadersKeepsLastResponse) {
+    const auto headers = RetryPolicy::ParseHeaders("HTTP/1.1 100 Continue\r\nX-Old: 1\r\n\r\n"
+                                                   "HTTP/2 429\r\nRetry-After: 3\r\nX-RateLimit-Reset-Tokens:  6m0s\r\n\r\n");
+    EXPECT_EQ(headers.count("x-old"), 0);
+    EXPECT_EQ(headers.at("retry-after"), "3");
+    EXPECT_EQ(headers.at("x-ratelimit-reset-tokens"), "6m0s");
+}
+
+TEST(RetryPolicyTest, ParseDuration) {
+    EXPECT_EQ(RetryPolicy::ParseDuration("20ms"), milliseconds(20));
+    EXPECT_EQ(RetryPolicy::ParseDuration("1.5s"), milliseconds(1500));
+    EXPECT_EQ(RetryPolicy::ParseDuration("6m0s"), milliseconds(360000));
+    EXPECT_FALSE(RetryPolicy::ParseDuration("soon").has_value());
+    EXPECT_FALSE(RetryPolicy::ParseDuration("").has_value());
+}
+
+TEST(RetryPolicyTest, ServerDelayPrefersExplicitHints) {
+    EXPECT_EQ(RetryPolicy::GetServerDelay({{"retry-after-ms", "250"}, {"retry-after", "9"}}), milliseconds(250));
+    EXPECT_EQ(RetryPolicy::GetServerDelay({{"retry-after", "2"}}), milliseconds(2000));
+    EXPECT_EQ(RetryPolicy::GetServerDelay({{"x-ratelimit-remaining-requests", "0"},
+                                           {"x-ratelimit-reset-requests", "120ms"},
+                                           {"x-ratelimit-remaining-tokens", "0"},
+                                           {"x-ratelimit-reset-tokens", "1s"}}),
+              milliseconds(1000));
+    // Budgets that are not exhausted give no hint.
+    EXPECT_FALSE(RetryPolicy::GetServerDelay({{"x-ratelimit-remaining-tokens", "10"},
+                                              {"x-ratelimit-reset-tokens", "1s"}})
+                         .has_value());
+}
+
+TEST(RetryPolicyTest, IsRetryable) {
+    EXPECT_TRUE(RetryPolicy::IsRetryable(CURLE_OPERATION_TIMEDOUT, 0, ""));
+    EXPECT_FALSE(RetryPolicy::IsRetryable(CURLE_URL_MALFORMAT, 0, ""));
+    EXPECT_TRUE(RetryPolicy::IsRetryable(CURLE_OK, 429, R"({"error":{"code":"rate_limit_exceeded"}})"));
+    EXPECT_FALSE(RetryPolicy::IsRetryable(CURLE_OK, 429, R"({"error":{"code":"insufficient_quota"}})"));
+    EXPECT_TRUE(RetryPolicy::IsRetryable(CURLE_OK, 503, ""));
+    EXPECT_FALSE(RetryPolicy::IsRetryable(CURLE_OK, 400, ""));
+    EXPECT_FALSE(RetryPolicy::IsRetryable(CURLE_OK, 200, ""));
+}
+
+TEST(RetryPolicyTest, IsUnavailable) {
+    EXPECT_TRUE(RetryPolicy::IsUnavailable(CURLE_COULDNT_CONNECT, 0));
+    EXPECT_TRUE(RetryPolicy::IsUnavailable(CURLE_OPERATION_TIMEDOUT, 0));
+    EXPECT_TRUE(RetryPolicy::IsUnavailable(CURLE_OK, 429));
+    EXPECT_TRUE(RetryPolicy::IsUnavailable(CURLE_OK, 503));
+    EXPECT_FALSE(RetryPolicy::IsUnavailable(CURLE_ABORTED_BY_CALLBACK, 0));
+    EXPECT_FALSE(RetryPolicy::IsUnavailable(CURLE_OK, 400));
+    EXPECT_FALSE(RetryPolicy::IsUnavailable(CURLE_OK, 200));
+}
+
+TEST(RetryPolicyTest, BackoffStaysWithinBounds) {
+    RequestOptions options;
+    options.base_delay = milliseconds(100);
+    options.max_delay = milliseconds(1000);
+    for (auto attempt = 0; attempt < 30; attempt++) {
+        const auto step = std::min<int64_t>(1000, 100LL << std::min(attempt, 20));
+        const auto delay = RetryPolicy::GetBackoff(attempt, options).count();
+        EXPECT_GE(delay, step / 2);
+        EXPECT_LE(delay, step);
+    }
+    // Server hints are honoured but still capped.
+    EXPECT_EQ(RetryPolicy::GetDelay(0, {{"retry-after", "120"}}, options), milliseconds(1000));
+}
+
+TEST(RetryPolicyTest, RetryBudgetIsSharedWithinQuery) {
+    const auto unscoped = QueryBudgets::GetCurrentRetryBudget("gpt-4o", 2);
+    EXPECT_NE(unscoped, QueryBudgets::GetCurrentRetryBudget("gpt-4o", 2));
+
+    QueryBudgets budgets;
+    std::shared_ptr<RetryBudget> budget;
+    {
+        const QueryBudgets::Scope scope({&budgets, 1, {}});
+        budget = QueryBudgets::GetCurrentRetryBudget("gpt-4o", 2);
+        EXPECT_EQ(budget, QueryBudgets::GetCurrentRetryBudget("gpt-4o", 2));
+        EXPECT_TRUE(budget->TryConsume());
+        EXPECT_TRUE(budget->TryConsume());
+        EXPECT_FALSE(budget->TryConsume());
+        // Each model of the query has its own budget.
+        const auto other_model = QueryBudgets::GetCurrentRetryBudget("llama3", 1);
+        EXPECT_NE(budget, other_model);
+        EXPECT_EQ(other_model->Remaining(), 1);
+    }
+    {
+        const QueryBudgets::Scope scope({&budgets, 2, {}});
+        EXPECT_NE(budget, QueryBudgets::GetCurrentRetryBudget("gpt-4o", 2));
+    }
+    EXPECT_TRUE(RetryBudget(-1).TryConsume());
+}
@@ -0,0 +1,115 @@
+#include "flockmtl/model_manager/semantic_cache.hpp"
+#include "flockmtl/core/config.hpp"
+#include "flockmtl_extension.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace flockmtl;
+
+TEST(SemanticCache, ReusesResponsesOfSimilarPrompts) {
+    SemanticCache cache;
+    cache.Insert("gpt-4o|embedding|text", {1, 0, 0}, "Q3 returns were flat.");
+    cache.Insert("gpt-4o|embedding|text", {0, 1, 0}, "Ducks migrate south.");
+
+    // cosine similarity 0.995 with the first prompt, whatever the scale
+    const auto hit = cache.Lookup("gpt-4o|embedding|text", {10, 1, 0}, 0.95);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(*hit, "Q3 returns were flat.");
+
+    // 0.707 is not similar enough
+    EXPECT_FALSE(cache.Lookup("gpt-4o|embedding|text", {1, 1, 0}, 0.95).has_value());
+
+    const auto statistics = cache.GetStatistics();
+    EXPECT_EQ(statistics.entries, 2);
+    EXPECT_EQ(statistics.lookups, 2);
+    EXPECT_EQ(statistics.hits, 1);
+}
+
+TEST(SemanticCache, PicksTheMostSimilarPrompt) {
+    SemanticCache cache;
+    cache.Insert("key", {1, 0.2f, 0}, "close");
+    cache.Insert("key", {1, 0.01f, 0}, "closest");
+    EXPECT_EQ(*cache.Lookup("key", {1, 0, 0}, 0.9), "closest");
+}
+
+TEST(SemanticCache, KeepsKeysAndDimensionsApart) {
+    SemanticCache cache;
+    cache.Insert("gpt-4o|embedding|text", {1, 0}, "text");
+    EXPECT_FALSE(cache.Lookup("gpt-4o|embedding|json", {1, 0}, 0.5).has_value());
+    EXPECT_FALSE(cache.Lookup("gpt-4o|other-embedding|text", {1, 0}, 0.5).has_value());
+    EXPECT_FALSE(cache.Lookup("gpt-4o|embedding|text", {1, 0, 0}, 0.5).has_value());
+}
+
+TEST(SemanticCache, KeepsCachesApart) {
+    SemanticCache cache;
+    SemanticCache other;
+    cache.Insert("key", {1, 0}, "first database");
+    EXPECT_FALSE(other.Lookup("key", {1, 0}, 0.5).has_value());
+    EXPECT_EQ(other.GetStatistics().entries, 0);
+}
+
+TEST(SemanticCache, EvictsTheOldestEntriesOfAKey) {
+    SemanticCache cache;
+    for (size_t i = 0; i <= SemanticCache::kMaxEntriesPerKey; i++) {
+        cache.Insert("key", {static_cast<float>(i), 1}, i);
+    }
+    cache.Insert("other", {0, 1}, "kept");
+    EXPECT_EQ(cache.GetStatistics().entries, static_cast<int64_t>(SemanticCache::kMaxEntriesPerKey) + 1);
+    // the first entry, {0, 1}, is gone
+    EXPECT_FALSE(cache.Lookup("key", {0, 1}, 0.9999).has_value());
+    EXPECT_EQ(*cache.Lookup("other", {0, 1}, 0.9999), "kept");
+}
+
+TEST(SemanticCache, SupportsConcurrentLookupsAndInserts) {
+    SemanticCache cache;
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 8; thread++) {
+        threads.emplace_back([&cache, thread] {
+            const auto key = "key" + std::to_string(thread % 2);
+            for (int i = 0; i < 200; i++) {
+                const std::vector<float> embedding = {static_cast<float>(thread), static_cast<float>(i), 1};
+                if (!cache.Lookup(key, embedding, 0.999999).has_value()) {
+                    cache.Insert(key, embedding, i);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const auto statistics = cache.GetStatistics();
+    EXPECT_EQ(statistics.lookups, 8 * 200);
+    EXPECT_EQ(statistics.entries + statistics.hits, 8 * 200);
+}
+
+TEST(SemanticCache, StartsAKeyOverWhenItsDimensionsChange) {
+    SemanticCache cache;
+    cache.Insert("key", {1, 0}, "two dimensions");
+    cache.Insert("key", {1, 0, 0}, "three dimensions");
+    EXPECT_FALSE(cache.Lookup("key", {1, 0}, 0.5).has_value());
+    EXPECT_EQ(*cache.Lookup("key", {1, 0, 0}, 0.5), "three dimensions");
+    EXPECT_EQ(cache.GetStatistics().entries, 1);
+}
+
+TEST(SemanticCache, ResolvesTheSettingsOncePerQuery) {
+    const auto previous_db = Config::db;
+    {
+        duckdb::DuckDB db(nullptr);
+        db.LoadExtension<duckdb::FlockmtlExtension>();
+        duckdb::Connection con(db);
+        auto& context = *con.context;
+        EXPECT_TRUE(con.Query("SET flockmtl_semantic_cache_threshold = 0.9")->GetError().empty());
+
+        auto options = Config::GetSemanticCacheOptions(context);
+        EXPECT_TRUE(options.model_name.empty());
+        EXPECT_EQ(options.cache, nullptr);
+        EXPECT_DOUBLE_EQ(options.threshold, 0.9);
+
+        // Settings changed within the query are only seen by the next one
+        context.config.set_variables["flockmtl_semantic_cache_threshold"] = duckdb::Value::DOUBLE(0.5);
+        EXPECT_DOUBLE_EQ(Config::GetSemanticCacheOptions(context).threshold, 0.9);
+        EXPECT_TRUE(con.Query("SELECT 1")->GetError().empty());
+        EXPECT_DOUBLE_EQ(Config::GetSemanticCacheOptions(context).threshold, 0.5);
+    }
+    Config::db = previous_db;
+}
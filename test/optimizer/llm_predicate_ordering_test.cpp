@@ -0,0 +1,80 @@
+#include "flockmtl/optimizer/llm_predicate_ordering.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+
+using namespace flockmtl;
+
+// Counts the rows stand-ins for the LLM functions are evaluated on. Tests that disable DuckDB's own filter reordering
+// and pushdown check that the FlockMTL rule alone keeps them away from rows a cheap predicate drops.
+class LlmPredicateOrderingTest : public ::testing::Test {
+protected:
+    static inline std::atomic<int64_t> evaluated_rows {0};
+
+    static void CountRows(duckdb::DataChunk& args, duckdb::ExpressionState&, duckdb::Vector& result) {
+        evaluated_rows += static_cast<int64_t>(args.size());
+        result.Reference(duckdb::Value::BOOLEAN(true));
+    }
+
+    void SetUp() override {
+        duckdb::DBConfig config;
+        config.optimizer_extensions.push_back(LlmPredicateOrdering::GetExtension());
+        db = std::make_unique<duckdb::DuckDB>(nullptr, &config);
+        // llm_custom is not a FlockMTL function and must be left where it is.
+        for (const auto* name : {"llm_filter", "llm_complete", "llm_custom"}) {
+            duckdb::ExtensionUtil::RegisterFunction(
+                *db->instance,
+                duckdb::ScalarFunction(name, {duckdb::LogicalType::BIGINT}, duckdb::LogicalType::BOOLEAN, CountRows,
+                                       nullptr, nullptr, nullptr, nullptr,
+                                       duckdb::LogicalType(duckdb::LogicalTypeId::INVALID),
+                                       duckdb::FunctionStability::VOLATILE));
+        }
+        con = std::make_unique<duckdb::Connection>(*db);
+        evaluated_rows = 0;
+    }
+
+    void DisableDuckDbReordering() { con->Query("SET disabled_optimizers = 'filter_pushdown,reorder_filter'"); }
+
+    int64_t Count(const std::string& query) {
+        const auto result = con->Query(query);
+        EXPECT_FALSE(result->HasError()) << result->GetError();
+        return result->GetValue(0, 0).GetValue<int64_t>();
+    }
+
+    std::unique_ptr<duckdb::DuckDB> db;
+    std::unique_ptr<duckdb::Connection> con;
+};
+
+TEST_F(LlmPredicateOrderingTest, LlmPredicatesRunLast) {
+    DisableDuckDbReordering();
+    EXPECT_EQ(Count("SELECT count(*) FROM range(10000) t(i) WHERE llm_filter(i) AND i % 100 = 0"), 100);
+    EXPECT_EQ(evaluated_rows, 100);
+
+    evaluated_rows = 0;
+    EXPECT_EQ(Count("SELECT count(*) FROM range(10000) t(i) WHERE (llm_filter(i) AND i < 50) AND i % 2 = 0"), 25);
+    EXPECT_EQ(evaluated_rows, 25);
+}
+
+TEST_F(LlmPredicateOrderingTest, CheapFiltersMoveBelowLlmProjections) {
+    DisableDuckDbReordering();
+    EXPECT_EQ(Count("SELECT count(c) FROM (SELECT i, llm_complete(i) AS c FROM range(10000) t(i)) WHERE i < 10"), 10);
+    EXPECT_EQ(evaluated_rows, 10);
+}
+
+TEST_F(LlmPredicateOrderingTest, LlmPredicatesRunLastWithDefaultOptimizers) {
+    EXPECT_EQ(Count("SELECT count(*) FROM range(10000) t(i) WHERE llm_filter(i) AND i % 100 = 0"), 100);
+    EXPECT_EQ(evaluated_rows, 100);
+
+    evaluated_rows = 0;
+    EXPECT_EQ(Count("SELECT count(*) FROM range(10000) t(i) WHERE (llm_filter(i) AND i < 50) AND i % 2 = 0"), 25);
+    EXPECT_EQ(evaluated_rows, 25);
+
+    evaluated_rows = 0;
+    EXPECT_EQ(Count("SELECT count(c) FROM (SELECT i, llm_complete(i) AS c FROM range(10000) t(i)) WHERE i < 10"), 10);
+    EXPECT_EQ(evaluated_rows, 10);
+}
+
+TEST_F(LlmPredicateOrderingTest, OnlyMovesFunctionsFlockmtlRegisters) {
+    DisableDuckDbReordering();
+    EXPECT_EQ(Count("SELECT count(*) FROM range(10000) t(i) WHERE llm_custom(i) AND i % 100 = 0"), 100);
+    EXPECT_EQ(evaluated_rows, 10000);
+}
@@ -0,0 +1,93 @@
+#include "flockmtl/vector_search/distance.hpp"
+#include "flockmtl/vector_search/top_k.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace flockmtl;
+
+static std::vector<float> RandomVector(std::mt19937& generator, const size_t dimensions) {
+    std::uniform_real_distribution<float> value(-1, 1);
+    std::vector<float> vector(dimensions);
+    for (auto& element : vector) {
+        element = value(generator);
+    }
+    return vector;
+}
+
+TEST(Distance, KernelsMatchScalarLoops) {
+    std::mt19937 generator(42);
+    // Dimensions below, at and past the kernel's lane count
+    for (const size_t dimensions : {1, 3, 16, 17, 100, 1536}) {
+        const auto a = RandomVector(generator, dimensions);
+        const auto b = RandomVector(generator, dimensions);
+        double dot = 0;
+        double squared_l2 = 0;
+        for (size_t i = 0; i < dimensions; i++) {
+            dot += a[i] * b[i];
+            squared_l2 += (a[i] - b[i]) * (a[i] - b[i]);
+        }
+        EXPECT_NEAR(Distance::Dot(a.data(), b.data(), dimensions), dot, 1e-3);
+        EXPECT_NEAR(Distance::SquaredL2(a.data(), b.data(), dimensions), squared_l2, 1e-3);
+    }
+}
+
+TEST(Distance, Metrics) {
+    const std::vector<float> query = {3, 4};
+    const std::vector<float> same_direction = {6, 8};
+    const std::vector<float> orthogonal = {-4, 3};
+    const std::vector<float> zero = {0, 0};
+    const auto query_norm = Distance::Norm(query.data(), 2);
+    EXPECT_FLOAT_EQ(query_norm, 5);
+
+    EXPECT_NEAR(Distance::Compute(DistanceMetric::COSINE, query.data(), query_norm, same_direction.data(), 2), 0, 1e-6);
+    EXPECT_FLOAT_EQ(Distance::Compute(DistanceMetric::COSINE, query.data(), query_norm, orthogonal.data(), 2), 1);
+    EXPECT_FLOAT_EQ(Distance::Compute(DistanceMetric::COSINE, query.data(), query_norm, zero.data(), 2), 1);
+    EXPECT_FLOAT_EQ(Distance::Compute(DistanceMetric::L2, query.data(), query_norm, same_direction.data(), 2), 5);
+    EXPECT_FLOAT_EQ(Distance::Compute(DistanceMetric::DOT, query.data(), query_norm, same_direction.data(), 2), -50);
+}
+
+TEST(Distance, ParseMetric) {
+    EXPECT_EQ(Distance::ParseMetric("cosine"), DistanceMetric::COSINE);
+    EXPECT_EQ(Distance::ParseMetric("l2"), DistanceMetric::L2);
+    EXPECT_EQ(Distance::ParseMetric("dot"), DistanceMetric::DOT);
+    EXPECT_THROW(Distance::ParseMetric("manhattan"), std::runtime_error);
+}
+
+TEST(TopK, KeepsClosestAndMerges) {
+    TopK<int> first(3);
+    TopK<int> second(3);
+    for (auto i = 0; i < 10; i++) {
+        (i % 2 == 0 ? first : second).Push(static_cast<float>((i * 7) % 10), i);
+    }
+    EXPECT_FALSE(first.Accepts(9));
+    first.Merge(second);
+
+    const auto closest = first.TakeSorted();
+    ASSERT_EQ(closest.size(), 3);
+    // Distances 0, 1 and 2 belong to 0, 3 and 6
+    EXPECT_EQ(closest[0].item, 0);
+    EXPECT_EQ(closest[1].item, 3);
+    EXPECT_EQ(closest[2].item, 6);
+    EXPECT_EQ(first.Size(), 0);
+}
+
+TEST(TopK, SkipsNaNDistances) {
+    TopK<int> top(2);
+    top.Push(std::numeric_limits<float>::quiet_NaN(), 0);
+    top.Push(1, 1);
+    top.Push(std::numeric_limits<float>::quiet_NaN(), 2);
+    top.Push(0, 3);
+    EXPECT_FALSE(top.Accepts(std::numeric_limits<float>::quiet_NaN()));
+
+    const auto closest = top.TakeSorted();
+    ASSERT_EQ(closest.size(), 2);
+    EXPECT_EQ(closest[0].item, 3);
+    EXPECT_EQ(closest[1].item, 1);
+}
+
+TEST(TopK, HugeKDoesNotReserveUpFront) {
+    TopK<int> top(std::numeric_limits<size_t>::max());
+    top.Push(0, 0);
+    EXPECT_EQ(top.Size(), 1);
+}
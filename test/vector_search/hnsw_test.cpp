@@ -0,0 +1,171 @@
+#include "flockmtl/vector_search/hnsw.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+
+using namespace flockmtl;
+
+static std::vector<float> RandomVectors(const size_t rows, const size_t dimensions, const uint64_t seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> value(-1, 1);
+    std::vector<float> vectors(rows * dimensions);
+    for (auto& element : vectors) {
+        element = value(generator);
+    }
+    return vectors;
+}
+
+// Share of the exact k nearest neighbours the index finds, averaged over `queries`.
+static double Recall(const HnswIndex& index, const std::vector<float>& vectors, const std::vector<float>& queries,
+                     const size_t k, const size_t ef_search) {
+    const auto dimensions = index.Dimensions();
+    const auto rows = vectors.size() / dimensions;
+    size_t found = 0;
+    size_t expected = 0;
+    for (size_t query = 0; query < queries.size() / dimensions; query++) {
+        const auto query_vector = queries.data() + query * dimensions;
+        TopK<int64_t> exact(k);
+        for (size_t row = 0; row < rows; row++) {
+            exact.Push(Distance::Compute(index.GetOptions().metric, query_vector,
+                                         Distance::Norm(query_vector, dimensions), vectors.data() + row * dimensions,
+                                         dimensions),
+                       static_cast<int64_t>(row));
+        }
+        std::set<int64_t> exact_ids;
+        for (const auto& entry : exact.TakeSorted()) {
+            exact_ids.insert(entry.item);
+        }
+        for (const auto& entry : index.Search(query_vector, k, ef_search)) {
+            found += exact_ids.count(entry.item);
+        }
+        expected += k;
+    }
+    return static_cast<double>(found) / static_cast<double>(expected);
+}
+
+static std::vector<int64_t> Ids(const size_t rows) {
+    std::vector<int64_t> ids(rows);
+    for (size_t row = 0; row < rows; row++) {
+        ids[row] = static_cast<int64_t>(row);
+    }
+    return ids;
+}
+
+TEST(HnswIndex, FindsMostExactNeighbours) {
+    const size_t rows = 2000;
+    const size_t dimensions = 16;
+    const auto vectors = RandomVectors(rows, dimensions, 1);
+    const auto queries = RandomVectors(50, dimensions, 2);
+    for (const auto metric : {DistanceMetric::COSINE, DistanceMetric::L2}) {
+        HnswIndex index(dimensions, {16, 100, metric});
+        index.Build(vectors, Ids(rows), 4);
+        ASSERT_EQ(index.Size(), rows);
+        EXPECT_GT(Recall(index, vectors, queries, 10, 64), 0.9);
+    }
+}
+
+TEST(HnswIndex, ReturnsNeighboursClosestFirst) {
+    const size_t dimensions = 8;
+    const auto vectors = RandomVectors(500, dimensions, 3);
+    HnswIndex index(dimensions, {8, 50, DistanceMetric::L2});
+    index.Build(vectors, Ids(500), 2);
+
+    const auto neighbours = index.Search(vectors.data() + 42 * dimensions, 5, 32);
+    ASSERT_EQ(neighbours.size(), 5u);
+    EXPECT_EQ(neighbours[0].item, 42);
+    EXPECT_NEAR(neighbours[0].distance, 0, 1e-5);
+    for (size_t i = 1; i < neighbours.size(); i++) {
+        EXPECT_LE(neighbours[i - 1].distance, neighbours[i].distance);
+    }
+    // fewer vectors than requested
+    HnswIndex small(dimensions, {});
+    small.Build(std::vector<float>(vectors.begin(), vectors.begin() + 3 * dimensions), {7, 8, 9}, 1);
+    EXPECT_EQ(small.Search(vectors.data(), 10, 10).size(), 3u);
+}
+
+template <class T>
+static void Append(std::string& data, const T value) {
+    data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+TEST(HnswIndex, SerializationRoundTrips) {
+    const size_t dimensions = 12;
+    const auto vectors = RandomVectors(300, dimensions, 4);
+    HnswIndex index(dimensions, {6, 40, DistanceMetric::DOT});
+    index.Build(vectors, Ids(300), 3);
+
+    const auto restored = HnswIndex::Deserialize(index.Serialize());
+    EXPECT_EQ(restored->Size(), index.Size());
+    EXPECT_EQ(restored->GetOptions().m, 6u);
+    EXPECT_EQ(restored->GetOptions().metric, DistanceMetric::DOT);
+    const auto query = RandomVectors(1, dimensions, 5);
+    const auto expected = index.Search(query.data(), 10, 20);
+    const auto actual = restored->Search(query.data(), 10, 20);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); i++) {
+        EXPECT_EQ(actual[i].item, expected[i].item);
+    }
+
+    auto corrupted = index.Serialize();
+    corrupted.resize(corrupted.size() - 1);
+    EXPECT_THROW(HnswIndex::Deserialize(corrupted), std::runtime_error);
+    EXPECT_THROW(HnswIndex::Deserialize("not an index"), std::runtime_error);
+}
+
+TEST(HnswIndex, KeepsItsVectors) {
+    const size_t dimensions = 4;
+    auto vectors = RandomVectors(50, dimensions, 6);
+    HnswIndex index(dimensions, {});
+    index.Build(vectors, Ids(50), 1);
+    const auto data = index.Serialize();
+    const auto query = std::vector<float>(vectors.begin() + 17 * dimensions, vectors.begin() + 18 * dimensions);
+
+    // A loaded index searches the vectors it was built from, whatever became of the rows.
+    vectors.clear();
+    const auto restored = HnswIndex::Deserialize(data);
+    const auto neighbours = restored->Search(query.data(), 1, 16);
+    ASSERT_EQ(neighbours.size(), 1u);
+    EXPECT_EQ(neighbours[0].item, 17);
+    EXPECT_NEAR(neighbours[0].distance, 0, 1e-5);
+
+    EXPECT_THROW(HnswIndex::Deserialize(data.substr(0, data.size() - sizeof(float))), std::runtime_error);
+    EXPECT_THROW(HnswIndex::Deserialize(data + std::string(sizeof(float), '\0')), std::runtime_error);
+}
+
+TEST(HnswIndex, RejectsLinksAboveTheLevelOfTheirTarget) {
+    // Two nodes on one dimension. Node 0 links to node 1 on level 1, but node 1 only exists on level 0.
+    std::string data = "FLKHNSW3";
+    Append<uint64_t>(data, 1);
+    Append<uint64_t>(data, 2);
+    Append<uint64_t>(data, 10);
+    Append<uint8_t>(data, static_cast<uint8_t>(DistanceMetric::L2));
+    Append<uint64_t>(data, 2);
+    Append<int32_t>(data, 1);
+    Append<uint32_t>(data, 0);
+    Append<int64_t>(data, 0);
+    Append<uint8_t>(data, 1);
+    Append<uint32_t>(data, 1);
+    Append<uint32_t>(data, 1);
+    Append<uint32_t>(data, 1);
+    Append<uint32_t>(data, 1);
+    Append<int64_t>(data, 1);
+    Append<uint8_t>(data, 0);
+    Append<uint32_t>(data, 1);
+    Append<uint32_t>(data, 0);
+    Append<float>(data, 0);
+    Append<float>(data, 1);
+
+    try {
+        HnswIndex::Deserialize(data);
+        FAIL() << "expected the link to be rejected";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("corrupted"), std::string::npos) << e.what();
+    }
+}
+
+TEST(HnswIndex, RejectsInvalidOptions) {
+    EXPECT_THROW(HnswIndex(0, {}), std::runtime_error);
+    EXPECT_THROW(HnswIndex(4, {1, 10, DistanceMetric::COSINE}), std::runtime_error);
+    HnswIndex index(4, {});
+    EXPECT_THROW(index.Build(std::vector<float>(7), {1, 2}, 1), std::runtime_error);
+}
@@ -0,0 +1,91 @@
+#include "flockmtl/vector_search/quantization.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace flockmtl;
+
+static std::vector<float> RandomVector(std::mt19937& generator, const size_t dimensions) {
+    std::uniform_real_distribution<float> value(-1, 1);
+    std::vector<float> vector(dimensions);
+    for (auto& element : vector) {
+        element = value(generator);
+    }
+    return vector;
+}
+
+TEST(Quantization, Int8KeepsTheDistances) {
+    std::mt19937 generator(42);
+    const size_t dimensions = 256;
+    const auto a = RandomVector(generator, dimensions);
+    const auto b = RandomVector(generator, dimensions);
+    const auto quantized_a = Quantization::QuantizeInt8(a.data(), dimensions);
+    const auto quantized_b = Quantization::QuantizeInt8(b.data(), dimensions);
+    ASSERT_EQ(quantized_a.size(), Quantization::kInt8HeaderSize + dimensions);
+
+    // The rounding errors are relative to the vectors' magnitudes rather than to the distances themselves
+    const auto norms = Distance::Norm(a.data(), dimensions) * Distance::Norm(b.data(), dimensions);
+    for (const auto metric : {DistanceMetric::COSINE, DistanceMetric::L2, DistanceMetric::DOT}) {
+        const auto exact = Distance::Compute(metric, a.data(), Distance::Norm(a.data(), dimensions), b.data(),
+                                             dimensions);
+        const auto approximate = Quantization::Compute(metric, quantized_a, quantized_b.data(), quantized_b.size());
+        EXPECT_NEAR(approximate, exact, metric == DistanceMetric::DOT ? 0.005 * norms : 0.005);
+        // The query's norm can be computed once up front.
+        EXPECT_EQ(Quantization::Compute(metric, quantized_a, Quantization::Int8SquaredNorm(quantized_a),
+                                        quantized_b.data(), quantized_b.size()),
+                  approximate);
+    }
+}
+
+TEST(Quantization, Int8DotMatchesScalarLoop) {
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> value(-127, 127);
+    // Dimensions below, at and past the kernel's lane count
+    for (const size_t dimensions : {1, 31, 32, 33, 1536}) {
+        std::vector<int8_t> a(dimensions);
+        std::vector<int8_t> b(dimensions);
+        int32_t expected = 0;
+        for (size_t i = 0; i < dimensions; i++) {
+            a[i] = static_cast<int8_t>(value(generator));
+            b[i] = static_cast<int8_t>(value(generator));
+            expected += a[i] * b[i];
+        }
+        EXPECT_EQ(Quantization::Int8Dot(a.data(), b.data(), dimensions), expected);
+    }
+}
+
+TEST(Quantization, BinaryKeepsSignsAndCountsDifferingBits) {
+    const std::vector<float> a = {0.5, -0.1, 0.2, 0, -3, 1, 1, 1, 1, -1};
+    const std::vector<float> b = {0.5, 0.1, 0.2, -1, -3, 1, 1, 1, 1, 1};
+    const auto quantized_a = Quantization::QuantizeBinary(a.data(), a.size());
+    const auto quantized_b = Quantization::QuantizeBinary(b.data(), b.size());
+    ASSERT_EQ(quantized_a.size(), 3u);
+    EXPECT_EQ(static_cast<uint8_t>(quantized_a[1]), 0b11100101);
+    EXPECT_EQ(static_cast<uint8_t>(quantized_a[2]), 0b01);
+    EXPECT_EQ(Quantization::Compute(DistanceMetric::COSINE, quantized_a, quantized_b.data(), quantized_b.size()), 2);
+
+    std::mt19937 generator(1);
+    const auto c = RandomVector(generator, 1000);
+    const auto d = RandomVector(generator, 1000);
+    const auto quantized_c = Quantization::QuantizeBinary(c.data(), c.size());
+    const auto quantized_d = Quantization::QuantizeBinary(d.data(), d.size());
+    uint64_t expected = 0;
+    for (size_t i = 0; i < c.size(); i++) {
+        expected += (c[i] > 0) != (d[i] > 0);
+    }
+    EXPECT_EQ(Quantization::Hamming(reinterpret_cast<const uint8_t*>(quantized_c.data()) + 1,
+                                    reinterpret_cast<const uint8_t*>(quantized_d.data()) + 1, quantized_c.size() - 1),
+              expected);
+}
+
+TEST(Quantization, RejectsMismatchedVectors) {
+    const std::vector<float> a = {1, 2, 3};
+    const std::vector<float> b = {1, 2, 3, 4};
+    const auto int8_a = Quantization::QuantizeInt8(a.data(), a.size());
+    const auto int8_b = Quantization::QuantizeInt8(b.data(), b.size());
+    const auto binary_a = Quantization::QuantizeBinary(a.data(), a.size());
+    EXPECT_THROW(Quantization::Compute(DistanceMetric::L2, int8_a, int8_b.data(), int8_b.size()), std::runtime_error);
+    EXPECT_THROW(Quantization::Compute(DistanceMetric::L2, int8_a, binary_a.data(), binary_a.size()),
+                 std::runtime_error);
+    EXPECT_THROW(Quantization::GetEncoding("\x07xyz", 4), std::runtime_error);
+}